@@ -275,9 +275,13 @@ public:
 	/** Initial value is ACTIVE_NETWORK compile flag, but can be overridden by a CLI flag */
 	static vxldollar::networks active_network;
 	/** Current protocol version */
-	uint8_t const protocol_version = 0x12;
+	uint8_t const protocol_version = 0x14;
 	/** Minimum accepted protocol version */
 	uint8_t const protocol_version_min = 0x12;
+	/** Minimum peer protocol version accepting several bulk_pull requests in flight on one bootstrap connection */
+	uint8_t const bootstrap_pipelining_version_min = 0x13;
+	/** Minimum peer protocol version serving compact bulk_pull responses, see bulk_pull_compact */
+	uint8_t const bootstrap_compact_version_min = 0x14;
 };
 
 std::string get_node_toml_config_path (boost::filesystem::path const & data_path);
@@ -0,0 +1,60 @@
+#include <vxldollar/secure/block_filter.hpp>
+
+#include <gtest/gtest.h>
+
+TEST (block_filter, insert_erase)
+{
+	vxldollar::block_filter filter (1000, 0.01, 1024 * 1024);
+	vxldollar::block_hash hash (42);
+	ASSERT_FALSE (filter.may_contain (hash));
+	filter.insert (hash);
+	ASSERT_TRUE (filter.may_contain (hash));
+	ASSERT_EQ (1, filter.size ());
+	filter.erase (hash);
+	ASSERT_FALSE (filter.may_contain (hash));
+	ASSERT_EQ (0, filter.size ());
+}
+
+// A hash cached as absent is forgotten once it is inserted
+TEST (block_filter, negative_cache)
+{
+	vxldollar::block_filter filter (1000, 0.01, 1024 * 1024);
+	vxldollar::block_hash hash (42);
+	ASSERT_FALSE (filter.cached_absent (hash));
+	filter.cache_absent (hash, filter.insert_stamp (hash));
+	ASSERT_TRUE (filter.cached_absent (hash));
+	ASSERT_FALSE (filter.cached_absent (vxldollar::block_hash (43)));
+	filter.insert (hash);
+	ASSERT_FALSE (filter.cached_absent (hash));
+}
+
+// A miss is not cached if the hash was inserted between its lookup and the commit of its transaction
+TEST (block_filter, negative_cache_insert_stamp)
+{
+	vxldollar::block_filter filter (1000, 0.01, 1024 * 1024);
+	vxldollar::block_hash hash (42);
+	auto stamp (filter.insert_stamp (hash));
+	filter.insert (hash);
+	filter.cache_absent (hash, stamp);
+	ASSERT_FALSE (filter.cached_absent (hash));
+	filter.cache_absent (hash, filter.insert_stamp (hash));
+	ASSERT_TRUE (filter.cached_absent (hash));
+}
+
+TEST (block_filter, memory_limit)
+{
+	vxldollar::block_filter small (1000 * 1000, 0.01, 64 * 1024);
+	vxldollar::block_filter large (1000 * 1000, 0.01, 1024 * 1024 * 1024);
+	ASSERT_LE (small.memory_size (), 64 * 1024 + vxldollar::block_filter::negative_cache_size * (sizeof (vxldollar::block_hash) + sizeof (uint64_t)));
+	ASSERT_LT (small.memory_size (), large.memory_size ());
+	for (uint64_t i (1); i <= 1000 * 1000; ++i)
+	{
+		vxldollar::block_hash hash;
+		hash.qwords[0] = i * 0x9e3779b97f4a7c15ull;
+		small.insert (hash);
+		large.insert (hash);
+	}
+	// The limited filter is too small for the configured rate, which is reported
+	ASSERT_GT (small.false_positive_rate (), 0.5);
+	ASSERT_LT (large.false_positive_rate (), 0.01);
+}
@@ -0,0 +1,73 @@
+#include <vxldollar/lib/counting_filter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+TEST (counting_filter, insert_erase)
+{
+	vxldollar::counting_filter filter (1024);
+	ASSERT_FALSE (filter.may_contain (42));
+	filter.insert (42);
+	ASSERT_TRUE (filter.may_contain (42));
+	filter.insert (42);
+	filter.erase (42);
+	ASSERT_TRUE (filter.may_contain (42));
+	filter.erase (42);
+	ASSERT_FALSE (filter.may_contain (42));
+}
+
+// Erasing keys never hides keys which are still inserted
+TEST (counting_filter, no_false_negatives)
+{
+	vxldollar::counting_filter filter (4096);
+	std::mt19937_64 random (42);
+	std::vector<uint64_t> keys (2000);
+	for (auto & key : keys)
+	{
+		key = random ();
+		filter.insert (key);
+	}
+	for (auto i (0); i < 1000; ++i)
+	{
+		filter.erase (keys[i]);
+	}
+	for (auto i (1000); i < 2000; ++i)
+	{
+		ASSERT_TRUE (filter.may_contain (keys[i]));
+	}
+}
+
+TEST (counting_filter, saturation)
+{
+	vxldollar::counting_filter filter (64);
+	for (auto i (0); i < 300; ++i)
+	{
+		filter.insert (7);
+	}
+	for (auto i (0); i < 300; ++i)
+	{
+		filter.erase (7);
+	}
+	// Saturated counters are never decremented
+	ASSERT_TRUE (filter.may_contain (7));
+	filter.clear ();
+	ASSERT_FALSE (filter.may_contain (7));
+}
+
+TEST (counting_filter, false_positive_rate)
+{
+	vxldollar::counting_filter filter (8 * 10000);
+	std::mt19937_64 random (42);
+	for (auto i (0); i < 10000; ++i)
+	{
+		filter.insert (random ());
+	}
+	auto positives (0);
+	for (auto i (0); i < 10000; ++i)
+	{
+		positives += filter.may_contain (random ());
+	}
+	// About 3% with 8 counters per key and 3 hashes
+	ASSERT_LT (positives, 1000);
+}
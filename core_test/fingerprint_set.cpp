@@ -0,0 +1,89 @@
+#include <vxldollar/lib/fingerprint_set.hpp>
+#include <vxldollar/lib/numbers.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unordered_set>
+
+TEST (fingerprint_set, empty)
+{
+	vxldollar::fingerprint_set set;
+	ASSERT_TRUE (set.empty ());
+	ASSERT_EQ (0, set.size ());
+	ASSERT_EQ (0, set.memory_size ());
+	ASSERT_FALSE (set.contains (1));
+	ASSERT_FALSE (set.erase (1));
+}
+
+TEST (fingerprint_set, insert_erase)
+{
+	vxldollar::fingerprint_set set;
+	ASSERT_TRUE (set.insert (42));
+	ASSERT_FALSE (set.insert (42));
+	ASSERT_EQ (1, set.size ());
+	ASSERT_TRUE (set.contains (42));
+	ASSERT_FALSE (set.contains (43));
+	ASSERT_TRUE (set.erase (42));
+	ASSERT_FALSE (set.erase (42));
+	ASSERT_FALSE (set.contains (42));
+	ASSERT_TRUE (set.empty ());
+}
+
+// Zero marks empty slots internally
+TEST (fingerprint_set, zero)
+{
+	vxldollar::fingerprint_set set;
+	ASSERT_TRUE (set.insert (0));
+	ASSERT_TRUE (set.contains (0));
+	std::vector<uint64_t> values;
+	set.for_each ([&values] (uint64_t value_a) { values.push_back (value_a); });
+	ASSERT_EQ (std::vector<uint64_t>{ 0 }, values);
+	ASSERT_TRUE (set.erase (0));
+	ASSERT_FALSE (set.contains (0));
+}
+
+// Compares against std::unordered_set through growth and erasure, including values that share probe sequences
+TEST (fingerprint_set, random)
+{
+	vxldollar::fingerprint_set set;
+	std::unordered_set<uint64_t> expected;
+	vxldollar::block_hash hash (0);
+	for (auto i (0); i < 10000; ++i)
+	{
+		hash = vxldollar::block_hash (hash.number () + 1);
+		auto value (std::hash<vxldollar::block_hash> () (hash));
+		ASSERT_EQ (expected.insert (value).second, set.insert (value));
+		// Sequential values collide with each other's probe sequences
+		ASSERT_EQ (expected.insert (i).second, set.insert (i));
+	}
+	ASSERT_EQ (expected.size (), set.size ());
+	auto i (0);
+	for (auto it (expected.begin ()); it != expected.end ();)
+	{
+		if (i++ % 3 == 0)
+		{
+			ASSERT_TRUE (set.erase (*it));
+			it = expected.erase (it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+	ASSERT_EQ (expected.size (), set.size ());
+	for (auto value : expected)
+	{
+		ASSERT_TRUE (set.contains (value));
+	}
+	std::size_t count (0);
+	set.for_each ([&expected, &count] (uint64_t value_a) {
+		ASSERT_EQ (1, expected.count (value_a));
+		++count;
+	});
+	ASSERT_EQ (expected.size (), count);
+	// 8 bytes per slot at no less than 37.5% load after growth, erasure does not shrink the table
+	ASSERT_LE (set.memory_size (), 20000 * sizeof (uint64_t) * 100 / (vxldollar::fingerprint_set::max_load_percent / 2));
+	set.clear ();
+	ASSERT_TRUE (set.empty ());
+	ASSERT_EQ (0, set.memory_size ());
+}
@@ -7,6 +7,8 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 using namespace std::chrono_literals;
 
 // Init returns an error if it can't open files at the path
@@ -3271,6 +3273,52 @@ TEST (ledger, pruning_action)
 	ASSERT_EQ (store->block.count (transaction), ledger.cache.block_count - ledger.cache.pruned_count);
 }
 
+// Lookups answered by the block filter agree with the database as blocks are added, rolled back and pruned
+TEST (ledger, block_filter)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	vxldollar::stat stats;
+	vxldollar::ledger ledger (*store, stats, vxldollar::dev::constants);
+	ledger.pruning = true;
+	store->initialize (store->tx_begin_write (), ledger.cache);
+	ledger.block_filter_enable (0.01, 1024 * 1024);
+	auto const filter (store->block_filter ());
+	ASSERT_NE (nullptr, filter);
+	ASSERT_EQ (1, filter->size ());
+	ASSERT_TRUE (ledger.block_or_pruned_exists (vxldollar::dev::genesis->hash ()));
+	ASSERT_FALSE (ledger.block_or_pruned_exists (vxldollar::block_hash (42)));
+	ASSERT_EQ (1, stats.count (vxldollar::stat::type::block_filter, vxldollar::stat::detail::filtered) + stats.count (vxldollar::stat::type::block_filter, vxldollar::stat::detail::false_positive));
+	vxldollar::work_pool pool{ vxldollar::dev::network_params.network, std::numeric_limits<unsigned>::max () };
+	vxldollar::state_block send1 (vxldollar::dev::genesis->account (), vxldollar::dev::genesis->hash (), vxldollar::dev::genesis->account (), vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio, vxldollar::dev::genesis->account (), vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub, *pool.generate (vxldollar::dev::genesis->hash ()));
+	vxldollar::state_block send2 (vxldollar::dev::genesis->account (), send1.hash (), vxldollar::dev::genesis->account (), vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio * 2, vxldollar::dev::genesis->account (), vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub, *pool.generate (send1.hash ()));
+	auto transaction (store->tx_begin_write ());
+	// A miss is not remembered once the block is added
+	ASSERT_FALSE (ledger.block_or_pruned_exists (transaction, send1.hash ()));
+	ASSERT_EQ (vxldollar::process_result::progress, ledger.process (transaction, send1).code);
+	transaction.refresh ();
+	ASSERT_FALSE (filter->cached_absent (send1.hash ()));
+	ASSERT_TRUE (ledger.block_or_pruned_exists (transaction, send1.hash ()));
+	ASSERT_EQ (vxldollar::process_result::progress, ledger.process (transaction, send2).code);
+	ASSERT_EQ (3, filter->size ());
+	std::vector<std::shared_ptr<vxldollar::block>> rollback_list;
+	ASSERT_FALSE (ledger.rollback (transaction, send2.hash (), rollback_list));
+	ASSERT_FALSE (ledger.block_or_pruned_exists (transaction, send2.hash ()));
+	// Other transactions may read the block until the rollback is committed, so it is erased from the filter and cached as absent afterwards
+	ASSERT_EQ (3, filter->size ());
+	ASSERT_FALSE (filter->cached_absent (send2.hash ()));
+	transaction.refresh ();
+	ASSERT_EQ (2, filter->size ());
+	ASSERT_TRUE (filter->cached_absent (send2.hash ()));
+	ASSERT_EQ (vxldollar::process_result::progress, ledger.process (transaction, send2).code);
+	ASSERT_EQ (1, ledger.pruning_action (transaction, send1.hash (), 1));
+	ASSERT_TRUE (ledger.block_or_pruned_exists (transaction, send1.hash ()));
+	ASSERT_TRUE (ledger.block_or_pruned_exists (transaction, send2.hash ()));
+	transaction.commit ();
+	ASSERT_EQ (3, filter->size ());
+}
+
 TEST (ledger, pruning_large_chain)
 {
 	vxldollar::logger_mt logger;
@@ -3671,6 +3719,57 @@ TEST (ledger, migrate_lmdb_to_rocksdb)
 	ASSERT_EQ (rocksdb_store.final_vote.get (rocksdb_transaction, vxldollar::root (send->previous ()))[0], vxldollar::block_hash (2));
 }
 
+// A migration which finds a checkpoint keeps the existing RocksDB database and skips the tables recorded as finished
+TEST (ledger, migrate_lmdb_to_rocksdb_resume)
+{
+	auto path = vxldollar::unique_path ();
+	vxldollar::logger_mt logger{};
+	vxldollar::mdb_store store{ logger, path / "data.ldb", vxldollar::dev::constants };
+	vxldollar::stat stats{};
+	vxldollar::ledger ledger{ store, stats, vxldollar::dev::constants };
+	vxldollar::endpoint_key endpoint_key1 (boost::asio::ip::make_address_v6 ("::ffff:127.0.0.1").to_bytes (), 100);
+	vxldollar::endpoint_key endpoint_key2 (boost::asio::ip::make_address_v6 ("::ffff:127.0.0.2").to_bytes (), 100);
+	{
+		auto transaction = store.tx_begin_write ();
+		store.initialize (transaction, ledger.cache);
+		store.peer.put (transaction, endpoint_key1);
+		// Spread over the key ranges which are migrated in parallel
+		for (auto i (1); i <= 5000; ++i)
+		{
+			store.pruned.put (transaction, vxldollar::block_hash (vxldollar::uint256_t (i) << 243));
+		}
+	}
+	std::vector<std::string> messages;
+	ASSERT_FALSE (ledger.migrate_lmdb_to_rocksdb (path, [&messages] (std::string const & message_a) { messages.push_back (message_a); }));
+	ASSERT_FALSE (messages.empty ());
+	auto migration_path (path / "rocksdb_migration");
+	ASSERT_FALSE (boost::filesystem::exists (migration_path));
+
+	// Interrupted after the peers were ingested, peers added to the source since then are not migrated
+	boost::filesystem::create_directories (migration_path);
+	{
+		std::ofstream checkpoint ((migration_path / "checkpoint").string ());
+		checkpoint << "peers done" << std::endl;
+	}
+	{
+		auto transaction = store.tx_begin_write ();
+		store.peer.put (transaction, endpoint_key2);
+		store.pruned.put (transaction, vxldollar::block_hash (vxldollar::uint256_t (5001) << 243));
+	}
+	ASSERT_FALSE (ledger.migrate_lmdb_to_rocksdb (path));
+	ASSERT_FALSE (boost::filesystem::exists (migration_path));
+
+	vxldollar::rocksdb_store rocksdb_store{ logger, path / "rocksdb", vxldollar::dev::constants };
+	auto rocksdb_transaction (rocksdb_store.tx_begin_read ());
+	ASSERT_TRUE (rocksdb_store.peer.exists (rocksdb_transaction, endpoint_key1));
+	ASSERT_FALSE (rocksdb_store.peer.exists (rocksdb_transaction, endpoint_key2));
+	ASSERT_TRUE (rocksdb_store.pruned.exists (rocksdb_transaction, vxldollar::block_hash (vxldollar::uint256_t (5001) << 243)));
+	ASSERT_TRUE (rocksdb_store.block.exists (rocksdb_transaction, vxldollar::dev::genesis->hash ()));
+	uint64_t pruned (0);
+	rocksdb_store.for_each_raw (rocksdb_transaction, vxldollar::tables::pruned, 0, 255, [&pruned] (uint8_t const *, std::size_t, uint8_t const *, std::size_t) { ++pruned; });
+	ASSERT_EQ (5001, pruned);
+}
+
 TEST (ledger, unconfirmed_frontiers)
 {
 	vxldollar::logger_mt logger;
@@ -3708,3 +3807,57 @@ TEST (ledger, unconfirmed_frontiers)
 	ASSERT_EQ (uncemented_info1.cemented_frontier, uncemented_info2.cemented_frontier);
 	ASSERT_EQ (uncemented_info1.frontier, uncemented_info2.frontier);
 }
+
+TEST (ledger, account_height_index)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	vxldollar::stat stats;
+	vxldollar::ledger ledger (*store, stats, vxldollar::dev::constants);
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, ledger.cache);
+	ledger.account_height_index = true;
+	ASSERT_EQ (1, ledger.account_height_index_build (transaction));
+	vxldollar::work_pool pool{ vxldollar::dev::network_params.network, std::numeric_limits<unsigned>::max () };
+	std::vector<vxldollar::block_hash> hashes{ vxldollar::dev::genesis->hash () };
+	for (auto i (1); i <= 3; ++i)
+	{
+		vxldollar::state_block send (vxldollar::dev::genesis->account (), hashes.back (), vxldollar::dev::genesis->account (), vxldollar::dev::constants.genesis_amount - i * vxldollar::Gxrb_ratio, vxldollar::dev::genesis->account (), vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub, *pool.generate (hashes.back ()));
+		ASSERT_EQ (vxldollar::process_result::progress, ledger.process (transaction, send).code);
+		hashes.push_back (send.hash ());
+	}
+	ASSERT_EQ (4, store->account_height.count (transaction));
+	for (uint64_t height (1); height <= hashes.size (); ++height)
+	{
+		ASSERT_EQ (hashes[height - 1], store->account_height.get (transaction, vxldollar::dev::genesis->account (), height));
+		ASSERT_EQ (hashes[height - 1], ledger.block_at_height (transaction, vxldollar::dev::genesis->account (), height));
+	}
+	// Without the index the chain is walked, with the same result
+	ledger.account_height_index = false;
+	for (uint64_t height (1); height <= hashes.size (); ++height)
+	{
+		ASSERT_EQ (hashes[height - 1], ledger.block_at_height (transaction, vxldollar::dev::genesis->account (), height));
+	}
+	ASSERT_TRUE (ledger.block_at_height (transaction, vxldollar::dev::genesis->account (), 0).is_zero ());
+	ASSERT_TRUE (ledger.block_at_height (transaction, vxldollar::dev::genesis->account (), 5).is_zero ());
+	ASSERT_TRUE (ledger.block_at_height (transaction, vxldollar::keypair ().pub, 1).is_zero ());
+	ledger.account_height_index = true;
+	// Rolled back blocks are removed
+	ASSERT_FALSE (ledger.rollback (transaction, hashes[3]));
+	ASSERT_TRUE (store->account_height.get (transaction, vxldollar::dev::genesis->account (), 4).is_zero ());
+	ASSERT_EQ (3, store->account_height.count (transaction));
+	// Pruned blocks are removed
+	ledger.pruning = true;
+	ASSERT_EQ (1, ledger.pruning_action (transaction, hashes[1], 1));
+	ASSERT_TRUE (store->account_height.get (transaction, vxldollar::dev::genesis->account (), 2).is_zero ());
+	ASSERT_EQ (hashes[2], ledger.block_at_height (transaction, vxldollar::dev::genesis->account (), 3));
+	// Rebuilding from a pruned ledger indexes the remaining blocks on both sides of the pruned one
+	store->account_height.clear (transaction);
+	ASSERT_EQ (2, ledger.account_height_index_build (transaction));
+	ASSERT_EQ (2, store->account_height.count (transaction));
+	ASSERT_EQ (hashes[0], store->account_height.get (transaction, vxldollar::dev::genesis->account (), 1));
+	ASSERT_TRUE (store->account_height.get (transaction, vxldollar::dev::genesis->account (), 2).is_zero ());
+	ASSERT_EQ (hashes[2], store->account_height.get (transaction, vxldollar::dev::genesis->account (), 3));
+	ASSERT_EQ (hashes[0], ledger.block_at_height (transaction, vxldollar::dev::genesis->account (), 1));
+}
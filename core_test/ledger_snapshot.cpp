@@ -0,0 +1,222 @@
+#include <vxldollar/node/ledger_snapshot.hpp>
+#include <vxldollar/test_common/system.hpp>
+#include <vxldollar/test_common/testutil.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+namespace
+{
+/** Genesis sends to a new account, which receives it. A second send stays pending. */
+void setup_ledger (vxldollar::node & node_a, vxldollar::keypair const & key_a, std::vector<std::shared_ptr<vxldollar::block>> & blocks_a)
+{
+	vxldollar::state_block_builder builder;
+	auto send1 = builder.make_block ()
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (vxldollar::dev::genesis->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio)
+				 .link (key_a.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*node_a.work_generate_blocking (vxldollar::dev::genesis->hash ()))
+				 .build_shared ();
+	auto open = builder.make_block ()
+				.account (key_a.pub)
+				.previous (0)
+				.representative (key_a.pub)
+				.balance (vxldollar::Gxrb_ratio)
+				.link (send1->hash ())
+				.sign (key_a.prv, key_a.pub)
+				.work (*node_a.work_generate_blocking (key_a.pub))
+				.build_shared ();
+	auto send2 = builder.make_block ()
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (send1->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - 2 * vxldollar::Gxrb_ratio)
+				 .link (key_a.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*node_a.work_generate_blocking (send1->hash ()))
+				 .build_shared ();
+	blocks_a = { send1, open, send2 };
+	for (auto const & block : blocks_a)
+	{
+		ASSERT_EQ (vxldollar::process_result::progress, node_a.process (*block).code);
+	}
+}
+}
+
+TEST (ledger_snapshot, export_import)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	vxldollar::keypair key;
+	std::vector<std::shared_ptr<vxldollar::block>> blocks;
+	setup_ledger (node, key, blocks);
+	vxldollar::confirmation_height_info confirmation_height{ 2, blocks[0]->hash () };
+	node.store.confirmation_height.put (node.store.tx_begin_write (), vxldollar::dev::genesis_key.pub, confirmation_height);
+	auto path (vxldollar::unique_path ());
+	vxldollar::ledger_export exporter (node.store, node.network_params);
+	ASSERT_FALSE (exporter.run (path));
+	ASSERT_EQ (2, exporter.accounts);
+	ASSERT_EQ (4, exporter.blocks);
+	ASSERT_EQ (1, exporter.pending);
+
+	// Import into a ledger holding only the genesis block
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store->init_error ());
+	{
+		vxldollar::ledger_cache ledger_cache;
+		store->initialize (store->tx_begin_write (), ledger_cache);
+	}
+	vxldollar::ledger_import importer (*store, vxldollar::dev::network_params, 2);
+	ASSERT_FALSE (importer.run (path));
+	ASSERT_EQ (exporter.accounts, importer.accounts);
+	ASSERT_EQ (exporter.blocks, importer.blocks);
+	ASSERT_EQ (exporter.pending, importer.pending);
+	ASSERT_EQ (exporter.frontiers, importer.frontiers);
+
+	auto transaction (store->tx_begin_read ());
+	auto node_transaction (node.store.tx_begin_read ());
+	ASSERT_EQ (node.store.block.count (node_transaction), store->block.count (transaction));
+	for (auto const & block : blocks)
+	{
+		auto imported (store->block.get (transaction, block->hash ()));
+		ASSERT_NE (nullptr, imported);
+		ASSERT_EQ (*block, *imported);
+		ASSERT_EQ (node.store.block.get (node_transaction, block->hash ())->sideband ().successor, imported->sideband ().successor);
+	}
+	for (auto const & account : { vxldollar::dev::genesis_key.pub, key.pub })
+	{
+		vxldollar::account_info expected;
+		vxldollar::account_info info;
+		ASSERT_FALSE (node.store.account.get (node_transaction, account, expected));
+		ASSERT_FALSE (store->account.get (transaction, account, info));
+		ASSERT_EQ (expected, info);
+	}
+	vxldollar::confirmation_height_info imported_height;
+	ASSERT_FALSE (store->confirmation_height.get (transaction, vxldollar::dev::genesis_key.pub, imported_height));
+	ASSERT_EQ (confirmation_height.height, imported_height.height);
+	ASSERT_EQ (confirmation_height.frontier, imported_height.frontier);
+	ASSERT_TRUE (store->pending.exists (transaction, vxldollar::pending_key (key.pub, blocks[2]->hash ())));
+	ASSERT_FALSE (store->pending.exists (transaction, vxldollar::pending_key (key.pub, blocks[0]->hash ())));
+	// The genesis frontier of the initialized store is replaced by the exported frontiers
+	ASSERT_EQ (node.store.frontier.get (node_transaction, vxldollar::dev::genesis->hash ()), store->frontier.get (transaction, vxldollar::dev::genesis->hash ()));
+}
+
+// The last record fills its chunk, which is followed by the totals without an empty chunk in between
+TEST (ledger_snapshot, export_chunk_filled)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	vxldollar::keypair key;
+	std::vector<std::shared_ptr<vxldollar::block>> blocks;
+	setup_ledger (node, key, blocks);
+	auto path (vxldollar::unique_path ());
+	// Frontier records are written last, a record type followed by a block hash and an account
+	auto const frontier_record_size (1 + sizeof (vxldollar::block_hash) + sizeof (vxldollar::account));
+	vxldollar::ledger_export exporter (node.store, node.network_params, frontier_record_size);
+	ASSERT_FALSE (exporter.run (path));
+	ASSERT_LT (0, exporter.frontiers);
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store->init_error ());
+	{
+		vxldollar::ledger_cache ledger_cache;
+		store->initialize (store->tx_begin_write (), ledger_cache);
+	}
+	vxldollar::ledger_import importer (*store, vxldollar::dev::network_params, 2);
+	ASSERT_FALSE (importer.run (path));
+	ASSERT_EQ (exporter.accounts, importer.accounts);
+	ASSERT_EQ (exporter.blocks, importer.blocks);
+	ASSERT_EQ (exporter.pending, importer.pending);
+	ASSERT_EQ (exporter.frontiers, importer.frontiers);
+}
+
+TEST (ledger_snapshot, import_corrupt)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	vxldollar::keypair key;
+	std::vector<std::shared_ptr<vxldollar::block>> blocks;
+	setup_ledger (node, key, blocks);
+	auto path (vxldollar::unique_path ());
+	vxldollar::ledger_export exporter (node.store, node.network_params);
+	ASSERT_FALSE (exporter.run (path));
+	auto size (boost::filesystem::file_size (path));
+	vxldollar::logger_mt logger;
+	// A flipped payload byte fails the chunk checksum
+	{
+		std::fstream file (path.string (), std::ios::binary | std::ios::in | std::ios::out);
+		file.seekg (vxldollar::ledger_snapshot::header_size + vxldollar::ledger_snapshot::chunk_header_size + 64);
+		char byte;
+		file.read (&byte, 1);
+		file.seekp (vxldollar::ledger_snapshot::header_size + vxldollar::ledger_snapshot::chunk_header_size + 64);
+		byte ^= 1;
+		file.write (&byte, 1);
+	}
+	{
+		auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+		vxldollar::ledger_import importer (*store, vxldollar::dev::network_params, 2);
+		ASSERT_TRUE (importer.run (path));
+	}
+	// A truncated file is missing its totals
+	ASSERT_FALSE (exporter.run (path));
+	boost::filesystem::resize_file (path, size - 1);
+	{
+		auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+		vxldollar::ledger_import importer (*store, vxldollar::dev::network_params, 2);
+		ASSERT_TRUE (importer.run (path));
+	}
+	// Only an empty ledger can be imported into
+	ASSERT_FALSE (exporter.run (path));
+	vxldollar::ledger_import importer (node.store, node.network_params, 2);
+	ASSERT_TRUE (importer.run (path));
+}
+
+// Chunks loaded before an error are removed, so the import can be retried with a good snapshot
+TEST (ledger_snapshot, import_retry)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	vxldollar::keypair key;
+	std::vector<std::shared_ptr<vxldollar::block>> blocks;
+	setup_ledger (node, key, blocks);
+	auto path (vxldollar::unique_path ());
+	// One record per chunk, all of them are loaded before the missing totals are noticed
+	vxldollar::ledger_export exporter (node.store, node.network_params, 1);
+	ASSERT_FALSE (exporter.run (path));
+	auto size (boost::filesystem::file_size (path));
+	boost::filesystem::resize_file (path, size - 1);
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store->init_error ());
+	{
+		vxldollar::ledger_cache ledger_cache;
+		store->initialize (store->tx_begin_write (), ledger_cache);
+	}
+	{
+		vxldollar::ledger_import importer (*store, vxldollar::dev::network_params, 2);
+		ASSERT_TRUE (importer.run (path));
+		ASSERT_EQ (0, importer.blocks);
+	}
+	{
+		auto transaction (store->tx_begin_read ());
+		ASSERT_EQ (1, store->block.count (transaction));
+		ASSERT_TRUE (store->block.exists (transaction, vxldollar::dev::genesis->hash ()));
+		ASSERT_EQ (1, store->account.count (transaction));
+		ASSERT_EQ (1, store->confirmation_height.count (transaction));
+		ASSERT_EQ (store->pending.end (), store->pending.begin (transaction));
+		ASSERT_EQ (vxldollar::dev::genesis_key.pub, store->frontier.get (transaction, vxldollar::dev::genesis->hash ()));
+		ASSERT_EQ (nullptr, store->block.get (transaction, blocks[0]->hash ()));
+	}
+	ASSERT_FALSE (exporter.run (path));
+	vxldollar::ledger_import importer (*store, vxldollar::dev::network_params, 2);
+	ASSERT_FALSE (importer.run (path));
+	ASSERT_EQ (exporter.blocks, importer.blocks);
+	auto transaction (store->tx_begin_read ());
+	ASSERT_EQ (4, store->block.count (transaction));
+	ASSERT_TRUE (store->pending.exists (transaction, vxldollar::pending_key (key.pub, blocks[2]->hash ())));
+}
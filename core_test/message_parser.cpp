@@ -224,3 +224,45 @@ TEST (message_parser, exact_keepalive_size)
 	ASSERT_EQ (1, visitor.keepalive_count);
 	ASSERT_NE (parser.status, vxldollar::message_parser::parse_status::success);
 }
+
+TEST (message_parser, duplicate_confirm_ack)
+{
+	vxldollar::system system (1);
+	dev_visitor visitor;
+	vxldollar::network_filter filter (1);
+	vxldollar::network_filter vote_filter (vxldollar::network_filter::bucket_ways);
+	vxldollar::block_uniquer block_uniquer;
+	vxldollar::vote_uniquer vote_uniquer (block_uniquer);
+	vxldollar::message_parser parser (filter, block_uniquer, vote_uniquer, visitor, system.work, vxldollar::dev::network_params.network, &vote_filter);
+	auto vote (std::make_shared<vxldollar::vote> (vxldollar::dev::genesis_key.pub, vxldollar::dev::genesis_key.prv, 0, 0, std::vector<vxldollar::block_hash>{ vxldollar::dev::genesis->hash () }));
+	vxldollar::confirm_ack message{ vxldollar::dev::network_params.network, vote };
+	auto bytes (message.to_bytes ());
+	parser.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser.status, vxldollar::message_parser::parse_status::success);
+	ASSERT_EQ (1, visitor.confirm_ack_count);
+	parser.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser.status, vxldollar::message_parser::parse_status::duplicate_confirm_ack_message);
+	ASSERT_EQ (1, visitor.confirm_ack_count);
+}
+
+TEST (message_parser, duplicate_confirm_req_salted)
+{
+	vxldollar::system system (1);
+	dev_visitor visitor;
+	vxldollar::network_filter filter (1);
+	vxldollar::network_filter confirm_req_filter (vxldollar::network_filter::bucket_ways);
+	vxldollar::block_uniquer block_uniquer;
+	vxldollar::vote_uniquer vote_uniquer (block_uniquer);
+	vxldollar::message_parser parser1 (filter, block_uniquer, vote_uniquer, visitor, system.work, vxldollar::dev::network_params.network, nullptr, &confirm_req_filter, 1);
+	vxldollar::message_parser parser2 (filter, block_uniquer, vote_uniquer, visitor, system.work, vxldollar::dev::network_params.network, nullptr, &confirm_req_filter, 2);
+	vxldollar::confirm_req message{ vxldollar::dev::network_params.network, vxldollar::dev::genesis->hash (), vxldollar::dev::genesis->root () };
+	auto bytes (message.to_bytes ());
+	parser1.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser1.status, vxldollar::message_parser::parse_status::success);
+	parser1.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser1.status, vxldollar::message_parser::parse_status::duplicate_confirm_req_message);
+	// The same request from another sender is not a duplicate
+	parser2.deserialize_buffer (bytes->data (), bytes->size ());
+	ASSERT_EQ (parser2.status, vxldollar::message_parser::parse_status::success);
+	ASSERT_EQ (2, visitor.confirm_req_count);
+}
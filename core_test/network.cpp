@@ -1015,6 +1015,29 @@ TEST (network, duplicate_revert_publish)
 	ASSERT_FALSE (node.network.publish_filter.apply (bytes.data (), bytes.size ()));
 }
 
+// Votes dropped before processing, here for being from another network, do not keep their digest in the vote filter
+TEST (network, duplicate_revert_dropped_vote)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	auto vote (std::make_shared<vxldollar::vote> (vxldollar::dev::genesis_key.pub, vxldollar::dev::genesis_key.prv, 0, 0, std::vector<vxldollar::block_hash>{ vxldollar::dev::genesis->hash () }));
+	vxldollar::confirm_ack message{ vxldollar::dev::network_params.network, vote };
+	std::vector<uint8_t> bytes;
+	{
+		vxldollar::vectorstream stream (bytes);
+		vote->serialize (stream);
+	}
+	vxldollar::uint128_t digest;
+	ASSERT_FALSE (node.network.vote_filter.apply (bytes.data (), bytes.size (), &digest));
+	ASSERT_TRUE (node.network.vote_filter.apply (bytes.data (), bytes.size ()));
+	message.digest = digest;
+	message.header.network = vxldollar::networks::vxldollar_live_network;
+	auto channel (std::make_shared<vxldollar::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.network.protocol_version));
+	node.network.inbound (message, channel);
+	ASSERT_EQ (1, node.stats.count (vxldollar::stat::type::message, vxldollar::stat::detail::invalid_network));
+	ASSERT_FALSE (node.network.vote_filter.apply (bytes.data (), bytes.size ()));
+}
+
 // The test must be completed in less than 1 second
 TEST (network, bandwidth_limiter)
 {
@@ -1291,3 +1314,65 @@ TEST (network, fill_keepalive_self)
 	system.nodes[0]->network.fill_keepalive_self (target);
 	ASSERT_TRUE (target[2].port () == system.nodes[1]->network.port);
 }
+
+TEST (network, channel_health)
+{
+	vxldollar::transport::channel_health health;
+	ASSERT_EQ (0, health.rtt ().count ());
+	ASSERT_EQ (1.0, health.score ());
+	health.rtt_sample (std::chrono::milliseconds (100));
+	ASSERT_EQ (std::chrono::milliseconds (100), health.rtt ());
+	auto const rtt_score (health.score ());
+	ASSERT_LT (rtt_score, 1.0);
+	// Smoothed towards new samples
+	health.rtt_sample (std::chrono::milliseconds (900));
+	ASSERT_GT (health.rtt (), std::chrono::milliseconds (100));
+	ASSERT_LT (health.rtt (), std::chrono::milliseconds (900));
+	ASSERT_LT (health.score (), rtt_score);
+	for (auto i (0); i < 200; ++i)
+	{
+		health.queue_sample (1.0);
+		health.send_sample (true);
+	}
+	ASSERT_GT (health.queue_occupancy (), 0.9);
+	ASSERT_GT (health.drop_rate (), 0.9);
+	ASSERT_EQ (vxldollar::transport::channel_health::min_score, health.score ());
+}
+
+// Flooding targets should mostly be healthy peers, while degraded peers are still picked sometimes
+TEST (network, select_by_health)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	std::unordered_set<std::shared_ptr<vxldollar::transport::channel>> degraded;
+	for (uint16_t i (0); i < 64; ++i)
+	{
+		auto channel (node.network.udp_channels.insert (vxldollar::endpoint (boost::asio::ip::address_v6::loopback (), 10000 + i), node.network_params.network.protocol_version));
+		ASSERT_NE (nullptr, channel);
+		if (i % 2 == 0)
+		{
+			for (auto j (0); j < 100; ++j)
+			{
+				channel->health->send_sample (true);
+			}
+			degraded.insert (channel);
+		}
+	}
+	ASSERT_EQ (64, node.network.list (128).size ());
+	size_t degraded_count (0);
+	size_t healthy_count (0);
+	for (auto i (0); i < 1000; ++i)
+	{
+		auto list (node.network.list (8));
+		ASSERT_EQ (8, list.size ());
+		ASSERT_EQ (8, std::unordered_set<std::shared_ptr<vxldollar::transport::channel>> (list.begin (), list.end ()).size ());
+		for (auto const & channel : list)
+		{
+			++(degraded.count (channel) ? degraded_count : healthy_count);
+		}
+	}
+	ASSERT_GT (degraded_count, 0);
+	ASSERT_GT (healthy_count, 5 * degraded_count);
+	// Background flooding may also select degraded peers
+	ASSERT_LE (degraded_count, node.stats.count (vxldollar::stat::type::peering, vxldollar::stat::detail::selected_degraded, vxldollar::stat::dir::out));
+}
@@ -2108,6 +2108,35 @@ TEST (node, stat_histogram)
 	ASSERT_EQ (histogram_ack_out->get_bins ()[1].value, 1);
 }
 
+TEST (node, stat_latency)
+{
+	vxldollar::stat stats;
+	ASSERT_EQ (nullptr, stats.get_latency (vxldollar::stat::detail::bulk_pull, vxldollar::stat::latency_stage::queue));
+	stats.update_latency (vxldollar::stat::detail::bulk_pull, vxldollar::stat::latency_stage::queue, std::chrono::microseconds (1));
+	stats.update_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::queue, std::chrono::microseconds (0));
+	stats.update_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::queue, std::chrono::microseconds (5));
+	stats.update_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::queue, std::chrono::microseconds (7));
+	stats.update_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::queue, std::chrono::hours (24));
+	auto histogram (stats.get_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::queue));
+	ASSERT_NE (nullptr, histogram);
+	ASSERT_EQ (4, histogram->count ());
+	auto bins (histogram->get_bins ());
+	ASSERT_EQ (vxldollar::stat_log_histogram::bin_count, bins.size ());
+	ASSERT_EQ (1, bins[0].value);
+	// 5 and 7 fall into [4, 8)
+	ASSERT_EQ (4, bins[3].start_inclusive);
+	ASSERT_EQ (8, bins[3].end_exclusive);
+	ASSERT_EQ (2, bins[3].value);
+	// Clamped into the last bin
+	ASSERT_EQ (1, bins.back ().value);
+	// Other stages and message types are unaffected
+	ASSERT_EQ (0, stats.get_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::handle)->count ());
+	ASSERT_EQ (0, stats.get_latency (vxldollar::stat::detail::confirm_ack, vxldollar::stat::latency_stage::queue)->count ());
+	stats.clear_latencies ();
+	ASSERT_EQ (0, histogram->count ());
+	ASSERT_EQ (0, histogram->total ());
+}
+
 TEST (node, online_reps)
 {
 	vxldollar::system system (1);
@@ -4288,6 +4317,41 @@ TEST (rep_crawler, recently_confirmed)
 
 namespace vxldollar
 {
+// Votes from a queried peer skip the duplicate filter until the query expires
+TEST (rep_crawler, queried_unfiltered)
+{
+	vxldollar::system system;
+	vxldollar::node_flags flags;
+	flags.disable_rep_crawler = true;
+	auto & node1 (*system.add_node (flags));
+	auto & node2 (*system.add_node (flags));
+	auto channel (node1.network.find_channel (node2.network.endpoint ()));
+	ASSERT_NE (nullptr, channel);
+	auto const address (channel->get_endpoint ().address ());
+	ASSERT_FALSE (node1.rep_crawler.is_queried (address));
+	node1.rep_crawler.query (channel);
+	ASSERT_TRUE (node1.rep_crawler.is_queried (address));
+	auto vote (std::make_shared<vxldollar::vote> (vxldollar::dev::genesis_key.pub, vxldollar::dev::genesis_key.prv, 0, 0, std::vector{ vxldollar::dev::genesis->hash () }));
+	vxldollar::confirm_ack message{ vxldollar::dev::network_params.network, vote };
+	auto const filtered (node1.stats.count (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_confirm_ack));
+	for (auto i (0); i < 2; ++i)
+	{
+		node2.network.find_channel (node1.network.endpoint ())->send (message);
+	}
+	ASSERT_TIMELY (5s, node1.stats.count (vxldollar::stat::type::message, vxldollar::stat::detail::confirm_ack, vxldollar::stat::dir::in) >= 2);
+	ASSERT_EQ (filtered, node1.stats.count (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_confirm_ack));
+	std::vector<vxldollar::block_hash> active;
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (node1.rep_crawler.active_mutex);
+		active.assign (node1.rep_crawler.active.begin (), node1.rep_crawler.active.end ());
+	}
+	for (auto const & hash : active)
+	{
+		node1.rep_crawler.remove (hash);
+	}
+	ASSERT_FALSE (node1.rep_crawler.is_queried (address));
+}
+
 TEST (rep_crawler, local)
 {
 	vxldollar::system system;
@@ -4485,3 +4549,137 @@ TEST (node, pruning_depth)
 	ASSERT_TRUE (node1.ledger.block_or_pruned_exists (send1->hash ()));
 	ASSERT_TRUE (node1.ledger.block_or_pruned_exists (send2->hash ()));
 }
+
+// Targets of accounts spread over several ranges are collected in parallel and pruned in sorted batches
+TEST (node, pruning_parallel)
+{
+	vxldollar::system system{};
+
+	vxldollar::node_config node_config{ vxldollar::get_available_port (), system.logging };
+	// TODO: remove after allowing pruned voting
+	node_config.enable_voting = false;
+	node_config.max_pruning_depth = 1;
+	node_config.pruning_threads = 4;
+	node_config.pruning_write_share = 0.5;
+
+	vxldollar::node_flags node_flags{};
+	node_flags.enable_pruning = true;
+
+	auto & node1 = *system.add_node (node_config, node_flags);
+	vxldollar::keypair key1{};
+	vxldollar::keypair key2{};
+	vxldollar::state_block_builder builder{};
+	auto send1 = builder.make_block ()
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (vxldollar::dev::genesis->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio)
+				 .link (key1.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*system.work.generate (vxldollar::dev::genesis->hash ()))
+				 .build_shared ();
+	auto send2 = builder.make_block ()
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (send1->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - 2 * vxldollar::Gxrb_ratio)
+				 .link (key2.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*system.work.generate (send1->hash ()))
+				 .build_shared ();
+	auto open1 = builder.make_block ()
+				 .account (key1.pub)
+				 .previous (0)
+				 .representative (key1.pub)
+				 .balance (vxldollar::Gxrb_ratio)
+				 .link (send1->hash ())
+				 .sign (key1.prv, key1.pub)
+				 .work (*system.work.generate (key1.pub))
+				 .build_shared ();
+	auto send3 = builder.make_block ()
+				 .account (key1.pub)
+				 .previous (open1->hash ())
+				 .representative (key1.pub)
+				 .balance (0)
+				 .link (key2.pub)
+				 .sign (key1.prv, key1.pub)
+				 .work (*system.work.generate (open1->hash ()))
+				 .build_shared ();
+	auto open2 = builder.make_block ()
+				 .account (key2.pub)
+				 .previous (0)
+				 .representative (key2.pub)
+				 .balance (vxldollar::Gxrb_ratio)
+				 .link (send2->hash ())
+				 .sign (key2.prv, key2.pub)
+				 .work (*system.work.generate (key2.pub))
+				 .build_shared ();
+	for (auto const & block : { send1, send2, open1, send3, open2 })
+	{
+		ASSERT_EQ (vxldollar::process_result::progress, node1.process (*block).code);
+	}
+
+	// Force-confirm the frontiers, which confirms every block below them
+	for (auto const & block : { send2, send3, open2 })
+	{
+		node1.process_confirmed (vxldollar::election_status{ block });
+		ASSERT_TIMELY (5s, node1.block_confirmed (block->hash ()));
+	}
+	ASSERT_EQ (6, node1.ledger.cache.block_count);
+
+	// The blocks below the frontiers of the genesis and key1 chains are pruned, the genesis block is kept
+	node1.ledger_pruning (1, true, false);
+	ASSERT_EQ (2, node1.ledger.cache.pruned_count);
+	ASSERT_EQ (2, node1.stats.count (vxldollar::stat::type::pruning, vxldollar::stat::detail::pruned));
+	ASSERT_TRUE (node1.store.pruned.exists (node1.store.tx_begin_read (), send1->hash ()));
+	ASSERT_TRUE (node1.store.pruned.exists (node1.store.tx_begin_read (), open1->hash ()));
+	ASSERT_TRUE (node1.store.block.exists (node1.store.tx_begin_read (), vxldollar::dev::genesis->hash ()));
+	for (auto const & block : { send1, send2, open1, send3, open2 })
+	{
+		ASSERT_TRUE (node1.ledger.block_or_pruned_exists (block->hash ()));
+	}
+
+	// Nothing is left to prune
+	node1.ledger_pruning (1, true, false);
+	ASSERT_EQ (2, node1.ledger.cache.pruned_count);
+}
+
+TEST (write_database_queue, group_commit)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store->init_error ());
+	vxldollar::stat stats;
+	std::atomic<unsigned> syncs{ 0 };
+	vxldollar::write_database_queue queue (false, [&store, &syncs] () { ++syncs; store->sync (); }, stats);
+	auto const count = 50;
+	std::vector<vxldollar::writer> writers{ vxldollar::writer::confirmation_height, vxldollar::writer::process_batch, vxldollar::writer::pruning };
+	std::vector<std::thread> threads;
+	for (auto i (0); i < writers.size (); ++i)
+	{
+		threads.emplace_back ([&store, &queue, writer = writers[i], i, count] () {
+			for (auto j (0); j < count; ++j)
+			{
+				auto guard (queue.wait (writer));
+				ASSERT_TRUE (vxldollar::deferred_sync::is_set ());
+				{
+					auto transaction (store->tx_begin_write ());
+					store->online_weight.put (transaction, i * count + j, vxldollar::amount (j));
+				}
+				guard.release ();
+				ASSERT_FALSE (vxldollar::deferred_sync::is_set ());
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	ASSERT_EQ (writers.size () * count, store->online_weight.count (store->tx_begin_read ()));
+	ASSERT_EQ (count, stats.count (vxldollar::stat::type::write_queue, vxldollar::stat::detail::writer_confirmation_height));
+	ASSERT_EQ (count, stats.count (vxldollar::stat::type::write_queue, vxldollar::stat::detail::writer_process_batch));
+	ASSERT_EQ (count, stats.count (vxldollar::stat::type::write_queue, vxldollar::stat::detail::writer_pruning));
+	ASSERT_EQ (syncs.load (), stats.count (vxldollar::stat::type::write_queue, vxldollar::stat::detail::group_sync));
+	ASSERT_GE (syncs.load (), 1);
+	ASSERT_LE (syncs.load (), writers.size () * count);
+}
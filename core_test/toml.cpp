@@ -147,16 +147,21 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.rpc.child_process.enable, defaults.rpc.child_process.enable);
 	ASSERT_EQ (conf.rpc.child_process.rpc_path, defaults.rpc.child_process.rpc_path);
 
+	ASSERT_EQ (conf.node.account_height_index, defaults.node.account_height_index);
 	ASSERT_EQ (conf.node.active_elections_size, defaults.node.active_elections_size);
 	ASSERT_EQ (conf.node.allow_local_peers, defaults.node.allow_local_peers);
 	ASSERT_EQ (conf.node.backup_before_upgrade, defaults.node.backup_before_upgrade);
 	ASSERT_EQ (conf.node.bandwidth_limit, defaults.node.bandwidth_limit);
 	ASSERT_EQ (conf.node.bandwidth_limit_burst_ratio, defaults.node.bandwidth_limit_burst_ratio);
+	ASSERT_EQ (conf.node.block_filter_false_positive_rate, defaults.node.block_filter_false_positive_rate);
+	ASSERT_EQ (conf.node.block_filter_memory_limit, defaults.node.block_filter_memory_limit);
 	ASSERT_EQ (conf.node.block_processor_batch_max_time, defaults.node.block_processor_batch_max_time);
 	ASSERT_EQ (conf.node.bootstrap_connections, defaults.node.bootstrap_connections);
 	ASSERT_EQ (conf.node.bootstrap_connections_max, defaults.node.bootstrap_connections_max);
 	ASSERT_EQ (conf.node.bootstrap_initiator_threads, defaults.node.bootstrap_initiator_threads);
 	ASSERT_EQ (conf.node.bootstrap_frontier_request_count, defaults.node.bootstrap_frontier_request_count);
+	ASSERT_EQ (conf.node.bootstrap_frontier_ranges, defaults.node.bootstrap_frontier_ranges);
+	ASSERT_EQ (conf.node.bootstrap_lazy_memory_limit, defaults.node.bootstrap_lazy_memory_limit);
 	ASSERT_EQ (conf.node.bootstrap_fraction_numerator, defaults.node.bootstrap_fraction_numerator);
 	ASSERT_EQ (conf.node.conf_height_processor_batch_min_time, defaults.node.conf_height_processor_batch_min_time);
 	ASSERT_EQ (conf.node.confirmation_history_size, defaults.node.confirmation_history_size);
@@ -180,6 +185,7 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.tcp_incoming_connections_max, defaults.node.tcp_incoming_connections_max);
 	ASSERT_EQ (conf.node.tcp_io_timeout, defaults.node.tcp_io_timeout);
 	ASSERT_EQ (conf.node.unchecked_cutoff_time, defaults.node.unchecked_cutoff_time);
+	ASSERT_EQ (conf.node.unchecked_memory_limit, defaults.node.unchecked_memory_limit);
 	ASSERT_EQ (conf.node.use_memory_pools, defaults.node.use_memory_pools);
 	ASSERT_EQ (conf.node.vote_generator_delay, defaults.node.vote_generator_delay);
 	ASSERT_EQ (conf.node.vote_generator_threshold, defaults.node.vote_generator_threshold);
@@ -238,6 +244,8 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.ipc_config.flatbuffers.skip_unexpected_fields_in_json, defaults.node.ipc_config.flatbuffers.skip_unexpected_fields_in_json);
 	ASSERT_EQ (conf.node.ipc_config.flatbuffers.verify_buffers, defaults.node.ipc_config.flatbuffers.verify_buffers);
 
+	ASSERT_EQ (conf.node.diagnostics_config.store_instrumentation.enable, defaults.node.diagnostics_config.store_instrumentation.enable);
+	ASSERT_EQ (conf.node.diagnostics_config.store_instrumentation.sample_interval, defaults.node.diagnostics_config.store_instrumentation.sample_interval);
 	ASSERT_EQ (conf.node.diagnostics_config.txn_tracking.enable, defaults.node.diagnostics_config.txn_tracking.enable);
 	ASSERT_EQ (conf.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time, defaults.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time);
 	ASSERT_EQ (conf.node.diagnostics_config.txn_tracking.min_read_txn_time, defaults.node.diagnostics_config.txn_tracking.min_read_txn_time);
@@ -254,11 +262,16 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.stat_config.log_samples_filename, defaults.node.stat_config.log_samples_filename);
 
 	ASSERT_EQ (conf.node.lmdb_config.sync, defaults.node.lmdb_config.sync);
+	ASSERT_EQ (conf.node.lmdb_config.group_commit, defaults.node.lmdb_config.group_commit);
 	ASSERT_EQ (conf.node.lmdb_config.max_databases, defaults.node.lmdb_config.max_databases);
 	ASSERT_EQ (conf.node.lmdb_config.map_size, defaults.node.lmdb_config.map_size);
 
 	ASSERT_EQ (conf.node.rocksdb_config.enable, defaults.node.rocksdb_config.enable);
 	ASSERT_EQ (conf.node.rocksdb_config.memory_multiplier, defaults.node.rocksdb_config.memory_multiplier);
+	ASSERT_EQ (conf.node.rocksdb_config.memory_budget, defaults.node.rocksdb_config.memory_budget);
+	ASSERT_EQ (conf.node.rocksdb_config.compression, defaults.node.rocksdb_config.compression);
+	ASSERT_EQ (conf.node.rocksdb_config.bottommost_compression, defaults.node.rocksdb_config.bottommost_compression);
+	ASSERT_EQ (conf.node.rocksdb_config.dictionary_bytes, defaults.node.rocksdb_config.dictionary_bytes);
 	ASSERT_EQ (conf.node.rocksdb_config.io_threads, defaults.node.rocksdb_config.io_threads);
 }
 
@@ -389,16 +402,21 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 
 	ss << R"toml(
 	[node]
+	account_height_index = true
 	active_elections_size = 999
 	allow_local_peers = false
 	backup_before_upgrade = true
 	bandwidth_limit = 999
 	bandwidth_limit_burst_ratio = 999.9
+	block_filter_false_positive_rate = 0.05
+	block_filter_memory_limit = 999
 	block_processor_batch_max_time = 999
 	bootstrap_connections = 999
 	bootstrap_connections_max = 999
 	bootstrap_initiator_threads = 999
 	bootstrap_frontier_request_count = 9999
+	bootstrap_frontier_ranges = 9
+	bootstrap_lazy_memory_limit = 999
 	bootstrap_fraction_numerator = 999
 	conf_height_processor_batch_min_time = 999
 	confirmation_history_size = 999
@@ -421,6 +439,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	tcp_incoming_connections_max = 999
 	tcp_io_timeout = 999
 	unchecked_cutoff_time = 999
+	unchecked_memory_limit = 999
 	use_memory_pools = false
 	vote_generator_delay = 999
 	vote_generator_threshold = 9
@@ -430,6 +449,9 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	max_work_generate_multiplier = 1.0
 	max_queued_requests = 999
 	frontiers_confirmation = "always"
+	[node.diagnostics.store_instrumentation]
+	enable = true
+	sample_interval = 999
 	[node.diagnostics.txn_tracking]
 	enable = true
 	ignore_writes_below_block_processor_max_time = false
@@ -508,18 +530,25 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 
 	[node.lmdb]
 	sync = "nosync_safe"
+	group_commit = true
 	max_databases = 999
 	map_size = 999
 
 	[node.rocksdb]
 	enable = true
 	memory_multiplier = 3
+	memory_budget = 999
+	compression = "lz4"
+	bottommost_compression = "zstd"
+	dictionary_bytes = 999
 	io_threads = 99
 
 	[node.experimental]
 	secondary_work_peers = ["dev.org:998"]
 	max_pruning_age = 999
 	max_pruning_depth = 999
+	pruning_threads = 57
+	pruning_write_share = 0.25
 
 	[opencl]
 	device = 999
@@ -553,16 +582,21 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.rpc.child_process.enable, defaults.rpc.child_process.enable);
 	ASSERT_NE (conf.rpc.child_process.rpc_path, defaults.rpc.child_process.rpc_path);
 
+	ASSERT_NE (conf.node.account_height_index, defaults.node.account_height_index);
 	ASSERT_NE (conf.node.active_elections_size, defaults.node.active_elections_size);
 	ASSERT_NE (conf.node.allow_local_peers, defaults.node.allow_local_peers);
 	ASSERT_NE (conf.node.backup_before_upgrade, defaults.node.backup_before_upgrade);
 	ASSERT_NE (conf.node.bandwidth_limit, defaults.node.bandwidth_limit);
 	ASSERT_NE (conf.node.bandwidth_limit_burst_ratio, defaults.node.bandwidth_limit_burst_ratio);
+	ASSERT_NE (conf.node.block_filter_false_positive_rate, defaults.node.block_filter_false_positive_rate);
+	ASSERT_NE (conf.node.block_filter_memory_limit, defaults.node.block_filter_memory_limit);
 	ASSERT_NE (conf.node.block_processor_batch_max_time, defaults.node.block_processor_batch_max_time);
 	ASSERT_NE (conf.node.bootstrap_connections, defaults.node.bootstrap_connections);
 	ASSERT_NE (conf.node.bootstrap_connections_max, defaults.node.bootstrap_connections_max);
 	ASSERT_NE (conf.node.bootstrap_initiator_threads, defaults.node.bootstrap_initiator_threads);
 	ASSERT_NE (conf.node.bootstrap_frontier_request_count, defaults.node.bootstrap_frontier_request_count);
+	ASSERT_NE (conf.node.bootstrap_frontier_ranges, defaults.node.bootstrap_frontier_ranges);
+	ASSERT_NE (conf.node.bootstrap_lazy_memory_limit, defaults.node.bootstrap_lazy_memory_limit);
 	ASSERT_NE (conf.node.bootstrap_fraction_numerator, defaults.node.bootstrap_fraction_numerator);
 	ASSERT_NE (conf.node.conf_height_processor_batch_min_time, defaults.node.conf_height_processor_batch_min_time);
 	ASSERT_NE (conf.node.confirmation_history_size, defaults.node.confirmation_history_size);
@@ -576,6 +610,8 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.secondary_work_peers, defaults.node.secondary_work_peers);
 	ASSERT_NE (conf.node.max_pruning_age, defaults.node.max_pruning_age);
 	ASSERT_NE (conf.node.max_pruning_depth, defaults.node.max_pruning_depth);
+	ASSERT_NE (conf.node.pruning_threads, defaults.node.pruning_threads);
+	ASSERT_NE (conf.node.pruning_write_share, defaults.node.pruning_write_share);
 	ASSERT_NE (conf.node.online_weight_minimum, defaults.node.online_weight_minimum);
 	ASSERT_NE (conf.node.rep_crawler_weight_minimum, defaults.node.rep_crawler_weight_minimum);
 	ASSERT_NE (conf.node.election_hint_weight_percent, defaults.node.election_hint_weight_percent);
@@ -589,6 +625,7 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.tcp_incoming_connections_max, defaults.node.tcp_incoming_connections_max);
 	ASSERT_NE (conf.node.tcp_io_timeout, defaults.node.tcp_io_timeout);
 	ASSERT_NE (conf.node.unchecked_cutoff_time, defaults.node.unchecked_cutoff_time);
+	ASSERT_NE (conf.node.unchecked_memory_limit, defaults.node.unchecked_memory_limit);
 	ASSERT_NE (conf.node.use_memory_pools, defaults.node.use_memory_pools);
 	ASSERT_NE (conf.node.vote_generator_delay, defaults.node.vote_generator_delay);
 	ASSERT_NE (conf.node.vote_generator_threshold, defaults.node.vote_generator_threshold);
@@ -647,6 +684,8 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.ipc_config.flatbuffers.skip_unexpected_fields_in_json, defaults.node.ipc_config.flatbuffers.skip_unexpected_fields_in_json);
 	ASSERT_NE (conf.node.ipc_config.flatbuffers.verify_buffers, defaults.node.ipc_config.flatbuffers.verify_buffers);
 
+	ASSERT_NE (conf.node.diagnostics_config.store_instrumentation.enable, defaults.node.diagnostics_config.store_instrumentation.enable);
+	ASSERT_NE (conf.node.diagnostics_config.store_instrumentation.sample_interval, defaults.node.diagnostics_config.store_instrumentation.sample_interval);
 	ASSERT_NE (conf.node.diagnostics_config.txn_tracking.enable, defaults.node.diagnostics_config.txn_tracking.enable);
 	ASSERT_NE (conf.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time, defaults.node.diagnostics_config.txn_tracking.ignore_writes_below_block_processor_max_time);
 	ASSERT_NE (conf.node.diagnostics_config.txn_tracking.min_read_txn_time, defaults.node.diagnostics_config.txn_tracking.min_read_txn_time);
@@ -663,12 +702,17 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.stat_config.log_samples_filename, defaults.node.stat_config.log_samples_filename);
 
 	ASSERT_NE (conf.node.lmdb_config.sync, defaults.node.lmdb_config.sync);
+	ASSERT_NE (conf.node.lmdb_config.group_commit, defaults.node.lmdb_config.group_commit);
 	ASSERT_NE (conf.node.lmdb_config.max_databases, defaults.node.lmdb_config.max_databases);
 	ASSERT_NE (conf.node.lmdb_config.map_size, defaults.node.lmdb_config.map_size);
 
 	ASSERT_TRUE (conf.node.rocksdb_config.enable);
 	ASSERT_EQ (vxldollar::rocksdb_config::using_rocksdb_in_tests (), defaults.node.rocksdb_config.enable);
 	ASSERT_NE (conf.node.rocksdb_config.memory_multiplier, defaults.node.rocksdb_config.memory_multiplier);
+	ASSERT_NE (conf.node.rocksdb_config.memory_budget, defaults.node.rocksdb_config.memory_budget);
+	ASSERT_NE (conf.node.rocksdb_config.compression, defaults.node.rocksdb_config.compression);
+	ASSERT_NE (conf.node.rocksdb_config.bottommost_compression, defaults.node.rocksdb_config.bottommost_compression);
+	ASSERT_NE (conf.node.rocksdb_config.dictionary_bytes, defaults.node.rocksdb_config.dictionary_bytes);
 	ASSERT_NE (conf.node.rocksdb_config.io_threads, defaults.node.rocksdb_config.io_threads);
 }
 
@@ -861,6 +905,21 @@ TEST (toml, daemon_config_deserialize_errors)
 
 		ASSERT_EQ (toml.get_error ().get_message (), "bootstrap_frontier_request_count must be greater than or equal to 1024");
 	}
+
+	{
+		std::stringstream ss;
+		ss << R"toml(
+		[node]
+		bootstrap_frontier_ranges = 0
+		)toml";
+
+		vxldollar::tomlconfig toml;
+		toml.read (ss);
+		vxldollar::daemon_config conf;
+		conf.deserialize_toml (toml);
+
+		ASSERT_EQ (toml.get_error ().get_message (), "bootstrap_frontier_ranges must be between 1 and 64");
+	}
 }
 
 TEST (toml, daemon_read_config)
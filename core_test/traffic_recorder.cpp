@@ -0,0 +1,109 @@
+#include <vxldollar/node/traffic_recorder.hpp>
+#include <vxldollar/test_common/system.hpp>
+#include <vxldollar/test_common/testutil.hpp>
+
+#include <gtest/gtest.h>
+
+#include <boost/endian/conversion.hpp>
+
+#include <fstream>
+
+using namespace std::chrono_literals;
+
+TEST (traffic_recorder, record_replay)
+{
+	vxldollar::system system;
+	auto path (vxldollar::unique_path ());
+	vxldollar::node_flags node_flags;
+	node_flags.record_traffic_path = path.string ();
+	auto & node1 (*system.add_node (node_flags));
+	auto & node2 (*system.add_node ());
+	ASSERT_NE (nullptr, node1.network.recorder);
+	ASSERT_FALSE (node1.network.recorder->error);
+	vxldollar::keypair key;
+	vxldollar::block_builder builder;
+	auto send = builder
+				.send ()
+				.previous (vxldollar::dev::genesis->hash ())
+				.destination (key.pub)
+				.balance (vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio)
+				.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				.work (*system.work.generate (vxldollar::dev::genesis->hash ()))
+				.build_shared ();
+	node2.process_active (send);
+	ASSERT_TIMELY (10s, node1.block (send->hash ()) != nullptr);
+	node1.network.recorder->flush ();
+	ASSERT_NE (0, node1.network.recorder->recorded);
+
+	// Replay into a node which is not connected to anyone
+	auto node3 (std::make_shared<vxldollar::node> (system.io_ctx, vxldollar::get_available_port (), vxldollar::unique_path (), system.logging, system.work));
+	ASSERT_FALSE (node3->init_error ());
+	vxldollar::traffic_replay replay (*node3, path);
+	ASSERT_FALSE (replay.run (0));
+	ASSERT_NE (0, replay.messages);
+	ASSERT_TIMELY (10s, node3->block (send->hash ()) != nullptr);
+	node3->stop ();
+}
+
+// Messages are replayed with the spacing of the capture, measured from its first message rather than from the start of recording
+TEST (traffic_recorder, replay_offset)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	auto path (vxldollar::unique_path ());
+	{
+		std::vector<uint8_t> bytes;
+		{
+			vxldollar::vectorstream stream (bytes);
+			vxldollar::write (stream, vxldollar::traffic_log::magic);
+			vxldollar::write (stream, vxldollar::traffic_log::version);
+			vxldollar::write (stream, boost::endian::native_to_big (static_cast<uint16_t> (node.network_params.network.current_network)));
+			vxldollar::write (stream, vxldollar::traffic_log::record_type::channel);
+			vxldollar::write (stream, boost::endian::native_to_big (uint32_t{ 0 }));
+			vxldollar::write (stream, vxldollar::transport::transport_type::tcp);
+			vxldollar::write (stream, boost::asio::ip::address_v6::loopback ().to_bytes ());
+			vxldollar::write (stream, boost::endian::native_to_big (uint16_t{ 7075 }));
+			vxldollar::write (stream, vxldollar::account{ 0 }.bytes);
+			std::vector<uint8_t> message;
+			{
+				vxldollar::vectorstream message_stream (message);
+				vxldollar::keepalive keepalive{ node.network_params.network };
+				keepalive.serialize (message_stream);
+			}
+			// A day into the recording, then 100 ms later
+			for (uint64_t timestamp : { 86400ull * 1000 * 1000, 86400ull * 1000 * 1000 + 100 * 1000 })
+			{
+				vxldollar::write (stream, vxldollar::traffic_log::record_type::message);
+				vxldollar::write (stream, boost::endian::native_to_big (uint32_t{ 0 }));
+				vxldollar::write (stream, boost::endian::native_to_big (timestamp));
+				vxldollar::write (stream, boost::endian::native_to_big (static_cast<uint32_t> (message.size ())));
+				vxldollar::write (stream, message);
+			}
+		}
+		std::ofstream file (path.string (), std::ios::binary);
+		file.write (reinterpret_cast<char const *> (bytes.data ()), bytes.size ());
+	}
+	vxldollar::traffic_replay replay (node, path);
+	auto const start (std::chrono::steady_clock::now ());
+	ASSERT_FALSE (replay.run (1.0));
+	auto const elapsed (std::chrono::steady_clock::now () - start);
+	ASSERT_EQ (2, replay.messages);
+	ASSERT_GE (elapsed, 100ms);
+	ASSERT_LT (elapsed, 10s);
+}
+
+TEST (traffic_recorder, replay_malformed)
+{
+	vxldollar::system system (1);
+	auto & node (*system.nodes[0]);
+	auto path (vxldollar::unique_path ());
+	vxldollar::traffic_replay missing (node, path);
+	ASSERT_TRUE (missing.run (0));
+	{
+		std::ofstream file (path.string (), std::ios::binary);
+		file << "not a traffic log";
+	}
+	vxldollar::traffic_replay malformed (node, path);
+	ASSERT_TRUE (malformed.run (0));
+	ASSERT_EQ (0, malformed.messages);
+}
@@ -79,3 +79,73 @@ TEST (block_store, one_bootstrap)
 	++begin;
 	ASSERT_EQ (end, begin);
 }
+
+TEST (unchecked_map, memory_trigger)
+{
+	vxldollar::system system{};
+	vxldollar::logger_mt logger{};
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	vxldollar::unchecked_map unchecked{ *store, false, 1024 * 1024 };
+	ASSERT_TRUE (unchecked.memory);
+	std::atomic<int> satisfied{ 0 };
+	unchecked.satisfied = [&satisfied] (vxldollar::unchecked_info const &) {
+		++satisfied;
+	};
+	auto block1 = block ();
+	auto block2 = std::make_shared<vxldollar::send_block> (block1->hash (), 1, 2, vxldollar::keypair ().prv, 4, 5);
+	unchecked.put (block1->previous (), vxldollar::unchecked_info{ block1, vxldollar::dev::genesis_key.pub });
+	unchecked.put (block1->previous (), vxldollar::unchecked_info{ block2 });
+	unchecked.put (block1->hash (), vxldollar::unchecked_info{ block2 });
+	auto transaction = store->tx_begin_read ();
+	// Entries are visible immediately, without waiting for a write to the unchecked table
+	ASSERT_EQ (3, unchecked.count (transaction));
+	ASSERT_EQ (2, unchecked.get (transaction, block1->previous ()).size ());
+	ASSERT_TRUE (unchecked.exists (transaction, vxldollar::unchecked_key{ block1->hash (), block2->hash () }));
+	auto [i, n] = unchecked.equal_range (transaction, block1->hash ());
+	ASSERT_NE (n, i);
+	ASSERT_EQ (block2->hash (), i->first.hash);
+	ASSERT_EQ (*block2, *i->second.block);
+	++i;
+	ASSERT_EQ (n, i);
+	ASSERT_GT (unchecked.memory_size (), 0);
+	unchecked.trigger (block1->previous ());
+	ASSERT_TIMELY (5s, satisfied == 2);
+	ASSERT_EQ (1, unchecked.count (transaction));
+	ASSERT_FALSE (unchecked.exists (transaction, vxldollar::unchecked_key{ block1->previous (), block1->hash () }));
+	unchecked.clear (store->tx_begin_write ());
+	ASSERT_EQ (0, unchecked.count (transaction));
+	ASSERT_EQ (0, unchecked.memory_size ());
+}
+
+TEST (unchecked_map, memory_evict_oldest)
+{
+	vxldollar::logger_mt logger{};
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	vxldollar::unchecked_map unchecked{ *store, false, 1 };
+	std::vector<std::shared_ptr<vxldollar::block>> blocks;
+	for (auto i (0); i < 3; ++i)
+	{
+		blocks.push_back (std::make_shared<vxldollar::send_block> (i + 1, 1, 2, vxldollar::keypair ().prv, 4, 5));
+	}
+	auto transaction = store->tx_begin_read ();
+	unchecked.put (blocks[0]->previous (), vxldollar::unchecked_info{ blocks[0] });
+	auto entry_size (unchecked.memory_size ());
+	ASSERT_GT (entry_size, 0);
+	// The newest entry is kept even if it alone exceeds the limit
+	ASSERT_EQ (1, unchecked.count (transaction));
+	unchecked.put (blocks[1]->previous (), vxldollar::unchecked_info{ blocks[1] });
+	ASSERT_EQ (1, unchecked.count (transaction));
+	ASSERT_EQ (1, unchecked.evicted.load ());
+	ASSERT_TRUE (unchecked.get (transaction, blocks[0]->previous ()).empty ());
+	ASSERT_EQ (1, unchecked.get (transaction, blocks[1]->previous ()).size ());
+
+	vxldollar::unchecked_map unchecked2{ *store, false, 2 * entry_size };
+	for (auto const & block : blocks)
+	{
+		unchecked2.put (block->previous (), vxldollar::unchecked_info{ block });
+	}
+	ASSERT_EQ (2, unchecked2.count (transaction));
+	ASSERT_EQ (1, unchecked2.evicted.load ());
+	ASSERT_FALSE (unchecked2.exists (transaction, vxldollar::unchecked_key{ blocks[0]->previous (), blocks[0]->hash () }));
+	ASSERT_TRUE (unchecked2.exists (transaction, vxldollar::unchecked_key{ blocks[2]->previous (), blocks[2]->hash () }));
+}
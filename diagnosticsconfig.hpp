@@ -18,6 +18,15 @@ public:
 	bool ignore_writes_below_block_processor_max_time{ true };
 };
 
+class store_instrumentation_config final
+{
+public:
+	/** If true, count store operations per table and time a sample of them from startup. Can also be toggled at runtime through RPC */
+	bool enable{ false };
+	/** One in this many operations on a table is timed */
+	unsigned sample_interval{ 64 };
+};
+
 /** Configuration options for diagnostics information */
 class diagnostics_config final
 {
@@ -26,5 +35,6 @@ public:
 	vxldollar::error deserialize_toml (vxldollar::tomlconfig &);
 
 	txn_tracking_config txn_tracking;
+	store_instrumentation_config store_instrumentation;
 };
 }
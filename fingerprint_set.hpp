@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vxldollar
+{
+/**
+ * Compact set of 64-bit fingerprints, e.g. block hashes folded with std::hash, using open addressing with linear probing.
+ * An element takes 8 bytes, about 11 bytes at the maximum load, instead of a heap node per element in std::unordered_set.
+ * Two keys with the same fingerprint are not told apart, the caller accepts the rare false positive.
+ * @note This class is not thread-safe
+ */
+class fingerprint_set final
+{
+public:
+	explicit fingerprint_set (std::size_t capacity_a = 0);
+	/** @return true if \p fingerprint_a was not in the set */
+	bool insert (uint64_t fingerprint_a);
+	/** @return true if \p fingerprint_a was in the set */
+	bool erase (uint64_t fingerprint_a);
+	bool contains (uint64_t fingerprint_a) const;
+	std::size_t size () const;
+	bool empty () const;
+	void clear ();
+	/** Bytes allocated for the table */
+	std::size_t memory_size () const;
+	template <typename FUNC>
+	void for_each (FUNC const & action_a) const
+	{
+		for (auto slot : slots)
+		{
+			if (slot != empty_slot)
+			{
+				action_a (slot == zero_fingerprint ? 0 : slot);
+			}
+		}
+	}
+
+	static std::size_t constexpr max_load_percent = 75;
+
+private:
+	/** Zero marks empty slots, a zero fingerprint is stored as zero_fingerprint, which is reserved */
+	static uint64_t constexpr empty_slot = 0;
+	static uint64_t constexpr zero_fingerprint = ~0ull;
+	static uint64_t encode (uint64_t fingerprint_a);
+	std::size_t index (uint64_t encoded_a) const;
+	void rehash (std::size_t slot_count_a);
+	std::vector<uint64_t> slots;
+	std::size_t count{ 0 };
+};
+}
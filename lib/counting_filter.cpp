@@ -0,0 +1,82 @@
+#include <vxldollar/lib/counting_filter.hpp>
+#include <vxldollar/lib/utility.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+uint8_t constexpr saturated = std::numeric_limits<uint8_t>::max ();
+
+std::size_t round_up_pow2 (std::size_t value_a)
+{
+	std::size_t result (1);
+	while (result < value_a)
+	{
+		result *= 2;
+	}
+	return result;
+}
+}
+
+vxldollar::counting_filter::counting_filter (std::size_t counters_a) :
+	counters (round_up_pow2 (std::max<std::size_t> (counters_a, 64)))
+{
+	clear ();
+}
+
+std::size_t vxldollar::counting_filter::index (uint64_t key_a, std::size_t i) const
+{
+	// Double hashing, the probe step is odd so the probes of a key land on distinct counters
+	auto const h1 (key_a * 0x9e3779b97f4a7c15ull);
+	auto const h2 (((key_a ^ (key_a >> 29)) * 0xbf58476d1ce4e5b9ull) | 1);
+	return static_cast<std::size_t> ((h1 + i * h2) >> 16) & (counters.size () - 1);
+}
+
+void vxldollar::counting_filter::insert (uint64_t key_a)
+{
+	for (std::size_t i (0); i < hash_count; ++i)
+	{
+		auto & counter (counters[index (key_a, i)]);
+		auto current (counter.load (std::memory_order_relaxed));
+		while (current != saturated && !counter.compare_exchange_weak (current, current + 1, std::memory_order_relaxed))
+		{
+		}
+	}
+}
+
+void vxldollar::counting_filter::erase (uint64_t key_a)
+{
+	for (std::size_t i (0); i < hash_count; ++i)
+	{
+		auto & counter (counters[index (key_a, i)]);
+		auto current (counter.load (std::memory_order_relaxed));
+		debug_assert (current != 0);
+		while (current != saturated && current != 0 && !counter.compare_exchange_weak (current, current - 1, std::memory_order_relaxed))
+		{
+		}
+	}
+}
+
+bool vxldollar::counting_filter::may_contain (uint64_t key_a) const
+{
+	auto result (true);
+	for (std::size_t i (0); result && i < hash_count; ++i)
+	{
+		result = counters[index (key_a, i)].load (std::memory_order_relaxed) != 0;
+	}
+	return result;
+}
+
+void vxldollar::counting_filter::clear ()
+{
+	for (auto & counter : counters)
+	{
+		counter.store (0, std::memory_order_relaxed);
+	}
+}
+
+std::size_t vxldollar::counting_filter::memory_size () const
+{
+	return counters.size () * sizeof (decltype (counters)::value_type);
+}
@@ -131,6 +131,8 @@ std::string vxldollar::error_rpc_messages::message (int ev) const
 			return "Unknown error";
 		case vxldollar::error_rpc::empty_response:
 			return "Empty response";
+		case vxldollar::error_rpc::backup_in_progress:
+			return "A ledger backup is already in progress";
 		case vxldollar::error_rpc::bad_destination:
 			return "Bad destination account";
 		case vxldollar::error_rpc::bad_difficulty_format:
@@ -187,6 +189,8 @@ std::string vxldollar::error_rpc_messages::message (int ev) const
 			return "Invalid balance number";
 		case vxldollar::error_rpc::invalid_destinations:
 			return "Invalid destinations number";
+		case vxldollar::error_rpc::invalid_enable:
+			return "Invalid enable, expected a boolean";
 		case vxldollar::error_rpc::invalid_epoch:
 			return "Invalid epoch number";
 		case vxldollar::error_rpc::invalid_epoch_signer:
@@ -197,6 +201,8 @@ std::string vxldollar::error_rpc_messages::message (int ev) const
 			return "Invalid or missing type argument";
 		case vxldollar::error_rpc::invalid_root:
 			return "Invalid root hash";
+		case vxldollar::error_rpc::invalid_sample_interval:
+			return "Invalid sample_interval";
 		case vxldollar::error_rpc::invalid_sources:
 			return "Invalid sources number";
 		case vxldollar::error_rpc::invalid_subtype:
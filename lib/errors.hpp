@@ -78,6 +78,7 @@ enum class error_rpc
 {
 	generic = 1,
 	empty_response,
+	backup_in_progress,
 	bad_destination,
 	bad_difficulty_format,
 	bad_key,
@@ -106,11 +107,13 @@ enum class error_rpc
 	disabled_bootstrap_legacy,
 	invalid_balance,
 	invalid_destinations,
+	invalid_enable,
 	invalid_epoch,
 	invalid_epoch_signer,
 	invalid_offset,
 	invalid_missing_type,
 	invalid_root,
+	invalid_sample_interval,
 	invalid_sources,
 	invalid_subtype,
 	invalid_subtype_balance,
@@ -0,0 +1,146 @@
+#include <vxldollar/lib/fingerprint_set.hpp>
+#include <vxldollar/lib/utility.hpp>
+
+#include <algorithm>
+
+vxldollar::fingerprint_set::fingerprint_set (std::size_t capacity_a)
+{
+	if (capacity_a > 0)
+	{
+		std::size_t slot_count (16);
+		while (slot_count * max_load_percent / 100 < capacity_a)
+		{
+			slot_count *= 2;
+		}
+		slots.resize (slot_count, empty_slot);
+	}
+}
+
+uint64_t vxldollar::fingerprint_set::encode (uint64_t fingerprint_a)
+{
+	// zero_fingerprint itself is folded into zero, the collision is accepted like any other fingerprint collision
+	return fingerprint_a == 0 || fingerprint_a == zero_fingerprint ? zero_fingerprint : fingerprint_a;
+}
+
+std::size_t vxldollar::fingerprint_set::index (uint64_t encoded_a) const
+{
+	debug_assert (!slots.empty ());
+	// Fibonacci hashing, fingerprints are not required to be well distributed in their low bits
+	return static_cast<std::size_t> ((encoded_a * 0x9e3779b97f4a7c15ull) >> 32) & (slots.size () - 1);
+}
+
+bool vxldollar::fingerprint_set::insert (uint64_t fingerprint_a)
+{
+	if ((count + 1) * 100 > slots.size () * max_load_percent)
+	{
+		rehash (std::max<std::size_t> (16, slots.size () * 2));
+	}
+	auto const encoded (encode (fingerprint_a));
+	auto const mask (slots.size () - 1);
+	for (auto i (index (encoded));; i = (i + 1) & mask)
+	{
+		if (slots[i] == encoded)
+		{
+			return false;
+		}
+		if (slots[i] == empty_slot)
+		{
+			slots[i] = encoded;
+			++count;
+			return true;
+		}
+	}
+}
+
+bool vxldollar::fingerprint_set::erase (uint64_t fingerprint_a)
+{
+	if (slots.empty ())
+	{
+		return false;
+	}
+	auto const encoded (encode (fingerprint_a));
+	auto const mask (slots.size () - 1);
+	auto i (index (encoded));
+	while (slots[i] != encoded)
+	{
+		if (slots[i] == empty_slot)
+		{
+			return false;
+		}
+		i = (i + 1) & mask;
+	}
+	// Backward shift deletion, so that probe sequences never cross an empty slot
+	for (auto j ((i + 1) & mask); slots[j] != empty_slot; j = (j + 1) & mask)
+	{
+		auto const home (index (slots[j]));
+		// Move the element into the hole if its home slot is not in the cyclic range (i, j]
+		if (((j - home) & mask) >= ((j - i) & mask))
+		{
+			slots[i] = slots[j];
+			i = j;
+		}
+	}
+	slots[i] = empty_slot;
+	--count;
+	return true;
+}
+
+bool vxldollar::fingerprint_set::contains (uint64_t fingerprint_a) const
+{
+	if (slots.empty ())
+	{
+		return false;
+	}
+	auto const encoded (encode (fingerprint_a));
+	auto const mask (slots.size () - 1);
+	for (auto i (index (encoded)); slots[i] != empty_slot; i = (i + 1) & mask)
+	{
+		if (slots[i] == encoded)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+std::size_t vxldollar::fingerprint_set::size () const
+{
+	return count;
+}
+
+bool vxldollar::fingerprint_set::empty () const
+{
+	return count == 0;
+}
+
+void vxldollar::fingerprint_set::clear ()
+{
+	decltype (slots) empty;
+	slots.swap (empty);
+	count = 0;
+}
+
+std::size_t vxldollar::fingerprint_set::memory_size () const
+{
+	return slots.capacity () * sizeof (uint64_t);
+}
+
+void vxldollar::fingerprint_set::rehash (std::size_t slot_count_a)
+{
+	debug_assert ((slot_count_a & (slot_count_a - 1)) == 0);
+	decltype (slots) old (slot_count_a, empty_slot);
+	old.swap (slots);
+	auto const mask (slots.size () - 1);
+	for (auto encoded : old)
+	{
+		if (encoded != empty_slot)
+		{
+			auto i (index (encoded));
+			while (slots[i] != empty_slot)
+			{
+				i = (i + 1) & mask;
+			}
+			slots[i] = encoded;
+		}
+	}
+}
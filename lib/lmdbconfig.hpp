@@ -44,6 +44,12 @@ public:
 
 	/** Sync strategy for the ledger database */
 	sync_strategy sync{ always };
+	/**
+	 * Writers taking turns through the write database queue commit without flushing, and wait for a flush shared
+	 * by all writers finishing in the same window. Only has an effect with the always and nosync_safe strategies.
+	 * As with nosync_unsafe, a system crash in that window may corrupt the database on filesystems without write ordering.
+	 */
+	bool group_commit{ false };
 	uint32_t max_databases{ 128 };
 	size_t map_size{ 256ULL * 1024 * 1024 * 1024 };
 };
@@ -6,6 +6,10 @@ vxldollar::error vxldollar::rocksdb_config::serialize_toml (vxldollar::tomlconfi
 {
 	toml.put ("enable", enable, "Whether to use the RocksDB backend for the ledger database.\ntype:bool");
 	toml.put ("memory_multiplier", memory_multiplier, "This will modify how much memory is used represented by 1 (low), 2 (medium), 3 (high). Default is 2.\ntype:uint8");
+	toml.put ("memory_budget", memory_budget, "Memory in bytes shared by the block cache and the memtables of all tables. Index and filter blocks are cached with high priority, memtables are flushed when their share of the budget is used. 0 uses 512 MB times memory_multiplier. Default is 0.\ntype:uint64");
+	toml.put ("compression", compression, "Compression of recently written data in the ledger tables, one of none, lz4 or zstd. lz4 is cheap enough to use on levels which are read often. Default is none.\ntype:string");
+	toml.put ("bottommost_compression", bottommost_compression, "Compression of the last level of the ledger tables, which holds most of the ledger, one of none, lz4 or zstd. Default is none.\ntype:string");
+	toml.put ("dictionary_bytes", dictionary_bytes, "Size in bytes of the dictionary zstd trains on samples of each bottommost file of the blocks table. Blocks share accounts and representatives, a dictionary of 16384 bytes improves their compression noticeably. Requires bottommost_compression=zstd. Default is 0 (no dictionary).\ntype:uint32");
 	toml.put ("io_threads", io_threads, "Number of threads to use with the background compaction and flushing. Number of hardware threads is recommended.\ntype:uint32");
 	return toml.get_error ();
 }
@@ -14,6 +18,10 @@ vxldollar::error vxldollar::rocksdb_config::deserialize_toml (vxldollar::tomlcon
 {
 	toml.get_optional<bool> ("enable", enable);
 	toml.get_optional<uint8_t> ("memory_multiplier", memory_multiplier);
+	toml.get_optional<uint64_t> ("memory_budget", memory_budget);
+	toml.get_optional<std::string> ("compression", compression);
+	toml.get_optional<std::string> ("bottommost_compression", bottommost_compression);
+	toml.get_optional<uint32_t> ("dictionary_bytes", dictionary_bytes);
 	toml.get_optional<unsigned> ("io_threads", io_threads);
 
 	// Validate ranges
@@ -25,10 +33,28 @@ vxldollar::error vxldollar::rocksdb_config::deserialize_toml (vxldollar::tomlcon
 	{
 		toml.get_error ().set ("memory_multiplier must be either 1, 2 or 3");
 	}
+	if (!valid_compression (compression) || !valid_compression (bottommost_compression))
+	{
+		toml.get_error ().set ("compression and bottommost_compression must be either none, lz4 or zstd");
+	}
+	if (dictionary_bytes != 0 && bottommost_compression != "zstd")
+	{
+		toml.get_error ().set ("dictionary_bytes requires bottommost_compression to be zstd");
+	}
 
 	return toml.get_error ();
 }
 
+uint64_t vxldollar::rocksdb_config::memory_budget_bytes () const
+{
+	return memory_budget != 0 ? memory_budget : 512ULL * 1024 * 1024 * memory_multiplier;
+}
+
+bool vxldollar::rocksdb_config::valid_compression (std::string const & compression_a)
+{
+	return compression_a == "none" || compression_a == "lz4" || compression_a == "zstd";
+}
+
 bool vxldollar::rocksdb_config::using_rocksdb_in_tests ()
 {
 	auto use_rocksdb_str = std::getenv ("TEST_USE_ROCKSDB");
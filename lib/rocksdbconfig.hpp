@@ -2,6 +2,7 @@
 
 #include <vxldollar/lib/errors.hpp>
 
+#include <string>
 #include <thread>
 
 namespace vxldollar
@@ -21,9 +22,21 @@ public:
 
 	/** To use RocksDB in tests make sure the environment variable TEST_USE_ROCKSDB=1 is set */
 	static bool using_rocksdb_in_tests ();
+	/** Whether \p compression_a names a supported compression: none, lz4 or zstd */
+	static bool valid_compression (std::string const & compression_a);
 
 	bool enable{ false };
 	uint8_t memory_multiplier{ 2 };
+	/** Bytes shared by the block cache and memtables of all tables, 0 derives the budget from memory_multiplier */
+	uint64_t memory_budget{ 0 };
+	/** The configured memory budget, or the one derived from memory_multiplier */
+	uint64_t memory_budget_bytes () const;
+	/** Compression of the upper levels of ledger tables, which hold recently written data */
+	std::string compression{ "none" };
+	/** Compression of the last level of ledger tables, which holds most of the data */
+	std::string bottommost_compression{ "none" };
+	/** Size of the zstd dictionary trained for each bottommost file of the blocks table, 0 disables dictionaries */
+	uint32_t dictionary_bytes{ 0 };
 	unsigned io_threads{ std::thread::hardware_concurrency () };
 };
 }
@@ -54,6 +54,9 @@ std::string vxldollar::thread_role::get_string (vxldollar::thread_role::name rol
 		case vxldollar::thread_role::name::bootstrap_connections:
 			thread_role_name_string = "Bootstrap conn";
 			break;
+		case vxldollar::thread_role::name::bootstrap_priority:
+			thread_role_name_string = "Bootstrap prio";
+			break;
 		case vxldollar::thread_role::name::voting:
 			thread_role_name_string = "Voting";
 			break;
@@ -90,6 +93,12 @@ std::string vxldollar::thread_role::get_string (vxldollar::thread_role::name rol
 		case vxldollar::thread_role::name::unchecked:
 			thread_role_name_string = "Unchecked";
 			break;
+		case vxldollar::thread_role::name::traffic_recorder:
+			thread_role_name_string = "Traffic record";
+			break;
+		case vxldollar::thread_role::name::ledger_backup:
+			thread_role_name_string = "Ledger backup";
+			break;
 		default:
 			debug_assert (false && "vxldollar::thread_role::get_string unhandled thread role");
 	}
@@ -80,6 +80,19 @@ void vxldollar::set_file_descriptor_limit (std::size_t limit)
 #endif
 }
 
+std::pair<uint64_t, uint64_t> vxldollar::thread_page_faults ()
+{
+	std::pair<uint64_t, uint64_t> result{ 0, 0 };
+#ifdef RUSAGE_THREAD
+	rusage usage{};
+	if (getrusage (RUSAGE_THREAD, &usage) == 0)
+	{
+		result = { static_cast<uint64_t> (usage.ru_minflt), static_cast<uint64_t> (usage.ru_majflt) };
+	}
+#endif
+	return result;
+}
+
 vxldollar::container_info_composite::container_info_composite (std::string const & name) :
 	name (name)
 {
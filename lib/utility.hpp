@@ -9,6 +9,7 @@
 #include <cassert>
 #include <functional>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace boost
@@ -147,6 +148,11 @@ std::string generate_stacktrace ();
 std::size_t get_file_descriptor_limit ();
 void set_file_descriptor_limit (std::size_t limit);
 
+/**
+ * Minor and major page faults of the calling thread so far. Both are zero on platforms which only count them per process.
+ */
+std::pair<uint64_t, uint64_t> thread_page_faults ();
+
 template <typename... T>
 class observer_set final
 {
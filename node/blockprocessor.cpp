@@ -232,9 +232,10 @@ void vxldollar::block_processor::process_verified_state_blocks (std::deque<vxldo
 
 void vxldollar::block_processor::process_batch (vxldollar::unique_lock<vxldollar::mutex> & lock_a)
 {
-	auto scoped_write_guard = write_database_queue.wait (vxldollar::writer::process_batch);
+	// Post events run once the write guard is released, with group commit this is after the batch has been flushed
 	block_post_events post_events ([&store = node.store] { return store.tx_begin_read (); });
-	auto transaction (node.store.tx_begin_write ({ tables::accounts, tables::blocks, tables::frontiers, tables::pending, tables::unchecked }));
+	auto scoped_write_guard = write_database_queue.wait (vxldollar::writer::process_batch);
+	auto transaction (node.store.tx_begin_write ({ tables::account_heights, tables::accounts, tables::blocks, tables::frontiers, tables::pending, tables::unchecked }));
 	vxldollar::timer<std::chrono::milliseconds> timer_l;
 	lock_a.lock ();
 	timer_l.start ();
@@ -346,6 +347,7 @@ vxldollar::process_return vxldollar::block_processor::process_one (vxldollar::wr
 	vxldollar::process_return result;
 	auto block (info_a.block);
 	auto hash (block->hash ());
+	auto const processing (std::chrono::steady_clock::now ());
 	result = node.ledger.process (transaction_a, *block, info_a.verified);
 	switch (result.code)
 	{
@@ -358,7 +360,13 @@ vxldollar::process_return vxldollar::block_processor::process_one (vxldollar::wr
 				block->serialize_json (block_string, node.config.logging.single_line_record ());
 				node.logger.try_log (boost::str (boost::format ("Processing block %1%: %2%") % hash.to_string () % block_string));
 			}
-			if (node.block_arrival.recent (hash) || forced_a)
+			std::chrono::steady_clock::time_point arrival;
+			auto const recent (node.block_arrival.recent (hash, &arrival));
+			if (recent && origin_a == vxldollar::block_origin::remote)
+			{
+				node.stats.update_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::processor, processing - arrival);
+			}
+			if (recent || forced_a)
 			{
 				events_a.events.emplace_back ([this, hash, block = info_a.block, result, origin_a] (vxldollar::transaction const & post_event_transaction_a) { process_live (post_event_transaction_a, hash, block, result, origin_a); });
 			}
@@ -382,7 +390,16 @@ vxldollar::process_return vxldollar::block_processor::process_one (vxldollar::wr
 			}
 			info_a.verified = result.verified;
 			node.unchecked.put (block->previous (), info_a);
-			events_a.events.emplace_back ([this, hash] (vxldollar::transaction const & /* unused */) { this->node.gap_cache.add (hash); });
+			// Accounts of state blocks missing from the ledger are pulled from their remote head, other gaps by their missing previous block
+			vxldollar::hash_or_account dependency (block->previous ());
+			if (!block->account ().is_zero () && node.ledger.latest (transaction_a, block->account ()).is_zero ())
+			{
+				dependency = block->account ();
+			}
+			events_a.events.emplace_back ([this, hash, dependency] (vxldollar::transaction const & /* unused */) {
+				this->node.gap_cache.add (hash);
+				this->node.bootstrap_initiator.bootstrap_priority (dependency);
+			});
 			node.stats.inc (vxldollar::stat::type::ledger, vxldollar::stat::detail::gap_previous);
 			break;
 		}
@@ -393,8 +410,12 @@ vxldollar::process_return vxldollar::block_processor::process_one (vxldollar::wr
 				node.logger.try_log (boost::str (boost::format ("Gap source for: %1%") % hash.to_string ()));
 			}
 			info_a.verified = result.verified;
-			node.unchecked.put (node.ledger.block_source (transaction_a, *(block)), info_a);
-			events_a.events.emplace_back ([this, hash] (vxldollar::transaction const & /* unused */) { this->node.gap_cache.add (hash); });
+			auto const source (node.ledger.block_source (transaction_a, *(block)));
+			node.unchecked.put (source, info_a);
+			events_a.events.emplace_back ([this, hash, source] (vxldollar::transaction const & /* unused */) {
+				this->node.gap_cache.add (hash);
+				this->node.bootstrap_initiator.bootstrap_priority (source);
+			});
 			node.stats.inc (vxldollar::stat::type::ledger, vxldollar::stat::detail::gap_source);
 			break;
 		}
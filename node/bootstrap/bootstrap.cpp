@@ -2,6 +2,7 @@
 #include <vxldollar/node/bootstrap/bootstrap.hpp>
 #include <vxldollar/node/bootstrap/bootstrap_lazy.hpp>
 #include <vxldollar/node/bootstrap/bootstrap_legacy.hpp>
+#include <vxldollar/node/bootstrap/bootstrap_priority.hpp>
 #include <vxldollar/node/common.hpp>
 #include <vxldollar/node/node.hpp>
 
@@ -10,6 +11,7 @@
 #include <algorithm>
 
 vxldollar::bootstrap_initiator::bootstrap_initiator (vxldollar::node & node_a) :
+	priorities (node_a.network_params.bootstrap.priority_request_interval),
 	node (node_a)
 {
 	connections = std::make_shared<vxldollar::bootstrap_connections> (node);
@@ -24,6 +26,13 @@ vxldollar::bootstrap_initiator::bootstrap_initiator (vxldollar::node & node_a) :
 			run_bootstrap ();
 		}));
 	}
+	if (node.flags.enable_priority_bootstrap)
+	{
+		bootstrap_initiator_threads.push_back (boost::thread ([this] () {
+			vxldollar::thread_role::set (vxldollar::thread_role::name::bootstrap_priority);
+			run_priority_bootstrap ();
+		}));
+	}
 }
 
 vxldollar::bootstrap_initiator::~bootstrap_initiator ()
@@ -127,6 +136,33 @@ void vxldollar::bootstrap_initiator::bootstrap_wallet (std::deque<vxldollar::acc
 	condition.notify_all ();
 }
 
+void vxldollar::bootstrap_initiator::bootstrap_priority (vxldollar::hash_or_account const & key_a, double priority_a)
+{
+	if (node.flags.enable_priority_bootstrap && !stopped)
+	{
+		priorities.raise (key_a, priority_a);
+		std::shared_ptr<vxldollar::bootstrap_attempt> priority_attempt;
+		{
+			vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+			priority_attempt = find_attempt (vxldollar::bootstrap_mode::priority);
+			if (priority_attempt == nullptr && !stopped)
+			{
+				node.stats.inc (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::initiate_priority, vxldollar::stat::dir::out);
+				attempts_list.push_back (std::make_shared<vxldollar::bootstrap_attempt_priority> (node.shared (), attempts.incremental++));
+				attempts.add (attempts_list.back ());
+			}
+		}
+		if (priority_attempt != nullptr)
+		{
+			priority_attempt->condition.notify_all ();
+		}
+		else
+		{
+			condition.notify_all ();
+		}
+	}
+}
+
 void vxldollar::bootstrap_initiator::run_bootstrap ()
 {
 	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
@@ -150,6 +186,26 @@ void vxldollar::bootstrap_initiator::run_bootstrap ()
 	}
 }
 
+void vxldollar::bootstrap_initiator::run_priority_bootstrap ()
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	while (!stopped)
+	{
+		auto attempt (find_attempt (vxldollar::bootstrap_mode::priority));
+		if (attempt != nullptr && !attempt->started.exchange (true))
+		{
+			lock.unlock ();
+			attempt->run ();
+			remove_attempt (attempt);
+			lock.lock ();
+		}
+		else
+		{
+			condition.wait (lock);
+		}
+	}
+}
+
 void vxldollar::bootstrap_initiator::lazy_requeue (vxldollar::block_hash const & hash_a, vxldollar::block_hash const & previous_a)
 {
 	auto lazy_attempt (current_lazy_attempt ());
@@ -168,7 +224,9 @@ void vxldollar::bootstrap_initiator::add_observer (std::function<void (bool)> co
 bool vxldollar::bootstrap_initiator::in_progress ()
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	return !attempts_list.empty ();
+	return std::any_of (attempts_list.begin (), attempts_list.end (), [] (std::shared_ptr<vxldollar::bootstrap_attempt> const & attempt_a) {
+		return attempt_a->mode != vxldollar::bootstrap_mode::priority;
+	});
 }
 
 std::shared_ptr<vxldollar::bootstrap_attempt> vxldollar::bootstrap_initiator::find_attempt (vxldollar::bootstrap_mode mode_a)
@@ -205,9 +263,10 @@ void vxldollar::bootstrap_initiator::remove_attempt (std::shared_ptr<vxldollar::
 
 std::shared_ptr<vxldollar::bootstrap_attempt> vxldollar::bootstrap_initiator::new_attempt ()
 {
+	// Priority attempts are started by run_priority_bootstrap
 	for (auto & i : attempts_list)
 	{
-		if (!i->started.exchange (true))
+		if (i->mode != vxldollar::bootstrap_mode::priority && !i->started.exchange (true))
 		{
 			return i;
 		}
@@ -219,7 +278,7 @@ bool vxldollar::bootstrap_initiator::has_new_attempts ()
 {
 	for (auto & i : attempts_list)
 	{
-		if (!i->started)
+		if (i->mode != vxldollar::bootstrap_mode::priority && !i->started)
 		{
 			return true;
 		}
@@ -245,6 +304,12 @@ std::shared_ptr<vxldollar::bootstrap_attempt> vxldollar::bootstrap_initiator::cu
 	return find_attempt (vxldollar::bootstrap_mode::wallet_lazy);
 }
 
+std::shared_ptr<vxldollar::bootstrap_attempt> vxldollar::bootstrap_initiator::current_priority_attempt ()
+{
+	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+	return find_attempt (vxldollar::bootstrap_mode::priority);
+}
+
 void vxldollar::bootstrap_initiator::stop_attempts ()
 {
 	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
@@ -303,6 +368,7 @@ std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_containe
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "observers", count, sizeof_element }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "pulls_cache", cache_count, sizeof_cache_element }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "priorities", bootstrap_initiator.priorities.size (), sizeof (vxldollar::bootstrap_priority_entry) }));
 	return composite;
 }
 
@@ -355,6 +421,135 @@ void vxldollar::pulls_cache::remove (vxldollar::pull_info const & pull_a)
 	cache.get<account_head_tag> ().erase (head_512);
 }
 
+constexpr double vxldollar::bootstrap_priorities::priority_increase;
+constexpr double vxldollar::bootstrap_priorities::priority_max;
+constexpr double vxldollar::bootstrap_priorities::priority_cutoff;
+constexpr std::size_t vxldollar::bootstrap_priorities::priorities_max;
+constexpr std::size_t vxldollar::bootstrap_priorities::next_scan_max;
+constexpr unsigned vxldollar::bootstrap_priorities::failures_max;
+
+vxldollar::bootstrap_priorities::bootstrap_priorities (std::chrono::milliseconds const & request_interval_a) :
+	request_interval (request_interval_a)
+{
+}
+
+bool vxldollar::bootstrap_priorities::raise (vxldollar::hash_or_account const & key_a, double priority_a)
+{
+	bool inserted (false);
+	if (!key_a.is_zero ())
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+		auto & by_key (entries.get<tag_key> ());
+		auto existing (by_key.find (key_a));
+		if (existing != by_key.end ())
+		{
+			by_key.modify (existing, [priority_a] (vxldollar::bootstrap_priority_entry & entry_a) {
+				entry_a.priority = std::min (entry_a.priority + priority_a, priority_max);
+			});
+		}
+		else
+		{
+			by_key.emplace (vxldollar::bootstrap_priority_entry{ key_a, std::min (priority_a, priority_max), std::chrono::steady_clock::time_point{} });
+			inserted = true;
+			if (entries.size () > priorities_max)
+			{
+				auto & by_priority (entries.get<tag_priority> ());
+				by_priority.erase (std::prev (by_priority.end ()));
+			}
+		}
+	}
+	return inserted;
+}
+
+void vxldollar::bootstrap_priorities::erase (vxldollar::hash_or_account const & key_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	entries.get<tag_key> ().erase (key_a);
+}
+
+vxldollar::hash_or_account vxldollar::bootstrap_priorities::next (std::chrono::steady_clock::time_point const & now_a)
+{
+	vxldollar::hash_or_account result{ 0 };
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	auto & by_priority (entries.get<tag_priority> ());
+	std::size_t scanned (0);
+	for (auto i (by_priority.begin ()), n (by_priority.end ()); i != n && scanned < next_scan_max; ++i, ++scanned)
+	{
+		if (i->next_request <= now_a)
+		{
+			result = i->key;
+			by_priority.modify (i, [next_request = now_a + request_interval] (vxldollar::bootstrap_priority_entry & entry_a) {
+				entry_a.next_request = next_request;
+			});
+			break;
+		}
+	}
+	return result;
+}
+
+void vxldollar::bootstrap_priorities::pull_succeeded (vxldollar::hash_or_account const & key_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	auto & by_key (entries.get<tag_key> ());
+	auto existing (by_key.find (key_a));
+	if (existing != by_key.end ())
+	{
+		auto const priority_l (existing->priority / 2);
+		if (priority_l < priority_cutoff)
+		{
+			by_key.erase (existing);
+		}
+		else
+		{
+			by_key.modify (existing, [priority_l] (vxldollar::bootstrap_priority_entry & entry_a) {
+				entry_a.priority = priority_l;
+				entry_a.failures = 0;
+			});
+		}
+	}
+}
+
+void vxldollar::bootstrap_priorities::pull_failed (vxldollar::hash_or_account const & key_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	auto & by_key (entries.get<tag_key> ());
+	auto existing (by_key.find (key_a));
+	if (existing != by_key.end ())
+	{
+		if (existing->failures + 1 >= failures_max)
+		{
+			// No peer could serve it, a new gap or vote inserts it again
+			by_key.erase (existing);
+		}
+		else
+		{
+			by_key.modify (existing, [] (vxldollar::bootstrap_priority_entry & entry_a) {
+				entry_a.priority = std::min (entry_a.priority + priority_increase, priority_max);
+				++entry_a.failures;
+			});
+		}
+	}
+}
+
+double vxldollar::bootstrap_priorities::priority (vxldollar::hash_or_account const & key_a) const
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	auto existing (entries.get<tag_key> ().find (key_a));
+	return existing != entries.get<tag_key> ().end () ? existing->priority : 0.0;
+}
+
+std::size_t vxldollar::bootstrap_priorities::size () const
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	return entries.size ();
+}
+
+void vxldollar::bootstrap_priorities::clear ()
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	entries.clear ();
+}
+
 void vxldollar::bootstrap_attempts::add (std::shared_ptr<vxldollar::bootstrap_attempt> attempt_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (bootstrap_attempts_mutex);
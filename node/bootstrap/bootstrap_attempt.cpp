@@ -110,6 +110,10 @@ std::string vxldollar::bootstrap_attempt::mode_text ()
 	{
 		mode_text = "wallet_lazy";
 	}
+	else if (mode == vxldollar::bootstrap_mode::priority)
+	{
+		mode_text = "priority";
+	}
 	return mode_text;
 }
 
@@ -189,6 +193,11 @@ void vxldollar::bootstrap_attempt::requeue_pending (vxldollar::account const &)
 	debug_assert (mode == vxldollar::bootstrap_mode::wallet_lazy);
 }
 
+void vxldollar::bootstrap_attempt::priority_pull_finished (vxldollar::pull_info const &, bool)
+{
+	debug_assert (mode == vxldollar::bootstrap_mode::priority);
+}
+
 void vxldollar::bootstrap_attempt::wallet_start (std::deque<vxldollar::account> &)
 {
 	debug_assert (mode == vxldollar::bootstrap_mode::wallet_lazy);
@@ -39,6 +39,7 @@ public:
 	virtual bool lazy_processed_or_exists (vxldollar::block_hash const &);
 	virtual bool process_block (std::shared_ptr<vxldollar::block> const &, vxldollar::account const &, uint64_t, vxldollar::bulk_pull::count_t, bool, unsigned);
 	virtual void requeue_pending (vxldollar::account const &);
+	virtual void priority_pull_finished (vxldollar::pull_info const &, bool);
 	virtual void wallet_start (std::deque<vxldollar::account> &);
 	virtual std::size_t wallet_size ();
 	virtual void get_information (boost::property_tree::ptree &) = 0;
@@ -18,6 +18,102 @@ vxldollar::pull_info::pull_info (vxldollar::hash_or_account const & account_or_h
 {
 }
 
+std::size_t vxldollar::bulk_pull_compact::serialize (vxldollar::stream & stream_a, vxldollar::block const & block_a)
+{
+	uint8_t elided (0);
+	if (last_valid && block_a.type () == vxldollar::block_type::state)
+	{
+		elided |= block_a.account () == last_account ? account_elided : 0;
+		elided |= block_a.representative () == last_representative ? representative_elided : 0;
+	}
+	std::size_t result (0);
+	if (elided != 0)
+	{
+		auto const & state (static_cast<vxldollar::state_block const &> (block_a));
+		auto const type (static_cast<uint8_t> (state_elided | elided));
+		vxldollar::write (stream_a, type);
+		if ((elided & account_elided) == 0)
+		{
+			vxldollar::write (stream_a, state.hashables.account);
+		}
+		vxldollar::write (stream_a, state.hashables.previous);
+		if ((elided & representative_elided) == 0)
+		{
+			vxldollar::write (stream_a, state.hashables.representative);
+		}
+		vxldollar::write (stream_a, state.hashables.balance);
+		vxldollar::write (stream_a, state.hashables.link);
+		vxldollar::write (stream_a, state.signature);
+		vxldollar::write (stream_a, boost::endian::native_to_big (state.work));
+		result = sizeof (type) + size (type);
+	}
+	else
+	{
+		vxldollar::serialize_block (stream_a, block_a);
+		result = sizeof (vxldollar::block_type) + vxldollar::block::size (block_a.type ());
+	}
+	update (block_a);
+	return result;
+}
+
+bool vxldollar::bulk_pull_compact::expand (uint8_t type_a, std::vector<uint8_t> & buffer_a, std::size_t size_a) const
+{
+	auto error (!last_valid || !is_elided (type_a) || size_a != size (type_a) || buffer_a.size () < size_a);
+	if (!error)
+	{
+		std::array<uint8_t, vxldollar::state_block::size> expanded;
+		auto in (buffer_a.cbegin ());
+		auto out (expanded.begin ());
+		auto field = [&in, &out] (bool elided_a, vxldollar::account const & last_a) {
+			if (elided_a)
+			{
+				out = std::copy (last_a.bytes.begin (), last_a.bytes.end (), out);
+			}
+			else
+			{
+				out = std::copy (in, in + sizeof (last_a), out);
+				in += sizeof (last_a);
+			}
+		};
+		field ((type_a & account_elided) != 0, last_account);
+		out = std::copy (in, in + sizeof (vxldollar::block_hash), out);
+		in += sizeof (vxldollar::block_hash);
+		field ((type_a & representative_elided) != 0, last_representative);
+		std::copy (in, buffer_a.cbegin () + size_a, out);
+		if (buffer_a.size () < expanded.size ())
+		{
+			buffer_a.resize (expanded.size ());
+		}
+		std::copy (expanded.begin (), expanded.end (), buffer_a.begin ());
+	}
+	return error;
+}
+
+void vxldollar::bulk_pull_compact::update (vxldollar::block const & block_a)
+{
+	if (block_a.type () == vxldollar::block_type::state)
+	{
+		last_account = block_a.account ();
+		last_representative = block_a.representative ();
+		last_valid = true;
+	}
+}
+
+bool vxldollar::bulk_pull_compact::is_elided (uint8_t type_a)
+{
+	auto const fields (static_cast<uint8_t> (account_elided | representative_elided));
+	return (type_a & state_elided) != 0 && (type_a & fields) != 0 && (type_a & ~(state_elided | fields)) == 0;
+}
+
+std::size_t vxldollar::bulk_pull_compact::size (uint8_t type_a)
+{
+	debug_assert (is_elided (type_a));
+	auto result (vxldollar::state_block::size);
+	result -= (type_a & account_elided) != 0 ? sizeof (vxldollar::account) : 0;
+	result -= (type_a & representative_elided) != 0 ? sizeof (vxldollar::account) : 0;
+	return result;
+}
+
 vxldollar::bulk_pull_client::bulk_pull_client (std::shared_ptr<vxldollar::bootstrap_client> const & connection_a, std::shared_ptr<vxldollar::bootstrap_attempt> const & attempt_a, vxldollar::pull_info const & pull_a) :
 	connection (connection_a),
 	attempt (attempt_a),
@@ -31,6 +127,12 @@ vxldollar::bulk_pull_client::bulk_pull_client (std::shared_ptr<vxldollar::bootst
 
 vxldollar::bulk_pull_client::~bulk_pull_client ()
 {
+	// Stopped before the end of the response, the connection cannot be used for the next pulls
+	finish (false);
+	if (attempt->mode == vxldollar::bootstrap_mode::priority)
+	{
+		attempt->priority_pull_finished (pull, !network_error && pull_blocks > unexpected_count);
+	}
 	/* If received end block is not expected end block
 	Or if given start and end blocks are from different chains (i.e. forked node or malicious node) */
 	if (expected != pull.end && !expected.is_zero ())
@@ -72,6 +174,7 @@ void vxldollar::bulk_pull_client::request ()
 	req.end = pull.end;
 	req.count = pull.count;
 	req.set_count_present (pull.count != 0);
+	req.set_compact (connection->compact);
 
 	if (connection->node->config.logging.bulk_pull_logging ())
 	{
@@ -82,11 +185,17 @@ void vxldollar::bulk_pull_client::request ()
 		connection->node->logger.always_log (boost::str (boost::format ("%1% accounts in pull queue") % attempt->pulling));
 	}
 	auto this_l (shared_from_this ());
+	// Responses come in request order, only the first pull in flight reads from the socket
+	auto const front (connection->pipeline_push (this_l));
 	connection->channel->send (
-	req, [this_l] (boost::system::error_code const & ec, std::size_t size_a) {
+	req, [this_l, front] (boost::system::error_code const & ec, std::size_t size_a) {
 		if (!ec)
 		{
-			this_l->throttled_receive_block ();
+			if (front)
+			{
+				this_l->throttled_receive_block ();
+			}
+			this_l->connection->pipeline_sent ();
 		}
 		else
 		{
@@ -185,15 +294,19 @@ void vxldollar::bulk_pull_client::received_type ()
 		case vxldollar::block_type::not_a_block:
 		{
 			// Avoid re-using slow peers, or peers that sent the wrong blocks.
-			if (!connection->pending_stop && (expected == pull.end || (pull.count != 0 && pull.count == pull_blocks)))
-			{
-				connection->connections.pool_connection (connection);
-			}
+			finish (draining || expected == pull.end || (pull.count != 0 && pull.count == pull_blocks));
 			break;
 		}
 		default:
 		{
-			if (connection->node->config.logging.network_packet_logging ())
+			auto const record_type (connection->receive_buffer->data ()[0]);
+			if (connection->compact && vxldollar::bulk_pull_compact::is_elided (record_type))
+			{
+				socket_l->async_read (connection->receive_buffer, vxldollar::bulk_pull_compact::size (record_type), [this_l, record_type] (boost::system::error_code const & ec, std::size_t size_a) {
+					this_l->received_elided (ec, size_a, record_type);
+				});
+			}
+			else if (connection->node->config.logging.network_packet_logging ())
 			{
 				connection->node->logger.try_log (boost::str (boost::format ("Unknown type received as block type: %1%") % static_cast<int> (type)));
 			}
@@ -202,12 +315,34 @@ void vxldollar::bulk_pull_client::received_type ()
 	}
 }
 
+void vxldollar::bulk_pull_client::received_elided (boost::system::error_code const & ec, std::size_t size_a, uint8_t type_a)
+{
+	auto size_l (size_a);
+	if (!ec && !draining && !compact.expand (type_a, *connection->receive_buffer, size_a))
+	{
+		size_l = vxldollar::state_block::size;
+	}
+	// A record which cannot be expanded is too short for a state block, it fails to deserialize
+	received_block (ec, size_l, vxldollar::block_type::state);
+}
+
 void vxldollar::bulk_pull_client::received_block (boost::system::error_code const & ec, std::size_t size_a, vxldollar::block_type type_a)
 {
-	if (!ec)
+	if (!ec && draining)
+	{
+		if (!connection->hard_stop.load ())
+		{
+			receive_block ();
+		}
+	}
+	else if (!ec)
 	{
 		vxldollar::bufferstream stream (connection->receive_buffer->data (), size_a);
 		auto block (vxldollar::deserialize_block (stream, type_a));
+		if (block != nullptr && connection->compact)
+		{
+			compact.update (*block);
+		}
 		if (block != nullptr && !connection->node->network_params.work.validate_entry (*block))
 		{
 			auto hash (block->hash ());
@@ -251,9 +386,15 @@ void vxldollar::bulk_pull_client::received_block (boost::system::error_code cons
 					throttled_receive_block ();
 				}
 			}
+			else if (stop_pull && block_expected && connection->pipelining && !connection->hard_stop.load ())
+			{
+				// Later responses are queued behind this one, skip the remaining blocks
+				draining = true;
+				receive_block ();
+			}
 			else if (stop_pull && block_expected)
 			{
-				connection->connections.pool_connection (connection);
+				finish (true);
 			}
 		}
 		else if (block == nullptr)
@@ -284,6 +425,15 @@ void vxldollar::bulk_pull_client::received_block (boost::system::error_code cons
 	}
 }
 
+void vxldollar::bulk_pull_client::finish (bool reuse_a)
+{
+	if (!finished)
+	{
+		finished = true;
+		connection->pipeline_pop (this, reuse_a);
+	}
+}
+
 vxldollar::bulk_pull_account_client::bulk_pull_account_client (std::shared_ptr<vxldollar::bootstrap_client> const & connection_a, std::shared_ptr<vxldollar::bootstrap_attempt> const & attempt_a, vxldollar::account const & account_a) :
 	connection (connection_a),
 	attempt (attempt_a),
@@ -479,21 +629,57 @@ void vxldollar::bulk_pull_server::set_current_end ()
 	}
 }
 
+std::size_t constexpr vxldollar::bulk_pull_server::read_ahead_max;
+std::size_t constexpr vxldollar::bulk_pull_server::send_buffer_max;
+
 void vxldollar::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
+	auto const start (std::chrono::steady_clock::now ());
+	std::vector<uint8_t> send_buffer;
+	std::size_t buffer_size (0);
+	std::size_t elided_size (0);
+	uint64_t count (0);
 	{
-		std::vector<uint8_t> send_buffer;
+		vxldollar::vectorstream stream (send_buffer);
+		while (buffer_size < send_buffer_max)
 		{
-			vxldollar::vectorstream stream (send_buffer);
-			vxldollar::serialize_block (stream, *block);
+			auto block (get_next ());
+			if (block == nullptr)
+			{
+				break;
+			}
+			if (connection->node->config.logging.bulk_pull_logging ())
+			{
+				connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
+			}
+			auto const plain_size (sizeof (vxldollar::block_type) + vxldollar::block::size (block->type ()));
+			if (compact)
+			{
+				auto const record_size (compact_state.serialize (stream, *block));
+				buffer_size += record_size;
+				elided_size += plain_size - record_size;
+			}
+			else
+			{
+				vxldollar::serialize_block (stream, *block);
+				buffer_size += plain_size;
+			}
+			++count;
 		}
-		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
+	}
+	if (count > 0)
+	{
+		// Blocks served per core second can be derived from these two counters
+		auto const elapsed (std::chrono::steady_clock::now () - start);
+		serve_time += elapsed;
+		served_count += count;
+		connection->node->stats.add (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_blocks_served, vxldollar::stat::dir::out, count);
+		connection->node->stats.add (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_serve_time_us, vxldollar::stat::dir::out, std::chrono::duration_cast<std::chrono::microseconds> (elapsed).count ());
+		if (elided_size > 0)
 		{
-			connection->node->logger.try_log (boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ()));
+			connection->node->stats.add (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_elided_bytes, vxldollar::stat::dir::out, elided_size);
 		}
+		auto this_l (shared_from_this ());
 		connection->socket->async_write (vxldollar::shared_const_buffer (std::move (send_buffer)), [this_l] (boost::system::error_code const & ec, std::size_t size_a) {
 			this_l->sent_action (ec, size_a);
 		});
@@ -505,6 +691,35 @@ void vxldollar::bulk_pull_server::send_next ()
 }
 
 std::shared_ptr<vxldollar::block> vxldollar::bulk_pull_server::get_next ()
+{
+	if (read_ahead.empty ())
+	{
+		fill_read_ahead ();
+	}
+	std::shared_ptr<vxldollar::block> result;
+	if (!read_ahead.empty ())
+	{
+		result = std::move (read_ahead.front ());
+		read_ahead.pop_front ();
+	}
+	return result;
+}
+
+void vxldollar::bulk_pull_server::fill_read_ahead ()
+{
+	auto transaction (connection->node->store.tx_begin_read ());
+	while (read_ahead.size () < read_ahead_max)
+	{
+		auto block (read_next (transaction));
+		if (block == nullptr)
+		{
+			break;
+		}
+		read_ahead.push_back (std::move (block));
+	}
+}
+
+std::shared_ptr<vxldollar::block> vxldollar::bulk_pull_server::read_next (vxldollar::transaction const & transaction_a)
 {
 	std::shared_ptr<vxldollar::block> result;
 	bool send_current = false, set_current_to_end = false;
@@ -545,7 +760,7 @@ std::shared_ptr<vxldollar::block> vxldollar::bulk_pull_server::get_next ()
 
 	if (send_current)
 	{
-		result = connection->node->block (current);
+		result = connection->node->store.block.get (transaction_a, current);
 		if (result != nullptr && set_current_to_end == false)
 		{
 			auto previous (result->previous ());
@@ -596,7 +811,8 @@ void vxldollar::bulk_pull_server::send_finished ()
 	auto this_l (shared_from_this ());
 	if (connection->node->config.logging.bulk_pull_logging ())
 	{
-		connection->node->logger.try_log ("Bulk sending finished");
+		auto const serve_seconds (std::chrono::duration<double> (serve_time).count ());
+		connection->node->logger.try_log (boost::str (boost::format ("Bulk sending finished, %1% blocks served at %2% blocks/s per core") % served_count % (serve_seconds > 0 ? served_count / serve_seconds : 0.0)));
 	}
 	connection->socket->async_write (send_buffer, [this_l] (boost::system::error_code const & ec, std::size_t size_a) {
 		this_l->no_block_sent (ec, size_a);
@@ -623,6 +839,7 @@ vxldollar::bulk_pull_server::bulk_pull_server (std::shared_ptr<vxldollar::bootst
 	connection (connection_a),
 	request (std::move (request_a))
 {
+	compact = request->is_compact ();
 	set_current_end ();
 }
 
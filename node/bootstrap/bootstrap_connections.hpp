@@ -16,6 +16,7 @@ namespace transport
 
 class bootstrap_attempt;
 class bootstrap_connections;
+class bulk_pull_client;
 class frontier_req_client;
 class pull_info;
 
@@ -31,6 +32,17 @@ public:
 	double sample_block_rate ();
 	double elapsed_seconds () const;
 	void set_start_time (std::chrono::steady_clock::time_point start_time_a);
+	/** Registers a pull before its request is sent. @return true if no other pull is in flight, so the pull reads its response once the request is sent */
+	bool pipeline_push (std::shared_ptr<vxldollar::bulk_pull_client> const &);
+	/** Called once a pull request has been sent. Makes the connection available for another pull if the peer supports pipelining and there is room */
+	void pipeline_sent ();
+	/**
+	 * Called when the pull reading from the socket is done. If \p reuse_a, the next pull in flight starts reading its response.
+	 * Otherwise the position in the response stream is unknown, so the remaining pulls are dropped (and requeued) and the socket is closed.
+	 */
+	void pipeline_pop (vxldollar::bulk_pull_client const *, bool reuse_a);
+	/** Returns the connection to the idle pool, or to the pipelined pool while pulls are in flight */
+	void pool ();
 	std::shared_ptr<vxldollar::node> node;
 	vxldollar::bootstrap_connections & connections;
 	std::shared_ptr<vxldollar::transport::channel_tcp> channel;
@@ -40,10 +52,22 @@ public:
 	std::atomic<double> block_rate{ 0 };
 	std::atomic<bool> pending_stop{ false };
 	std::atomic<bool> hard_stop{ false };
+	/** Set if the peer accepts several bulk_pull requests in flight, negotiated from the version of its realtime channel */
+	bool pipelining{ false };
+	/** Set if the peer serves compact bulk_pull responses, negotiated the same way */
+	bool compact{ false };
 
 private:
 	mutable vxldollar::mutex start_time_mutex;
 	std::chrono::steady_clock::time_point start_time_m;
+	vxldollar::mutex pipeline_mutex;
+	/**
+	 * Pulls sent on this connection and not done yet, in request order. The front pull reads from the socket and is kept alive by its own
+	 * callbacks, the others are owned here until it is their turn.
+	 */
+	std::deque<std::pair<vxldollar::bulk_pull_client const *, std::shared_ptr<vxldollar::bulk_pull_client>>> pipeline;
+	/** Set once the pipeline made the connection available again, until the next pull is pushed */
+	bool pooled{ false };
 };
 
 /**
@@ -56,6 +80,8 @@ public:
 	explicit bootstrap_connections (vxldollar::node & node_a);
 	std::shared_ptr<vxldollar::bootstrap_client> connection (std::shared_ptr<vxldollar::bootstrap_attempt> const & attempt_a = nullptr, bool use_front_connection = false);
 	void pool_connection (std::shared_ptr<vxldollar::bootstrap_client> const & client_a, bool new_client = false, bool push_front = false);
+	/** Makes a connection with pulls in flight available for more pulls. Such connections are only used by request_pull */
+	void pool_pipelined (std::shared_ptr<vxldollar::bootstrap_client> const & client_a);
 	void add_connection (vxldollar::endpoint const & endpoint_a);
 	std::shared_ptr<vxldollar::bootstrap_client> find_connection (vxldollar::tcp_endpoint const & endpoint_a);
 	void connect_client (vxldollar::tcp_endpoint const & endpoint_a, bool push_front = false);
@@ -72,6 +98,7 @@ public:
 	std::atomic<unsigned> connections_count{ 0 };
 	vxldollar::node & node;
 	std::deque<std::shared_ptr<vxldollar::bootstrap_client>> idle;
+	std::deque<std::shared_ptr<vxldollar::bootstrap_client>> pipelined;
 	std::deque<vxldollar::pull_info> pulls;
 	std::atomic<bool> populate_connections_started{ false };
 	std::atomic<bool> new_connections_empty{ false };
@@ -2,6 +2,7 @@
 
 #include <vxldollar/node/common.hpp>
 
+#include <atomic>
 #include <deque>
 #include <future>
 
@@ -17,7 +18,8 @@ class frontier_req_client final : public std::enable_shared_from_this<vxldollar:
 {
 public:
 	explicit frontier_req_client (std::shared_ptr<vxldollar::bootstrap_client> const &, std::shared_ptr<vxldollar::bootstrap_attempt> const &);
-	void run (vxldollar::account const & start_account_a, uint32_t const frontiers_age_a, uint32_t const count_a);
+	/** Requests frontiers of the accounts after \p start_account_a, up to and including \p end_account_a */
+	void run (vxldollar::account const & start_account_a, vxldollar::account const & end_account_a, uint32_t const frontiers_age_a, uint32_t const count_a);
 	void receive_frontier ();
 	void received_frontier (boost::system::error_code const &, std::size_t);
 	bool bulk_push_available ();
@@ -27,8 +29,10 @@ public:
 	std::shared_ptr<vxldollar::bootstrap_attempt> attempt;
 	vxldollar::account current;
 	vxldollar::block_hash frontier;
-	unsigned count;
+	std::atomic<unsigned> count{ 0 };
 	vxldollar::account last_account{ std::numeric_limits<vxldollar::uint256_t>::max () }; // Using last possible account stop further frontier requests
+	/** Last account of the requested range, the server is not bounded so later frontiers are ignored */
+	vxldollar::account end_account{ std::numeric_limits<vxldollar::uint256_t>::max () };
 	std::chrono::steady_clock::time_point start_time;
 	std::promise<bool> promise;
 	/** A very rough estimate of the cost of `bulk_push`ing missing blocks */
@@ -13,6 +13,27 @@ namespace vxldollar
 {
 class node;
 
+/**
+ * Part of the account space whose frontiers are requested from one peer: the accounts after \p start, up to and including \p end.
+ * \p start moves forward as frontiers are received, the range is complete once it reaches \p end.
+ */
+class frontier_range final
+{
+public:
+	frontier_range (vxldollar::account const &, vxldollar::account const &);
+	bool complete () const;
+	/** Estimate of the share of the range received so far, in percent */
+	double progress () const;
+	vxldollar::account const begin;
+	vxldollar::account start;
+	vxldollar::account const end;
+	unsigned requests{ 0 };
+	vxldollar::tcp_endpoint endpoint;
+	std::weak_ptr<vxldollar::frontier_req_client> client;
+	/** Valid while a request for this range is in flight */
+	std::future<bool> future;
+};
+
 /**
  * Legacy bootstrap session. This is made up of 3 phases: frontier requests, bootstrap pulls, bootstrap pushes.
  */
@@ -23,7 +44,10 @@ public:
 	void run () override;
 	bool consume_future (std::future<bool> &);
 	void stop () override;
-	bool request_frontier (vxldollar::unique_lock<vxldollar::mutex> &, bool = false);
+	void request_frontier (vxldollar::unique_lock<vxldollar::mutex> &, vxldollar::frontier_range &, bool = false);
+	bool frontier_finished (vxldollar::unique_lock<vxldollar::mutex> &, vxldollar::frontier_range &);
+	/** Moves frontier pulls received so far to the pull queue */
+	void flush_frontier_pulls (vxldollar::unique_lock<vxldollar::mutex> &);
 	void request_push (vxldollar::unique_lock<vxldollar::mutex> &);
 	void add_frontier (vxldollar::pull_info const &) override;
 	void add_bulk_push_target (vxldollar::block_hash const &, vxldollar::block_hash const &) override;
@@ -32,7 +56,8 @@ public:
 	void run_start (vxldollar::unique_lock<vxldollar::mutex> &);
 	void get_information (boost::property_tree::ptree &) override;
 	vxldollar::tcp_endpoint endpoint_frontier_request;
-	std::weak_ptr<vxldollar::frontier_req_client> frontiers;
+	/** Ordered, disjoint ranges covering the accounts after start_account, requested in parallel */
+	std::vector<vxldollar::frontier_range> frontier_ranges;
 	std::weak_ptr<vxldollar::bulk_push_client> push;
 	std::deque<vxldollar::pull_info> frontier_pulls;
 	std::vector<std::pair<vxldollar::block_hash, vxldollar::block_hash>> bulk_push_targets;
@@ -0,0 +1,114 @@
+#include <vxldollar/node/bootstrap/bootstrap.hpp>
+#include <vxldollar/node/bootstrap/bootstrap_priority.hpp>
+#include <vxldollar/node/node.hpp>
+
+#include <boost/format.hpp>
+
+constexpr unsigned vxldollar::bootstrap_limits::priority_pulls_max;
+constexpr std::chrono::seconds vxldollar::bootstrap_limits::priority_idle_timeout;
+
+vxldollar::bootstrap_attempt_priority::bootstrap_attempt_priority (std::shared_ptr<vxldollar::node> const & node_a, uint64_t incremental_id_a, std::string const & id_a) :
+	vxldollar::bootstrap_attempt (node_a, vxldollar::bootstrap_mode::priority, incremental_id_a, id_a)
+{
+}
+
+bool vxldollar::bootstrap_attempt_priority::request (vxldollar::unique_lock<vxldollar::mutex> & lock_a)
+{
+	lock_a.unlock ();
+	auto key (node->bootstrap_initiator.priorities.next ());
+	auto result (!key.is_zero ());
+	if (result)
+	{
+		auto transaction (node->store.tx_begin_read ());
+		// Keys are either block hashes or accounts, gaps in accounts already in the ledger are scored by the missing block hash
+		if (node->ledger.block_or_pruned_exists (transaction, key.as_block_hash ()))
+		{
+			// Received since it was scored, e.g. from the live network
+			node->bootstrap_initiator.priorities.erase (key);
+			++satisfied;
+		}
+		else
+		{
+			// Accounts already in the ledger are pulled from the remote head down to the local head
+			vxldollar::account_info info;
+			auto end (node->store.account.get (transaction, key.as_account (), info) ? vxldollar::block_hash (0) : info.head);
+			// Either may be a long chain, it is pulled in batches which continue from the last block received
+			// Remote heads are unknown, the pulls are not requeued on failure, the entry is picked again while its score lasts
+			node->bootstrap_initiator.connections->add_pull (vxldollar::pull_info (key, vxldollar::block_hash (0), end, incremental_id, node->network_params.bootstrap.lazy_max_pull_blocks, 0));
+			++pulling;
+			++requests;
+			node->stats.inc (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull, vxldollar::stat::dir::out);
+		}
+	}
+	lock_a.lock ();
+	return result;
+}
+
+void vxldollar::bootstrap_attempt_priority::run ()
+{
+	debug_assert (started);
+	debug_assert (node->flags.enable_priority_bootstrap);
+	node->bootstrap_initiator.connections->populate_connections (false);
+	auto idle_start (std::chrono::steady_clock::now ());
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	while (!stopped && (pulling > 0 || std::chrono::steady_clock::now () - idle_start < vxldollar::bootstrap_limits::priority_idle_timeout))
+	{
+		auto requested (pulling < vxldollar::bootstrap_limits::priority_pulls_max && request (lock));
+		if (!requested)
+		{
+			// Woken up by finished pulls and by bootstrap_initiator::bootstrap_priority
+			condition.wait_for (lock, std::chrono::seconds (1));
+		}
+		if (requested || pulling > 0)
+		{
+			idle_start = std::chrono::steady_clock::now ();
+		}
+	}
+	if (!stopped)
+	{
+		node->logger.try_log (boost::str (boost::format ("Completed priority pulls, %1% requests") % requests));
+	}
+	lock.unlock ();
+	stop ();
+	condition.notify_all ();
+}
+
+bool vxldollar::bootstrap_attempt_priority::process_block (std::shared_ptr<vxldollar::block> const & block_a, vxldollar::account const & known_account_a, uint64_t pull_blocks_processed, vxldollar::bulk_pull::count_t max_blocks, bool block_expected, unsigned retry_limit)
+{
+	bool stop_pull (false);
+	// Pulls started from a block hash have no end, stop once the ledger is reached
+	if (node->ledger.block_or_pruned_exists (block_a->hash ()))
+	{
+		stop_pull = true;
+	}
+	else
+	{
+		vxldollar::unchecked_info info (block_a, known_account_a, vxldollar::signature_verification::unknown);
+		node->block_processor.add (info);
+		if (max_blocks != 0 && pull_blocks_processed >= max_blocks && !block_a->previous ().is_zero ())
+		{
+			// Batch ended before reaching the ledger
+			node->bootstrap_initiator.priorities.raise (block_a->previous ());
+		}
+	}
+	return stop_pull;
+}
+
+void vxldollar::bootstrap_attempt_priority::priority_pull_finished (vxldollar::pull_info const & pull_a, bool success_a)
+{
+	if (success_a)
+	{
+		node->bootstrap_initiator.priorities.pull_succeeded (pull_a.account_or_head);
+	}
+	else
+	{
+		node->bootstrap_initiator.priorities.pull_failed (pull_a.account_or_head);
+	}
+}
+
+void vxldollar::bootstrap_attempt_priority::get_information (boost::property_tree::ptree & tree_a)
+{
+	tree_a.put ("priorities", std::to_string (node->bootstrap_initiator.priorities.size ()));
+	tree_a.put ("requests", std::to_string (requests));
+	tree_a.put ("satisfied", std::to_string (satisfied));
+}
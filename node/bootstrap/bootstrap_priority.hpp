@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vxldollar/node/bootstrap/bootstrap_attempt.hpp>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <atomic>
+
+namespace vxldollar
+{
+class node;
+
+/**
+ * Priority bootstrap session. Continuously pulls the highest scored entries of bootstrap_initiator::priorities, so that accounts
+ * with recent unconfirmed activity are bootstrapped first. Accounts missing from the ledger and block hashes are pulled in batches down to the ledger.
+ * Runs on its own thread, the session ends once no entry was ready for bootstrap_limits::priority_idle_timeout.
+ */
+class bootstrap_attempt_priority final : public bootstrap_attempt
+{
+public:
+	explicit bootstrap_attempt_priority (std::shared_ptr<vxldollar::node> const & node_a, uint64_t incremental_id_a, std::string const & id_a = "");
+	void run () override;
+	bool process_block (std::shared_ptr<vxldollar::block> const &, vxldollar::account const &, uint64_t, vxldollar::bulk_pull::count_t, bool, unsigned) override;
+	void priority_pull_finished (vxldollar::pull_info const &, bool) override;
+	void get_information (boost::property_tree::ptree &) override;
+	/** @return false if no entry was ready */
+	bool request (vxldollar::unique_lock<vxldollar::mutex> &);
+	std::atomic<uint64_t> requests{ 0 };
+	/** Entries which were already in the ledger when picked */
+	std::atomic<uint64_t> satisfied{ 0 };
+};
+}
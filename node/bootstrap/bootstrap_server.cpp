@@ -490,15 +490,30 @@ void vxldollar::bootstrap_server::receive_confirm_req_action (boost::system::err
 {
 	if (!ec)
 	{
-		auto error (false);
-		vxldollar::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<vxldollar::confirm_req> (error, stream, header_a));
-		if (!error)
+		vxldollar::uint128_t digest{ 0 };
+		// Identical requests from different peers all need a reply, so the digest is salted with the sender
+		auto salt (std::hash<vxldollar::tcp_endpoint> () (remote_endpoint));
+		if (!is_realtime_connection () || !node->network.confirm_req_filter.apply (receive_buffer->data (), size_a, &digest, salt))
 		{
-			if (is_realtime_connection ())
+			auto error (false);
+			vxldollar::bufferstream stream (receive_buffer->data (), size_a);
+			auto request (std::make_unique<vxldollar::confirm_req> (error, stream, header_a, nullptr, digest));
+			if (!error)
 			{
-				add_request (std::unique_ptr<vxldollar::message> (request.release ()));
+				if (is_realtime_connection ())
+				{
+					add_request (std::unique_ptr<vxldollar::message> (request.release ()));
+				}
+				receive ();
+			}
+			else if (digest != 0)
+			{
+				node->network.confirm_req_filter.clear (digest);
 			}
+		}
+		else
+		{
+			node->stats.inc (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_confirm_req);
 			receive ();
 		}
 	}
@@ -512,34 +527,48 @@ void vxldollar::bootstrap_server::receive_confirm_ack_action (boost::system::err
 {
 	if (!ec)
 	{
-		auto error (false);
-		vxldollar::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<vxldollar::confirm_ack> (error, stream, header_a));
-		if (!error)
+		vxldollar::uint128_t digest{ 0 };
+		// Votes of peers queried by the rep crawler are not filtered, a reply may repeat a vote received before the query
+		if (!is_realtime_connection () || node->rep_crawler.is_queried (remote_endpoint.address ()) || !node->network.vote_filter.apply (receive_buffer->data (), size_a, &digest))
 		{
-			if (is_realtime_connection ())
+			auto error (false);
+			vxldollar::bufferstream stream (receive_buffer->data (), size_a);
+			auto request (std::make_unique<vxldollar::confirm_ack> (error, stream, header_a, nullptr, digest));
+			if (!error)
 			{
-				bool process_vote (true);
-				if (header_a.block_type () != vxldollar::block_type::not_a_block)
+				if (is_realtime_connection ())
 				{
-					for (auto & vote_block : request->vote->blocks)
+					bool process_vote (true);
+					if (header_a.block_type () != vxldollar::block_type::not_a_block)
 					{
-						if (!vote_block.which ())
+						for (auto & vote_block : request->vote->blocks)
 						{
-							auto const & block (boost::get<std::shared_ptr<vxldollar::block>> (vote_block));
-							if (node->network_params.work.validate_entry (*block))
+							if (!vote_block.which ())
 							{
-								process_vote = false;
-								node->stats.inc_detail_only (vxldollar::stat::type::error, vxldollar::stat::detail::insufficient_work);
+								auto const & block (boost::get<std::shared_ptr<vxldollar::block>> (vote_block));
+								if (node->network_params.work.validate_entry (*block))
+								{
+									process_vote = false;
+									node->stats.inc_detail_only (vxldollar::stat::type::error, vxldollar::stat::detail::insufficient_work);
+								}
 							}
 						}
 					}
+					if (process_vote)
+					{
+						add_request (std::unique_ptr<vxldollar::message> (request.release ()));
+					}
 				}
-				if (process_vote)
-				{
-					add_request (std::unique_ptr<vxldollar::message> (request.release ()));
-				}
+				receive ();
 			}
+			else if (digest != 0)
+			{
+				node->network.vote_filter.clear (digest);
+			}
+		}
+		else
+		{
+			node->stats.inc (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_confirm_ack);
 			receive ();
 		}
 	}
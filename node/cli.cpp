@@ -1,10 +1,13 @@
 #include <vxldollar/lib/cli.hpp>
+#include <vxldollar/lib/timer.hpp>
 #include <vxldollar/lib/tlsconfig.hpp>
 #include <vxldollar/lib/tomlconfig.hpp>
 #include <vxldollar/node/cli.hpp>
 #include <vxldollar/node/common.hpp>
 #include <vxldollar/node/daemonconfig.hpp>
+#include <vxldollar/node/ledger_snapshot.hpp>
 #include <vxldollar/node/node.hpp>
+#include <vxldollar/node/rocksdb/rocksdb.hpp>
 
 #include <boost/format.hpp>
 
@@ -51,6 +54,10 @@ void vxldollar::add_node_options (boost::program_options::options_description &
 	("account_key", "Get the public key for <account>")
 	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted.")
 	("snapshot", "Compact database and create snapshot, functions similar to vacuum but does not replace the existing database")
+	("ledger_export", "Write account chains, pending entries and confirmation heights to <file>, for use with --ledger_import")
+	("ledger_import", "Verify and load a ledger written by --ledger_export from <file>. The ledger must be empty or only hold the genesis block")
+	("ledger_backup", "Copy the LMDB ledger into the <file> directory, also while a node is running on it. RocksDB ledgers are backed up with the ledger_backup RPC")
+	("max_bytes_per_second", boost::program_options::value<uint64_t> (), "Limits the copy rate of --ledger_backup")
 	("data_path", boost::program_options::value<std::string> (), "Use the supplied path as the data directory")
 	("network", boost::program_options::value<std::string> (), "Use the supplied network (live, test, beta or dev)")
 	("clear_send_ids", "Remove all send IDs from the database (dangerous: not intended for production use)")
@@ -61,6 +68,7 @@ void vxldollar::add_node_options (boost::program_options::options_description &
 	("final_vote_clear", "Clear final votes")
 	("rebuild_database", "Rebuild LMDB database with vacuum for best compaction")
 	("migrate_database_lmdb_to_rocksdb", "Migrates LMDB database to RocksDB")
+	("compact_blocks", "Rewrite the RocksDB blocks table with the configured compression. With rocksdb.dictionary_bytes set, zstd trains a dictionary on samples of each rewritten file")
 	("diagnostics", "Run internal diagnostics")
 	("generate_config", boost::program_options::value<std::string> (), "Write configuration to stdout, populated with defaults suitable for this system. Pass the configuration type node, rpc or tls. See also use_defaults.")
 	("key_create", "Generates a adhoc random keypair and prints it to stdout")
@@ -96,6 +104,8 @@ void vxldollar::add_node_flag_options (boost::program_options::options_descripti
 		("disable_backup", "Disable wallet automatic backups")
 		("disable_lazy_bootstrap", "Disables lazy bootstrap")
 		("disable_legacy_bootstrap", "Disables legacy bootstrap")
+		("disable_bootstrap_pipelining", "Disables sending several bulk_pull requests at once on a bootstrap connection")
+		("disable_bootstrap_compact", "Disables requesting compact bulk_pull responses, which leave out fields repeated within an account chain")
 		("disable_wallet_bootstrap", "Disables wallet lazy bootstrap")
 		("disable_ongoing_bootstrap", "Disable ongoing bootstrap")
 		("disable_rep_crawler", "Disable rep crawler")
@@ -109,6 +119,7 @@ void vxldollar::add_node_flag_options (boost::program_options::options_descripti
 		("disable_providing_telemetry_metrics", "Disable using any node information in the telemetry_ack messages.")
 		("disable_block_processor_unchecked_deletion", "Disable deletion of unchecked blocks after processing")
 		("enable_pruning", "Enable experimental ledger pruning")
+		("enable_priority_bootstrap", "Enables bootstrap of accounts and blocks seen in unconfirmed activity, ordered by how often they were seen")
 		("allow_bootstrap_peers_duplicates", "Allow multiple connections to same peer in bootstrap attempts")
 		("fast_bootstrap", "Increase bootstrap speed for high end nodes with higher limits")
 		("block_processor_batch_size", boost::program_options::value<std::size_t>(), "Increase block processor transaction batch write size, default 0 (limited by config block_processor_batch_max_time), 256k for fast_bootstrap")
@@ -116,6 +127,7 @@ void vxldollar::add_node_flag_options (boost::program_options::options_descripti
 		("block_processor_verification_size", boost::program_options::value<std::size_t>(), "Increase batch signature verification size in block processor, default 0 (limited by config signature_checker_threads), unlimited for fast_bootstrap")
 		("inactive_votes_cache_size", boost::program_options::value<std::size_t>(), "Increase cached votes without active elections size, default 16384")
 		("vote_processor_capacity", boost::program_options::value<std::size_t>(), "Vote processor queue size before dropping votes, default 144k")
+		("record_traffic", boost::program_options::value<std::string>(), "Record inbound realtime messages to the given file, for use with --debug_traffic_replay")
 		;
 	// clang-format on
 }
@@ -127,6 +139,8 @@ std::error_code vxldollar::update_flags (vxldollar::node_flags & flags_a, boost:
 	flags_a.disable_backup = (vm.count ("disable_backup") > 0);
 	flags_a.disable_lazy_bootstrap = (vm.count ("disable_lazy_bootstrap") > 0);
 	flags_a.disable_legacy_bootstrap = (vm.count ("disable_legacy_bootstrap") > 0);
+	flags_a.disable_bootstrap_pipelining = (vm.count ("disable_bootstrap_pipelining") > 0);
+	flags_a.disable_bootstrap_compact = (vm.count ("disable_bootstrap_compact") > 0);
 	flags_a.disable_wallet_bootstrap = (vm.count ("disable_wallet_bootstrap") > 0);
 	flags_a.disable_ongoing_bootstrap = (vm.count ("disable_ongoing_bootstrap") > 0);
 	flags_a.disable_rep_crawler = (vm.count ("disable_rep_crawler") > 0);
@@ -150,6 +164,7 @@ std::error_code vxldollar::update_flags (vxldollar::node_flags & flags_a, boost:
 	flags_a.disable_unchecked_drop = (vm.count ("disable_unchecked_drop") > 0);
 	flags_a.disable_block_processor_unchecked_deletion = (vm.count ("disable_block_processor_unchecked_deletion") > 0);
 	flags_a.enable_pruning = (vm.count ("enable_pruning") > 0);
+	flags_a.enable_priority_bootstrap = (vm.count ("enable_priority_bootstrap") > 0);
 	flags_a.allow_bootstrap_peers_duplicates = (vm.count ("allow_bootstrap_peers_duplicates") > 0);
 	flags_a.fast_bootstrap = (vm.count ("fast_bootstrap") > 0);
 	if (flags_a.fast_bootstrap)
@@ -184,6 +199,11 @@ std::error_code vxldollar::update_flags (vxldollar::node_flags & flags_a, boost:
 	{
 		flags_a.vote_processor_capacity = vote_processor_capacity_it->second.as<std::size_t> ();
 	}
+	auto record_traffic_it = vm.find ("record_traffic");
+	if (record_traffic_it != vm.end ())
+	{
+		flags_a.record_traffic_path = record_traffic_it->second.as<std::string> ();
+	}
 	// Config overriding
 	auto config (vm.find ("config"));
 	if (config != vm.end ())
@@ -471,6 +491,123 @@ std::error_code vxldollar::handle_node_options (boost::program_options::variable
 			std::cerr << "Snapshot failed (unknown reason)" << std::endl;
 		}
 	}
+	else if (vm.count ("ledger_export"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			auto node_flags = vxldollar::inactive_node_flag_defaults ();
+			vxldollar::update_flags (node_flags, vm);
+			vxldollar::inactive_node node (data_path, node_flags);
+			auto & node_l (*node.node);
+			if (!node_l.init_error ())
+			{
+				std::cout << "Exporting ledger, this may take a while..." << std::endl;
+				vxldollar::ledger_export exporter (node_l.store, node_l.network_params);
+				auto error (exporter.run (vm["file"].as<std::string> ()));
+				if (!error)
+				{
+					std::cout << boost::str (boost::format ("Exported %1% accounts, %2% blocks, %3% pending entries and %4% frontiers\n") % exporter.accounts % exporter.blocks % exporter.pending % exporter.frontiers);
+				}
+				else
+				{
+					std::cerr << "Ledger export failed: " << error.get_message () << std::endl;
+					ec = vxldollar::error_cli::generic;
+				}
+			}
+			else
+			{
+				ec = vxldollar::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "ledger_export requires one <file> option\n";
+			ec = vxldollar::error_cli::invalid_arguments;
+		}
+	}
+	else if (vm.count ("ledger_backup"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			auto node_flags = vxldollar::inactive_node_flag_defaults ();
+			vxldollar::update_flags (node_flags, vm);
+			vxldollar::inactive_node node (data_path, node_flags);
+			auto & node_l (*node.node);
+			if (!node_l.init_error ())
+			{
+				if (dynamic_cast<vxldollar::rocksdb_store *> (node_l.store_impl.get ()) == nullptr)
+				{
+					auto max_bytes_per_second (vm.count ("max_bytes_per_second") ? vm["max_bytes_per_second"].as<uint64_t> () : 0);
+					node_l.ledger_backup.start (vm["file"].as<std::string> (), max_bytes_per_second);
+					auto status (node_l.ledger_backup.get_status ());
+					while (status.running)
+					{
+						std::this_thread::sleep_for (std::chrono::seconds (1));
+						status = node_l.ledger_backup.get_status ();
+						std::cout << boost::str (boost::format ("\r%1% of at most %2% MB copied") % (status.bytes_copied / (1024 * 1024)) % (status.bytes_total / (1024 * 1024))) << std::flush;
+					}
+					if (status.success.value_or (false))
+					{
+						std::cout << boost::str (boost::format ("\nBackup completed in %1% seconds\n") % status.duration.count ());
+					}
+					else
+					{
+						std::cerr << "\nLedger backup failed" << std::endl;
+						ec = vxldollar::error_cli::generic;
+					}
+				}
+				else
+				{
+					std::cerr << "ledger_backup requires the LMDB backend, use the ledger_backup RPC to back up a RocksDB ledger" << std::endl;
+					ec = vxldollar::error_cli::invalid_arguments;
+				}
+			}
+			else
+			{
+				ec = vxldollar::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "ledger_backup requires one <file> option\n";
+			ec = vxldollar::error_cli::invalid_arguments;
+		}
+	}
+	else if (vm.count ("ledger_import"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			auto node_flags = vxldollar::inactive_node_flag_defaults ();
+			node_flags.read_only = false;
+			vxldollar::update_flags (node_flags, vm);
+			vxldollar::inactive_node node (data_path, node_flags);
+			auto & node_l (*node.node);
+			if (!node_l.init_error ())
+			{
+				std::cout << "Importing ledger, this may take a while..." << std::endl;
+				vxldollar::ledger_import importer (node_l.store, node_l.network_params);
+				auto error (importer.run (vm["file"].as<std::string> ()));
+				if (!error)
+				{
+					std::cout << boost::str (boost::format ("Imported %1% accounts, %2% blocks, %3% pending entries and %4% frontiers\n") % importer.accounts % importer.blocks % importer.pending % importer.frontiers);
+				}
+				else
+				{
+					std::cerr << "Ledger import failed: " << error.get_message () << std::endl;
+					ec = vxldollar::error_cli::database_write_error;
+				}
+			}
+			else
+			{
+				ec = vxldollar::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "ledger_import requires one <file> option\n";
+			ec = vxldollar::error_cli::invalid_arguments;
+		}
+	}
 	else if (vm.count ("migrate_database_lmdb_to_rocksdb"))
 	{
 		auto data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : vxldollar::working_path ();
@@ -481,8 +618,10 @@ std::error_code vxldollar::handle_node_options (boost::program_options::variable
 		auto error (false);
 		if (!node.node->init_error ())
 		{
-			std::cout << "Migrating LMDB database to RocksDB, might take a while..." << std::endl;
-			error = node.node->ledger.migrate_lmdb_to_rocksdb (data_path);
+			std::cout << "Migrating LMDB database to RocksDB, might take a while. An interrupted migration continues when run again" << std::endl;
+			error = node.node->ledger.migrate_lmdb_to_rocksdb (data_path, [] (std::string const & message_a) {
+				std::cout << message_a << std::endl;
+			});
 		}
 		else
 		{
@@ -498,6 +637,43 @@ std::error_code vxldollar::handle_node_options (boost::program_options::variable
 			std::cerr << "There was an error migrating" << std::endl;
 		}
 	}
+	else if (vm.count ("compact_blocks"))
+	{
+		auto data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : vxldollar::working_path ();
+		auto node_flags = vxldollar::inactive_node_flag_defaults ();
+		node_flags.read_only = false;
+		vxldollar::update_flags (node_flags, vm);
+		vxldollar::inactive_node node (data_path, node_flags);
+		if (!node.node->init_error ())
+		{
+			auto rocksdb_store (dynamic_cast<vxldollar::rocksdb_store *> (node.node->store_impl.get ()));
+			if (rocksdb_store != nullptr)
+			{
+				std::cout << "Compacting blocks table, might take a while..." << std::endl;
+				auto size_before (rocksdb_store->table_file_size (vxldollar::tables::blocks));
+				vxldollar::timer<std::chrono::seconds> timer;
+				timer.start ();
+				if (!rocksdb_store->compact (vxldollar::tables::blocks))
+				{
+					auto size_after (rocksdb_store->table_file_size (vxldollar::tables::blocks));
+					std::cout << boost::str (boost::format ("Blocks table compacted in %1% seconds from %2% to %3% bytes\n") % timer.stop ().count () % size_before % size_after);
+				}
+				else
+				{
+					std::cerr << "There was an error compacting the blocks table" << std::endl;
+				}
+			}
+			else
+			{
+				std::cerr << "compact_blocks requires the RocksDB backend" << std::endl;
+				ec = vxldollar::error_cli::invalid_arguments;
+			}
+		}
+		else
+		{
+			database_write_lock_error (ec);
+		}
+	}
 	else if (vm.count ("unchecked_clear"))
 	{
 		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : vxldollar::working_path ();
@@ -129,6 +129,43 @@ std::string vxldollar::message_type_to_string (vxldollar::message_type message_t
 	return "n/a";
 }
 
+vxldollar::stat::detail vxldollar::message_type_to_stat_detail (vxldollar::message_type message_type_l)
+{
+	auto result (vxldollar::stat::detail::all);
+	switch (message_type_l)
+	{
+		case vxldollar::message_type::keepalive:
+			result = vxldollar::stat::detail::keepalive;
+			break;
+		case vxldollar::message_type::publish:
+			result = vxldollar::stat::detail::publish;
+			break;
+		case vxldollar::message_type::confirm_req:
+			result = vxldollar::stat::detail::confirm_req;
+			break;
+		case vxldollar::message_type::confirm_ack:
+			result = vxldollar::stat::detail::confirm_ack;
+			break;
+		case vxldollar::message_type::node_id_handshake:
+			result = vxldollar::stat::detail::node_id_handshake;
+			break;
+		case vxldollar::message_type::telemetry_req:
+			result = vxldollar::stat::detail::telemetry_req;
+			break;
+		case vxldollar::message_type::telemetry_ack:
+			result = vxldollar::stat::detail::telemetry_ack;
+			break;
+		case vxldollar::message_type::invalid:
+		case vxldollar::message_type::not_a_type:
+		case vxldollar::message_type::bulk_pull:
+		case vxldollar::message_type::bulk_push:
+		case vxldollar::message_type::frontier_req:
+		case vxldollar::message_type::bulk_pull_account:
+			break;
+	}
+	return result;
+}
+
 std::string vxldollar::message_header::to_string ()
 {
 	// Cast to uint16_t to get integer value since uint8_t is treated as an unsigned char in string formatting.
@@ -366,6 +403,14 @@ std::string vxldollar::message_parser::status_string ()
 		{
 			return "duplicate_publish_message";
 		}
+		case vxldollar::message_parser::parse_status::duplicate_confirm_req_message:
+		{
+			return "duplicate_confirm_req_message";
+		}
+		case vxldollar::message_parser::parse_status::duplicate_confirm_ack_message:
+		{
+			return "duplicate_confirm_ack_message";
+		}
 	}
 
 	debug_assert (false);
@@ -373,8 +418,11 @@ std::string vxldollar::message_parser::status_string ()
 	return "[unknown parse_status]";
 }
 
-vxldollar::message_parser::message_parser (vxldollar::network_filter & publish_filter_a, vxldollar::block_uniquer & block_uniquer_a, vxldollar::vote_uniquer & vote_uniquer_a, vxldollar::message_visitor & visitor_a, vxldollar::work_pool & pool_a, vxldollar::network_constants const & network) :
+vxldollar::message_parser::message_parser (vxldollar::network_filter & publish_filter_a, vxldollar::block_uniquer & block_uniquer_a, vxldollar::vote_uniquer & vote_uniquer_a, vxldollar::message_visitor & visitor_a, vxldollar::work_pool & pool_a, vxldollar::network_constants const & network, vxldollar::network_filter * vote_filter_a, vxldollar::network_filter * confirm_req_filter_a, uint64_t salt_a) :
 	publish_filter (publish_filter_a),
+	vote_filter (vote_filter_a),
+	confirm_req_filter (confirm_req_filter_a),
+	salt (salt_a),
 	block_uniquer (block_uniquer_a),
 	vote_uniquer (vote_uniquer_a),
 	visitor (visitor_a),
@@ -423,12 +471,28 @@ void vxldollar::message_parser::deserialize_buffer (uint8_t const * buffer_a, st
 					}
 					case vxldollar::message_type::confirm_req:
 					{
-						deserialize_confirm_req (stream, header);
+						vxldollar::uint128_t digest{ 0 };
+						if (confirm_req_filter == nullptr || !confirm_req_filter->apply (buffer_a + header.size, size_a - header.size, &digest, salt))
+						{
+							deserialize_confirm_req (stream, header, digest);
+						}
+						else
+						{
+							status = parse_status::duplicate_confirm_req_message;
+						}
 						break;
 					}
 					case vxldollar::message_type::confirm_ack:
 					{
-						deserialize_confirm_ack (stream, header);
+						vxldollar::uint128_t digest{ 0 };
+						if (vote_filter == nullptr || !vote_filter->apply (buffer_a + header.size, size_a - header.size, &digest))
+						{
+							deserialize_confirm_ack (stream, header, digest);
+						}
+						else
+						{
+							status = parse_status::duplicate_confirm_ack_message;
+						}
 						break;
 					}
 					case vxldollar::message_type::node_id_handshake:
@@ -496,10 +560,10 @@ void vxldollar::message_parser::deserialize_publish (vxldollar::stream & stream_
 	}
 }
 
-void vxldollar::message_parser::deserialize_confirm_req (vxldollar::stream & stream_a, vxldollar::message_header const & header_a)
+void vxldollar::message_parser::deserialize_confirm_req (vxldollar::stream & stream_a, vxldollar::message_header const & header_a, vxldollar::uint128_t const & digest_a)
 {
 	auto error (false);
-	vxldollar::confirm_req incoming (error, stream_a, header_a, &block_uniquer);
+	vxldollar::confirm_req incoming (error, stream_a, header_a, &block_uniquer, digest_a);
 	if (!error && at_end (stream_a))
 	{
 		if (incoming.block == nullptr || !network.work.validate_entry (*incoming.block))
@@ -517,10 +581,10 @@ void vxldollar::message_parser::deserialize_confirm_req (vxldollar::stream & str
 	}
 }
 
-void vxldollar::message_parser::deserialize_confirm_ack (vxldollar::stream & stream_a, vxldollar::message_header const & header_a)
+void vxldollar::message_parser::deserialize_confirm_ack (vxldollar::stream & stream_a, vxldollar::message_header const & header_a, vxldollar::uint128_t const & digest_a)
 {
 	auto error (false);
-	vxldollar::confirm_ack incoming (error, stream_a, header_a, &vote_uniquer);
+	vxldollar::confirm_ack incoming (error, stream_a, header_a, &vote_uniquer, digest_a);
 	if (!error && at_end (stream_a))
 	{
 		for (auto & vote_block : incoming.vote->blocks)
@@ -698,8 +762,9 @@ bool vxldollar::publish::operator== (vxldollar::publish const & other_a) const
 	return *block == *other_a.block;
 }
 
-vxldollar::confirm_req::confirm_req (bool & error_a, vxldollar::stream & stream_a, vxldollar::message_header const & header_a, vxldollar::block_uniquer * uniquer_a) :
-	message (header_a)
+vxldollar::confirm_req::confirm_req (bool & error_a, vxldollar::stream & stream_a, vxldollar::message_header const & header_a, vxldollar::block_uniquer * uniquer_a, vxldollar::uint128_t const & digest_a) :
+	message (header_a),
+	digest (digest_a)
 {
 	if (!error_a)
 	{
@@ -838,9 +903,10 @@ std::size_t vxldollar::confirm_req::size (vxldollar::block_type type_a, std::siz
 	return result;
 }
 
-vxldollar::confirm_ack::confirm_ack (bool & error_a, vxldollar::stream & stream_a, vxldollar::message_header const & header_a, vxldollar::vote_uniquer * uniquer_a) :
+vxldollar::confirm_ack::confirm_ack (bool & error_a, vxldollar::stream & stream_a, vxldollar::message_header const & header_a, vxldollar::vote_uniquer * uniquer_a, vxldollar::uint128_t const & digest_a) :
 	message (header_a),
-	vote (vxldollar::make_shared<vxldollar::vote> (error_a, stream_a, header.block_type ()))
+	vote (vxldollar::make_shared<vxldollar::vote> (error_a, stream_a, header.block_type ())),
+	digest (digest_a)
 {
 	if (!error_a && uniquer_a)
 	{
@@ -1044,6 +1110,16 @@ void vxldollar::bulk_pull::set_count_present (bool value_a)
 	header.extensions.set (count_present_flag, value_a);
 }
 
+bool vxldollar::bulk_pull::is_compact () const
+{
+	return header.extensions.test (compact_flag);
+}
+
+void vxldollar::bulk_pull::set_compact (bool value_a)
+{
+	header.extensions.set (compact_flag, value_a);
+}
+
 vxldollar::bulk_pull_account::bulk_pull_account (vxldollar::network_constants const & constants) :
 	message (constants, vxldollar::message_type::bulk_pull_account)
 {
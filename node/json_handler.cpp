@@ -338,6 +338,25 @@ vxldollar::block_hash vxldollar::json_handler::hash_impl (std::string search_tex
 	return result;
 }
 
+/** Decodes the "hashes" list up to the first invalid hash, so the blocks can be read in one batch. Returns true if an invalid hash was found */
+bool vxldollar::json_handler::hashes_impl (std::vector<std::string> & hash_texts_a, std::vector<vxldollar::block_hash> & hashes_a)
+{
+	bool result (false);
+	for (auto const & hashes : request.get_child ("hashes"))
+	{
+		std::string hash_text = hashes.second.data ();
+		vxldollar::block_hash hash;
+		if (hash.decode_hex (hash_text))
+		{
+			result = true;
+			break;
+		}
+		hash_texts_a.push_back (std::move (hash_text));
+		hashes_a.push_back (hash);
+	}
+	return result;
+}
+
 vxldollar::amount vxldollar::json_handler::threshold_optional_impl ()
 {
 	vxldollar::amount result (0);
@@ -1195,41 +1214,38 @@ void vxldollar::json_handler::blocks ()
 {
 	bool const json_block_l = request.get<bool> ("json_block", false);
 	boost::property_tree::ptree blocks;
+	std::vector<std::string> hash_texts;
+	std::vector<vxldollar::block_hash> hashes;
+	auto bad_hash (hashes_impl (hash_texts, hashes));
 	auto transaction (node.store.tx_begin_read ());
-	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
+	auto blocks_l (node.store.block.get_many (transaction, hashes));
+	for (std::size_t i (0), n (hashes.size ()); i < n && !ec; ++i)
 	{
-		if (!ec)
+		auto const & hash_text (hash_texts[i]);
+		auto const & block (blocks_l[i]);
+		if (block != nullptr)
 		{
-			std::string hash_text = hashes.second.data ();
-			vxldollar::block_hash hash;
-			if (!hash.decode_hex (hash_text))
+			if (json_block_l)
 			{
-				auto block (node.store.block.get (transaction, hash));
-				if (block != nullptr)
-				{
-					if (json_block_l)
-					{
-						boost::property_tree::ptree block_node_l;
-						block->serialize_json (block_node_l);
-						blocks.add_child (hash_text, block_node_l);
-					}
-					else
-					{
-						std::string contents;
-						block->serialize_json (contents);
-						blocks.put (hash_text, contents);
-					}
-				}
-				else
-				{
-					ec = vxldollar::error_blocks::not_found;
-				}
+				boost::property_tree::ptree block_node_l;
+				block->serialize_json (block_node_l);
+				blocks.add_child (hash_text, block_node_l);
 			}
 			else
 			{
-				ec = vxldollar::error_blocks::bad_hash_number;
+				std::string contents;
+				block->serialize_json (contents);
+				blocks.put (hash_text, contents);
 			}
 		}
+		else
+		{
+			ec = vxldollar::error_blocks::not_found;
+		}
+	}
+	if (!ec && bad_hash)
+	{
+		ec = vxldollar::error_blocks::bad_hash_number;
 	}
 	response_l.add_child ("blocks", blocks);
 	response_errors ();
@@ -1246,127 +1262,125 @@ void vxldollar::json_handler::blocks_info ()
 
 	boost::property_tree::ptree blocks;
 	boost::property_tree::ptree blocks_not_found;
+	std::vector<std::string> hash_texts;
+	std::vector<vxldollar::block_hash> hashes;
+	auto bad_hash (hashes_impl (hash_texts, hashes));
 	auto transaction (node.store.tx_begin_read ());
-	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
+	auto blocks_l (node.store.block.get_many (transaction, hashes));
+	for (std::size_t i (0), n (hashes.size ()); i < n && !ec; ++i)
 	{
-		if (!ec)
+		auto const & hash_text (hash_texts[i]);
+		auto const & hash (hashes[i]);
+		auto const & block (blocks_l[i]);
+		if (block != nullptr)
 		{
-			std::string hash_text = hashes.second.data ();
-			vxldollar::block_hash hash;
-			if (!hash.decode_hex (hash_text))
+			boost::property_tree::ptree entry;
+			vxldollar::account account (block->account ().is_zero () ? block->sideband ().account : block->account ());
+			entry.put ("block_account", account.to_account ());
+			bool error_or_pruned (false);
+			auto amount (node.ledger.amount_safe (transaction, hash, error_or_pruned));
+			if (!error_or_pruned)
 			{
-				auto block (node.store.block.get (transaction, hash));
-				if (block != nullptr)
+				entry.put ("amount", amount.convert_to<std::string> ());
+			}
+			auto balance (node.ledger.balance (transaction, hash));
+			entry.put ("balance", balance.convert_to<std::string> ());
+			entry.put ("height", std::to_string (block->sideband ().height));
+			entry.put ("local_timestamp", std::to_string (block->sideband ().timestamp));
+			entry.put ("successor", block->sideband ().successor.to_string ());
+			auto confirmed (node.ledger.block_confirmed (transaction, hash));
+			entry.put ("confirmed", confirmed);
+
+			if (json_block_l)
+			{
+				boost::property_tree::ptree block_node_l;
+				block->serialize_json (block_node_l);
+				entry.add_child ("contents", block_node_l);
+			}
+			else
+			{
+				std::string contents;
+				block->serialize_json (contents);
+				entry.put ("contents", contents);
+			}
+			if (block->type () == vxldollar::block_type::state)
+			{
+				auto subtype (vxldollar::state_subtype (block->sideband ().details));
+				entry.put ("subtype", subtype);
+			}
+			if (receivable || receive_hash)
+			{
+				auto destination (node.ledger.block_destination (transaction, *block));
+				if (destination.is_zero ())
 				{
-					boost::property_tree::ptree entry;
-					vxldollar::account account (block->account ().is_zero () ? block->sideband ().account : block->account ());
-					entry.put ("block_account", account.to_account ());
-					bool error_or_pruned (false);
-					auto amount (node.ledger.amount_safe (transaction, hash, error_or_pruned));
-					if (!error_or_pruned)
+					if (receivable)
 					{
-						entry.put ("amount", amount.convert_to<std::string> ());
+						entry.put ("pending", "0");
+						entry.put ("receivable", "0");
 					}
-					auto balance (node.ledger.balance (transaction, hash));
-					entry.put ("balance", balance.convert_to<std::string> ());
-					entry.put ("height", std::to_string (block->sideband ().height));
-					entry.put ("local_timestamp", std::to_string (block->sideband ().timestamp));
-					entry.put ("successor", block->sideband ().successor.to_string ());
-					auto confirmed (node.ledger.block_confirmed (transaction, hash));
-					entry.put ("confirmed", confirmed);
-
-					if (json_block_l)
+					if (receive_hash)
 					{
-						boost::property_tree::ptree block_node_l;
-						block->serialize_json (block_node_l);
-						entry.add_child ("contents", block_node_l);
+						entry.put ("receive_hash", vxldollar::block_hash (0).to_string ());
 					}
-					else
+				}
+				else if (node.store.pending.exists (transaction, vxldollar::pending_key (destination, hash)))
+				{
+					if (receivable)
 					{
-						std::string contents;
-						block->serialize_json (contents);
-						entry.put ("contents", contents);
+						entry.put ("pending", "1");
+						entry.put ("receivable", "1");
 					}
-					if (block->type () == vxldollar::block_type::state)
+					if (receive_hash)
 					{
-						auto subtype (vxldollar::state_subtype (block->sideband ().details));
-						entry.put ("subtype", subtype);
+						entry.put ("receive_hash", vxldollar::block_hash (0).to_string ());
 					}
-					if (receivable || receive_hash)
+				}
+				else
+				{
+					if (receivable)
 					{
-						auto destination (node.ledger.block_destination (transaction, *block));
-						if (destination.is_zero ())
-						{
-							if (receivable)
-							{
-								entry.put ("pending", "0");
-								entry.put ("receivable", "0");
-							}
-							if (receive_hash)
-							{
-								entry.put ("receive_hash", vxldollar::block_hash (0).to_string ());
-							}
-						}
-						else if (node.store.pending.exists (transaction, vxldollar::pending_key (destination, hash)))
-						{
-							if (receivable)
-							{
-								entry.put ("pending", "1");
-								entry.put ("receivable", "1");
-							}
-							if (receive_hash)
-							{
-								entry.put ("receive_hash", vxldollar::block_hash (0).to_string ());
-							}
-						}
-						else
-						{
-							if (receivable)
-							{
-								entry.put ("pending", "0");
-								entry.put ("receivable", "0");
-							}
-							if (receive_hash)
-							{
-								std::shared_ptr<vxldollar::block> receive_block = node.ledger.find_receive_block_by_send_hash (transaction, destination, hash);
-								std::string receive_hash = receive_block ? receive_block->hash ().to_string () : vxldollar::block_hash (0).to_string ();
-								entry.put ("receive_hash", receive_hash);
-							}
-						}
+						entry.put ("pending", "0");
+						entry.put ("receivable", "0");
 					}
-					if (source)
+					if (receive_hash)
 					{
-						vxldollar::block_hash source_hash (node.ledger.block_source (transaction, *block));
-						auto block_a (node.store.block.get (transaction, source_hash));
-						if (block_a != nullptr)
-						{
-							auto source_account (node.ledger.account (transaction, source_hash));
-							entry.put ("source_account", source_account.to_account ());
-						}
-						else
-						{
-							entry.put ("source_account", "0");
-						}
+						std::shared_ptr<vxldollar::block> receive_block = node.ledger.find_receive_block_by_send_hash (transaction, destination, hash);
+						std::string receive_hash = receive_block ? receive_block->hash ().to_string () : vxldollar::block_hash (0).to_string ();
+						entry.put ("receive_hash", receive_hash);
 					}
-					blocks.push_back (std::make_pair (hash_text, entry));
 				}
-				else if (include_not_found)
+			}
+			if (source)
+			{
+				vxldollar::block_hash source_hash (node.ledger.block_source (transaction, *block));
+				auto block_a (node.store.block.get (transaction, source_hash));
+				if (block_a != nullptr)
 				{
-					boost::property_tree::ptree entry;
-					entry.put ("", hash_text);
-					blocks_not_found.push_back (std::make_pair ("", entry));
+					auto source_account (node.ledger.account (transaction, source_hash));
+					entry.put ("source_account", source_account.to_account ());
 				}
 				else
 				{
-					ec = vxldollar::error_blocks::not_found;
+					entry.put ("source_account", "0");
 				}
 			}
-			else
-			{
-				ec = vxldollar::error_blocks::bad_hash_number;
-			}
+			blocks.push_back (std::make_pair (hash_text, entry));
+		}
+		else if (include_not_found)
+		{
+			boost::property_tree::ptree entry;
+			entry.put ("", hash_text);
+			blocks_not_found.push_back (std::make_pair ("", entry));
+		}
+		else
+		{
+			ec = vxldollar::error_blocks::not_found;
 		}
 	}
+	if (!ec && bad_hash)
+	{
+		ec = vxldollar::error_blocks::bad_hash_number;
+	}
 	if (!ec)
 	{
 		response_l.add_child ("blocks", blocks);
@@ -1895,6 +1909,17 @@ void vxldollar::json_handler::chain (bool successors)
 	{
 		boost::property_tree::ptree blocks;
 		auto transaction (node.store.tx_begin_read ());
+		if (offset > 0 && node.ledger.account_height_index)
+		{
+			auto block_l (node.store.block.get (transaction, hash));
+			if (block_l != nullptr)
+			{
+				// Jump over the skipped blocks instead of walking them
+				auto height (block_l->sideband ().height);
+				hash = node.ledger.block_at_height (transaction, node.ledger.account (transaction, hash), successors ? (offset < std::numeric_limits<uint64_t>::max () - height ? height + offset : 0) : (height > offset ? height - offset : 0));
+				offset = 0;
+			}
+		}
 		while (!hash.is_zero () && blocks.size () < count)
 		{
 			auto block_l (node.store.block.get (transaction, hash));
@@ -2108,6 +2133,37 @@ void vxldollar::json_handler::confirmation_quorum ()
 	response_errors ();
 }
 
+void vxldollar::json_handler::database_instrumentation ()
+{
+	auto & instrumentation (node.store.instrumentation);
+	auto enable (instrumentation.is_enabled ());
+	try
+	{
+		enable = request.get<bool> ("enable", enable);
+	}
+	catch (boost::property_tree::ptree_bad_data const &)
+	{
+		ec = vxldollar::error_rpc::invalid_enable;
+	}
+	auto sample_interval (instrumentation.sample_interval ());
+	boost::optional<std::string> sample_interval_text (request.get_optional<std::string> ("sample_interval"));
+	if (sample_interval_text.is_initialized ())
+	{
+		auto success = boost::conversion::try_lexical_convert<unsigned> (*sample_interval_text, sample_interval);
+		if ((!success || sample_interval == 0) && !ec)
+		{
+			ec = vxldollar::error_rpc::invalid_sample_interval;
+		}
+	}
+	if (!ec)
+	{
+		instrumentation.enable (enable, sample_interval);
+		response_l.put ("enabled", instrumentation.is_enabled ());
+		response_l.put ("sample_interval", instrumentation.sample_interval ());
+	}
+	response_errors ();
+}
+
 void vxldollar::json_handler::database_txn_tracker ()
 {
 	boost::property_tree::ptree json;
@@ -2596,6 +2652,14 @@ void vxldollar::json_handler::account_history ()
 		bool output_raw (request.get_optional<bool> ("raw") == true);
 		response_l.put ("account", account.to_account ());
 		auto block (node.store.block.get (transaction, hash));
+		if (block != nullptr && offset > 0 && node.ledger.account_height_index)
+		{
+			// Jump over the skipped blocks instead of walking them
+			auto height (block->sideband ().height);
+			hash = node.ledger.block_at_height (transaction, account, reverse ? (offset < std::numeric_limits<uint64_t>::max () - height ? height + offset : 0) : (height > offset ? height - offset : 0));
+			block = node.store.block.get (transaction, hash);
+			offset = 0;
+		}
 		while (block != nullptr && count > 0)
 		{
 			if (offset > 0)
@@ -2807,6 +2871,52 @@ void vxldollar::json_handler::ledger ()
 	response_errors ();
 }
 
+void vxldollar::json_handler::ledger_backup ()
+{
+	if (request.get<bool> ("cancel", false))
+	{
+		node.ledger_backup.cancel ();
+		response_l.put ("success", "");
+	}
+	else
+	{
+		std::string path_text (request.get<std::string> ("path"));
+		uint64_t max_bytes_per_second (0);
+		boost::optional<std::string> max_bytes_per_second_text (request.get_optional<std::string> ("max_bytes_per_second"));
+		if (max_bytes_per_second_text.is_initialized () && decode_unsigned (max_bytes_per_second_text.get (), max_bytes_per_second))
+		{
+			ec = vxldollar::error_common::invalid_amount;
+		}
+		if (!ec)
+		{
+			if (!node.ledger_backup.start (boost::filesystem::path (path_text), max_bytes_per_second))
+			{
+				response_l.put ("started", "1");
+			}
+			else
+			{
+				ec = vxldollar::error_rpc::backup_in_progress;
+			}
+		}
+	}
+	response_errors ();
+}
+
+void vxldollar::json_handler::ledger_backup_status ()
+{
+	auto status (node.ledger_backup.get_status ());
+	response_l.put ("running", status.running);
+	if (status.success.is_initialized ())
+	{
+		response_l.put ("success", status.success.get ());
+	}
+	response_l.put ("path", status.destination.string ());
+	response_l.put ("bytes_copied", std::to_string (status.bytes_copied));
+	response_l.put ("bytes_total", std::to_string (status.bytes_total));
+	response_l.put ("duration", status.duration.count ());
+	response_errors ();
+}
+
 void vxldollar::json_handler::mvxldollar_from_raw (vxldollar::uint128_t ratio)
 {
 	auto amount (amount_impl ());
@@ -2975,6 +3085,11 @@ void vxldollar::json_handler::peers ()
 				pending_tree.put ("node_id", "");
 			}
 			pending_tree.put ("type", channel->get_type () == vxldollar::transport::transport_type::tcp ? "tcp" : "udp");
+			auto const & health (*channel->health);
+			pending_tree.put ("rtt", std::to_string (std::chrono::duration_cast<std::chrono::milliseconds> (health.rtt ()).count ()));
+			pending_tree.put ("queue_occupancy", boost::str (boost::format ("%.3f") % health.queue_occupancy ()));
+			pending_tree.put ("drop_rate", boost::str (boost::format ("%.3f") % health.drop_rate ()));
+			pending_tree.put ("health", boost::str (boost::format ("%.3f") % health.score ()));
 			peers_l.push_back (boost::property_tree::ptree::value_type (text.str (), pending_tree));
 		}
 		else
@@ -3891,6 +4006,47 @@ void vxldollar::json_handler::stats ()
 	{
 		node.store.serialize_memory_stats (response_l);
 	}
+	else if (type == "store")
+	{
+		node.store.instrumentation.serialize (response_l);
+	}
+	else if (type == "latency")
+	{
+		std::array<std::pair<vxldollar::stat::latency_stage, char const *>, vxldollar::stat::latency_stage_count> const stages{ { { vxldollar::stat::latency_stage::queue, "queue" }, { vxldollar::stat::latency_stage::handle, "handle" }, { vxldollar::stat::latency_stage::processor, "processor" } } };
+		for (auto detail (static_cast<uint8_t> (vxldollar::stat::detail::keepalive)); detail <= static_cast<uint8_t> (vxldollar::stat::detail::telemetry_ack); ++detail)
+		{
+			boost::property_tree::ptree message_l;
+			for (auto const & [stage, stage_name] : stages)
+			{
+				auto histogram (node.stats.get_latency (static_cast<vxldollar::stat::detail> (detail), stage));
+				auto count (histogram->count ());
+				if (count > 0)
+				{
+					boost::property_tree::ptree stage_l;
+					stage_l.put ("count", count);
+					stage_l.put ("average_us", histogram->total () / count);
+					boost::property_tree::ptree bins_l;
+					for (auto const & bin : histogram->get_bins ())
+					{
+						if (bin.value > 0)
+						{
+							boost::property_tree::ptree bin_l;
+							bin_l.put ("start_us", bin.start_inclusive);
+							bin_l.put ("end_us", bin.end_exclusive);
+							bin_l.put ("count", bin.value);
+							bins_l.push_back (std::make_pair ("", bin_l));
+						}
+					}
+					stage_l.add_child ("bins", bins_l);
+					message_l.add_child (stage_name, stage_l);
+				}
+			}
+			if (!message_l.empty ())
+			{
+				response_l.add_child (vxldollar::stat::detail_to_string (static_cast<vxldollar::stat::detail> (detail)), message_l);
+			}
+		}
+	}
 	else
 	{
 		ec = vxldollar::error_rpc::invalid_missing_type;
@@ -3912,6 +4068,8 @@ void vxldollar::json_handler::stats ()
 void vxldollar::json_handler::stats_clear ()
 {
 	node.stats.clear ();
+	node.stats.clear_latencies ();
+	node.store.instrumentation.clear ();
 	response_l.put ("success", "");
 	std::stringstream ostream;
 	boost::property_tree::write_json (ostream, response_l);
@@ -5292,6 +5450,7 @@ ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ()
 	no_arg_funcs.emplace ("confirmation_history", &vxldollar::json_handler::confirmation_history);
 	no_arg_funcs.emplace ("confirmation_info", &vxldollar::json_handler::confirmation_info);
 	no_arg_funcs.emplace ("confirmation_quorum", &vxldollar::json_handler::confirmation_quorum);
+	no_arg_funcs.emplace ("database_instrumentation", &vxldollar::json_handler::database_instrumentation);
 	no_arg_funcs.emplace ("database_txn_tracker", &vxldollar::json_handler::database_txn_tracker);
 	no_arg_funcs.emplace ("delegators", &vxldollar::json_handler::delegators);
 	no_arg_funcs.emplace ("delegators_count", &vxldollar::json_handler::delegators_count);
@@ -5303,6 +5462,8 @@ ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ()
 	no_arg_funcs.emplace ("key_create", &vxldollar::json_handler::key_create);
 	no_arg_funcs.emplace ("key_expand", &vxldollar::json_handler::key_expand);
 	no_arg_funcs.emplace ("ledger", &vxldollar::json_handler::ledger);
+	no_arg_funcs.emplace ("ledger_backup", &vxldollar::json_handler::ledger_backup);
+	no_arg_funcs.emplace ("ledger_backup_status", &vxldollar::json_handler::ledger_backup_status);
 	no_arg_funcs.emplace ("node_id", &vxldollar::json_handler::node_id);
 	no_arg_funcs.emplace ("node_id_delete", &vxldollar::json_handler::node_id_delete);
 	no_arg_funcs.emplace ("password_change", &vxldollar::json_handler::password_change);
@@ -0,0 +1,91 @@
+#include <vxldollar/lib/logger_mt.hpp>
+#include <vxldollar/lib/threading.hpp>
+#include <vxldollar/node/ledger_backup.hpp>
+
+#include <boost/format.hpp>
+
+vxldollar::ledger_backup::ledger_backup (vxldollar::store & store_a, vxldollar::logger_mt & logger_a) :
+	store (store_a),
+	logger (logger_a)
+{
+}
+
+vxldollar::ledger_backup::~ledger_backup ()
+{
+	stop ();
+}
+
+bool vxldollar::ledger_backup::start (boost::filesystem::path const & destination_a, uint64_t max_bytes_per_second_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	auto result (running);
+	if (!result)
+	{
+		// The thread of the previous backup does not lock the mutex after it stopped running
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
+		running = true;
+		success = boost::none;
+		destination = destination_a;
+		started = std::chrono::steady_clock::now ();
+		progress.bytes_copied = 0;
+		progress.bytes_total = 0;
+		progress.cancelled = false;
+		thread = std::thread ([this, destination_a, max_bytes_per_second_a] () {
+			vxldollar::thread_role::set (vxldollar::thread_role::name::ledger_backup);
+			run (destination_a, max_bytes_per_second_a);
+		});
+	}
+	return result;
+}
+
+void vxldollar::ledger_backup::run (boost::filesystem::path const & destination_a, uint64_t max_bytes_per_second_a)
+{
+	logger.always_log (boost::str (boost::format ("Ledger backup to %1% started") % destination_a));
+	auto success_l (store.backup (destination_a, progress, max_bytes_per_second_a));
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+		running = false;
+		success = success_l;
+		finished = std::chrono::steady_clock::now ();
+		logger.always_log (boost::str (boost::format ("Ledger backup to %1% %2% after %3% seconds, %4% bytes copied") % destination_a % (success_l ? "completed" : (progress.cancelled ? "cancelled" : "failed")) % std::chrono::duration_cast<std::chrono::seconds> (finished - started).count () % progress.bytes_copied));
+	}
+	condition.notify_all ();
+}
+
+void vxldollar::ledger_backup::cancel ()
+{
+	progress.cancelled = true;
+}
+
+void vxldollar::ledger_backup::wait ()
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	condition.wait (lock, [this] () { return !running; });
+}
+
+void vxldollar::ledger_backup::stop ()
+{
+	cancel ();
+	wait ();
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+vxldollar::ledger_backup::status vxldollar::ledger_backup::get_status ()
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	status result;
+	result.running = running;
+	result.success = success;
+	result.destination = destination;
+	result.bytes_copied = progress.bytes_copied;
+	result.bytes_total = progress.bytes_total;
+	result.duration = std::chrono::duration_cast<std::chrono::seconds> ((running ? std::chrono::steady_clock::now () : finished) - started);
+	return result;
+}
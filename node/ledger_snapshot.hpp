@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vxldollar/lib/errors.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace vxldollar
+{
+class network_params;
+class store;
+
+/**
+ * Streaming ledger snapshot, written by --ledger_export and read by --ledger_import
+ * The file starts with the magic "vxls", a format version byte and the network id (2 bytes), followed by chunks. Integers in headers are big endian.
+ * - chunk header: record count (4 bytes), payload size (4 bytes), compression (1 byte), blake2b checksum of the payload (16 bytes)
+ * - payload: records, each starting with its record_type
+ *   - block: size (2 bytes), the block and its sideband as held in the blocks table
+ *   - account: account, account_info, confirmation_height_info
+ *   - pending: pending_key, pending_info
+ *   - frontier: block hash, account
+ * Account chains are written from the open block to the head, followed by their account record. A chain may continue in the next chunk,
+ * records do not depend on each other, so chunks can be verified and loaded independently.
+ * The last chunk has a record count of zero and holds the number of accounts, blocks, pending entries and frontiers written (8 bytes each),
+ * so that a truncated file is detected.
+ */
+class ledger_snapshot final
+{
+public:
+	enum class record_type : uint8_t
+	{
+		block = 0,
+		account = 1,
+		pending = 2,
+		frontier = 3
+	};
+	enum class compression : uint8_t
+	{
+		none = 0
+	};
+	static std::array<char, 4> constexpr magic{ { 'v', 'x', 'l', 's' } };
+	static uint8_t constexpr version = 1;
+	static std::size_t constexpr header_size = 4 + 1 + 2;
+	static std::size_t constexpr chunk_header_size = 4 + 4 + 1 + 16;
+	/** A chunk is written once its payload reaches this size */
+	static std::size_t constexpr chunk_size = 4 * 1024 * 1024;
+	/** Chunks larger than this are rejected on import */
+	static std::size_t constexpr chunk_size_max = 64 * 1024 * 1024;
+};
+
+/**
+ * Writes the ledger in \p store_a to a ledger_snapshot, from a single read transaction
+ * Pruned ledgers are not supported, as their account chains are incomplete.
+ */
+class ledger_export final
+{
+public:
+	/** Chunks are written once their payload reaches \p chunk_size_a bytes */
+	ledger_export (vxldollar::store & store_a, vxldollar::network_params const & network_params_a, std::size_t chunk_size_a = ledger_snapshot::chunk_size);
+	vxldollar::error run (boost::filesystem::path const & path_a);
+	uint64_t accounts{ 0 };
+	uint64_t blocks{ 0 };
+	uint64_t pending{ 0 };
+	uint64_t frontiers{ 0 };
+
+private:
+	void record_end ();
+	void flush ();
+	vxldollar::store & store;
+	vxldollar::network_params const & network_params;
+	std::size_t const chunk_size;
+	std::ofstream file;
+	std::vector<uint8_t> payload;
+	uint32_t records{ 0 };
+};
+
+/**
+ * Loads a ledger_snapshot into \p store_a, which must not hold more than the genesis block
+ * Chunks are read sequentially and verified by \p threads_a threads. Block signatures and work are checked, each verified chunk is written in one write transaction.
+ * If the import fails, everything it wrote is deleted and the genesis block restored, so that the import can be retried.
+ */
+class ledger_import final
+{
+public:
+	ledger_import (vxldollar::store & store_a, vxldollar::network_params & network_params_a, unsigned threads_a = std::max (1u, std::thread::hardware_concurrency ()));
+	vxldollar::error run (boost::filesystem::path const & path_a);
+	std::atomic<uint64_t> accounts{ 0 };
+	std::atomic<uint64_t> blocks{ 0 };
+	std::atomic<uint64_t> pending{ 0 };
+	std::atomic<uint64_t> frontiers{ 0 };
+
+private:
+	class chunk final
+	{
+	public:
+		uint32_t records{ 0 };
+		std::vector<uint8_t> payload;
+	};
+	vxldollar::error load (vxldollar::ledger_import::chunk const &);
+	/** Deletes the records of a failed import, restoring the genesis block if the store held it */
+	void discard (bool genesis_a);
+	vxldollar::store & store;
+	vxldollar::network_params & network_params;
+	unsigned const threads;
+};
+}
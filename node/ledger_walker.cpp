@@ -36,15 +36,19 @@ void vxldollar::ledger_walker::walk_backward (vxldollar::block_hash const & star
 		}
 
 		visitor_callback_a (block);
+		std::vector<vxldollar::block_hash> dependents;
 		for (auto const & hash : ledger.dependent_blocks (transaction, *block))
 		{
 			if (!hash.is_zero ())
 			{
-				auto const dependent_block = ledger.store.block.get (transaction, hash);
-				if (dependent_block)
-				{
-					enqueue_block (dependent_block);
-				}
+				dependents.push_back (hash);
+			}
+		}
+		for (auto const & dependent_block : ledger.store.block.get_many (transaction, dependents))
+		{
+			if (dependent_block)
+			{
+				enqueue_block (dependent_block);
 			}
 		}
 	}
@@ -64,6 +68,21 @@ void vxldollar::ledger_walker::walk (vxldollar::block_hash const & end_block_has
 	});
 
 	auto const transaction = ledger.store.tx_begin_read ();
+	std::vector<vxldollar::block_hash> batch;
+	batch.reserve (walk_batch_size);
+	auto visit_batch = [&] () {
+		for (auto const & block : ledger.store.block.get_many (transaction, batch))
+		{
+			if (!block)
+			{
+				debug_assert (false);
+				continue;
+			}
+
+			visitor_callback_a (block);
+		}
+		batch.clear ();
+	};
 	for (auto walked_block_order_index = last_walked_block_order_index; walked_block_order_index != 0; --walked_block_order_index)
 	{
 		auto const * block_hash = walked_blocks_order.lookup (std::to_string (walked_block_order_index).c_str ());
@@ -73,15 +92,13 @@ void vxldollar::ledger_walker::walk (vxldollar::block_hash const & end_block_has
 			continue;
 		}
 
-		auto const block = ledger.store.block.get (transaction, *block_hash);
-		if (!block)
+		batch.push_back (*block_hash);
+		if (batch.size () >= walk_batch_size)
 		{
-			debug_assert (false);
-			continue;
+			visit_batch ();
 		}
-
-		visitor_callback_a (block);
 	}
+	visit_batch ();
 }
 
 void vxldollar::ledger_walker::walk_backward (vxldollar::block_hash const & start_block_hash_a, visitor_callback const & visitor_callback_a)
@@ -1,4 +1,7 @@
 #include <vxldollar/crypto_lib/random_pool.hpp>
+#include <vxldollar/lib/rate_limiting.hpp>
+#include <vxldollar/lib/threading.hpp>
+#include <vxldollar/lib/timer.hpp>
 #include <vxldollar/lib/utility.hpp>
 #include <vxldollar/node/common.hpp>
 #include <vxldollar/node/lmdb/lmdb.hpp>
@@ -11,7 +14,25 @@
 #include <boost/format.hpp>
 #include <boost/polymorphic_cast.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
 #include <queue>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#endif
 
 namespace vxldollar
 {
@@ -40,6 +61,134 @@ void mdb_val::convert_buffer_to_value ()
 }
 }
 
+namespace
+{
+/** LMDB reads through a memory map, so the page faults of a thread show which lookups go to disk */
+class page_fault_backend final : public vxldollar::store_instrumentation::backend
+{
+public:
+	void sample_begin (vxldollar::store_instrumentation::counter_values & counters_a) override
+	{
+		read (counters_a);
+	}
+
+	void sample_end (vxldollar::store_instrumentation::counter_values & counters_a) override
+	{
+		read (counters_a);
+	}
+
+private:
+	static void read (vxldollar::store_instrumentation::counter_values & counters_a)
+	{
+		auto const [minor, major] = vxldollar::thread_page_faults ();
+		counters_a[static_cast<std::size_t> (vxldollar::store_instrumentation::counter::minor_page_faults)] = minor;
+		counters_a[static_cast<std::size_t> (vxldollar::store_instrumentation::counter::major_page_faults)] = major;
+	}
+};
+
+/** Pending keys start with the account, accounts are uniformly distributed so their first bytes serve as the filter key */
+uint64_t pending_filter_key (vxldollar::mdb_val const & key_a)
+{
+	debug_assert (key_a.size () >= sizeof (uint64_t));
+	uint64_t result;
+	std::memcpy (&result, key_a.data (), sizeof (result));
+	return result;
+}
+
+/** Anonymous pipe, mdb_env_copyfd2 writes the copy into one end while the backup reads it from the other at a limited rate */
+class copy_pipe final
+{
+public:
+	copy_pipe ()
+	{
+#ifdef _WIN32
+		error = !CreatePipe (&read_end, &write_end, nullptr, 0);
+#else
+		int ends[2];
+		error = ::pipe (ends) != 0;
+		if (!error)
+		{
+			read_end = ends[0];
+			write_end = ends[1];
+		}
+#endif
+	}
+
+	~copy_pipe ()
+	{
+		close (read_end);
+		close (write_end);
+	}
+
+	/** @return the number of bytes read, 0 once the write end is closed */
+	std::size_t read (uint8_t * buffer_a, std::size_t size_a)
+	{
+#ifdef _WIN32
+		DWORD result (0);
+		if (!ReadFile (read_end, buffer_a, static_cast<DWORD> (size_a), &result, nullptr))
+		{
+			result = 0;
+		}
+		return result;
+#else
+		ssize_t result;
+		do
+		{
+			result = ::read (read_end, buffer_a, size_a);
+		} while (result < 0 && errno == EINTR);
+		return result > 0 ? static_cast<std::size_t> (result) : 0;
+#endif
+	}
+
+	void close_write ()
+	{
+		close (write_end);
+	}
+
+	/** Writes to the pipe then fail with EPIPE, or ERROR_NO_DATA on Windows, which aborts mdb_env_copyfd2 */
+	void close_read ()
+	{
+		close (read_end);
+	}
+
+	/** Makes writes from the calling thread to a pipe without reader fail instead of raising SIGPIPE, which would terminate the node */
+	static void ignore_sigpipe ()
+	{
+#ifndef _WIN32
+		sigset_t set;
+		sigemptyset (&set);
+		sigaddset (&set, SIGPIPE);
+		// SIGPIPE is sent to the writing thread, a blocked one stays pending and is discarded when the thread exits
+		pthread_sigmask (SIG_BLOCK, &set, nullptr);
+#endif
+	}
+
+	mdb_filehandle_t write_end{ invalid_handle };
+	bool error{ false };
+
+private:
+	void close (mdb_filehandle_t & handle_a)
+	{
+		if (handle_a != invalid_handle)
+		{
+#ifdef _WIN32
+			CloseHandle (handle_a);
+#else
+			::close (handle_a);
+#endif
+			handle_a = invalid_handle;
+		}
+	}
+
+#ifdef _WIN32
+	static inline mdb_filehandle_t const invalid_handle{ INVALID_HANDLE_VALUE };
+#else
+	static mdb_filehandle_t constexpr invalid_handle{ -1 };
+#endif
+	mdb_filehandle_t read_end{ invalid_handle };
+};
+}
+
 vxldollar::mdb_store::mdb_store (vxldollar::logger_mt & logger_a, boost::filesystem::path const & path_a, vxldollar::ledger_constants & constants, vxldollar::txn_tracking_config const & txn_tracking_config_a, std::chrono::milliseconds block_processor_batch_max_time_a, vxldollar::lmdb_config const & lmdb_config_a, bool backup_before_upgrade_a) :
 	// clang-format off
 	store_partial{
@@ -54,7 +203,8 @@ vxldollar::mdb_store::mdb_store (vxldollar::logger_mt & logger_a, boost::filesys
 		peer_store_partial,
 		confirmation_height_store_partial,
 		final_vote_store_partial,
-		version_store_partial
+		version_store_partial,
+		account_height_store_partial
 	},
 	// clang-format on
 	block_store_partial{ *this },
@@ -68,11 +218,13 @@ vxldollar::mdb_store::mdb_store (vxldollar::logger_mt & logger_a, boost::filesys
 	final_vote_store_partial{ *this },
 	unchecked_mdb_store{ *this },
 	version_store_partial{ *this },
+	account_height_store_partial{ *this },
 	logger (logger_a),
 	env (error, path_a, vxldollar::mdb_env::options::make ().set_config (lmdb_config_a).set_use_no_mem_init (true)),
 	mdb_txn_tracker (logger_a, txn_tracking_config_a, block_processor_batch_max_time_a),
 	txn_tracking_enabled (txn_tracking_config_a.enable)
 {
+	instrumentation.backend_set (std::make_unique<page_fault_backend> ());
 	if (!error)
 	{
 		auto is_fully_upgraded (false);
@@ -123,9 +275,38 @@ vxldollar::mdb_store::mdb_store (vxldollar::logger_mt & logger_a, boost::filesys
 			auto transaction (tx_begin_read ());
 			open_databases (error, transaction, 0);
 		}
+		if (!error)
+		{
+			populate_pending_filter ();
+			read_txn_pool = std::make_unique<vxldollar::read_mdb_txn_pool> (env);
+		}
 	}
 }
 
+void vxldollar::mdb_store::populate_pending_filter ()
+{
+	vxldollar::timer<std::chrono::milliseconds> timer;
+	timer.start ();
+	auto transaction (tx_begin_read ());
+	auto pending_count (count (transaction, tables::pending));
+	// 8 counters per entry give about 3% false positives, at most 64 MB are used on ledgers with a very large pending table
+	auto filter (std::make_unique<vxldollar::counting_filter> (std::clamp<uint64_t> (pending_count * 8, 1024 * 1024, 64 * 1024 * 1024)));
+	for (auto i (pending.begin (transaction)), n (pending.end ()); i != n; ++i)
+	{
+		filter->insert (pending_filter_key (vxldollar::mdb_val (i->first.account)));
+	}
+	pending_filter = std::move (filter);
+	if (pending_count > 0)
+	{
+		logger.always_log (boost::str (boost::format ("Pending filter of %1% entries populated in %2% ms") % pending_count % timer.stop ().count ()));
+	}
+}
+
+bool vxldollar::mdb_store::pending_may_exist (vxldollar::mdb_val const & key_a) const
+{
+	return pending_filter == nullptr || pending_filter->may_contain (pending_filter_key (key_a));
+}
+
 bool vxldollar::mdb_store::vacuum_after_upgrade (boost::filesystem::path const & path_a, vxldollar::lmdb_config const & lmdb_config_a)
 {
 	// Vacuum the database. This is not a required step and may actually fail if there isn't enough storage space.
@@ -186,6 +367,10 @@ vxldollar::write_transaction vxldollar::mdb_store::tx_begin_write (std::vector<v
 
 vxldollar::read_transaction vxldollar::mdb_store::tx_begin_read () const
 {
+	if (read_txn_pool != nullptr)
+	{
+		return vxldollar::read_transaction{ std::make_unique<vxldollar::read_mdb_txn> (*read_txn_pool, create_txn_callbacks ()) };
+	}
 	return env.tx_begin_read (create_txn_callbacks ());
 }
 
@@ -223,6 +408,7 @@ void vxldollar::mdb_store::open_databases (bool & error_a, vxldollar::transactio
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "pending", flags, &pending_v0_handle) != 0;
 	pending_handle = pending_v0_handle;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "final_votes", flags, &final_votes_handle) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "account_heights", flags, &account_heights_handle) != 0;
 
 	auto version_l = version.get (transaction_a);
 	if (version_l < 19)
@@ -307,6 +493,9 @@ bool vxldollar::mdb_store::do_upgrades (vxldollar::write_transaction & transacti
 			upgrade_v20_to_v21 (transaction_a);
 			[[fallthrough]];
 		case 21:
+			upgrade_v21_to_v22 (transaction_a);
+			[[fallthrough]];
+		case 22:
 			break;
 		default:
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
@@ -780,6 +969,14 @@ void vxldollar::mdb_store::upgrade_v20_to_v21 (vxldollar::write_transaction cons
 	logger.always_log ("Finished creating new final_vote table");
 }
 
+void vxldollar::mdb_store::upgrade_v21_to_v22 (vxldollar::write_transaction const & transaction_a)
+{
+	logger.always_log ("Preparing v21 to v22 database upgrade...");
+	mdb_dbi_open (env.tx (transaction_a), "account_heights", MDB_CREATE, &account_heights_handle);
+	version.put (transaction_a, 22);
+	logger.always_log ("Finished creating new account_heights table, it is filled on start when node.account_height_index is enabled");
+}
+
 /** Takes a filepath, appends '_backup_<timestamp>' to the end (but before any extension) and saves that file in the same directory */
 void vxldollar::mdb_store::create_backup_file (vxldollar::mdb_env & env_a, boost::filesystem::path const & filepath_a, vxldollar::logger_mt & logger_a)
 {
@@ -822,23 +1019,85 @@ bool vxldollar::mdb_store::exists (vxldollar::transaction const & transaction_a,
 	return (status == MDB_SUCCESS);
 }
 
+bool vxldollar::mdb_store::exists_prefix (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & prefix_a) const
+{
+	if (table_a == tables::pending && !pending_may_exist (prefix_a))
+	{
+		return false;
+	}
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (env.tx (transaction_a), table_to_dbi (table_a), &cursor));
+	release_assert_success (*this, status);
+	// Positions the cursor at the first key not less than the prefix
+	MDB_val key (prefix_a.value);
+	MDB_val value;
+	status = mdb_cursor_get (cursor, &key, &value, MDB_SET_RANGE);
+	release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+	auto result (status == MDB_SUCCESS && key.mv_size >= prefix_a.size () && std::memcmp (key.mv_data, prefix_a.data (), prefix_a.size ()) == 0);
+	mdb_cursor_close (cursor);
+	return result;
+}
+
 int vxldollar::mdb_store::get (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a, vxldollar::mdb_val & value_a) const
 {
+	if (table_a == tables::pending && !pending_may_exist (key_a))
+	{
+		return MDB_NOTFOUND;
+	}
 	return mdb_get (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a);
 }
 
+std::vector<int> vxldollar::mdb_store::get_many (vxldollar::transaction const & transaction_a, tables table_a, std::vector<vxldollar::mdb_val> const & keys_a, std::vector<vxldollar::mdb_val> & values_a) const
+{
+	// Lookups in key order descend through mostly the same branch pages, which are then still in cache
+	std::vector<std::size_t> order (keys_a.size ());
+	std::iota (order.begin (), order.end (), std::size_t{ 0 });
+	std::sort (order.begin (), order.end (), [&keys_a] (std::size_t lhs, std::size_t rhs) {
+		auto const & lhs_key (keys_a[lhs]);
+		auto const & rhs_key (keys_a[rhs]);
+		auto compare (std::memcmp (lhs_key.data (), rhs_key.data (), std::min (lhs_key.size (), rhs_key.size ())));
+		return compare < 0 || (compare == 0 && lhs_key.size () < rhs_key.size ());
+	});
+	auto dbi (table_to_dbi (table_a));
+	auto tx (env.tx (transaction_a));
+	values_a.assign (keys_a.size (), vxldollar::mdb_val{});
+	std::vector<int> result (keys_a.size ());
+	for (auto i : order)
+	{
+		result[i] = mdb_get (tx, dbi, keys_a[i], values_a[i]);
+	}
+	return result;
+}
+
 int vxldollar::mdb_store::put (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a, vxldollar::mdb_val const & value_a) const
 {
-	return (mdb_put (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a, 0));
+	auto status (mdb_put (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a, 0));
+	if (table_a == tables::pending && pending_filter != nullptr && status == MDB_SUCCESS)
+	{
+		pending_filter->insert (pending_filter_key (key_a));
+	}
+	return status;
 }
 
 int vxldollar::mdb_store::del (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a) const
 {
-	return (mdb_del (env.tx (transaction_a), table_to_dbi (table_a), key_a, nullptr));
+	auto status (mdb_del (env.tx (transaction_a), table_to_dbi (table_a), key_a, nullptr));
+	if (table_a == tables::pending && pending_filter != nullptr && status == MDB_SUCCESS)
+	{
+		// Other transactions may still read the key until the deletion is committed
+		transaction_a.on_commit ([filter = pending_filter.get (), key = pending_filter_key (key_a)] () {
+			filter->erase (key);
+		});
+	}
+	return status;
 }
 
 int vxldollar::mdb_store::drop (vxldollar::write_transaction const & transaction_a, tables table_a)
 {
+	if (table_a == tables::pending && pending_filter != nullptr)
+	{
+		pending_filter->clear ();
+	}
 	return clear (transaction_a, table_to_dbi (table_a));
 }
 
@@ -886,6 +1145,8 @@ MDB_dbi vxldollar::mdb_store::table_to_dbi (tables table_a) const
 			return confirmation_height_handle;
 		case tables::final_votes:
 			return final_votes_handle;
+		case tables::account_heights:
+			return account_heights_handle;
 		default:
 			release_assert (false);
 			return peers_handle;
@@ -917,6 +1178,90 @@ bool vxldollar::mdb_store::copy_db (boost::filesystem::path const & destination_
 	return !mdb_env_copy2 (env.environment, destination_file.string ().c_str (), MDB_CP_COMPACT);
 }
 
+bool vxldollar::mdb_store::backup (boost::filesystem::path const & destination_a, vxldollar::backup_progress & progress_a, uint64_t max_bytes_per_second_a)
+{
+	boost::system::error_code error_l;
+	boost::filesystem::create_directories (destination_a, error_l);
+	// The previous backup is only replaced once the new one is complete
+	auto const partial_path (destination_a / "data.ldb.partial");
+	std::ofstream file (partial_path.string (), std::ios::binary | std::ios::trunc);
+	copy_pipe pipe;
+	if (error_l || !file || pipe.error)
+	{
+		return false;
+	}
+	MDB_envinfo info;
+	MDB_stat stat;
+	mdb_env_info (env, &info);
+	mdb_env_stat (env, &stat);
+	// Compaction leaves out free pages, so this is an upper bound
+	progress_a.bytes_total = (info.me_last_pgno + 1) * static_cast<uint64_t> (stat.ms_psize);
+
+	// mdb_env_copyfd2 copies from its own read transaction and does not block writers
+	auto copy_status (MDB_SUCCESS);
+	std::thread copy_thread ([this, &pipe, &copy_status] () {
+		vxldollar::thread_role::set (vxldollar::thread_role::name::ledger_backup);
+		copy_pipe::ignore_sigpipe ();
+		copy_status = mdb_env_copyfd2 (env, pipe.write_end, MDB_CP_COMPACT);
+		pipe.close_write ();
+	});
+	vxldollar::rate::token_bucket limiter (std::max<std::size_t> (max_bytes_per_second_a, backup_chunk_size), std::max<uint64_t> (max_bytes_per_second_a, 1));
+	std::vector<uint8_t> buffer (backup_chunk_size);
+	auto write_error (false);
+	while (auto size = pipe.read (buffer.data (), buffer.size ()))
+	{
+		// Reading slower blocks the copy on a full pipe
+		while (max_bytes_per_second_a != 0 && !limiter.try_consume (static_cast<unsigned> (size)) && !progress_a.cancelled)
+		{
+			std::this_thread::sleep_for (std::chrono::milliseconds (10));
+		}
+		if (progress_a.cancelled)
+		{
+			break;
+		}
+		file.write (reinterpret_cast<char const *> (buffer.data ()), size);
+		write_error = !file;
+		if (write_error)
+		{
+			break;
+		}
+		progress_a.bytes_copied += size;
+	}
+	// Once cancelled or failed, the copy is aborted rather than drained, so that cancelling does not wait for the whole ledger to be read
+	pipe.close_read ();
+	copy_thread.join ();
+	file.close ();
+	auto result (success (copy_status) && !write_error && file && !progress_a.cancelled);
+	if (result)
+	{
+		boost::filesystem::rename (partial_path, destination_a / "data.ldb", error_l);
+		result = !error_l;
+	}
+	else
+	{
+		boost::filesystem::remove (partial_path, error_l);
+	}
+	return result;
+}
+
+void vxldollar::mdb_store::for_each_raw (vxldollar::transaction const & transaction_a, tables table_a, uint8_t first_a, uint8_t last_a, std::function<void (uint8_t const *, std::size_t, uint8_t const *, std::size_t)> const & action_a) const
+{
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (env.tx (transaction_a), table_to_dbi (table_a), &cursor));
+	release_assert_success (*this, status);
+	// Keys are compared bytewise, so the range starts at the single byte key first_a
+	MDB_val key{ sizeof (first_a), &first_a };
+	MDB_val value;
+	status = mdb_cursor_get (cursor, &key, &value, MDB_SET_RANGE);
+	while (status == MDB_SUCCESS && key.mv_size > 0 && *static_cast<uint8_t const *> (key.mv_data) <= last_a)
+	{
+		action_a (static_cast<uint8_t const *> (key.mv_data), key.mv_size, static_cast<uint8_t const *> (value.mv_data), value.mv_size);
+		status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT);
+	}
+	release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+	mdb_cursor_close (cursor);
+}
+
 void vxldollar::mdb_store::rebuild_db (vxldollar::write_transaction const & transaction_a)
 {
 	// Tables with uint256_union key
@@ -972,6 +1317,12 @@ bool vxldollar::mdb_store::init_error () const
 	return error;
 }
 
+void vxldollar::mdb_store::sync ()
+{
+	auto status (mdb_env_sync (env, 1));
+	release_assert (success (status), error_string (status));
+}
+
 std::shared_ptr<vxldollar::block> vxldollar::mdb_store::block_get_v18 (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const
 {
 	vxldollar::block_type type;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vxldollar/lib/counting_filter.hpp>
 #include <vxldollar/lib/diagnosticsconfig.hpp>
 #include <vxldollar/lib/lmdbconfig.hpp>
 #include <vxldollar/lib/logger_mt.hpp>
@@ -8,6 +9,7 @@
 #include <vxldollar/node/lmdb/lmdb_iterator.hpp>
 #include <vxldollar/node/lmdb/lmdb_txn.hpp>
 #include <vxldollar/secure/common.hpp>
+#include <vxldollar/secure/store/account_height_store_partial.hpp>
 #include <vxldollar/secure/store/account_store_partial.hpp>
 #include <vxldollar/secure/store/block_store_partial.hpp>
 #include <vxldollar/secure/store/confirmation_height_store_partial.hpp>
@@ -64,6 +66,7 @@ private:
 	vxldollar::confirmation_height_store_partial<MDB_val, mdb_store> confirmation_height_store_partial;
 	vxldollar::final_vote_store_partial<MDB_val, mdb_store> final_vote_store_partial;
 	vxldollar::version_store_partial<MDB_val, mdb_store> version_store_partial;
+	vxldollar::account_height_store_partial<MDB_val, mdb_store> account_height_store_partial;
 
 	friend class vxldollar::unchecked_mdb_store;
 
@@ -203,6 +206,12 @@ public:
 	 */
 	MDB_dbi pruned_handle{ 0 };
 
+	/**
+	 * Optional index of the blocks in each account chain by height
+	 * vxldollar::account_height_key -> vxldollar::block_hash
+	 */
+	MDB_dbi account_heights_handle{ 0 };
+
 	/*
 	 * Endpoints for peers
 	 * vxldollar::endpoint_key -> no_value
@@ -228,13 +237,18 @@ public:
 	MDB_dbi final_votes_handle{ 0 };
 
 	bool exists (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a) const;
+	bool exists_prefix (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & prefix_a) const;
 
 	int get (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a, vxldollar::mdb_val & value_a) const;
+	std::vector<int> get_many (vxldollar::transaction const & transaction_a, tables table_a, std::vector<vxldollar::mdb_val> const & keys_a, std::vector<vxldollar::mdb_val> & values_a) const;
 	int put (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a, vxldollar::mdb_val const & value_a) const;
 	int del (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::mdb_val const & key_a) const;
 
 	bool copy_db (boost::filesystem::path const & destination_file) override;
+	/** Writes a compacted copy to data.ldb in \p destination. The copy holds a read transaction, so pages freed meanwhile are only reused after it */
+	bool backup (boost::filesystem::path const & destination, vxldollar::backup_progress & progress_a, uint64_t max_bytes_per_second_a) override;
 	void rebuild_db (vxldollar::write_transaction const & transaction_a) override;
+	void for_each_raw (vxldollar::transaction const & transaction_a, tables table_a, uint8_t first_a, uint8_t last_a, std::function<void (uint8_t const *, std::size_t, uint8_t const *, std::size_t)> const & action_a) const override;
 
 	template <typename Key, typename Value>
 	vxldollar::store_iterator<Key, Value> make_iterator (vxldollar::transaction const & transaction_a, tables table_a, bool const direction_asc) const
@@ -249,6 +263,7 @@ public:
 	}
 
 	bool init_error () const override;
+	void sync () override;
 
 	uint64_t count (vxldollar::transaction const &, MDB_dbi) const;
 	std::string error_string (int status) const override;
@@ -269,6 +284,7 @@ private:
 	void upgrade_v18_to_v19 (vxldollar::write_transaction const &);
 	void upgrade_v19_to_v20 (vxldollar::write_transaction const &);
 	void upgrade_v20_to_v21 (vxldollar::write_transaction const &);
+	void upgrade_v21_to_v22 (vxldollar::write_transaction const &);
 
 	std::shared_ptr<vxldollar::block> block_get_v18 (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const;
 	vxldollar::mdb_val block_raw_get_v18 (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a, vxldollar::block_type & type_a) const;
@@ -286,10 +302,21 @@ private:
 
 	MDB_dbi table_to_dbi (tables table_a) const;
 
+	/** Size of the reads from the backup copy, and so the unit of its rate limiting */
+	static std::size_t constexpr backup_chunk_size = 1024 * 1024;
+
 	mutable vxldollar::mdb_txn_tracker mdb_txn_tracker;
 	vxldollar::mdb_txn_callbacks create_txn_callbacks () const;
 	bool txn_tracking_enabled;
 
+	/** Reused read transactions, null until the databases are opened as that needs transactions which are committed */
+	std::unique_ptr<vxldollar::read_mdb_txn_pool> read_txn_pool;
+
+	/** Accounts with pending entries, lookups for other accounts skip the pending table. Null until populated after upgrades */
+	std::unique_ptr<vxldollar::counting_filter> pending_filter;
+	void populate_pending_filter ();
+	bool pending_may_exist (vxldollar::mdb_val const & key_a) const;
+
 	uint64_t count (vxldollar::transaction const & transaction_a, tables table_a) const override;
 
 	bool vacuum_after_upgrade (boost::filesystem::path const & path_a, vxldollar::lmdb_config const & lmdb_config_a);
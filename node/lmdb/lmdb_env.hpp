@@ -62,5 +62,7 @@ public:
 	vxldollar::write_transaction tx_begin_write (mdb_txn_callbacks txn_callbacks = mdb_txn_callbacks{}) const;
 	MDB_txn * tx (vxldollar::transaction const & transaction_a) const;
 	MDB_env * environment;
+	/** Set if commits are flushed to disk, so that write transactions begun while vxldollar::deferred_sync is set can skip the flush */
+	bool sync_deferrable{ false };
 };
 }
@@ -57,11 +57,26 @@ vxldollar::read_mdb_txn::read_mdb_txn (vxldollar::mdb_env const & environment_a,
 	txn_callbacks.txn_start (this);
 }
 
+vxldollar::read_mdb_txn::read_mdb_txn (vxldollar::read_mdb_txn_pool & pool_a, vxldollar::mdb_txn_callbacks txn_callbacks_a) :
+	handle (pool_a.take ()),
+	txn_callbacks (txn_callbacks_a),
+	pool (&pool_a)
+{
+	txn_callbacks.txn_start (this);
+}
+
 vxldollar::read_mdb_txn::~read_mdb_txn ()
 {
-	// This uses commit rather than abort, as it is needed when opening databases with a read only transaction
-	auto status (mdb_txn_commit (handle));
-	release_assert (status == MDB_SUCCESS);
+	if (pool != nullptr)
+	{
+		pool->give_back (handle);
+	}
+	else
+	{
+		// This uses commit rather than abort, as it is needed when opening databases with a read only transaction
+		auto status (mdb_txn_commit (handle));
+		release_assert (status == MDB_SUCCESS);
+	}
 	txn_callbacks.txn_end (this);
 }
 
@@ -83,6 +98,91 @@ void * vxldollar::read_mdb_txn::get_handle () const
 	return handle;
 }
 
+vxldollar::read_mdb_txn_pool::read_mdb_txn_pool (vxldollar::mdb_env const & env_a, std::chrono::milliseconds max_age_a) :
+	env (env_a),
+	max_age (max_age_a)
+{
+}
+
+vxldollar::read_mdb_txn_pool::~read_mdb_txn_pool ()
+{
+	clear ();
+}
+
+vxldollar::read_mdb_txn_pool::shard & vxldollar::read_mdb_txn_pool::current_shard ()
+{
+	return shards[std::hash<std::thread::id>{}(std::this_thread::get_id ()) % shard_count];
+}
+
+MDB_txn * vxldollar::read_mdb_txn_pool::take ()
+{
+	MDB_txn * result (nullptr);
+	{
+		auto & shard_l (current_shard ());
+		vxldollar::lock_guard<vxldollar::mutex> guard (shard_l.mutex);
+		auto const now (std::chrono::steady_clock::now ());
+		while (result == nullptr && !shard_l.entries.empty ())
+		{
+			auto entry_l (shard_l.entries.back ());
+			shard_l.entries.pop_back ();
+			if (now - entry_l.reset_at < max_age && mdb_txn_renew (entry_l.handle) == MDB_SUCCESS)
+			{
+				result = entry_l.handle;
+			}
+			else
+			{
+				mdb_txn_abort (entry_l.handle);
+			}
+		}
+	}
+	if (result == nullptr)
+	{
+		auto status (mdb_txn_begin (env, nullptr, MDB_RDONLY, &result));
+		release_assert (status == 0);
+	}
+	return result;
+}
+
+void vxldollar::read_mdb_txn_pool::give_back (MDB_txn * handle_a)
+{
+	mdb_txn_reset (handle_a);
+	auto & shard_l (current_shard ());
+	vxldollar::unique_lock<vxldollar::mutex> lock (shard_l.mutex);
+	if (shard_l.entries.size () < shard_capacity)
+	{
+		shard_l.entries.push_back ({ handle_a, std::chrono::steady_clock::now () });
+	}
+	else
+	{
+		lock.unlock ();
+		mdb_txn_abort (handle_a);
+	}
+}
+
+void vxldollar::read_mdb_txn_pool::clear ()
+{
+	for (auto & shard_l : shards)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (shard_l.mutex);
+		for (auto const & entry_l : shard_l.entries)
+		{
+			mdb_txn_abort (entry_l.handle);
+		}
+		shard_l.entries.clear ();
+	}
+}
+
+std::size_t vxldollar::read_mdb_txn_pool::size () const
+{
+	std::size_t result (0);
+	for (auto const & shard_l : shards)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (shard_l.mutex);
+		result += shard_l.entries.size ();
+	}
+	return result;
+}
+
 vxldollar::write_mdb_txn::write_mdb_txn (vxldollar::mdb_env const & environment_a, vxldollar::mdb_txn_callbacks txn_callbacks_a) :
 	env (environment_a),
 	txn_callbacks (txn_callbacks_a)
@@ -110,6 +210,12 @@ void vxldollar::write_mdb_txn::renew ()
 {
 	auto status (mdb_txn_begin (env, nullptr, 0, &handle));
 	release_assert (status == MDB_SUCCESS, mdb_strerror (status));
+	if (env.sync_deferrable)
+	{
+		// The flag is read on commit, other writers cannot change it meanwhile as they are blocked on the write lock
+		auto status2 (mdb_env_set_flags (env, MDB_NOSYNC, vxldollar::deferred_sync::is_set () ? 1 : 0));
+		release_assert (status2 == MDB_SUCCESS, mdb_strerror (status2));
+	}
 	txn_callbacks.txn_start (this);
 	active = true;
 }
@@ -3,12 +3,14 @@
 #include <vxldollar/node/network.hpp>
 #include <vxldollar/node/node.hpp>
 #include <vxldollar/node/telemetry.hpp>
+#include <vxldollar/node/traffic_recorder.hpp>
 #include <vxldollar/secure/buffer.hpp>
 
 #include <boost/asio/steady_timer.hpp>
 #include <boost/format.hpp>
 #include <boost/variant/get.hpp>
 
+#include <cmath>
 #include <numeric>
 
 vxldollar::network::network (vxldollar::node & node_a, uint16_t port_a) :
@@ -21,6 +23,7 @@ vxldollar::network::network (vxldollar::node & node_a, uint16_t port_a) :
 		}
 		else
 		{
+			clear_filters (message);
 			this->node.stats.inc (vxldollar::stat::type::message, vxldollar::stat::detail::invalid_network);
 		}
 	} },
@@ -30,6 +33,8 @@ vxldollar::network::network (vxldollar::node & node_a, uint16_t port_a) :
 	tcp_message_manager (node_a.config.tcp_incoming_connections_max),
 	node (node_a),
 	publish_filter (256 * 1024),
+	vote_filter (256 * 1024),
+	confirm_req_filter (64 * 1024),
 	udp_channels (node_a, port_a, inbound),
 	tcp_channels (node_a, inbound),
 	port (port_a),
@@ -39,6 +44,10 @@ vxldollar::network::network (vxldollar::node & node_a, uint16_t port_a) :
 	{
 		port = udp_channels.get_local_endpoint ().port ();
 	}
+	if (!node.flags.record_traffic_path.empty ())
+	{
+		recorder = std::make_unique<vxldollar::traffic_recorder> (node, node.flags.record_traffic_path);
+	}
 
 	boost::thread::attributes attrs;
 	vxldollar::thread_attributes::set (attrs);
@@ -152,6 +161,10 @@ void vxldollar::network::stop ()
 		{
 			thread.join ();
 		}
+		if (recorder)
+		{
+			recorder->stop ();
+		}
 	}
 }
 
@@ -467,13 +480,17 @@ public:
 		{
 			if (message_a.block != nullptr)
 			{
-				node.aggregator.add (channel, { { message_a.block->hash (), message_a.block->root () } });
+				node.aggregator.add (channel, { { message_a.block->hash (), message_a.block->root () } }, message_a.digest);
 			}
 			else if (!message_a.roots_hashes.empty ())
 			{
-				node.aggregator.add (channel, message_a.roots_hashes);
+				node.aggregator.add (channel, message_a.roots_hashes, message_a.digest);
 			}
 		}
+		else if (message_a.digest != 0)
+		{
+			node.network.confirm_req_filter.clear (message_a.digest);
+		}
 	}
 	void confirm_ack (vxldollar::confirm_ack const & message_a) override
 	{
@@ -502,7 +519,12 @@ public:
 					}
 				}
 			}
-			node.vote_processor.vote (message_a.vote, channel);
+			auto dropped (node.vote_processor.vote (message_a.vote, channel));
+			// Repeated votes must reach the vote processor if this one was not processed, or if it could be a reply to the rep crawler
+			if (message_a.digest != 0 && (dropped || node.rep_crawler.is_pending (message_a.vote)))
+			{
+				node.network.vote_filter.clear (message_a.digest);
+			}
 		}
 	}
 	void bulk_pull (vxldollar::bulk_pull const &) override
@@ -562,8 +584,50 @@ public:
 
 void vxldollar::network::process_message (vxldollar::message const & message_a, std::shared_ptr<vxldollar::transport::channel> const & channel_a)
 {
+	if (recorder)
+	{
+		recorder->record (message_a, *channel_a);
+	}
+	auto const start (std::chrono::steady_clock::now ());
 	network_message_visitor visitor (node, channel_a);
 	message_a.visit (visitor);
+	node.stats.update_latency (vxldollar::message_type_to_stat_detail (message_a.header.type), vxldollar::stat::latency_stage::handle, std::chrono::steady_clock::now () - start);
+}
+
+void vxldollar::network::clear_filters (vxldollar::message const & message_a)
+{
+	switch (message_a.header.type)
+	{
+		case vxldollar::message_type::publish:
+		{
+			auto const & digest (static_cast<vxldollar::publish const &> (message_a).digest);
+			if (digest != 0)
+			{
+				publish_filter.clear (digest);
+			}
+			break;
+		}
+		case vxldollar::message_type::confirm_req:
+		{
+			auto const & digest (static_cast<vxldollar::confirm_req const &> (message_a).digest);
+			if (digest != 0)
+			{
+				confirm_req_filter.clear (digest);
+			}
+			break;
+		}
+		case vxldollar::message_type::confirm_ack:
+		{
+			auto const & digest (static_cast<vxldollar::confirm_ack const &> (message_a).digest);
+			if (digest != 0)
+			{
+				vote_filter.clear (digest);
+			}
+			break;
+		}
+		default:
+			break;
+	}
 }
 
 // Send keepalives to all the peers we've been notified of
@@ -619,11 +683,7 @@ std::deque<std::shared_ptr<vxldollar::transport::channel>> vxldollar::network::l
 	std::deque<std::shared_ptr<vxldollar::transport::channel>> result;
 	tcp_channels.list (result, minimum_version_a, include_tcp_temporary_channels_a);
 	udp_channels.list (result, minimum_version_a);
-	vxldollar::random_pool_shuffle (result.begin (), result.end ());
-	if (result.size () > count_a)
-	{
-		result.resize (count_a, nullptr);
-	}
+	select_by_health (result, count_a);
 	return result;
 }
 
@@ -632,16 +692,45 @@ std::deque<std::shared_ptr<vxldollar::transport::channel>> vxldollar::network::l
 	std::deque<std::shared_ptr<vxldollar::transport::channel>> result;
 	tcp_channels.list (result);
 	udp_channels.list (result);
-	vxldollar::random_pool_shuffle (result.begin (), result.end ());
 	result.erase (std::remove_if (result.begin (), result.end (), [this] (std::shared_ptr<vxldollar::transport::channel> const & channel) {
 		return this->node.rep_crawler.is_pr (*channel);
 	}),
 	result.end ());
-	if (result.size () > count_a)
+	select_by_health (result, count_a);
+	return result;
+}
+
+void vxldollar::network::select_by_health (std::deque<std::shared_ptr<vxldollar::transport::channel>> & channels_a, std::size_t count_a)
+{
+	if (channels_a.size () <= count_a)
 	{
-		result.resize (count_a, nullptr);
+		vxldollar::random_pool_shuffle (channels_a.begin (), channels_a.end ());
+	}
+	else
+	{
+		// Weighted sampling without replacement (Efraimidis-Spirakis): every channel draws log (u) / weight for a uniform u in (0, 1]
+		// and the largest keys are kept. Each peer keeps a chance of being picked, which is needed for propagation.
+		auto const word_max (std::numeric_limits<uint32_t>::max ());
+		std::vector<std::pair<double, std::shared_ptr<vxldollar::transport::channel>>> keyed;
+		keyed.reserve (channels_a.size ());
+		for (auto & channel : channels_a)
+		{
+			auto uniform (static_cast<double> (vxldollar::random_pool::generate_word32 (1, word_max)) / word_max);
+			keyed.emplace_back (std::log (uniform) / channel->health->score (), std::move (channel));
+		}
+		auto selected_end (keyed.begin () + count_a);
+		std::nth_element (keyed.begin (), selected_end, keyed.end (), [] (auto const & lhs, auto const & rhs) {
+			return lhs.first > rhs.first;
+		});
+		channels_a.clear ();
+		uint64_t degraded (0);
+		for (auto i (keyed.begin ()); i != selected_end; ++i)
+		{
+			degraded += i->second->health->score () < 0.5;
+			channels_a.push_back (std::move (i->second));
+		}
+		node.stats.add (vxldollar::stat::type::peering, vxldollar::stat::detail::selected_degraded, vxldollar::stat::dir::out, degraded);
 	}
-	return result;
 }
 
 // Simulating with sqrt_broadcast_simulate shows we only need to broadcast to sqrt(total_peers) random peers in order to successfully publish to everyone with high probability
@@ -1062,6 +1151,10 @@ std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_containe
 	composite->add_component (network.udp_channels.collect_container_info ("udp_channels"));
 	composite->add_component (network.syn_cookies.collect_container_info ("syn_cookies"));
 	composite->add_component (collect_container_info (network.excluded_peers, "excluded_peers"));
+	if (network.recorder)
+	{
+		composite->add_component (collect_container_info (*network.recorder, "traffic_recorder"));
+	}
 	return composite;
 }
 
@@ -16,6 +16,7 @@ namespace vxldollar
 class channel;
 class node;
 class stats;
+class traffic_recorder;
 class transaction;
 class message_buffer final
 {
@@ -23,6 +24,8 @@ public:
 	uint8_t * buffer{ nullptr };
 	std::size_t size{ 0 };
 	vxldollar::endpoint endpoint;
+	/** Set when the datagram has been received, to measure time spent queued */
+	std::chrono::steady_clock::time_point received;
 };
 /**
   * A circular buffer for servicing vxldollar realtime messages.
@@ -150,6 +153,11 @@ public:
 	bool reachout (vxldollar::endpoint const &, bool = false);
 	std::deque<std::shared_ptr<vxldollar::transport::channel>> list (std::size_t, uint8_t = 0, bool = true);
 	std::deque<std::shared_ptr<vxldollar::transport::channel>> list_non_pr (std::size_t);
+	/**
+	 * Keeps \p count_a channels picked at random, weighted by their health so that saturated, lossy or slow peers are chosen less often.
+	 * All channels are kept in random order when there are no more than \p count_a of them.
+	 */
+	void select_by_health (std::deque<std::shared_ptr<vxldollar::transport::channel>> &, std::size_t count_a);
 	// Desired fanout for a given scale
 	std::size_t fanout (float scale = 1.0f) const;
 	void random_fill (std::array<vxldollar::endpoint, 8> &) const;
@@ -170,6 +178,8 @@ public:
 	bool empty () const;
 	void erase (vxldollar::transport::channel const &);
 	void set_bandwidth_params (double, std::size_t);
+	/** Clears the duplicate filter digest of a message which is dropped before being processed, so that its retransmissions are not filtered */
+	void clear_filters (vxldollar::message const &);
 	static std::string to_string (vxldollar::networks);
 
 private:
@@ -185,8 +195,13 @@ public:
 	vxldollar::tcp_message_manager tcp_message_manager;
 	vxldollar::node & node;
 	vxldollar::network_filter publish_filter;
+	vxldollar::network_filter vote_filter;
+	/** Filters confirm_req payloads per sender, entries are cleared when the request aggregator serves them */
+	vxldollar::network_filter confirm_req_filter;
 	vxldollar::transport::udp_channels udp_channels;
 	vxldollar::transport::tcp_channels tcp_channels;
+	/** Set when node_flags::record_traffic_path is given */
+	std::unique_ptr<vxldollar::traffic_recorder> recorder;
 	std::atomic<uint16_t> port{ 0 };
 	std::function<void ()> disconnect_observer;
 	// Called when a new channel is observed
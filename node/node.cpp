@@ -18,6 +18,7 @@
 #include <cstdlib>
 #include <future>
 #include <sstream>
+#include <thread>
 
 double constexpr vxldollar::node::price_max;
 double constexpr vxldollar::node::free_cutoff;
@@ -80,7 +81,7 @@ vxldollar::node::node (boost::asio::io_context & io_ctx_a, uint16_t peering_port
 }
 
 vxldollar::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path const & application_path_a, vxldollar::node_config const & config_a, vxldollar::work_pool & work_a, vxldollar::node_flags flags_a, unsigned seq) :
-	write_database_queue (!flags_a.force_use_write_database_queue && (config_a.rocksdb_config.enable)),
+	write_database_queue (!flags_a.force_use_write_database_queue && (config_a.rocksdb_config.enable), (config_a.lmdb_config.group_commit && !config_a.rocksdb_config.enable) ? std::function<void ()> ([this] () { store.sync (); }) : nullptr, stats),
 	io_ctx (io_ctx_a),
 	node_initialized_latch (1),
 	config (config_a),
@@ -93,7 +94,8 @@ vxldollar::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::pa
 	logger (config_a.logging.min_time_between_log_output),
 	store_impl (vxldollar::make_store (logger, application_path_a, network_params.ledger, flags.read_only, true, config_a.rocksdb_config, config_a.diagnostics_config.txn_tracking, config_a.block_processor_batch_max_time, config_a.lmdb_config, config_a.backup_before_upgrade)),
 	store (*store_impl),
-	unchecked{ store, flags.disable_block_processor_unchecked_deletion },
+	unchecked{ store, flags.disable_block_processor_unchecked_deletion, config.unchecked_memory_limit },
+	ledger_backup (store, logger),
 	wallets_store_impl (std::make_unique<vxldollar::mdb_wallets_store> (application_path_a / "wallets.ldb", config_a.lmdb_config)),
 	wallets_store (*wallets_store_impl),
 	gap_cache (*this),
@@ -125,7 +127,7 @@ vxldollar::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::pa
 	confirmation_height_processor (ledger, write_database_queue, config.conf_height_processor_batch_min_time, config.logging, logger, node_initialized_latch, flags.confirmation_height_processor_mode),
 	active (*this, confirmation_height_processor),
 	scheduler{ *this },
-	aggregator (config, stats, active.generator, active.final_generator, history, ledger, wallets, active),
+	aggregator (config, stats, active.generator, active.final_generator, history, ledger, wallets, active, network.confirm_req_filter),
 	wallets (wallets_store.init_error (), *this),
 	startup_time (std::chrono::steady_clock::now ()),
 	node_seq (seq)
@@ -441,6 +443,43 @@ vxldollar::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::pa
 				std::exit (1);
 			}
 		}
+
+		if (config.block_filter_false_positive_rate > 0 && !flags.inactive_node)
+		{
+			vxldollar::timer<std::chrono::milliseconds> timer (vxldollar::timer_state::started);
+			ledger.block_filter_enable (config.block_filter_false_positive_rate, config.block_filter_memory_limit);
+			auto const & filter (*store.block_filter ());
+			logger.always_log (boost::str (boost::format ("Block filter of %1% hashes populated in %2% ms, using %3% MB for an expected false positive rate of %4%") % filter.size () % timer.stop ().count () % (filter.memory_size () / (1024 * 1024)) % filter.false_positive_rate ()));
+		}
+
+		store.instrumentation.enable (config.diagnostics_config.store_instrumentation.enable, config.diagnostics_config.store_instrumentation.sample_interval);
+
+		// The account height index is either complete or empty, it is only maintained while enabled
+		auto account_height_index_empty (false);
+		{
+			auto const transaction (store.tx_begin_read ());
+			account_height_index_empty = store.account_height.begin (transaction) == store.account_height.end ();
+		}
+		if (!flags.read_only)
+		{
+			if (config.account_height_index && account_height_index_empty)
+			{
+				logger.always_log ("Building account height index...");
+				vxldollar::timer<std::chrono::milliseconds> timer (vxldollar::timer_state::started);
+				auto transaction (store.tx_begin_write ({ tables::account_heights }));
+				auto indexed (ledger.account_height_index_build (transaction));
+				logger.always_log (boost::str (boost::format ("Finished building account height index, %1% blocks indexed in %2% ms") % indexed % timer.stop ().count ()));
+				account_height_index_empty = false;
+			}
+			else if (!config.account_height_index && !account_height_index_empty)
+			{
+				auto const transaction (store.tx_begin_write ({ tables::account_heights }));
+				store.account_height.clear (transaction);
+				logger.always_log ("Dropped account height index as node.account_height_index is disabled");
+				account_height_index_empty = true;
+			}
+		}
+		ledger.account_height_index = config.account_height_index && !account_height_index_empty;
 	}
 	node_initialized_latch.count_down ();
 }
@@ -537,6 +576,7 @@ std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_containe
 	composite->add_component (collect_container_info (node.work, "work"));
 	composite->add_component (collect_container_info (node.gap_cache, "gap_cache"));
 	composite->add_component (collect_container_info (node.ledger, "ledger"));
+	composite->add_component (collect_container_info (node.store.instrumentation, "store_instrumentation"));
 	composite->add_component (collect_container_info (node.active, "active"));
 	composite->add_component (collect_container_info (node.bootstrap_initiator, "bootstrap_initiator"));
 	composite->add_component (collect_container_info (node.bootstrap, "bootstrap"));
@@ -551,6 +591,7 @@ std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_containe
 	composite->add_component (collect_container_info (node.vote_processor, "vote_processor"));
 	composite->add_component (collect_container_info (node.rep_crawler, "rep_crawler"));
 	composite->add_component (collect_container_info (node.block_processor, "block_processor"));
+	composite->add_component (collect_container_info (node.unchecked, "unchecked"));
 	composite->add_component (collect_container_info (node.block_arrival, "block_arrival"));
 	composite->add_component (collect_container_info (node.online_reps, "online_reps"));
 	composite->add_component (collect_container_info (node.history, "history"));
@@ -571,7 +612,7 @@ void vxldollar::node::process_active (std::shared_ptr<vxldollar::block> const &
 
 vxldollar::process_return vxldollar::node::process (vxldollar::block & block_a)
 {
-	auto const transaction (store.tx_begin_write ({ tables::accounts, tables::blocks, tables::frontiers, tables::pending }));
+	auto const transaction (store.tx_begin_write ({ tables::account_heights, tables::accounts, tables::blocks, tables::frontiers, tables::pending }));
 	auto result (ledger.process (transaction, block_a));
 	return result;
 }
@@ -586,7 +627,7 @@ vxldollar::process_return vxldollar::node::process_local (std::shared_ptr<vxldol
 	block_processor.wait_write ();
 	// Process block
 	block_post_events post_events ([&store = store] { return store.tx_begin_read (); });
-	auto const transaction (store.tx_begin_write ({ tables::accounts, tables::blocks, tables::frontiers, tables::pending }));
+	auto const transaction (store.tx_begin_write ({ tables::account_heights, tables::accounts, tables::blocks, tables::frontiers, tables::pending }));
 	return block_processor.process_one (transaction, post_events, info, false, vxldollar::block_origin::local);
 }
 
@@ -699,6 +740,7 @@ void vxldollar::node::stop ()
 		port_mapping.stop ();
 		checker.stop ();
 		wallets.stop ();
+		ledger_backup.stop ();
 		stats.stop ();
 		auto epoch_upgrade = epoch_upgrading.lock ();
 		if (epoch_upgrade->valid ())
@@ -997,101 +1039,154 @@ void vxldollar::node::ongoing_backlog_population ()
 	});
 }
 
-bool vxldollar::node::collect_ledger_pruning_targets (std::deque<vxldollar::block_hash> & pruning_targets_a, vxldollar::account & last_account_a, uint64_t const batch_read_size_a, uint64_t const max_depth_a, uint64_t const cutoff_time_a)
+void vxldollar::node::collect_ledger_pruning_targets (std::vector<vxldollar::pruning_target> & pruning_targets_a, vxldollar::pruning_range & range_a, uint64_t const batch_read_size_a, uint64_t const max_depth_a, uint64_t const cutoff_time_a)
 {
 	uint64_t read_operations (0);
-	bool finish_transaction (false);
 	auto const transaction (store.tx_begin_read ());
-	for (auto i (store.confirmation_height.begin (transaction, last_account_a)), n (store.confirmation_height.end ()); i != n && !finish_transaction;)
+	auto i (store.confirmation_height.begin (transaction, range_a.next));
+	auto const n (store.confirmation_height.end ());
+	while (read_operations < batch_read_size_a && !range_a.finished)
 	{
-		++read_operations;
-		auto const & account (i->first);
-		vxldollar::block_hash hash (i->second.frontier);
-		uint64_t depth (0);
-		while (!hash.is_zero () && depth < max_depth_a)
+		if (!range_a.chain.is_zero ())
 		{
-			auto block (store.block.get (transaction, hash));
+			// The whole chain below a target is collected, down to an already pruned block or the genesis block
+			auto block (range_a.chain != network_params.ledger.genesis->hash () ? store.block.get (transaction, range_a.chain) : nullptr);
+			++read_operations;
 			if (block != nullptr)
 			{
-				if (block->sideband ().timestamp > cutoff_time_a || depth == 0)
-				{
-					hash = block->previous ();
-				}
-				else
-				{
-					break;
-				}
+				pruning_targets_a.push_back ({ range_a.chain, store.block.account_calculated (*block), block->sideband ().height });
+				range_a.chain = block->previous ();
 			}
 			else
 			{
-				release_assert (depth != 0);
-				hash = 0;
+				range_a.chain = 0;
 			}
-			if (++depth % batch_read_size_a == 0)
-			{
-				transaction.refresh ();
-			}
-		}
-		if (!hash.is_zero ())
-		{
-			pruning_targets_a.push_back (hash);
 		}
-		read_operations += depth;
-		if (read_operations >= batch_read_size_a)
+		else if (i == n || (!range_a.end.is_zero () && i->first.number () >= range_a.end.number ()) || stopped)
 		{
-			last_account_a = account.number () + 1;
-			finish_transaction = true;
+			// A chain being collected is always finished, otherwise its blocks below the pruned ones could not be reached again
+			range_a.finished = true;
 		}
 		else
 		{
+			++read_operations;
+			vxldollar::block_hash hash (i->second.frontier);
+			uint64_t depth (0);
+			while (!hash.is_zero () && depth < max_depth_a)
+			{
+				auto block (store.block.get (transaction, hash));
+				if (block != nullptr)
+				{
+					if (block->sideband ().timestamp > cutoff_time_a || depth == 0)
+					{
+						hash = block->previous ();
+					}
+					else
+					{
+						break;
+					}
+				}
+				else
+				{
+					release_assert (depth != 0);
+					hash = 0;
+				}
+				++depth;
+			}
+			read_operations += depth;
+			range_a.chain = hash;
+			range_a.next = i->first.number () + 1;
+			range_a.finished = range_a.next.is_zero ();
 			++i;
 		}
 	}
-	return !finish_transaction || last_account_a.is_zero ();
 }
 
 void vxldollar::node::ledger_pruning (uint64_t const batch_size_a, bool bootstrap_weight_reached_a, bool log_to_cout_a)
 {
+	vxldollar::lock_guard<vxldollar::mutex> pruning_lock (pruning_mutex);
 	uint64_t const max_depth (config.max_pruning_depth != 0 ? config.max_pruning_depth : std::numeric_limits<uint64_t>::max ());
 	uint64_t const cutoff_time (bootstrap_weight_reached_a ? vxldollar::seconds_since_epoch () - config.max_pruning_age.count () : std::numeric_limits<uint64_t>::max ());
-	uint64_t pruned_count (0);
-	uint64_t transaction_write_count (0);
-	vxldollar::account last_account (1); // 0 Burn account is never opened. So it can be used to break loop
-	std::deque<vxldollar::block_hash> pruning_targets;
-	bool target_finished (false);
-	while ((transaction_write_count != 0 || !target_finished) && !stopped)
-	{
-		// Search pruning targets
-		while (pruning_targets.size () < batch_size_a && !target_finished && !stopped)
+	auto log_progress = [this, log_to_cout_a] (std::string const & message_a) {
+		if (!log_to_cout_a)
+		{
+			logger.try_log (message_a);
+		}
+		else
 		{
-			target_finished = collect_ledger_pruning_targets (pruning_targets, last_account, batch_size_a * 2, max_depth, cutoff_time);
+			std::cout << message_a << std::endl;
 		}
-		// Pruning write operation
-		transaction_write_count = 0;
-		if (!pruning_targets.empty () && !stopped)
+	};
+	// Each thread collects targets from its own range of accounts
+	auto const thread_count (std::max (1u, config.pruning_threads));
+	std::vector<vxldollar::pruning_range> ranges (thread_count);
+	vxldollar::uint256_t const range_size (std::numeric_limits<vxldollar::uint256_t>::max () / thread_count);
+	for (unsigned i (0); i < thread_count; ++i)
+	{
+		ranges[i].next = i != 0 ? vxldollar::account (range_size * i) : vxldollar::account (1); // 0 Burn account is never opened
+		ranges[i].end = i + 1 != thread_count ? vxldollar::account (range_size * (i + 1)) : vxldollar::account (0);
+	}
+	vxldollar::timer<std::chrono::milliseconds> timer (vxldollar::timer_state::started);
+	uint64_t pruned_count (0);
+	auto unfinished = [&ranges] () {
+		return std::any_of (ranges.begin (), ranges.end (), [] (vxldollar::pruning_range const & range_a) { return !range_a.finished; });
+	};
+	while (unfinished () && !stopped)
+	{
+		std::vector<std::vector<vxldollar::pruning_target>> collected (thread_count);
 		{
-			auto scoped_write_guard = write_database_queue.wait (vxldollar::writer::pruning);
-			auto write_transaction (store.tx_begin_write ({ tables::blocks, tables::pruned }));
-			while (!pruning_targets.empty () && transaction_write_count < batch_size_a && !stopped)
+			std::vector<std::thread> threads;
+			for (unsigned i (0); i < thread_count; ++i)
 			{
-				auto const & pruning_hash (pruning_targets.front ());
-				auto account_pruned_count (ledger.pruning_action (write_transaction, pruning_hash, batch_size_a));
-				transaction_write_count += account_pruned_count;
-				pruning_targets.pop_front ();
+				if (!ranges[i].finished)
+				{
+					threads.emplace_back ([this, &collected, &ranges, i, batch_size_a, max_depth, cutoff_time] () {
+						vxldollar::thread_role::set (vxldollar::thread_role::name::db_parallel_traversal);
+						collect_ledger_pruning_targets (collected[i], ranges[i], batch_size_a * 2, max_depth, cutoff_time);
+					});
+				}
 			}
-			pruned_count += transaction_write_count;
-			auto log_message (boost::str (boost::format ("%1% blocks pruned") % pruned_count));
-			if (!log_to_cout_a)
+			for (auto & thread : threads)
 			{
-				logger.try_log (log_message);
+				thread.join ();
 			}
-			else
+		}
+		std::vector<vxldollar::pruning_target> pruning_targets;
+		for (auto const & targets : collected)
+		{
+			pruning_targets.insert (pruning_targets.end (), targets.begin (), targets.end ());
+		}
+		// Each chain is pruned from its lowest block upwards, so that its pruned blocks stay below the unpruned ones if the round is interrupted.
+		// Targets are collected by walking down from the newest unpruned block until a missing one, a gap higher up would hide the blocks below it.
+		std::sort (pruning_targets.begin (), pruning_targets.end (), [] (vxldollar::pruning_target const & a, vxldollar::pruning_target const & b) {
+			return a.account < b.account || (a.account == b.account && a.height < b.height);
+		});
+		for (auto i (pruning_targets.begin ()), n (pruning_targets.end ()); i != n && !stopped;)
+		{
+			auto const batch_end (i + std::min<std::ptrdiff_t> (batch_size_a, n - i));
+			auto const batch_count (static_cast<uint64_t> (batch_end - i));
+			vxldollar::timer<std::chrono::microseconds> write_timer (vxldollar::timer_state::started);
+			{
+				auto scoped_write_guard = write_database_queue.wait (vxldollar::writer::pruning);
+				auto write_transaction (store.tx_begin_write ({ tables::account_heights, tables::blocks, tables::pruned }));
+				for (; i != batch_end; ++i)
+				{
+					ledger.prune (write_transaction, *i);
+				}
+			}
+			auto const write_time (write_timer.stop ());
+			pruned_count += batch_count;
+			stats.add (vxldollar::stat::type::pruning, vxldollar::stat::detail::pruned, vxldollar::stat::dir::in, batch_count);
+			log_progress (boost::str (boost::format ("%1% blocks pruned, %2% blocks/s") % pruned_count % (pruned_count * 1000 / std::max<uint64_t> (timer.since_start ().count (), 1))));
+			// The write lock is left to block processing for the rest of the write budget
+			if (config.pruning_write_share < 1 && (i != n || unfinished ()) && !stopped)
 			{
-				std::cout << log_message << std::endl;
+				std::this_thread::sleep_for (std::chrono::duration_cast<std::chrono::microseconds> (write_time * ((1 - config.pruning_write_share) / config.pruning_write_share)));
 			}
 		}
 	}
-	auto const log_message (boost::str (boost::format ("Total recently pruned block count: %1%") % pruned_count));
+	auto const elapsed (timer.stop ());
+	auto const log_message (boost::str (boost::format ("Total recently pruned block count: %1% in %2% ms, %3% blocks/s") % pruned_count % elapsed.count () % (pruned_count * 1000 / std::max<uint64_t> (elapsed.count (), 1))));
 	if (!log_to_cout_a)
 	{
 		logger.always_log (log_message);
@@ -1408,7 +1503,7 @@ bool vxldollar::block_arrival::add (vxldollar::block_hash const & hash_a)
 	return result;
 }
 
-bool vxldollar::block_arrival::recent (vxldollar::block_hash const & hash_a)
+bool vxldollar::block_arrival::recent (vxldollar::block_hash const & hash_a, std::chrono::steady_clock::time_point * arrival_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
 	auto now (std::chrono::steady_clock::now ());
@@ -1416,7 +1511,13 @@ bool vxldollar::block_arrival::recent (vxldollar::block_hash const & hash_a)
 	{
 		arrival.get<tag_sequence> ().pop_front ();
 	}
-	return arrival.get<tag_hash> ().find (hash_a) != arrival.get<tag_hash> ().end ();
+	auto existing (arrival.get<tag_hash> ().find (hash_a));
+	auto result (existing != arrival.get<tag_hash> ().end ());
+	if (result && arrival_a != nullptr)
+	{
+		*arrival_a = existing->arrival;
+	}
+	return result;
 }
 
 std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_container_info (block_arrival & block_arrival, std::string const & name)
@@ -13,6 +13,7 @@
 #include <vxldollar/node/election.hpp>
 #include <vxldollar/node/election_scheduler.hpp>
 #include <vxldollar/node/gap_cache.hpp>
+#include <vxldollar/node/ledger_backup.hpp>
 #include <vxldollar/node/network.hpp>
 #include <vxldollar/node/node_observers.hpp>
 #include <vxldollar/node/nodeconfig.hpp>
@@ -63,7 +64,8 @@ class block_arrival final
 public:
 	// Return `true' to indicated an error if the block has already been inserted
 	bool add (vxldollar::block_hash const &);
-	bool recent (vxldollar::block_hash const &);
+	/** @param arrival_a if given and the block is recent, will be set to its arrival time */
+	bool recent (vxldollar::block_hash const &, std::chrono::steady_clock::time_point * arrival_a = nullptr);
 	// clang-format off
 	class tag_sequence {};
 	class tag_hash {};
@@ -83,6 +85,18 @@ std::unique_ptr<container_info_component> collect_container_info (block_arrival
 
 std::unique_ptr<container_info_component> collect_container_info (rep_crawler & rep_crawler, std::string const & name);
 
+/** A range of accounts which ledger pruning collects targets from, and the position reached in it */
+class pruning_range final
+{
+public:
+	vxldollar::account next;
+	/** Exclusive, zero for the end of the account space */
+	vxldollar::account end;
+	/** Next block of the chain being collected, zero if none */
+	vxldollar::block_hash chain{ 0 };
+	bool finished{ false };
+};
+
 class node final : public std::enable_shared_from_this<vxldollar::node>
 {
 public:
@@ -125,7 +139,7 @@ public:
 	void search_receivable_all ();
 	void bootstrap_wallet ();
 	void unchecked_cleanup ();
-	bool collect_ledger_pruning_targets (std::deque<vxldollar::block_hash> &, vxldollar::account &, uint64_t const, uint64_t const, uint64_t const);
+	void collect_ledger_pruning_targets (std::vector<vxldollar::pruning_target> &, vxldollar::pruning_range &, uint64_t const, uint64_t const, uint64_t const);
 	void ledger_pruning (uint64_t const, bool, bool);
 	void ongoing_ledger_pruning ();
 	int price (vxldollar::uint128_t const &, int);
@@ -168,6 +182,7 @@ public:
 	std::unique_ptr<vxldollar::store> store_impl;
 	vxldollar::store & store;
 	vxldollar::unchecked_map unchecked;
+	vxldollar::ledger_backup ledger_backup;
 	std::unique_ptr<vxldollar::wallets_store> wallets_store_impl;
 	vxldollar::wallets_store & wallets_store;
 	vxldollar::gap_cache gap_cache;
@@ -199,6 +214,7 @@ public:
 	std::chrono::seconds unchecked_cutoff = std::chrono::seconds (7 * 24 * 60 * 60); // Week
 	std::atomic<bool> unresponsive_work_peers{ false };
 	std::atomic<bool> stopped{ false };
+	vxldollar::mutex pruning_mutex;
 	static double constexpr price_max = 16.0;
 	static double constexpr free_cutoff = 1024.0;
 	// For tests only
@@ -13,6 +13,7 @@
 
 #include <chrono>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mi = boost::multi_index;
@@ -102,6 +103,15 @@ public:
 	 */
 	bool response (std::shared_ptr<vxldollar::transport::channel> const &, std::shared_ptr<vxldollar::vote> const &);
 
+	/** Returns true if \p vote_a contains a hash of an outstanding query, in which case repeats of it are possible replies and must not be filtered out */
+	bool is_pending (std::shared_ptr<vxldollar::vote> const & vote_a);
+
+	/**
+	 * Returns true if a query to a peer at \p address_a is outstanding. Its votes skip the duplicate filter, as a reply can repeat a vote seen before the query.
+	 * Peers are matched by address, since replies may arrive on another connection than the query.
+	 */
+	bool is_queried (boost::asio::ip::address const & address_a);
+
 	/** Get total available weight from representatives */
 	vxldollar::uint128_t total_weight () const;
 
@@ -126,6 +136,9 @@ private:
 	/** We have solicted votes for these random blocks */
 	std::unordered_set<vxldollar::block_hash> active;
 
+	/** Addresses of the peers queried for each active hash */
+	std::unordered_multimap<boost::asio::ip::address, vxldollar::block_hash> queried;
+
 	// Validate responses to see if they're reps
 	void validate ();
 
@@ -153,6 +166,7 @@ private:
 	friend class active_transactions_confirm_election_by_request_Test;
 	friend class active_transactions_confirm_frontier_Test;
 	friend class rep_crawler_local_Test;
+	friend class rep_crawler_queried_unfiltered_Test;
 	friend class node_online_reps_rep_crawler_Test;
 
 	std::deque<std::pair<std::shared_ptr<vxldollar::transport::channel>, std::shared_ptr<vxldollar::vote>>> responses;
@@ -20,6 +20,7 @@ namespace vxldollar
 class active_transactions;
 class ledger;
 class local_vote_history;
+class network_filter;
 class node_config;
 class stat;
 class vote_generator;
@@ -47,6 +48,8 @@ class request_aggregator final
 		{
 		}
 		std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> hashes_roots;
+		/** Duplicate filter digests of the requests in this pool, cleared once the pool is served */
+		std::vector<vxldollar::uint128_t> digests;
 		std::shared_ptr<vxldollar::transport::channel> channel;
 		vxldollar::endpoint endpoint;
 		std::chrono::steady_clock::time_point const start{ std::chrono::steady_clock::now () };
@@ -59,10 +62,13 @@ class request_aggregator final
 	// clang-format on
 
 public:
-	request_aggregator (vxldollar::node_config const & config, vxldollar::stat & stats_a, vxldollar::vote_generator &, vxldollar::vote_generator &, vxldollar::local_vote_history &, vxldollar::ledger &, vxldollar::wallets &, vxldollar::active_transactions &);
+	request_aggregator (vxldollar::node_config const & config, vxldollar::stat & stats_a, vxldollar::vote_generator &, vxldollar::vote_generator &, vxldollar::local_vote_history &, vxldollar::ledger &, vxldollar::wallets &, vxldollar::active_transactions &, vxldollar::network_filter &);
 
-	/** Add a new request by \p channel_a for hashes \p hashes_roots_a */
-	void add (std::shared_ptr<vxldollar::transport::channel> const & channel_a, std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> const & hashes_roots_a);
+	/**
+	 * Add a new request by \p channel_a for hashes \p hashes_roots_a
+	 * A non-zero \p digest_a is cleared from the confirm_req filter once the request is served or rejected, so that later requests are not dropped as duplicates
+	 */
+	void add (std::shared_ptr<vxldollar::transport::channel> const & channel_a, std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> const & hashes_roots_a, vxldollar::uint128_t const & digest_a = 0);
 	void stop ();
 	/** Returns the number of currently queued request pools */
 	std::size_t size ();
@@ -88,6 +94,7 @@ private:
 	vxldollar::active_transactions & active;
 	vxldollar::vote_generator & generator;
 	vxldollar::vote_generator & final_generator;
+	vxldollar::network_filter & confirm_req_filter;
 
 	// clang-format off
 	boost::multi_index_container<channel_pool,
@@ -9,13 +9,19 @@
 #include <boost/polymorphic_cast.hpp>
 #include <boost/property_tree/ptree.hpp>
 
+#include <rocksdb/convenience.h>
 #include <rocksdb/merge_operator.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/slice_transform.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/utilities/backupable_db.h>
 #include <rocksdb/utilities/transaction.h>
 #include <rocksdb/utilities/transaction_db.h>
 
+#include <numeric>
+
 namespace
 {
 class event_listener : public rocksdb::EventListener
@@ -34,6 +40,95 @@ public:
 private:
 	std::function<void (rocksdb::FlushJobInfo const &)> flush_completed_cb;
 };
+
+/** Reads the perf context of the calling thread, counting is enabled the same way as for the cache counters */
+class perf_context_backend final : public vxldollar::store_instrumentation::backend
+{
+public:
+	void sample_begin (vxldollar::store_instrumentation::counter_values & counters_a) override
+	{
+		// The backend is shared by all threads, the perf level of each thread is saved by the outermost sample
+		if (sample_depth++ == 0)
+		{
+			previous_level = rocksdb::GetPerfLevel ();
+		}
+		if (rocksdb::GetPerfLevel () < rocksdb::PerfLevel::kEnableCount)
+		{
+			rocksdb::SetPerfLevel (rocksdb::PerfLevel::kEnableCount);
+		}
+		read (counters_a);
+	}
+
+	void sample_end (vxldollar::store_instrumentation::counter_values & counters_a) override
+	{
+		read (counters_a);
+		debug_assert (sample_depth > 0);
+		if (--sample_depth == 0)
+		{
+			rocksdb::SetPerfLevel (previous_level);
+		}
+	}
+
+private:
+	static thread_local unsigned sample_depth;
+	static thread_local rocksdb::PerfLevel previous_level;
+
+	static void read (vxldollar::store_instrumentation::counter_values & counters_a)
+	{
+		using counter = vxldollar::store_instrumentation::counter;
+		auto context (rocksdb::get_perf_context ());
+		counters_a[static_cast<std::size_t> (counter::block_reads)] = context->block_read_count;
+		counters_a[static_cast<std::size_t> (counter::block_read_bytes)] = context->block_read_byte;
+		counters_a[static_cast<std::size_t> (counter::block_cache_hits)] = context->block_cache_hit_count;
+		counters_a[static_cast<std::size_t> (counter::memtable_lookups)] = context->get_from_memtable_count;
+		counters_a[static_cast<std::size_t> (counter::bloom_filter_useful)] = context->bloom_sst_miss_count;
+	}
+};
+
+thread_local unsigned perf_context_backend::sample_depth{ 0 };
+thread_local rocksdb::PerfLevel perf_context_backend::previous_level{ rocksdb::PerfLevel::kDisable };
+
+class sst_table_file_writer final : public vxldollar::table_file_writer
+{
+public:
+	sst_table_file_writer (rocksdb::Options const & options_a, rocksdb::ColumnFamilyHandle * handle_a, boost::filesystem::path const & path_a) :
+		writer (rocksdb::EnvOptions{}, options_a, handle_a),
+		path (path_a)
+	{
+	}
+
+	bool open ()
+	{
+		return !writer.Open (path.string ()).ok ();
+	}
+
+	bool put (uint8_t const * key_a, std::size_t key_size_a, uint8_t const * value_a, std::size_t value_size_a) override
+	{
+		++entries;
+		return !writer.Put (rocksdb::Slice (reinterpret_cast<char const *> (key_a), key_size_a), rocksdb::Slice (reinterpret_cast<char const *> (value_a), value_size_a)).ok ();
+	}
+
+	bool finish () override
+	{
+		auto error (false);
+		// RocksDB cannot create a table file without entries
+		if (entries > 0)
+		{
+			error = !writer.Finish ().ok ();
+		}
+		else
+		{
+			boost::system::error_code ec;
+			boost::filesystem::remove (path, ec);
+		}
+		return error;
+	}
+
+private:
+	rocksdb::SstFileWriter writer;
+	boost::filesystem::path const path;
+	uint64_t entries{ 0 };
+};
 }
 
 namespace vxldollar
@@ -77,7 +172,8 @@ vxldollar::rocksdb_store::rocksdb_store (vxldollar::logger_mt & logger_a, boost:
 		peer_store_partial,
 		confirmation_height_store_partial,
 		final_vote_store_partial,
-		version_rocksdb_store
+		version_rocksdb_store,
+		account_height_store_partial
 	},
 	// clang-format on
 	block_store_partial{ *this },
@@ -91,12 +187,16 @@ vxldollar::rocksdb_store::rocksdb_store (vxldollar::logger_mt & logger_a, boost:
 	confirmation_height_store_partial{ *this },
 	final_vote_store_partial{ *this },
 	version_rocksdb_store{ *this },
+	account_height_store_partial{ *this },
 	logger{ logger_a },
 	constants{ constants },
 	rocksdb_config{ rocksdb_config_a },
+	block_cache{ rocksdb::NewLRUCache (rocksdb::LRUCacheOptions (rocksdb_config_a.memory_budget_bytes (), -1, false, high_priority_pool_ratio)) },
+	write_buffer_manager{ std::make_shared<rocksdb::WriteBufferManager> (rocksdb_config_a.memory_budget_bytes () / write_buffer_budget_divisor, block_cache) },
 	max_block_write_batch_num_m{ vxldollar::narrow_cast<unsigned> (blocks_memtable_size_bytes () / (2 * (sizeof (vxldollar::block_type) + vxldollar::state_block::size + vxldollar::block_sideband::size (vxldollar::block_type::state)))) },
 	cf_name_table_map{ create_cf_name_table_map () }
 {
+	instrumentation.backend_set (std::make_unique<perf_context_backend> ());
 	boost::system::error_code error_mkdir, error_chmod;
 	boost::filesystem::create_directories (path_a, error_mkdir);
 	vxldollar::set_secure_perm_directory (path_a, error_chmod);
@@ -105,6 +205,13 @@ vxldollar::rocksdb_store::rocksdb_store (vxldollar::logger_mt & logger_a, boost:
 	if (!error)
 	{
 		generate_tombstone_map ();
+		compression = supported_compression (rocksdb_config.compression);
+		bottommost_compression = supported_compression (rocksdb_config.bottommost_compression);
+		for (auto table : all_tables ())
+		{
+			cache_counters_map.emplace (std::piecewise_construct, std::forward_as_tuple (table), std::forward_as_tuple ());
+		}
+		active_table_factory.reset (rocksdb::NewBlockBasedTableFactory (get_active_table_options ()));
 		small_table_factory.reset (rocksdb::NewBlockBasedTableFactory (get_small_table_options ()));
 		if (!open_read_only_a)
 		{
@@ -128,7 +235,8 @@ std::unordered_map<char const *, vxldollar::tables> vxldollar::rocksdb_store::cr
 		{ "peers", tables::peers },
 		{ "confirmation_height", tables::confirmation_height },
 		{ "pruned", tables::pruned },
-		{ "final_votes", tables::final_votes } };
+		{ "final_votes", tables::final_votes },
+		{ "account_heights", tables::account_heights } };
 
 	debug_assert (map.size () == all_tables ().size () + 1);
 	return map;
@@ -214,18 +322,39 @@ rocksdb::ColumnFamilyOptions vxldollar::rocksdb_store::get_common_cf_options (st
 	// Number of memtables to keep in memory
 	cf_options.max_write_buffer_number = num_memtables;
 
+	// Small tables are not worth compressing, the default would use snappy if it is available
+	cf_options.compression = rocksdb::kNoCompression;
+
 	return cf_options;
 }
 
+rocksdb::CompressionType vxldollar::rocksdb_store::supported_compression (std::string const & compression_a) const
+{
+	auto result (rocksdb::kNoCompression);
+	if (compression_a == "lz4")
+	{
+		result = rocksdb::kLZ4Compression;
+	}
+	else if (compression_a == "zstd")
+	{
+		result = rocksdb::kZSTD;
+	}
+	auto supported (rocksdb::GetSupportedCompressions ());
+	if (result != rocksdb::kNoCompression && std::find (supported.begin (), supported.end (), result) == supported.end ())
+	{
+		logger.always_log (boost::str (boost::format ("RocksDB was built without %1% support, the ledger will not be compressed") % compression_a));
+		result = rocksdb::kNoCompression;
+	}
+	return result;
+}
+
 rocksdb::ColumnFamilyOptions vxldollar::rocksdb_store::get_cf_options (std::string const & cf_name_a) const
 {
 	rocksdb::ColumnFamilyOptions cf_options;
 	auto const memtable_size_bytes = base_memtable_size_bytes ();
-	auto const block_cache_size_bytes = 1024ULL * 1024 * rocksdb_config.memory_multiplier * base_block_cache_size;
 	if (cf_name_a == "unchecked")
 	{
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes * 4)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 
 		// Create prefix bloom for memtable with the size of write_buffer_size * memtable_prefix_bloom_size_ratio
 		cf_options.memtable_prefix_bloom_size_ratio = 0.25;
@@ -238,14 +367,20 @@ rocksdb::ColumnFamilyOptions vxldollar::rocksdb_store::get_cf_options (std::stri
 	}
 	else if (cf_name_a == "blocks")
 	{
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes * 4)));
-		cf_options = get_active_cf_options (table_factory, blocks_memtable_size_bytes ());
+		cf_options = get_active_cf_options (active_table_factory, blocks_memtable_size_bytes ());
+
+		// Blocks repeat accounts, representatives and sideband fields, which a dictionary shared by all blocks of a file compresses well
+		if (bottommost_compression == rocksdb::kZSTD && rocksdb_config.dictionary_bytes > 0)
+		{
+			cf_options.bottommost_compression_opts.enabled = true;
+			cf_options.bottommost_compression_opts.max_dict_bytes = rocksdb_config.dictionary_bytes;
+			cf_options.bottommost_compression_opts.zstd_max_train_bytes = rocksdb_config.dictionary_bytes * dictionary_training_ratio;
+		}
 	}
 	else if (cf_name_a == "confirmation_height")
 	{
 		// Entries will not be deleted in the normal case, so can make memtables a lot bigger
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes * 2);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes * 2);
 	}
 	else if (cf_name_a == "meta" || cf_name_a == "online_weight" || cf_name_a == "peers")
 	{
@@ -262,42 +397,49 @@ rocksdb::ColumnFamilyOptions vxldollar::rocksdb_store::get_cf_options (std::stri
 	else if (cf_name_a == "pending")
 	{
 		// Pending can have a lot of deletions too
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 
 		// Number of files in level 0 which triggers compaction. Size of L0 and L1 should be kept similar as this is the only compaction which is single threaded
 		cf_options.level0_file_num_compaction_trigger = 2;
 
 		// L1 size, compaction is triggered for L0 at this size (2 SST files in L1)
 		cf_options.max_bytes_for_level_base = memtable_size_bytes * 2;
+
+		// Keys start with the account, bloom filters of files and memtables also hold the account so lookups of accounts without pending entries skip them
+		cf_options.prefix_extractor.reset (rocksdb::NewFixedPrefixTransform (sizeof (vxldollar::account)));
+		cf_options.memtable_prefix_bloom_size_ratio = 0.1;
 	}
 	else if (cf_name_a == "frontiers")
 	{
 		// Frontiers is only needed during bootstrap for legacy blocks
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 	}
 	else if (cf_name_a == "accounts")
 	{
 		// Can have deletions from rollbacks
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes * 2)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 	}
 	else if (cf_name_a == "vote")
 	{
 		// No deletes it seems, only overwrites.
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes * 2)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 	}
 	else if (cf_name_a == "pruned")
 	{
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes * 2)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 	}
 	else if (cf_name_a == "final_votes")
 	{
-		std::shared_ptr<rocksdb::TableFactory> table_factory (rocksdb::NewBlockBasedTableFactory (get_active_table_options (block_cache_size_bytes * 2)));
-		cf_options = get_active_cf_options (table_factory, memtable_size_bytes);
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
+
+		// Keys start with the root, most roots have no final vote which the prefix bloom filters answer
+		cf_options.prefix_extractor.reset (rocksdb::NewFixedPrefixTransform (sizeof (vxldollar::root)));
+		cf_options.memtable_prefix_bloom_size_ratio = 0.1;
+	}
+	else if (cf_name_a == "account_heights")
+	{
+		// Appended to as blocks are added, deletions only from rollbacks and pruning
+		cf_options = get_active_cf_options (active_table_factory, memtable_size_bytes);
 	}
 	else if (cf_name_a == rocksdb::kDefaultColumnFamilyName)
 	{
@@ -389,6 +531,8 @@ rocksdb::ColumnFamilyHandle * vxldollar::rocksdb_store::table_to_column_family (
 			return get_handle ("confirmation_height");
 		case tables::final_votes:
 			return get_handle ("final_votes");
+		case tables::account_heights:
+			return get_handle ("account_heights");
 		default:
 			release_assert (false);
 			return get_handle ("");
@@ -399,6 +543,7 @@ bool vxldollar::rocksdb_store::exists (vxldollar::transaction const & transactio
 {
 	rocksdb::PinnableSlice slice;
 	rocksdb::Status status;
+	cache_read_scope cache_scope (cache_counters_map.at (table_a));
 	if (is_read (transaction_a))
 	{
 		status = db->Get (snapshot_options (transaction_a), table_to_column_family (table_a), key_a, &slice);
@@ -413,6 +558,27 @@ bool vxldollar::rocksdb_store::exists (vxldollar::transaction const & transactio
 	return (status.ok ());
 }
 
+bool vxldollar::rocksdb_store::exists_prefix (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & prefix_a) const
+{
+	// Iterating only within the prefix lets the seek skip memtables and files whose prefix bloom filter does not contain it
+	std::unique_ptr<rocksdb::Iterator> iterator;
+	auto handle (table_to_column_family (table_a));
+	if (is_read (transaction_a))
+	{
+		auto options (snapshot_options (transaction_a));
+		options.prefix_same_as_start = true;
+		iterator.reset (db->NewIterator (options, handle));
+	}
+	else
+	{
+		rocksdb::ReadOptions options;
+		options.prefix_same_as_start = true;
+		iterator.reset (tx (transaction_a)->GetIterator (options, handle));
+	}
+	iterator->Seek (prefix_a);
+	return iterator->Valid () && iterator->key ().starts_with (prefix_a);
+}
+
 int vxldollar::rocksdb_store::del (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & key_a)
 {
 	debug_assert (transaction_a.contains (table_a));
@@ -463,13 +629,16 @@ int vxldollar::rocksdb_store::get (vxldollar::transaction const & transaction_a,
 	rocksdb::PinnableSlice slice;
 	auto handle = table_to_column_family (table_a);
 	rocksdb::Status status;
-	if (is_read (transaction_a))
-	{
-		status = db->Get (snapshot_options (transaction_a), handle, key_a, &slice);
-	}
-	else
 	{
-		status = tx (transaction_a)->Get (options, handle, key_a, &slice);
+		cache_read_scope cache_scope (cache_counters_map.at (table_a));
+		if (is_read (transaction_a))
+		{
+			status = db->Get (snapshot_options (transaction_a), handle, key_a, &slice);
+		}
+		else
+		{
+			status = tx (transaction_a)->Get (options, handle, key_a, &slice);
+		}
 	}
 
 	if (status.ok ())
@@ -481,6 +650,43 @@ int vxldollar::rocksdb_store::get (vxldollar::transaction const & transaction_a,
 	return status.code ();
 }
 
+std::vector<int> vxldollar::rocksdb_store::get_many (vxldollar::transaction const & transaction_a, tables table_a, std::vector<vxldollar::rocksdb_val> const & keys_a, std::vector<vxldollar::rocksdb_val> & values_a) const
+{
+	std::vector<rocksdb::Slice> keys;
+	keys.reserve (keys_a.size ());
+	for (auto const & key : keys_a)
+	{
+		keys.push_back (key);
+	}
+	std::vector<rocksdb::PinnableSlice> slices (keys.size ());
+	std::vector<rocksdb::Status> statuses (keys.size ());
+	auto handle = table_to_column_family (table_a);
+	cache_read_scope cache_scope (cache_counters_map.at (table_a));
+	// Batched read path, keys sharing a data block or filter are served with a single read
+	if (is_read (transaction_a))
+	{
+		db->MultiGet (snapshot_options (transaction_a), handle, keys.size (), keys.data (), slices.data (), statuses.data ());
+	}
+	else
+	{
+		rocksdb::ReadOptions options;
+		tx (transaction_a)->MultiGet (options, handle, keys.size (), keys.data (), slices.data (), statuses.data ());
+	}
+	values_a.assign (keys.size (), vxldollar::rocksdb_val{});
+	std::vector<int> result (keys.size ());
+	for (std::size_t i (0), n (keys.size ()); i < n; ++i)
+	{
+		if (statuses[i].ok ())
+		{
+			values_a[i].buffer = std::make_shared<std::vector<uint8_t>> (slices[i].size ());
+			std::memcpy (values_a[i].buffer->data (), slices[i].data (), slices[i].size ());
+			values_a[i].convert_buffer_to_value ();
+		}
+		result[i] = statuses[i].code ();
+	}
+	return result;
+}
+
 int vxldollar::rocksdb_store::put (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & key_a, vxldollar::rocksdb_val const & value_a)
 {
 	debug_assert (transaction_a.contains (table_a));
@@ -536,6 +742,11 @@ uint64_t vxldollar::rocksdb_store::count (vxldollar::transaction const & transac
 	{
 		db->GetIntProperty (table_to_column_family (table_a), "rocksdb.estimate-num-keys", &sum);
 	}
+	// This is only an estimation, rollbacks and pruning delete from it
+	else if (table_a == tables::account_heights)
+	{
+		db->GetIntProperty (table_to_column_family (table_a), "rocksdb.estimate-num-keys", &sum);
+	}
 	// Accounts and blocks should only be used in tests and CLI commands to check database consistency
 	// otherwise there can be performance issues.
 	else if (table_a == tables::accounts)
@@ -646,6 +857,9 @@ rocksdb::Options vxldollar::rocksdb_store::get_db_options ()
 	// Start aggressively flushing WAL files when they reach over 1GB
 	db_options.max_total_wal_size = 1 * 1024 * 1024 * 1024LL;
 
+	// Memtables of all tables are flushed when they use their share of the memory budget
+	db_options.write_buffer_manager = write_buffer_manager;
+
 	// Optimize RocksDB. This is the easiest way to get RocksDB to perform well
 	db_options.IncreaseParallelism (rocksdb_config.io_threads);
 	db_options.OptimizeLevelStyleCompaction ();
@@ -669,7 +883,7 @@ rocksdb::Options vxldollar::rocksdb_store::get_db_options ()
 	return db_options;
 }
 
-rocksdb::BlockBasedTableOptions vxldollar::rocksdb_store::get_active_table_options (std::size_t lru_size) const
+rocksdb::BlockBasedTableOptions vxldollar::rocksdb_store::get_active_table_options () const
 {
 	rocksdb::BlockBasedTableOptions table_options;
 
@@ -683,8 +897,12 @@ rocksdb::BlockBasedTableOptions vxldollar::rocksdb_store::get_active_table_optio
 	table_options.format_version = 4;
 	table_options.index_block_restart_interval = 16;
 
-	// Block cache for reads
-	table_options.block_cache = rocksdb::NewLRUCache (lru_size);
+	// Block cache for reads, shared with all tables so that hot tables can use the capacity cold ones leave unused
+	table_options.block_cache = block_cache;
+
+	// Index and filter blocks are charged to the block cache and kept in its high priority pool, so they are evicted after data blocks
+	table_options.cache_index_and_filter_blocks = true;
+	table_options.cache_index_and_filter_blocks_with_high_priority = true;
 
 	// Bloom filter to help with point reads. 10bits gives 1% false positive rate.
 	table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (10, false));
@@ -705,6 +923,7 @@ rocksdb::BlockBasedTableOptions vxldollar::rocksdb_store::get_small_table_option
 	table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash;
 	table_options.data_block_hash_table_util_ratio = 0.75;
 	table_options.block_size = 1024ULL;
+	table_options.block_cache = block_cache;
 	return table_options;
 }
 
@@ -735,6 +954,10 @@ rocksdb::ColumnFamilyOptions vxldollar::rocksdb_store::get_active_cf_options (st
 	// Size target of levels are changed dynamically based on size of the last level
 	cf_options.level_compaction_dynamic_level_bytes = true;
 
+	// Recent data is read the most, the last level holds most of the data and can use a stronger compression
+	cf_options.compression = compression;
+	cf_options.bottommost_compression = bottommost_compression;
+
 	return cf_options;
 }
 
@@ -749,7 +972,7 @@ void vxldollar::rocksdb_store::on_flush (rocksdb::FlushJobInfo const & flush_job
 
 std::vector<vxldollar::tables> vxldollar::rocksdb_store::all_tables () const
 {
-	return std::vector<vxldollar::tables>{ tables::accounts, tables::blocks, tables::confirmation_height, tables::final_votes, tables::frontiers, tables::meta, tables::online_weight, tables::peers, tables::pending, tables::pruned, tables::unchecked, tables::vote };
+	return std::vector<vxldollar::tables>{ tables::account_heights, tables::accounts, tables::blocks, tables::confirmation_height, tables::final_votes, tables::frontiers, tables::meta, tables::online_weight, tables::peers, tables::pending, tables::pruned, tables::unchecked, tables::vote };
 }
 
 bool vxldollar::rocksdb_store::copy_db (boost::filesystem::path const & destination_path)
@@ -822,6 +1045,115 @@ bool vxldollar::rocksdb_store::copy_db (boost::filesystem::path const & destinat
 	return false;
 }
 
+bool vxldollar::rocksdb_store::backup (boost::filesystem::path const & destination_a, vxldollar::backup_progress & progress_a, uint64_t max_bytes_per_second_a)
+{
+	// File deletions cannot be paused on a read-only database
+	if (optimistic_db == nullptr)
+	{
+		return false;
+	}
+	std::vector<rocksdb::LiveFileMetaData> files;
+	db->GetLiveFilesMetaData (&files);
+	progress_a.bytes_total = std::accumulate (files.begin (), files.end (), uint64_t (0), [] (uint64_t total_a, rocksdb::LiveFileMetaData const & file_a) {
+		return total_a + file_a.size;
+	});
+
+	rocksdb::BackupableDBOptions backup_options (destination_a.string ());
+	backup_options.share_table_files = true;
+	backup_options.backup_rate_limit = max_bytes_per_second_a;
+	backup_options.callback_trigger_interval_size = backup_progress_interval;
+	rocksdb::BackupEngine * backup_engine_raw;
+	auto status (rocksdb::BackupEngine::Open (rocksdb::Env::Default (), backup_options, &backup_engine_raw));
+	if (!status.ok ())
+	{
+		return false;
+	}
+	std::unique_ptr<rocksdb::BackupEngine> backup_engine (backup_engine_raw);
+	// Memtables are not flushed, the write ahead log is copied instead, so writers are not stalled
+	status = backup_engine->CreateNewBackup (db.get (), false, [&progress_a, &backup_engine] () {
+		progress_a.bytes_copied += backup_progress_interval;
+		if (progress_a.cancelled)
+		{
+			backup_engine->StopBackup ();
+		}
+	});
+	if (status.ok ())
+	{
+		status = backup_engine->PurgeOldBackups (backups_kept);
+	}
+	return status.ok ();
+}
+
+bool vxldollar::rocksdb_store::compact (vxldollar::tables table_a)
+{
+	auto handle (table_to_column_family (table_a));
+	auto status (db->Flush (rocksdb::FlushOptions{}, handle));
+	if (status.ok ())
+	{
+		// Files already in the last level are rewritten too, so that they use the current compression settings
+		rocksdb::CompactRangeOptions options;
+		options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForce;
+		status = db->CompactRange (options, handle, nullptr, nullptr);
+	}
+	return !status.ok ();
+}
+
+uint64_t vxldollar::rocksdb_store::table_file_size (vxldollar::tables table_a) const
+{
+	uint64_t result (0);
+	db->GetIntProperty (table_to_column_family (table_a), rocksdb::DB::Properties::kTotalSstFilesSize, &result);
+	return result;
+}
+
+void vxldollar::rocksdb_store::for_each_raw (vxldollar::transaction const & transaction_a, tables table_a, uint8_t first_a, uint8_t last_a, std::function<void (uint8_t const *, std::size_t, uint8_t const *, std::size_t)> const & action_a) const
+{
+	std::unique_ptr<rocksdb::Iterator> iterator;
+	auto handle (table_to_column_family (table_a));
+	// Ranges span many prefixes, so prefix bloom filters must not be used
+	if (is_read (transaction_a))
+	{
+		auto options (snapshot_options (transaction_a));
+		options.total_order_seek = true;
+		options.fill_cache = false;
+		iterator.reset (db->NewIterator (options, handle));
+	}
+	else
+	{
+		rocksdb::ReadOptions options;
+		options.total_order_seek = true;
+		options.fill_cache = false;
+		iterator.reset (tx (transaction_a)->GetIterator (options, handle));
+	}
+	auto const first (static_cast<char> (first_a));
+	for (iterator->Seek (rocksdb::Slice (&first, sizeof (first))); iterator->Valid () && !iterator->key ().empty () && static_cast<uint8_t> (iterator->key ()[0]) <= last_a; iterator->Next ())
+	{
+		auto key (iterator->key ());
+		auto value (iterator->value ());
+		action_a (reinterpret_cast<uint8_t const *> (key.data ()), key.size (), reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+	}
+	release_assert (iterator->status ().ok ());
+}
+
+std::unique_ptr<vxldollar::table_file_writer> vxldollar::rocksdb_store::make_table_file_writer (vxldollar::tables table_a, boost::filesystem::path const & path_a)
+{
+	auto handle (table_to_column_family (table_a));
+	auto result (std::make_unique<sst_table_file_writer> (db->GetOptions (handle), handle, path_a));
+	if (result->open ())
+	{
+		result.reset ();
+	}
+	return result;
+}
+
+bool vxldollar::rocksdb_store::ingest (vxldollar::tables table_a, std::vector<boost::filesystem::path> const & paths_a)
+{
+	std::vector<std::string> files;
+	std::transform (paths_a.begin (), paths_a.end (), std::back_inserter (files), [] (auto const & path_a) { return path_a.string (); });
+	rocksdb::IngestExternalFileOptions options;
+	options.move_files = true;
+	return files.empty () ? false : !db->IngestExternalFile (table_to_column_family (table_a), files, options).ok ();
+}
+
 void vxldollar::rocksdb_store::rebuild_db (vxldollar::write_transaction const & transaction_a)
 {
 	// Not available for RocksDB
@@ -832,6 +1164,16 @@ bool vxldollar::rocksdb_store::init_error () const
 	return error;
 }
 
+void vxldollar::rocksdb_store::sync ()
+{
+	// Read-only databases have nothing to flush
+	if (optimistic_db != nullptr)
+	{
+		auto status (db->FlushWAL (true));
+		release_assert (status.ok (), status.ToString ());
+	}
+}
+
 void vxldollar::rocksdb_store::serialize_memory_stats (boost::property_tree::ptree & json)
 {
 	uint64_t val;
@@ -870,13 +1212,55 @@ void vxldollar::rocksdb_store::serialize_memory_stats (boost::property_tree::ptr
 	db->GetAggregatedIntProperty (rocksdb::DB::Properties::kTotalSstFilesSize, &val);
 	json.put ("total-sst-files-size", val);
 
-	// Block cache capacity.
-	db->GetAggregatedIntProperty (rocksdb::DB::Properties::kBlockCacheCapacity, &val);
-	json.put ("block-cache-capacity", val);
+	// Block cache capacity, the cache is shared so the properties of each column family would count it again.
+	json.put ("block-cache-capacity", block_cache->GetCapacity ());
+
+	// Memory size for the entries residing in block cache, including memtables charged to it.
+	json.put ("block-cache-usage", block_cache->GetUsage ());
+	json.put ("block-cache-pinned-usage", block_cache->GetPinnedUsage ());
+
+	// Memtable memory counted against the write buffer budget.
+	json.put ("write-buffer-usage", write_buffer_manager->memory_usage ());
+	json.put ("write-buffer-budget", write_buffer_manager->buffer_size ());
 
-	// Memory size for the entries residing in block cache.
-	db->GetAggregatedIntProperty (rocksdb::DB::Properties::kBlockCacheUsage, &val);
-	json.put ("block-cache-usage", val);
+	// Block cache hit rate of point reads per table
+	boost::property_tree::ptree tables_l;
+	for (auto const & [name, table] : cf_name_table_map)
+	{
+		if (auto it = cache_counters_map.find (table); it != cache_counters_map.end ())
+		{
+			auto hits (it->second.hits.load ());
+			auto misses (it->second.misses.load ());
+			boost::property_tree::ptree table_l;
+			table_l.put ("block-cache-hits", hits);
+			table_l.put ("block-cache-misses", misses);
+			table_l.put ("block-cache-hit-rate", hits + misses > 0 ? static_cast<double> (hits) / (hits + misses) : 0.0);
+			tables_l.add_child (name, table_l);
+		}
+	}
+	json.add_child ("tables", tables_l);
+}
+
+vxldollar::rocksdb_store::cache_read_scope::cache_read_scope (cache_counters & counters_a) :
+	counters (counters_a),
+	previous_level (rocksdb::GetPerfLevel ())
+{
+	// Only counting is enabled, timing stats are not needed
+	if (previous_level < rocksdb::PerfLevel::kEnableCount)
+	{
+		rocksdb::SetPerfLevel (rocksdb::PerfLevel::kEnableCount);
+	}
+	auto context (rocksdb::get_perf_context ());
+	hits = context->block_cache_hit_count;
+	misses = context->block_read_count;
+}
+
+vxldollar::rocksdb_store::cache_read_scope::~cache_read_scope ()
+{
+	auto context (rocksdb::get_perf_context ());
+	counters.hits += context->block_cache_hit_count - hits;
+	counters.misses += context->block_read_count - misses;
+	rocksdb::SetPerfLevel (previous_level);
 }
 
 unsigned long long vxldollar::rocksdb_store::blocks_memtable_size_bytes () const
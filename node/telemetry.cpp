@@ -60,6 +60,11 @@ void vxldollar::telemetry::set (vxldollar::telemetry_ack const & message_a, vxld
 		recent_or_initial_request_telemetry_data.modify (it, [&message_a] (vxldollar::telemetry_info & telemetry_info_a) {
 			telemetry_info_a.data = message_a.data;
 		});
+		if (it->last_request != std::chrono::steady_clock::time_point{})
+		{
+			channel_a.health->rtt_sample (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - it->last_request));
+			stats.inc (vxldollar::stat::type::peering, vxldollar::stat::detail::rtt_sample);
+		}
 
 		// This can also remove the peer
 		auto error = verify_message (message_a, channel_a);
@@ -348,6 +353,7 @@ void vxldollar::telemetry::fire_request_message (std::shared_ptr<vxldollar::tran
 		auto it = recent_or_initial_request_telemetry_data.find (channel_a->get_endpoint ());
 		recent_or_initial_request_telemetry_data.modify (it, [] (vxldollar::telemetry_info & telemetry_info_a) {
 			++telemetry_info_a.round;
+			telemetry_info_a.last_request = std::chrono::steady_clock::now ();
 		});
 		round_l = it->round;
 	}
@@ -355,7 +361,7 @@ void vxldollar::telemetry::fire_request_message (std::shared_ptr<vxldollar::tran
 	std::weak_ptr<vxldollar::telemetry> this_w (shared_from_this ());
 	vxldollar::telemetry_req message{ network_params.network };
 	// clang-format off
-	channel_a->send (message, [this_w, endpoint = channel_a->get_endpoint (), round_l](boost::system::error_code const & ec, std::size_t size_a) {
+	channel_a->send (message, [this_w, endpoint = channel_a->get_endpoint (), health = channel_a->health, round_l](boost::system::error_code const & ec, std::size_t size_a) {
 		if (auto this_l = this_w.lock ())
 		{
 			if (ec)
@@ -368,13 +374,15 @@ void vxldollar::telemetry::fire_request_message (std::shared_ptr<vxldollar::tran
 			else
 			{
 				// If no response is seen after a certain period of time remove it
-				this_l->workers.add_timed_task (std::chrono::steady_clock::now () + this_l->response_time_cutoff, [round_l, this_w, endpoint]() {
+				this_l->workers.add_timed_task (std::chrono::steady_clock::now () + this_l->response_time_cutoff, [round_l, this_w, endpoint, health]() {
 					if (auto this_l = this_w.lock ())
 					{
 						vxldollar::lock_guard<vxldollar::mutex> guard (this_l->mutex);
 						auto it = this_l->recent_or_initial_request_telemetry_data.find (endpoint);
 						if (it != this_l->recent_or_initial_request_telemetry_data.cend () && it->undergoing_request && round_l == it->round)
 						{
+							// A missing response counts as a round trip of the full cutoff
+							health->rtt_sample (std::chrono::duration_cast<std::chrono::microseconds> (this_l->response_time_cutoff));
 							this_l->stats.inc (vxldollar::stat::type::telemetry, vxldollar::stat::detail::no_response_received);
 							this_l->channel_processed (endpoint, true);
 						}
@@ -47,6 +47,8 @@ public:
 	vxldollar::endpoint endpoint;
 	vxldollar::telemetry_data data;
 	std::chrono::steady_clock::time_point last_response;
+	/** When the current request was sent, used to measure the channel round trip time */
+	std::chrono::steady_clock::time_point last_request;
 	bool undergoing_request{ false };
 	uint64_t round{ 0 };
 };
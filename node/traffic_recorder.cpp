@@ -0,0 +1,355 @@
+#include <vxldollar/lib/threading.hpp>
+#include <vxldollar/node/node.hpp>
+#include <vxldollar/node/traffic_recorder.hpp>
+#include <vxldollar/secure/buffer.hpp>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/format.hpp>
+
+#include <cstring>
+#include <thread>
+
+namespace
+{
+template <typename T>
+void write_big_endian (vxldollar::stream & stream_a, T value_a)
+{
+	vxldollar::write (stream_a, boost::endian::native_to_big (value_a));
+}
+
+template <typename T>
+T read_big_endian (uint8_t const * bytes_a)
+{
+	T result;
+	std::memcpy (&result, bytes_a, sizeof (result));
+	return boost::endian::big_to_native (result);
+}
+
+/** Hands every parsed message to the node as if it had arrived on \p channel */
+class replay_visitor final : public vxldollar::message_visitor
+{
+public:
+	replay_visitor (vxldollar::node & node_a, std::shared_ptr<vxldollar::transport::channel> channel_a) :
+		node (node_a),
+		channel (std::move (channel_a))
+	{
+	}
+	void keepalive (vxldollar::keepalive const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	void publish (vxldollar::publish const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	void confirm_req (vxldollar::confirm_req const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	void confirm_ack (vxldollar::confirm_ack const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	void bulk_pull (vxldollar::bulk_pull const &) override
+	{
+		debug_assert (false);
+	}
+	void bulk_pull_account (vxldollar::bulk_pull_account const &) override
+	{
+		debug_assert (false);
+	}
+	void bulk_push (vxldollar::bulk_push const &) override
+	{
+		debug_assert (false);
+	}
+	void frontier_req (vxldollar::frontier_req const &) override
+	{
+		debug_assert (false);
+	}
+	void node_id_handshake (vxldollar::node_id_handshake const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	void telemetry_req (vxldollar::telemetry_req const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	void telemetry_ack (vxldollar::telemetry_ack const & message_a) override
+	{
+		node.network.inbound (message_a, channel);
+	}
+	vxldollar::node & node;
+	std::shared_ptr<vxldollar::transport::channel> channel;
+};
+}
+
+std::array<char, 4> constexpr vxldollar::traffic_log::magic;
+
+vxldollar::traffic_recorder::traffic_recorder (vxldollar::node & node_a, boost::filesystem::path const & path_a) :
+	node (node_a),
+	file (path_a.string (), std::ios::binary | std::ios::trunc)
+{
+	error = !file.is_open ();
+	if (!error)
+	{
+		std::vector<uint8_t> header;
+		{
+			vxldollar::vectorstream stream (header);
+			vxldollar::write (stream, vxldollar::traffic_log::magic);
+			vxldollar::write (stream, vxldollar::traffic_log::version);
+			write_big_endian (stream, static_cast<uint16_t> (node.network_params.network.current_network));
+		}
+		file.write (reinterpret_cast<char const *> (header.data ()), header.size ());
+		thread = std::thread ([this] () { run (); });
+	}
+	else
+	{
+		node.logger.always_log (boost::str (boost::format ("Unable to open traffic log %1%") % path_a));
+	}
+}
+
+vxldollar::traffic_recorder::~traffic_recorder ()
+{
+	stop ();
+}
+
+void vxldollar::traffic_recorder::record (vxldollar::message const & message_a, vxldollar::transport::channel const & channel_a)
+{
+	auto const timestamp (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ());
+	auto const endpoint (channel_a.get_endpoint ());
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	if (stopped || error)
+	{
+		return;
+	}
+	if (buffer.size () >= buffer_max)
+	{
+		++dropped;
+		return;
+	}
+	vxldollar::vectorstream stream (buffer);
+	auto [existing, inserted] = channel_ids.emplace (endpoint, static_cast<uint32_t> (channel_ids.size ()));
+	if (inserted)
+	{
+		vxldollar::write (stream, vxldollar::traffic_log::record_type::channel);
+		write_big_endian (stream, existing->second);
+		vxldollar::write (stream, channel_a.get_type ());
+		vxldollar::write (stream, endpoint.address ().to_v6 ().to_bytes ());
+		write_big_endian (stream, endpoint.port ());
+		vxldollar::write (stream, channel_a.get_node_id ().bytes);
+	}
+	std::vector<uint8_t> message;
+	{
+		vxldollar::vectorstream message_stream (message);
+		message_a.serialize (message_stream);
+	}
+	vxldollar::write (stream, vxldollar::traffic_log::record_type::message);
+	write_big_endian (stream, existing->second);
+	write_big_endian (stream, static_cast<uint64_t> (timestamp));
+	write_big_endian (stream, static_cast<uint32_t> (message.size ()));
+	vxldollar::write (stream, message);
+	++recorded;
+	lock.unlock ();
+	condition.notify_all (); // Notify run ()
+}
+
+void vxldollar::traffic_recorder::stop ()
+{
+	{
+		vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+		stopped = true;
+	}
+	condition.notify_all (); // Notify run ()
+	if (thread.joinable ())
+	{
+		thread.join ();
+	}
+}
+
+void vxldollar::traffic_recorder::flush ()
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	condition.wait (lock, [this] () {
+		return stopped || (buffer.empty () && !writing_back_buffer);
+	});
+}
+
+void vxldollar::traffic_recorder::run ()
+{
+	vxldollar::thread_role::set (vxldollar::thread_role::name::traffic_recorder);
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	// Pending records are still written once stopped, so the log ends on a complete record
+	while (!stopped || !buffer.empty ())
+	{
+		if (!buffer.empty ())
+		{
+			back_buffer.swap (buffer);
+			writing_back_buffer = true;
+			lock.unlock ();
+			file.write (reinterpret_cast<char const *> (back_buffer.data ()), back_buffer.size ());
+			file.flush ();
+			back_buffer.clear ();
+			lock.lock ();
+			writing_back_buffer = false;
+		}
+		else
+		{
+			condition.notify_all (); // Notify flush ()
+			condition.wait (lock, [this] () {
+				return stopped || !buffer.empty ();
+			});
+		}
+	}
+	condition.notify_all (); // Notify flush ()
+}
+
+std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_container_info (traffic_recorder & recorder, std::string const & name)
+{
+	std::size_t buffer_size;
+	std::size_t channels_count;
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (recorder.mutex);
+		buffer_size = recorder.buffer.size ();
+		channels_count = recorder.channel_ids.size ();
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "buffer", buffer_size, sizeof (uint8_t) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "channels", channels_count, sizeof (decltype (recorder.channel_ids)::value_type) }));
+	return composite;
+}
+
+vxldollar::transport::channel_replay::channel_replay (vxldollar::node & node_a, vxldollar::transport::transport_type type_a, vxldollar::endpoint const & endpoint_a) :
+	channel (node_a),
+	type (type_a),
+	endpoint (endpoint_a)
+{
+}
+
+std::size_t vxldollar::transport::channel_replay::hash_code () const
+{
+	std::hash<::vxldollar::endpoint> hash;
+	return hash (endpoint);
+}
+
+bool vxldollar::transport::channel_replay::operator== (vxldollar::transport::channel const & other_a) const
+{
+	auto other_l (dynamic_cast<vxldollar::transport::channel_replay const *> (&other_a));
+	return other_l != nullptr && endpoint == other_l->endpoint;
+}
+
+void vxldollar::transport::channel_replay::send_buffer (vxldollar::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, std::size_t)> const & callback_a, vxldollar::buffer_drop_policy drop_policy_a)
+{
+	set_last_packet_sent (std::chrono::steady_clock::now ());
+	if (callback_a)
+	{
+		node.background ([callback_a, size = buffer_a.size ()] () {
+			callback_a (boost::system::errc::make_error_code (boost::system::errc::success), size);
+		});
+	}
+}
+
+std::string vxldollar::transport::channel_replay::to_string () const
+{
+	return boost::str (boost::format ("%1%") % endpoint);
+}
+
+vxldollar::traffic_replay::traffic_replay (vxldollar::node & node_a, boost::filesystem::path const & path_a) :
+	node (node_a),
+	path (path_a)
+{
+}
+
+bool vxldollar::traffic_replay::run (double speed_a)
+{
+	std::ifstream file (path.string (), std::ios::binary);
+	std::array<uint8_t, vxldollar::traffic_log::magic.size () + 1 + 2> header;
+	auto error (!file.read (reinterpret_cast<char *> (header.data ()), header.size ()));
+	if (!error)
+	{
+		error = !std::equal (vxldollar::traffic_log::magic.begin (), vxldollar::traffic_log::magic.end (), header.begin ());
+		error |= header[vxldollar::traffic_log::magic.size ()] != vxldollar::traffic_log::version;
+		error |= read_big_endian<uint16_t> (header.data () + vxldollar::traffic_log::magic.size () + 1) != static_cast<uint16_t> (node.network_params.network.current_network);
+	}
+	auto const start (std::chrono::steady_clock::now ());
+	while (!error && !node.stopped)
+	{
+		auto type (file.peek ());
+		if (type == std::ifstream::traits_type::eof ())
+		{
+			break;
+		}
+		switch (static_cast<vxldollar::traffic_log::record_type> (type))
+		{
+			case vxldollar::traffic_log::record_type::channel:
+				error = read_channel (file);
+				break;
+			case vxldollar::traffic_log::record_type::message:
+				error = read_message (file, start, speed_a);
+				break;
+			default:
+				error = true;
+				break;
+		}
+	}
+	return error;
+}
+
+bool vxldollar::traffic_replay::read_channel (std::istream & stream_a)
+{
+	std::array<uint8_t, vxldollar::traffic_log::channel_record_size> record;
+	auto error (!stream_a.read (reinterpret_cast<char *> (record.data ()), record.size ()));
+	if (!error)
+	{
+		auto const id (read_big_endian<uint32_t> (record.data () + 1));
+		auto const type (static_cast<vxldollar::transport::transport_type> (record[5]));
+		boost::asio::ip::address_v6::bytes_type address;
+		std::copy_n (record.begin () + 6, address.size (), address.begin ());
+		auto const port (read_big_endian<uint16_t> (record.data () + 22));
+		vxldollar::account node_id;
+		std::copy_n (record.begin () + 24, node_id.bytes.size (), node_id.bytes.begin ());
+		auto channel (std::make_shared<vxldollar::transport::channel_replay> (node, type, vxldollar::endpoint (boost::asio::ip::address_v6 (address), port)));
+		if (!node_id.is_zero ())
+		{
+			channel->set_node_id (node_id);
+		}
+		channels[id] = std::move (channel);
+	}
+	return error;
+}
+
+bool vxldollar::traffic_replay::read_message (std::istream & stream_a, std::chrono::steady_clock::time_point const & start_a, double speed_a)
+{
+	std::array<uint8_t, vxldollar::traffic_log::message_header_size> record;
+	auto error (!stream_a.read (reinterpret_cast<char *> (record.data ()), record.size ()));
+	if (!error)
+	{
+		auto const id (read_big_endian<uint32_t> (record.data () + 1));
+		auto const timestamp (read_big_endian<uint64_t> (record.data () + 5));
+		auto const size (read_big_endian<uint32_t> (record.data () + 13));
+		std::vector<uint8_t> message (size);
+		auto existing (channels.find (id));
+		error = existing == channels.end () || !stream_a.read (reinterpret_cast<char *> (message.data ()), message.size ());
+		if (!error)
+		{
+			// Recording may have started long before the first message, gaps are measured from it
+			if (!first_timestamp)
+			{
+				first_timestamp = timestamp;
+			}
+			if (speed_a > 0)
+			{
+				auto const offset (timestamp > *first_timestamp ? timestamp - *first_timestamp : 0);
+				std::this_thread::sleep_until (start_a + std::chrono::microseconds (static_cast<uint64_t> (offset / speed_a)));
+			}
+			replay_visitor visitor (node, existing->second);
+			vxldollar::message_parser parser (publish_filter, node.block_uniquer, node.vote_uniquer, visitor, node.work, node.network_params.network);
+			parser.deserialize_buffer (message.data (), message.size ());
+			++messages;
+			if (parser.status != vxldollar::message_parser::parse_status::success)
+			{
+				++dropped;
+			}
+		}
+	}
+	return error;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vxldollar/lib/locks.hpp>
+#include <vxldollar/node/transport/transport.hpp>
+#include <vxldollar/secure/network_filter.hpp>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vxldollar
+{
+class node;
+class message;
+class container_info_component;
+
+/**
+ * Binary log of inbound realtime messages, as they reach network::process_message
+ * The log starts with the magic "vxlt", a format version byte and the network id, followed by records. Integers are big endian.
+ * - channel record: record_type::channel, channel id (4 bytes), transport type (1 byte), IPv6 address (16 bytes), port (2 bytes), node id (32 bytes)
+ * - message record: record_type::message, channel id (4 bytes), microseconds since recording started (8 bytes), size (4 bytes), serialized message including its header
+ * A channel record precedes the first message received on that channel.
+ */
+class traffic_log final
+{
+public:
+	enum class record_type : uint8_t
+	{
+		channel = 0,
+		message = 1
+	};
+	static std::array<char, 4> constexpr magic{ { 'v', 'x', 'l', 't' } };
+	static uint8_t constexpr version = 1;
+	static std::size_t constexpr channel_record_size = 1 + 4 + 1 + 16 + 2 + 32;
+	static std::size_t constexpr message_header_size = 1 + 4 + 8 + 4;
+};
+
+/**
+ * Records inbound realtime messages to a traffic_log. Recording does not block network threads on disk,
+ * records are buffered and written by a dedicated thread. Records are dropped when the buffer exceeds \p buffer_max.
+ */
+class traffic_recorder final
+{
+public:
+	traffic_recorder (vxldollar::node &, boost::filesystem::path const &);
+	~traffic_recorder ();
+	void record (vxldollar::message const &, vxldollar::transport::channel const &);
+	void stop ();
+	/** Waits until all buffered records have been written */
+	void flush ();
+	/** Set if the log could not be opened */
+	bool error{ false };
+	std::atomic<uint64_t> recorded{ 0 };
+	std::atomic<uint64_t> dropped{ 0 };
+	static std::size_t constexpr buffer_max = 64 * 1024 * 1024;
+
+private:
+	void run ();
+	vxldollar::node & node;
+	std::ofstream file;
+	std::chrono::steady_clock::time_point const start{ std::chrono::steady_clock::now () };
+	std::unordered_map<vxldollar::endpoint, uint32_t> channel_ids;
+	std::vector<uint8_t> buffer;
+	std::vector<uint8_t> back_buffer;
+	bool writing_back_buffer{ false };
+	bool stopped{ false };
+	vxldollar::condition_variable condition;
+	vxldollar::mutex mutex;
+	std::thread thread;
+
+	friend std::unique_ptr<container_info_component> collect_container_info (traffic_recorder &, std::string const &);
+};
+
+std::unique_ptr<container_info_component> collect_container_info (traffic_recorder & recorder, std::string const & name);
+
+namespace transport
+{
+	/** Stands for a recorded peer during replay. Anything sent to it is discarded. */
+	class channel_replay final : public vxldollar::transport::channel
+	{
+	public:
+		channel_replay (vxldollar::node &, vxldollar::transport::transport_type, vxldollar::endpoint const &);
+		std::size_t hash_code () const override;
+		bool operator== (vxldollar::transport::channel const &) const override;
+		void send_buffer (vxldollar::shared_const_buffer const &, std::function<void (boost::system::error_code const &, std::size_t)> const & = nullptr, vxldollar::buffer_drop_policy = vxldollar::buffer_drop_policy::limiter) override;
+		std::string to_string () const override;
+
+		vxldollar::endpoint get_endpoint () const override
+		{
+			return endpoint;
+		}
+
+		vxldollar::tcp_endpoint get_tcp_endpoint () const override
+		{
+			return vxldollar::transport::map_endpoint_to_tcp (endpoint);
+		}
+
+		vxldollar::transport::transport_type get_type () const override
+		{
+			return type;
+		}
+
+	private:
+		vxldollar::transport::transport_type const type;
+		vxldollar::endpoint const endpoint;
+	};
+}
+
+/**
+ * Feeds a traffic_log into a node through network::inbound, without sockets
+ * Messages are delivered in recorded order from the calling thread, so a replay of the same log against the same ledger is repeatable.
+ */
+class traffic_replay final
+{
+public:
+	traffic_replay (vxldollar::node &, boost::filesystem::path const &);
+	/**
+	 * Replays the whole log. Recorded gaps between messages are divided by \p speed_a, a speed of 0 replays as fast as possible.
+	 * @return true if the log could not be opened or is malformed
+	 */
+	bool run (double speed_a = 1.0);
+	uint64_t messages{ 0 };
+	/** Messages which were not delivered, e.g. duplicates or blocks with insufficient work */
+	uint64_t dropped{ 0 };
+
+private:
+	bool read_channel (std::istream &);
+	bool read_message (std::istream &, std::chrono::steady_clock::time_point const &, double);
+	vxldollar::node & node;
+	boost::filesystem::path const path;
+	std::unordered_map<uint32_t, std::shared_ptr<vxldollar::transport::channel_replay>> channels;
+	/** Timestamp of the first message, which is replayed immediately */
+	boost::optional<uint64_t> first_timestamp;
+	/** Replay has its own duplicate filter, the log only contains messages the recording node did not filter */
+	vxldollar::network_filter publish_filter{ 256 * 1024 };
+};
+}
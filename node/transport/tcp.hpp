@@ -24,6 +24,8 @@ public:
 	vxldollar::tcp_endpoint endpoint;
 	vxldollar::account node_id;
 	std::shared_ptr<vxldollar::socket> socket;
+	/** Time the message was read from the socket, to measure time spent in tcp_message_manager */
+	std::chrono::steady_clock::time_point received{ std::chrono::steady_clock::now () };
 };
 namespace transport
 {
@@ -228,6 +230,11 @@ namespace transport
 				mi::member<tcp_endpoint_attempt, std::chrono::steady_clock::time_point, &tcp_endpoint_attempt::last_attempt>>>>
 		attempts;
 		// clang-format on
+		using snapshot_t = vxldollar::transport::channel_snapshot<vxldollar::transport::channel_tcp, vxldollar::tcp_endpoint>;
+		/** Rebuilds and publishes the snapshot of \p channels, must be called with \p mutex held */
+		void publish_snapshot ();
+		std::shared_ptr<snapshot_t const> load_snapshot () const;
+		std::shared_ptr<snapshot_t const> snapshot{ std::make_shared<snapshot_t> () };
 		std::atomic<bool> stopped{ false };
 
 		friend class network_peer_max_tcp_attempts_subnetwork_Test;
@@ -8,6 +8,9 @@
 
 #include <boost/asio/ip/network_v6.hpp>
 
+#include <unordered_map>
+#include <vector>
+
 namespace vxldollar
 {
 class bandwidth_limiter final
@@ -43,6 +46,38 @@ namespace transport
 		tcp = 2,
 		loopback = 3
 	};
+
+	/**
+	 * Rolling estimates of how well a peer keeps up with the traffic sent to it: round trip time, occupancy of the local
+	 * write queue and the rate of dropped or failed writes. Estimates are exponentially weighted moving averages held in
+	 * atomics, so they are updated from I/O completion handlers without locking.
+	 */
+	class channel_health final
+	{
+	public:
+		/** Records a request answered by the peer, e.g. a telemetry_req followed by its telemetry_ack */
+		void rtt_sample (std::chrono::microseconds const &);
+		/** Records the fill level of the write queue as a fraction in [0, 1] of its capacity */
+		void queue_sample (double);
+		/** Records whether a buffer was written or dropped */
+		void send_sample (bool dropped_a);
+		/** Smoothed round trip time, zero until the first sample */
+		std::chrono::microseconds rtt () const;
+		double queue_occupancy () const;
+		double drop_rate () const;
+		/** Selection weight in [min_score, 1], a peer without samples is considered healthy */
+		double score () const;
+
+		static double constexpr min_score = 0.05;
+		/** Round trip time at which the score is halved */
+		static std::chrono::milliseconds constexpr rtt_reference{ 500 };
+
+	private:
+		std::atomic<double> rtt_m{ 0.0 };
+		std::atomic<double> queue_occupancy_m{ 0.0 };
+		std::atomic<double> drop_rate_m{ 0.0 };
+	};
+
 	class channel
 	{
 	public:
@@ -139,6 +174,10 @@ namespace transport
 		boost::optional<vxldollar::account> node_id{ boost::none };
 		std::atomic<uint8_t> network_version{ 0 };
 
+	public:
+		/** Shared with pending write handlers, which record their outcome after the channel may be gone */
+		std::shared_ptr<vxldollar::transport::channel_health> const health{ std::make_shared<vxldollar::transport::channel_health> () };
+
 	protected:
 		vxldollar::node & node;
 	};
@@ -176,6 +215,20 @@ namespace transport
 	private:
 		vxldollar::endpoint const endpoint;
 	};
+
+	/**
+	 * Immutable copy of a channel container, rebuilt under the container mutex on every membership change and published atomically.
+	 * Frequent readers (flooding, random peer selection, endpoint and node ID lookups) load the current snapshot and take no lock.
+	 * Fields which change per packet, such as the network version or last packet times, are still read from the channels themselves.
+	 */
+	template <typename CHANNEL, typename ENDPOINT>
+	class channel_snapshot final
+	{
+	public:
+		std::vector<std::shared_ptr<CHANNEL>> channels;
+		std::unordered_map<ENDPOINT, std::shared_ptr<CHANNEL>> endpoints;
+		std::unordered_map<vxldollar::account, std::shared_ptr<CHANNEL>> node_ids;
+	};
 } // namespace transport
 } // namespace vxldollar
 
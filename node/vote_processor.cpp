@@ -57,6 +57,8 @@ void vxldollar::vote_processor::process_loop ()
 		{
 			decltype (votes) votes_l;
 			votes_l.swap (votes);
+			decltype (votes_queued) votes_queued_l;
+			votes_queued_l.swap (votes_queued);
 
 			log_this_iteration = false;
 			if (config.logging.network_logging () && votes_l.size () > 50)
@@ -70,6 +72,11 @@ void vxldollar::vote_processor::process_loop ()
 			}
 			is_active = true;
 			lock.unlock ();
+			auto const now (std::chrono::steady_clock::now ());
+			for (auto const & queued : votes_queued_l)
+			{
+				stats.update_latency (vxldollar::stat::detail::confirm_ack, vxldollar::stat::latency_stage::processor, now - queued);
+			}
 			verify_votes (votes_l);
 			lock.lock ();
 			is_active = false;
@@ -121,6 +128,7 @@ bool vxldollar::vote_processor::vote (std::shared_ptr<vxldollar::vote> const & v
 		if (process)
 		{
 			votes.emplace_back (vote_a, channel_a);
+			votes_queued.push_back (std::chrono::steady_clock::now ());
 			lock.unlock ();
 			condition.notify_all ();
 			// Lock no longer required
@@ -66,6 +66,8 @@ private:
 	vxldollar::network_params & network_params;
 	std::size_t max_votes;
 	std::deque<std::pair<std::shared_ptr<vxldollar::vote>, std::shared_ptr<vxldollar::transport::channel>>> votes;
+	/** Time each entry of votes was queued at, kept in the same order */
+	std::deque<std::chrono::steady_clock::time_point> votes_queued;
 	/** Representatives levels for random early detection */
 	std::unordered_set<vxldollar::account> representatives_1;
 	std::unordered_set<vxldollar::account> representatives_2;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vxldollar/lib/locks.hpp>
+#include <vxldollar/lib/stats.hpp>
 
 #include <condition_variable>
 #include <deque>
@@ -39,6 +40,12 @@ class write_database_queue final
 {
 public:
 	write_database_queue (bool use_noops_a);
+	/**
+	 * Group commit, enabled if \p group_sync_a is set. Writers commit without flushing while at the head of the queue,
+	 * then wait for their commit to be flushed by \p group_sync_a. One call flushes the commits of every writer which released
+	 * the queue before it started, and the next writer can write meanwhile.
+	 */
+	write_database_queue (bool use_noops_a, std::function<void ()> group_sync_a, vxldollar::stat & stats_a);
 	/** Blocks until we are at the head of the queue */
 	write_guard wait (vxldollar::writer writer);
 
@@ -52,10 +59,20 @@ public:
 	write_guard pop ();
 
 private:
+	write_guard make_guard ();
+	void finish ();
+	void wait_group_sync (uint64_t ticket_a);
 	std::deque<vxldollar::writer> queue;
 	vxldollar::mutex mutex;
 	vxldollar::condition_variable cv;
 	std::function<void ()> guard_finish_callback;
 	bool use_noops;
+	std::function<void ()> group_sync;
+	vxldollar::stat * stats{ nullptr };
+	/** Number of writers which have released the queue, and of those whose commits have been flushed */
+	uint64_t written{ 0 };
+	uint64_t synced{ 0 };
+	bool syncing{ false };
+	vxldollar::condition_variable sync_condition;
 };
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vxldollar/lib/locks.hpp>
+
 #include <algorithm>
 #include <chrono>
 #include <mutex>
@@ -1738,6 +1738,11 @@ TEST (rpc, peers_node_id)
 	auto tree2 (peers_node.get_child (endpoint_text.str ()));
 	ASSERT_EQ (std::to_string (node->network_params.network.protocol_version), tree2.get<std::string> ("protocol_version"));
 	ASSERT_EQ ("", tree2.get<std::string> ("node_id"));
+	for (auto const & health_field : { "rtt", "queue_occupancy", "drop_rate", "health" })
+	{
+		ASSERT_FALSE (tree1.get<std::string> (health_field).empty ());
+		ASSERT_FALSE (tree2.get<std::string> (health_field).empty ());
+	}
 }
 
 TEST (rpc, pending)
@@ -5616,6 +5621,15 @@ TEST (rpc, memory_stats)
 		auto response (wait_response (system, rpc_ctx, request));
 		ASSERT_TRUE (!response.empty ());
 	}
+
+	node->stats.update_latency (vxldollar::stat::detail::publish, vxldollar::stat::latency_stage::handle, std::chrono::microseconds (5));
+	request.put ("type", "latency");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		auto & handle (response.get_child ("publish").get_child ("handle"));
+		ASSERT_LE (1, handle.get<uint64_t> ("count"));
+		ASSERT_FALSE (handle.get_child ("bins").empty ());
+	}
 }
 
 TEST (rpc, block_confirmed)
@@ -5770,6 +5784,128 @@ TEST (rpc, database_txn_tracker)
 	thread.join ();
 }
 
+TEST (rpc, database_instrumentation)
+{
+	vxldollar::system system;
+	auto node = add_ipc_enabled_node (system);
+	auto const rpc_ctx = add_rpc (system, node);
+	ASSERT_FALSE (node->store.instrumentation.is_enabled ());
+
+	boost::property_tree::ptree request;
+	request.put ("action", "database_instrumentation");
+	request.put ("enable", "true");
+	request.put ("sample_interval", "0");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		std::error_code ec (vxldollar::error_rpc::invalid_sample_interval);
+		ASSERT_EQ (response.get<std::string> ("error"), ec.message ());
+	}
+	ASSERT_FALSE (node->store.instrumentation.is_enabled ());
+
+	// Time every operation
+	request.put ("sample_interval", "1");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		ASSERT_EQ ("true", response.get<std::string> ("enabled"));
+		ASSERT_EQ (1, response.get<unsigned> ("sample_interval"));
+	}
+	ASSERT_NE (nullptr, node->store.block.get (node->store.tx_begin_read (), vxldollar::dev::genesis->hash ()));
+
+	boost::property_tree::ptree stats_request;
+	stats_request.put ("action", "stats");
+	stats_request.put ("type", "store");
+	{
+		auto response (wait_response (system, rpc_ctx, stats_request));
+		ASSERT_EQ ("true", response.get<std::string> ("enabled"));
+		auto & get (response.get_child ("tables.blocks.get"));
+		ASSERT_LE (1, get.get<uint64_t> ("count"));
+		ASSERT_EQ (get.get<uint64_t> ("count"), get.get<uint64_t> ("timed"));
+		ASSERT_FALSE (get.get_child ("bins").empty ());
+		ASSERT_EQ (1, response.get_child ("backend").count ("block_reads"));
+	}
+
+	request.put ("enable", "false");
+	request.erase ("sample_interval");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		ASSERT_EQ ("false", response.get<std::string> ("enabled"));
+	}
+	// Omitting enable keeps the current state
+	request.erase ("enable");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		ASSERT_EQ ("false", response.get<std::string> ("enabled"));
+		ASSERT_EQ (1, response.get<unsigned> ("sample_interval"));
+	}
+	// Booleans are also accepted as numbers, other values are rejected
+	request.put ("enable", "1");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		ASSERT_EQ ("true", response.get<std::string> ("enabled"));
+	}
+	request.put ("enable", "ture");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		std::error_code ec (vxldollar::error_rpc::invalid_enable);
+		ASSERT_EQ (response.get<std::string> ("error"), ec.message ());
+	}
+	ASSERT_TRUE (node->store.instrumentation.is_enabled ());
+	request.put ("enable", "0");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		ASSERT_EQ ("false", response.get<std::string> ("enabled"));
+	}
+	auto const count (node->store.instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get));
+	ASSERT_NE (nullptr, node->store.block.get (node->store.tx_begin_read (), vxldollar::dev::genesis->hash ()));
+	ASSERT_EQ (count, node->store.instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get));
+}
+
+TEST (rpc, ledger_backup)
+{
+	vxldollar::system system;
+	auto node = add_ipc_enabled_node (system);
+	auto const rpc_ctx = add_rpc (system, node);
+	auto destination (vxldollar::unique_path ());
+	boost::property_tree::ptree request;
+	request.put ("action", "ledger_backup");
+	request.put ("path", destination.string ());
+	request.put ("max_bytes_per_second", "invalid");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		std::error_code ec (vxldollar::error_common::invalid_amount);
+		ASSERT_EQ (response.get<std::string> ("error"), ec.message ());
+	}
+	request.erase ("max_bytes_per_second");
+	{
+		auto response (wait_response (system, rpc_ctx, request));
+		ASSERT_EQ ("1", response.get<std::string> ("started"));
+	}
+	node->ledger_backup.wait ();
+
+	boost::property_tree::ptree status_request;
+	status_request.put ("action", "ledger_backup_status");
+	{
+		auto response (wait_response (system, rpc_ctx, status_request));
+		ASSERT_EQ ("false", response.get<std::string> ("running"));
+		ASSERT_EQ ("true", response.get<std::string> ("success"));
+		ASSERT_EQ (destination.string (), response.get<std::string> ("path"));
+		ASSERT_LT (0, response.get<uint64_t> ("bytes_copied"));
+	}
+	if (!vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		ASSERT_TRUE (boost::filesystem::exists (destination / "data.ldb"));
+	}
+
+	// Cancelling without a running backup succeeds
+	boost::property_tree::ptree cancel_request;
+	cancel_request.put ("action", "ledger_backup");
+	cancel_request.put ("cancel", "true");
+	{
+		auto response (wait_response (system, rpc_ctx, cancel_request));
+		ASSERT_EQ ("", response.get<std::string> ("success"));
+	}
+}
+
 TEST (rpc, active_difficulty)
 {
 	vxldollar::system system;
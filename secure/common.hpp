@@ -93,6 +93,7 @@ class account_info final
 public:
 	account_info () = default;
 	account_info (vxldollar::block_hash const &, vxldollar::account const &, vxldollar::block_hash const &, vxldollar::amount const &, uint64_t, uint64_t, epoch);
+	void serialize (vxldollar::stream &) const;
 	bool deserialize (vxldollar::stream &);
 	bool operator== (vxldollar::account_info const &) const;
 	bool operator!= (vxldollar::account_info const &) const;
@@ -117,6 +118,7 @@ public:
 	pending_info () = default;
 	pending_info (vxldollar::account const &, vxldollar::amount const &, vxldollar::epoch);
 	size_t db_size () const;
+	void serialize (vxldollar::stream &) const;
 	bool deserialize (vxldollar::stream &);
 	bool operator== (vxldollar::pending_info const &) const;
 	vxldollar::account source{};
@@ -128,6 +130,7 @@ class pending_key final
 public:
 	pending_key () = default;
 	pending_key (vxldollar::account const &, vxldollar::block_hash const &);
+	void serialize (vxldollar::stream &) const;
 	bool deserialize (vxldollar::stream &);
 	bool operator== (vxldollar::pending_key const &) const;
 	vxldollar::account const & key () const;
@@ -162,6 +165,25 @@ private:
 	uint16_t network_port{ 0 };
 };
 
+/**
+ * Key of the account height index. The height is stored big endian so that keys sort by account, then by height.
+ */
+class account_height_key final
+{
+public:
+	account_height_key () = default;
+	account_height_key (vxldollar::account const &, uint64_t);
+	vxldollar::account const & key () const;
+	/*
+	 * @return The height in host byte order
+	 */
+	uint64_t height () const;
+
+private:
+	vxldollar::account account{};
+	uint64_t big_endian_height{ 0 };
+};
+
 enum class no_value
 {
 	dummy
@@ -458,6 +480,8 @@ public:
 	unsigned lazy_destinations_retry_limit;
 	std::chrono::milliseconds gap_cache_bootstrap_start_interval;
 	uint32_t default_frontiers_age_seconds;
+	/** Minimum time between two pulls of the same priority bootstrap entry */
+	std::chrono::milliseconds priority_request_interval;
 };
 
 /** Constants whose value depends on the active network */
@@ -24,6 +24,15 @@ public:
 	vxldollar::account account;
 };
 
+/** A block to be pruned, with the account and height which index it in the account height table */
+class pruning_target final
+{
+public:
+	vxldollar::block_hash hash;
+	vxldollar::account account;
+	uint64_t height;
+};
+
 class ledger final
 {
 public:
@@ -48,6 +57,11 @@ public:
 	vxldollar::block_hash representative_calculated (vxldollar::transaction const &, vxldollar::block_hash const &);
 	bool block_or_pruned_exists (vxldollar::block_hash const &) const;
 	bool block_or_pruned_exists (vxldollar::transaction const &, vxldollar::block_hash const &) const;
+	/**
+	 * Answers block_or_pruned_exists for most absent hashes without reading the database, see block_filter.
+	 * The filter is populated from the blocks and pruned tables in parallel, they must not be written meanwhile.
+	 */
+	void block_filter_enable (double false_positive_rate_a, std::size_t max_memory_a);
 	std::string block_text (char const *);
 	std::string block_text (vxldollar::block_hash const &);
 	bool is_send (vxldollar::transaction const &, vxldollar::state_block const &) const;
@@ -59,6 +73,12 @@ public:
 	bool rollback (vxldollar::write_transaction const &, vxldollar::block_hash const &);
 	void update_account (vxldollar::write_transaction const &, vxldollar::account const &, vxldollar::account_info const &, vxldollar::account_info const &);
 	uint64_t pruning_action (vxldollar::write_transaction &, vxldollar::block_hash const &, uint64_t const);
+	/** Prunes a single block, which must exist. Other blocks of its chain are left as is */
+	void prune (vxldollar::write_transaction const &, vxldollar::pruning_target const &);
+	/** Hash of the block at \p height_a in the chain of \p account_a, zero if there is none. Uses the account height index when enabled, otherwise walks the chain from its nearer end */
+	vxldollar::block_hash block_at_height (vxldollar::transaction const &, vxldollar::account const &, uint64_t height_a) const;
+	/** Indexes every block in the ledger, committing periodically. @return the number of indexed blocks */
+	uint64_t account_height_index_build (vxldollar::write_transaction &);
 	void dump_account_chain (vxldollar::account const &, std::ostream & = std::cout);
 	bool could_fit (vxldollar::transaction const &, vxldollar::block const &) const;
 	bool dependents_confirmed (vxldollar::transaction const &, vxldollar::block const &) const;
@@ -68,7 +88,8 @@ public:
 	vxldollar::account const & epoch_signer (vxldollar::link const &) const;
 	vxldollar::link const & epoch_link (vxldollar::epoch) const;
 	std::multimap<uint64_t, uncemented_info, std::greater<>> unconfirmed_frontiers () const;
-	bool migrate_lmdb_to_rocksdb (boost::filesystem::path const &) const;
+	/** Migrates into data_path_a/rocksdb, resuming an interrupted migration. \p progress_a is called with a message as each table is migrated. @return true on error */
+	bool migrate_lmdb_to_rocksdb (boost::filesystem::path const &, std::function<void (std::string const &)> const & progress_a = nullptr) const;
 	static vxldollar::uint128_t const unit;
 	vxldollar::ledger_constants & constants;
 	vxldollar::store & store;
@@ -79,6 +100,8 @@ public:
 	uint64_t bootstrap_weight_max_blocks{ 1 };
 	std::atomic<bool> check_bootstrap_weights;
 	bool pruning{ false };
+	/** Maintain the account height index when blocks are added, rolled back or pruned */
+	bool account_height_index{ false };
 
 private:
 	void initialize (vxldollar::generate_cache const &);
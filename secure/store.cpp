@@ -84,9 +84,16 @@ void * vxldollar::write_transaction::get_handle () const
 	return impl->get_handle ();
 }
 
+vxldollar::write_transaction::~write_transaction ()
+{
+	impl->commit ();
+	committed ();
+}
+
 void vxldollar::write_transaction::commit ()
 {
 	impl->commit ();
+	committed ();
 }
 
 void vxldollar::write_transaction::renew ()
@@ -97,6 +104,7 @@ void vxldollar::write_transaction::renew ()
 void vxldollar::write_transaction::refresh ()
 {
 	impl->commit ();
+	committed ();
 	impl->renew ();
 }
 
@@ -105,6 +113,36 @@ bool vxldollar::write_transaction::contains (vxldollar::tables table_a) const
 	return impl->contains (table_a);
 }
 
+void vxldollar::write_transaction::on_commit (std::function<void ()> action_a) const
+{
+	commit_actions.push_back (std::move (action_a));
+}
+
+void vxldollar::write_transaction::committed ()
+{
+	// Commits which fail do not return, so the actions of a discarded transaction never run
+	for (auto const & action : commit_actions)
+	{
+		action ();
+	}
+	commit_actions.clear ();
+}
+
+namespace
+{
+thread_local bool deferred_sync_l{ false };
+}
+
+void vxldollar::deferred_sync::set (bool deferred_a)
+{
+	deferred_sync_l = deferred_a;
+}
+
+bool vxldollar::deferred_sync::is_set ()
+{
+	return deferred_sync_l;
+}
+
 // clang-format off
 vxldollar::store::store (
 	vxldollar::block_store & block_store_a,
@@ -117,7 +155,8 @@ vxldollar::store::store (
 	vxldollar::peer_store & peer_store_a,
 	vxldollar::confirmation_height_store & confirmation_height_store_a,
 	vxldollar::final_vote_store & final_vote_store_a,
-	vxldollar::version_store & version_store_a
+	vxldollar::version_store & version_store_a,
+	vxldollar::account_height_store & account_height_store_a
 ) :
 	block (block_store_a),
 	frontier (frontier_store_a),
@@ -129,11 +168,24 @@ vxldollar::store::store (
 	peer (peer_store_a),
 	confirmation_height (confirmation_height_store_a),
 	final_vote (final_vote_store_a),
-	version (version_store_a)
+	version (version_store_a),
+	account_height (account_height_store_a)
 {
 }
 // clang-format on
 
+vxldollar::block_filter * vxldollar::store::block_filter () const
+{
+	return block_filter_l.load (std::memory_order_acquire);
+}
+
+void vxldollar::store::block_filter_set (std::unique_ptr<vxldollar::block_filter> filter_a)
+{
+	debug_assert (block_filter_m == nullptr);
+	block_filter_m = std::move (filter_a);
+	block_filter_l.store (block_filter_m.get (), std::memory_order_release);
+}
+
 auto vxldollar::unchecked_store::equal_range (vxldollar::transaction const & transaction, vxldollar::block_hash const & dependency) -> std::pair<iterator, iterator>
 {
 	vxldollar::unchecked_key begin_l{ dependency, 0 };
@@ -6,13 +6,17 @@
 #include <vxldollar/lib/logger_mt.hpp>
 #include <vxldollar/lib/memory.hpp>
 #include <vxldollar/lib/rocksdbconfig.hpp>
+#include <vxldollar/secure/block_filter.hpp>
 #include <vxldollar/secure/buffer.hpp>
 #include <vxldollar/secure/common.hpp>
+#include <vxldollar/secure/store_instrumentation.hpp>
 #include <vxldollar/secure/versioning.hpp>
 
 #include <boost/endian/conversion.hpp>
+#include <boost/optional.hpp>
 #include <boost/polymorphic_cast.hpp>
 
+#include <atomic>
 #include <stack>
 
 namespace vxldollar
@@ -103,6 +107,12 @@ public:
 		static_assert (std::is_standard_layout<vxldollar::pending_key>::value, "Standard layout is required");
 	}
 
+	db_val (vxldollar::account_height_key const & val_a) :
+		db_val (sizeof (val_a), const_cast<vxldollar::account_height_key *> (&val_a))
+	{
+		static_assert (std::is_standard_layout<vxldollar::account_height_key>::value, "Standard layout is required");
+	}
+
 	db_val (vxldollar::unchecked_info const & val_a) :
 		buffer (std::make_shared<std::vector<uint8_t>> ())
 	{
@@ -212,6 +222,15 @@ public:
 		return result;
 	}
 
+	explicit operator vxldollar::account_height_key () const
+	{
+		vxldollar::account_height_key result;
+		debug_assert (size () == sizeof (result));
+		static_assert (sizeof (vxldollar::account) + sizeof (uint64_t) == sizeof (result), "Packed class");
+		std::copy (reinterpret_cast<uint8_t const *> (data ()), reinterpret_cast<uint8_t const *> (data ()) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+		return result;
+	}
+
 	explicit operator vxldollar::confirmation_height_info () const
 	{
 		vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
@@ -539,6 +558,7 @@ private:
 // Keep this in alphabetical order
 enum class tables
 {
+	account_heights,
 	accounts,
 	blocks,
 	confirmation_height,
@@ -608,14 +628,58 @@ class write_transaction final : public transaction
 {
 public:
 	explicit write_transaction (std::unique_ptr<vxldollar::write_transaction_impl> write_transaction_impl);
+	~write_transaction ();
 	void * get_handle () const override;
 	void commit ();
 	void renew ();
 	void refresh ();
 	bool contains (vxldollar::tables table_a) const;
+	/**
+	 * Runs \p action_a once the changes made so far are committed, in the order queued. Used for in-memory state which must not
+	 * run ahead of the database, such as filter entries of deleted keys. Actions are dropped if the commit fails.
+	 */
+	void on_commit (std::function<void ()> action_a) const;
 
 private:
+	void committed ();
 	std::unique_ptr<vxldollar::write_transaction_impl> impl;
+	mutable std::vector<std::function<void ()>> commit_actions;
+};
+
+/**
+ * While set, write transactions begun by the current thread may commit without flushing to disk.
+ * Their durability is then left to a later store::sync (). Stores which cannot defer a flush ignore it.
+ */
+class deferred_sync final
+{
+public:
+	static void set (bool deferred_a);
+	static bool is_set ();
+};
+
+/** Progress of a store::backup, which may be read while the backup runs */
+class backup_progress final
+{
+public:
+	std::atomic<uint64_t> bytes_copied{ 0 };
+	/** Upper bound of the bytes to copy, 0 until known */
+	std::atomic<uint64_t> bytes_total{ 0 };
+	/** Set to stop a running backup, which then fails */
+	std::atomic<bool> cancelled{ false };
+};
+
+/**
+ * Writes entries of a table to a file, which store::ingest adds to a store in bulk
+ * Entries must be put in ascending key order.
+ */
+class table_file_writer
+{
+public:
+	virtual ~table_file_writer () = default;
+	/** @return true on error */
+	virtual bool put (uint8_t const * key_a, std::size_t key_size_a, uint8_t const * value_a, std::size_t value_size_a) = 0;
+	/** Completes the file, a file without entries is removed instead. @return true on error */
+	virtual bool finish () = 0;
 };
 
 class ledger_cache;
@@ -643,6 +707,8 @@ class account_store
 public:
 	virtual void put (vxldollar::write_transaction const &, vxldollar::account const &, vxldollar::account_info const &) = 0;
 	virtual bool get (vxldollar::transaction const &, vxldollar::account const &, vxldollar::account_info &) = 0;
+	/** Looks up \p accounts_a in one batch, results are in the same order and empty for missing accounts */
+	virtual std::vector<boost::optional<vxldollar::account_info>> get_many (vxldollar::transaction const &, std::vector<vxldollar::account> const & accounts_a) = 0;
 	virtual void del (vxldollar::write_transaction const &, vxldollar::account const &) = 0;
 	virtual bool exists (vxldollar::transaction const &, vxldollar::account const &) = 0;
 	virtual size_t count (vxldollar::transaction const &) = 0;
@@ -662,6 +728,8 @@ public:
 	virtual void put (vxldollar::write_transaction const &, vxldollar::pending_key const &, vxldollar::pending_info const &) = 0;
 	virtual void del (vxldollar::write_transaction const &, vxldollar::pending_key const &) = 0;
 	virtual bool get (vxldollar::transaction const &, vxldollar::pending_key const &, vxldollar::pending_info &) = 0;
+	/** Looks up \p keys_a in one batch, results are in the same order and empty for missing entries */
+	virtual std::vector<boost::optional<vxldollar::pending_info>> get_many (vxldollar::transaction const &, std::vector<vxldollar::pending_key> const & keys_a) = 0;
 	virtual bool exists (vxldollar::transaction const &, vxldollar::pending_key const &) = 0;
 	virtual bool any (vxldollar::transaction const &, vxldollar::account const &) = 0;
 	virtual vxldollar::store_iterator<vxldollar::pending_key, vxldollar::pending_info> begin (vxldollar::transaction const &, vxldollar::pending_key const &) const = 0;
@@ -718,6 +786,24 @@ public:
 	virtual void for_each_par (std::function<void (vxldollar::read_transaction const &, vxldollar::store_iterator<vxldollar::block_hash, std::nullptr_t>, vxldollar::store_iterator<vxldollar::block_hash, std::nullptr_t>)> const & action_a) const = 0;
 };
 
+/**
+ * Manages the account height index, which maps the height of each block in an account chain to its hash
+ */
+class account_height_store
+{
+public:
+	virtual void put (vxldollar::write_transaction const &, vxldollar::account const &, uint64_t, vxldollar::block_hash const &) = 0;
+	virtual void del (vxldollar::write_transaction const &, vxldollar::account const &, uint64_t) = 0;
+	/** @return the hash of the block at \p height_a in the chain of \p account_a, or zero if it is not indexed */
+	virtual vxldollar::block_hash get (vxldollar::transaction const &, vxldollar::account const &, uint64_t height_a) const = 0;
+	virtual size_t count (vxldollar::transaction const &) const = 0;
+	virtual void clear (vxldollar::write_transaction const &) = 0;
+	virtual vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> begin (vxldollar::transaction const &, vxldollar::account_height_key const &) const = 0;
+	virtual vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> begin (vxldollar::transaction const &) const = 0;
+	virtual vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> end () const = 0;
+	virtual void for_each_par (std::function<void (vxldollar::read_transaction const &, vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash>, vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash>)> const &) const = 0;
+};
+
 /**
  * Manages confirmation height storage and iteration
  */
@@ -733,6 +819,9 @@ public:
 	 */
 	virtual bool get (vxldollar::transaction const & transaction_a, vxldollar::account const & account_a, vxldollar::confirmation_height_info & confirmation_height_info_a) = 0;
 
+	/** Looks up \p accounts_a in one batch, results are in the same order. As with get, missing accounts have a height and frontier of 0 */
+	virtual std::vector<vxldollar::confirmation_height_info> get_many (vxldollar::transaction const & transaction_a, std::vector<vxldollar::account> const & accounts_a) = 0;
+
 	virtual bool exists (vxldollar::transaction const & transaction_a, vxldollar::account const & account_a) const = 0;
 	virtual void del (vxldollar::write_transaction const & transaction_a, vxldollar::account const & account_a) = 0;
 	virtual uint64_t count (vxldollar::transaction const & transaction_a) = 0;
@@ -801,10 +890,16 @@ class block_store
 {
 public:
 	virtual void put (vxldollar::write_transaction const &, vxldollar::block_hash const &, vxldollar::block const &) = 0;
+	/** Adds a block which is already serialized with its sideband */
 	virtual void raw_put (vxldollar::write_transaction const &, std::vector<uint8_t> const &, vxldollar::block_hash const &) = 0;
 	virtual vxldollar::block_hash successor (vxldollar::transaction const &, vxldollar::block_hash const &) const = 0;
 	virtual void successor_clear (vxldollar::write_transaction const &, vxldollar::block_hash const &) = 0;
 	virtual std::shared_ptr<vxldollar::block> get (vxldollar::transaction const &, vxldollar::block_hash const &) const = 0;
+	/**
+	 * Looks up \p hashes_a in one batch, results are in the same order and nullptr for missing blocks
+	 * Cheaper than calling get for each hash, LMDB reads keys in sorted order and RocksDB uses its batched read path
+	 */
+	virtual std::vector<std::shared_ptr<vxldollar::block>> get_many (vxldollar::transaction const &, std::vector<vxldollar::block_hash> const & hashes_a) const = 0;
 	virtual std::shared_ptr<vxldollar::block> get_no_sideband (vxldollar::transaction const &, vxldollar::block_hash const &) const = 0;
 	virtual std::shared_ptr<vxldollar::block> random (vxldollar::transaction const &) = 0;
 	virtual void del (vxldollar::write_transaction const &, vxldollar::block_hash const &) = 0;
@@ -841,7 +936,8 @@ public:
 		vxldollar::peer_store &,
 		vxldollar::confirmation_height_store &,
 		vxldollar::final_vote_store &,
-		vxldollar::version_store &
+		vxldollar::version_store &,
+		vxldollar::account_height_store &
 	);
 	// clang-format on
 	virtual ~store () = default;
@@ -863,10 +959,24 @@ public:
 	confirmation_height_store & confirmation_height;
 	final_vote_store & final_vote;
 	version_store & version;
+	account_height_store & account_height;
+
+	/** Hashes of the blocks and pruned tables, kept up to date by their stores once set. Null unless enabled through ledger::block_filter_enable */
+	vxldollar::block_filter * block_filter () const;
+	/** Publishes \p filter_a to other threads. It must hold every hash of the blocks and pruned tables, so no blocks may be written while it is populated */
+	void block_filter_set (std::unique_ptr<vxldollar::block_filter> filter_a);
+	/** Operation counts and latencies per table, updated from const lookups as well */
+	mutable vxldollar::store_instrumentation instrumentation;
 
 	virtual unsigned max_block_write_batch_num () const = 0;
 
 	virtual bool copy_db (boost::filesystem::path const & destination) = 0;
+	/**
+	 * Copies the database into the \p destination directory while it stays open for reads and writes.
+	 * The copy is limited to \p max_bytes_per_second_a, unless 0.
+	 * @return true if the backup completed
+	 */
+	virtual bool backup (boost::filesystem::path const & destination, vxldollar::backup_progress & progress_a, uint64_t max_bytes_per_second_a) = 0;
 	virtual void rebuild_db (vxldollar::write_transaction const & transaction_a) = 0;
 
 	/** Not applicable to all sub-classes */
@@ -875,6 +985,26 @@ public:
 
 	virtual bool init_error () const = 0;
 
+	virtual uint64_t count (vxldollar::transaction const &, vxldollar::tables) const = 0;
+	/**
+	 * Calls \p action_a with the encoded key and value of each entry of \p table_a whose first key byte is within [ \p first_a, \p last_a ], in ascending key order.
+	 * All stores share the entry encoding and key order, so entries can be copied between them without decoding.
+	 */
+	virtual void for_each_raw (vxldollar::transaction const &, vxldollar::tables table_a, uint8_t first_a, uint8_t last_a, std::function<void (uint8_t const *, std::size_t, uint8_t const *, std::size_t)> const & action_a) const = 0;
+	/** Creates a writer of a table file at \p path_a for ingest, null if the store cannot ingest files or the file cannot be created */
+	virtual std::unique_ptr<vxldollar::table_file_writer> make_table_file_writer (vxldollar::tables, boost::filesystem::path const &)
+	{
+		return nullptr;
+	}
+	/** Adds the entries of the table files at \p paths_a to \p table_a, replacing existing entries with the same keys. The files may be moved. @return true on error */
+	virtual bool ingest (vxldollar::tables, std::vector<boost::filesystem::path> const &)
+	{
+		return true;
+	}
+
+	/** Flushes all committed write transactions to disk, including those committed while deferred_sync was set */
+	virtual void sync () = 0;
+
 	/** Start read-write transaction */
 	virtual vxldollar::write_transaction tx_begin_write (std::vector<vxldollar::tables> const & tables_to_lock = {}, std::vector<vxldollar::tables> const & tables_no_lock = {}) = 0;
 
@@ -884,6 +1014,11 @@ public:
 	virtual std::string vendor_get () const = 0;
 
 	friend class unchecked_map;
+
+private:
+	std::unique_ptr<vxldollar::block_filter> block_filter_m;
+	/** Read by lookups on any thread, set once block_filter_m holds the populated filter */
+	std::atomic<vxldollar::block_filter *> block_filter_l{ nullptr };
 };
 
 std::unique_ptr<vxldollar::store> make_store (vxldollar::logger_mt & logger, boost::filesystem::path const & path, vxldollar::ledger_constants & constants, bool open_read_only = false, bool add_db_postfix = false, vxldollar::rocksdb_config const & rocksdb_config = vxldollar::rocksdb_config{}, vxldollar::txn_tracking_config const & txn_tracking_config_a = vxldollar::txn_tracking_config{}, std::chrono::milliseconds block_processor_batch_max_time_a = std::chrono::milliseconds (5000), vxldollar::lmdb_config const & lmdb_config_a = vxldollar::lmdb_config{}, bool backup_before_upgrade = false);
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vxldollar/secure/store_partial.hpp>
+
+namespace
+{
+template <typename T>
+void parallel_traversal (std::function<void (T const &, T const &, bool const)> const & action);
+}
+
+namespace vxldollar
+{
+template <typename Val, typename Derived_Store>
+class store_partial;
+
+template <typename Val, typename Derived_Store>
+void release_assert_success (store_partial<Val, Derived_Store> const &, int const);
+
+template <typename Val, typename Derived_Store>
+class account_height_store_partial : public account_height_store
+{
+private:
+	vxldollar::store_partial<Val, Derived_Store> & store;
+
+	friend void release_assert_success<Val, Derived_Store> (store_partial<Val, Derived_Store> const &, int const);
+
+public:
+	explicit account_height_store_partial (vxldollar::store_partial<Val, Derived_Store> & store_a) :
+		store (store_a){};
+
+	void put (vxldollar::write_transaction const & transaction_a, vxldollar::account const & account_a, uint64_t height_a, vxldollar::block_hash const & hash_a) override
+	{
+		vxldollar::account_height_key key (account_a, height_a);
+		auto status = store.put (transaction_a, tables::account_heights, key, hash_a);
+		release_assert_success (store, status);
+	}
+
+	void del (vxldollar::write_transaction const & transaction_a, vxldollar::account const & account_a, uint64_t height_a) override
+	{
+		vxldollar::account_height_key key (account_a, height_a);
+		auto status = store.del (transaction_a, tables::account_heights, key);
+		release_assert_success (store, status);
+	}
+
+	vxldollar::block_hash get (vxldollar::transaction const & transaction_a, vxldollar::account const & account_a, uint64_t height_a) const override
+	{
+		vxldollar::account_height_key key (account_a, height_a);
+		vxldollar::db_val<Val> value;
+		auto status = store.get (transaction_a, tables::account_heights, vxldollar::db_val<Val> (key), value);
+		release_assert (store.success (status) || store.not_found (status));
+		vxldollar::block_hash result{ 0 };
+		if (store.success (status))
+		{
+			result = static_cast<vxldollar::block_hash> (value);
+		}
+		return result;
+	}
+
+	size_t count (vxldollar::transaction const & transaction_a) const override
+	{
+		return store.count (transaction_a, tables::account_heights);
+	}
+
+	void clear (vxldollar::write_transaction const & transaction_a) override
+	{
+		auto status = store.drop (transaction_a, tables::account_heights);
+		release_assert_success (store, status);
+	}
+
+	vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> begin (vxldollar::transaction const & transaction_a, vxldollar::account_height_key const & key_a) const override
+	{
+		return store.template make_iterator<vxldollar::account_height_key, vxldollar::block_hash> (transaction_a, tables::account_heights, vxldollar::db_val<Val> (key_a));
+	}
+
+	vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> begin (vxldollar::transaction const & transaction_a) const override
+	{
+		return store.template make_iterator<vxldollar::account_height_key, vxldollar::block_hash> (transaction_a, tables::account_heights);
+	}
+
+	vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> end () const override
+	{
+		return vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash> (nullptr);
+	}
+
+	void for_each_par (std::function<void (vxldollar::read_transaction const &, vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash>, vxldollar::store_iterator<vxldollar::account_height_key, vxldollar::block_hash>)> const & action_a) const override
+	{
+		parallel_traversal<vxldollar::uint256_t> (
+		[&action_a, this] (vxldollar::uint256_t const & start, vxldollar::uint256_t const & end, bool const is_last) {
+			auto transaction (this->store.tx_begin_read ());
+			action_a (transaction, this->begin (transaction, vxldollar::account_height_key (start, 0)), !is_last ? this->begin (transaction, vxldollar::account_height_key (end, 0)) : this->end ());
+		});
+	}
+};
+
+}
@@ -51,6 +51,28 @@ public:
 		return result;
 	}
 
+	std::vector<boost::optional<vxldollar::account_info>> get_many (vxldollar::transaction const & transaction_a, std::vector<vxldollar::account> const & accounts_a) override
+	{
+		std::vector<vxldollar::db_val<Val>> keys (accounts_a.begin (), accounts_a.end ());
+		std::vector<vxldollar::db_val<Val>> values;
+		auto statuses (store.get_many (transaction_a, tables::accounts, keys, values));
+		std::vector<boost::optional<vxldollar::account_info>> result (accounts_a.size ());
+		for (std::size_t i (0), n (accounts_a.size ()); i < n; ++i)
+		{
+			release_assert (store.success (statuses[i]) || store.not_found (statuses[i]));
+			if (store.success (statuses[i]))
+			{
+				vxldollar::account_info info;
+				vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (values[i].data ()), values[i].size ());
+				if (!info.deserialize (stream))
+				{
+					result[i] = info;
+				}
+			}
+		}
+		return result;
+	}
+
 	void del (vxldollar::write_transaction const & transaction_a, vxldollar::account const & account_a) override
 	{
 		auto status = store.del (transaction_a, tables::accounts, account_a);
@@ -51,6 +51,10 @@ public:
 		vxldollar::db_val<Val> value{ data.size (), (void *)data.data () };
 		auto status = store.put (transaction_a, tables::blocks, hash_a, value);
 		release_assert_success (store, status);
+		if (auto const filter = store.block_filter (); filter != nullptr)
+		{
+			filter->insert (hash_a);
+		}
 	}
 
 	vxldollar::block_hash successor (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const override
@@ -80,25 +84,25 @@ public:
 		auto type = block_type_from_raw (value.data ());
 		std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
 		std::fill_n (data.begin () + block_successor_offset (transaction_a, value.size (), type), sizeof (vxldollar::block_hash), uint8_t{ 0 });
-		raw_put (transaction_a, data, hash_a);
+		block_raw_replace (transaction_a, data, hash_a);
 	}
 
 	std::shared_ptr<vxldollar::block> get (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const override
 	{
-		auto value (block_raw_get (transaction_a, hash_a));
-		std::shared_ptr<vxldollar::block> result;
-		if (value.size () != 0)
+		return block_from_raw (block_raw_get (transaction_a, hash_a));
+	}
+
+	std::vector<std::shared_ptr<vxldollar::block>> get_many (vxldollar::transaction const & transaction_a, std::vector<vxldollar::block_hash> const & hashes_a) const override
+	{
+		std::vector<vxldollar::db_val<Val>> keys (hashes_a.begin (), hashes_a.end ());
+		std::vector<vxldollar::db_val<Val>> values;
+		auto statuses (store.get_many (transaction_a, tables::blocks, keys, values));
+		std::vector<std::shared_ptr<vxldollar::block>> result;
+		result.reserve (hashes_a.size ());
+		for (std::size_t i (0), n (hashes_a.size ()); i < n; ++i)
 		{
-			vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			vxldollar::block_type type;
-			auto error (try_read (stream, type));
-			release_assert (!error);
-			result = vxldollar::deserialize_block (stream, type);
-			release_assert (result != nullptr);
-			vxldollar::block_sideband sideband;
-			error = (sideband.deserialize (stream, type));
-			release_assert (!error);
-			result->sideband_set (sideband);
+			release_assert (store.success (statuses[i]) || store.not_found (statuses[i]));
+			result.push_back (store.success (statuses[i]) ? block_from_raw (values[i]) : nullptr);
 		}
 		return result;
 	}
@@ -134,6 +138,13 @@ public:
 	{
 		auto status = store.del (transaction_a, tables::blocks, hash_a);
 		release_assert_success (store, status);
+		if (auto const filter = store.block_filter (); filter != nullptr)
+		{
+			// Other transactions may still read the hash until the deletion is committed
+			transaction_a.on_commit ([filter, hash_a] () {
+				filter->erase (hash_a);
+			});
+		}
 	}
 
 	bool exists (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) override
@@ -241,6 +252,14 @@ public:
 	}
 
 protected:
+	/** Overwrites an existing block, e.g. to update its sideband. Unlike raw_put the block filter is left as is */
+	void block_raw_replace (vxldollar::write_transaction const & transaction_a, std::vector<uint8_t> const & data, vxldollar::block_hash const & hash_a)
+	{
+		vxldollar::db_val<Val> value{ data.size (), (void *)data.data () };
+		auto status = store.put (transaction_a, tables::blocks, hash_a, value);
+		release_assert_success (store, status);
+	}
+
 	vxldollar::db_val<Val> block_raw_get (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const
 	{
 		vxldollar::db_val<Val> result;
@@ -249,6 +268,25 @@ protected:
 		return result;
 	}
 
+	std::shared_ptr<vxldollar::block> block_from_raw (vxldollar::db_val<Val> const & value_a) const
+	{
+		std::shared_ptr<vxldollar::block> result;
+		if (value_a.size () != 0)
+		{
+			vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (value_a.data ()), value_a.size ());
+			vxldollar::block_type type;
+			auto error (try_read (stream, type));
+			release_assert (!error);
+			result = vxldollar::deserialize_block (stream, type);
+			release_assert (result != nullptr);
+			vxldollar::block_sideband sideband;
+			error = (sideband.deserialize (stream, type));
+			release_assert (!error);
+			result->sideband_set (sideband);
+		}
+		return result;
+	}
+
 	size_t block_successor_offset (vxldollar::transaction const & transaction_a, size_t entry_size_a, vxldollar::block_type type_a) const
 	{
 		return entry_size_a - vxldollar::block_sideband::size (type_a);
@@ -282,7 +320,7 @@ public:
 		auto type = block_store.block_type_from_raw (value.data ());
 		std::vector<uint8_t> data (static_cast<uint8_t *> (value.data ()), static_cast<uint8_t *> (value.data ()) + value.size ());
 		std::copy (hash.bytes.begin (), hash.bytes.end (), data.begin () + block_store.block_successor_offset (transaction, value.size (), type));
-		block_store.raw_put (transaction, data, block_a.previous ());
+		block_store.block_raw_replace (transaction, data, block_a.previous ());
 	}
 	void send_block (vxldollar::send_block const & block_a) override
 	{
@@ -55,6 +55,27 @@ public:
 		return result;
 	}
 
+	std::vector<vxldollar::confirmation_height_info> get_many (vxldollar::transaction const & transaction_a, std::vector<vxldollar::account> const & accounts_a) override
+	{
+		std::vector<vxldollar::db_val<Val>> keys (accounts_a.begin (), accounts_a.end ());
+		std::vector<vxldollar::db_val<Val>> values;
+		auto statuses (store.get_many (transaction_a, tables::confirmation_height, keys, values));
+		std::vector<vxldollar::confirmation_height_info> result (accounts_a.size ());
+		for (std::size_t i (0), n (accounts_a.size ()); i < n; ++i)
+		{
+			release_assert (store.success (statuses[i]) || store.not_found (statuses[i]));
+			if (store.success (statuses[i]))
+			{
+				vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (values[i].data ()), values[i].size ());
+				if (result[i].deserialize (stream))
+				{
+					result[i] = vxldollar::confirmation_height_info{};
+				}
+			}
+		}
+		return result;
+	}
+
 	bool exists (vxldollar::transaction const & transaction_a, vxldollar::account const & account_a) const override
 	{
 		return store.exists (transaction_a, tables::confirmation_height, vxldollar::db_val<Val> (account_a));
@@ -49,6 +49,11 @@ public:
 	std::vector<vxldollar::block_hash> get (vxldollar::transaction const & transaction_a, vxldollar::root const & root_a) override
 	{
 		std::vector<vxldollar::block_hash> result;
+		// Most roots have no final vote, which the prefix filter answers without seeking
+		if (!store.exists_prefix (transaction_a, tables::final_votes, vxldollar::db_val<Val> (root_a.raw)))
+		{
+			return result;
+		}
 		vxldollar::qualified_root key_start (root_a.raw, 0);
 		for (auto i (begin (transaction_a, key_start)), n (end ()); i != n && vxldollar::qualified_root (i->first).root () == root_a; ++i)
 		{
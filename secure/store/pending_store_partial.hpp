@@ -56,16 +56,36 @@ public:
 		return result;
 	}
 
+	std::vector<boost::optional<vxldollar::pending_info>> get_many (vxldollar::transaction const & transaction_a, std::vector<vxldollar::pending_key> const & keys_a) override
+	{
+		std::vector<vxldollar::db_val<Val>> keys (keys_a.begin (), keys_a.end ());
+		std::vector<vxldollar::db_val<Val>> values;
+		auto statuses (store.get_many (transaction_a, tables::pending, keys, values));
+		std::vector<boost::optional<vxldollar::pending_info>> result (keys_a.size ());
+		for (std::size_t i (0), n (keys_a.size ()); i < n; ++i)
+		{
+			release_assert (store.success (statuses[i]) || store.not_found (statuses[i]));
+			if (store.success (statuses[i]))
+			{
+				vxldollar::pending_info info;
+				vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (values[i].data ()), values[i].size ());
+				if (!info.deserialize (stream))
+				{
+					result[i] = info;
+				}
+			}
+		}
+		return result;
+	}
+
 	bool exists (vxldollar::transaction const & transaction_a, vxldollar::pending_key const & key_a) override
 	{
-		auto iterator (begin (transaction_a, key_a));
-		return iterator != end () && vxldollar::pending_key (iterator->first) == key_a;
+		return store.exists (transaction_a, tables::pending, vxldollar::db_val<Val> (key_a));
 	}
 
 	bool any (vxldollar::transaction const & transaction_a, vxldollar::account const & account_a) override
 	{
-		auto iterator (begin (transaction_a, vxldollar::pending_key (account_a, 0)));
-		return iterator != end () && vxldollar::pending_key (iterator->first).account == account_a;
+		return store.exists_prefix (transaction_a, tables::pending, vxldollar::db_val<Val> (account_a));
 	}
 
 	vxldollar::store_iterator<vxldollar::pending_key, vxldollar::pending_info> begin (vxldollar::transaction const & transaction_a, vxldollar::pending_key const & key_a) const override
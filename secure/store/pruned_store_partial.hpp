@@ -32,12 +32,23 @@ public:
 	{
 		auto status = store.put_key (transaction_a, tables::pruned, hash_a);
 		release_assert_success (store, status);
+		if (auto const filter = store.block_filter (); filter != nullptr)
+		{
+			filter->insert (hash_a);
+		}
 	}
 
 	void del (vxldollar::write_transaction const & transaction_a, vxldollar::block_hash const & hash_a) override
 	{
 		auto status = store.del (transaction_a, tables::pruned, hash_a);
 		release_assert_success (store, status);
+		if (auto const filter = store.block_filter (); filter != nullptr)
+		{
+			// Other transactions may still read the hash until the deletion is committed
+			transaction_a.on_commit ([filter, hash_a] () {
+				filter->erase (hash_a);
+			});
+		}
 	}
 
 	bool exists (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const override
@@ -0,0 +1,279 @@
+#include <vxldollar/lib/utility.hpp>
+#include <vxldollar/secure/store.hpp>
+#include <vxldollar/secure/store_instrumentation.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+
+static_assert (static_cast<std::size_t> (vxldollar::tables::vote) + 1 == vxldollar::store_instrumentation::table_count);
+
+void vxldollar::store_instrumentation::enable (bool enable_a, unsigned sample_interval_a)
+{
+	interval = std::max (1u, sample_interval_a);
+	enabled = enable_a;
+}
+
+bool vxldollar::store_instrumentation::is_enabled () const
+{
+	return enabled;
+}
+
+unsigned vxldollar::store_instrumentation::sample_interval () const
+{
+	return interval;
+}
+
+void vxldollar::store_instrumentation::clear ()
+{
+	for (auto & operations : entries)
+	{
+		for (auto & entry : operations)
+		{
+			entry.count = 0;
+			entry.latency.clear ();
+		}
+	}
+	for (auto & total : totals)
+	{
+		total = 0;
+	}
+}
+
+void vxldollar::store_instrumentation::backend_set (std::unique_ptr<backend> backend_a)
+{
+	backend_counters = std::move (backend_a);
+}
+
+void vxldollar::store_instrumentation::begin (measurement & measurement_a, vxldollar::tables table_a, operation operation_a)
+{
+	auto & entry (get (table_a, operation_a));
+	if (entry.count.fetch_add (1, std::memory_order_relaxed) % interval.load (std::memory_order_relaxed) == 0)
+	{
+		measurement_a.instrumentation = this;
+		measurement_a.latency = &entry.latency;
+		if (backend_counters != nullptr)
+		{
+			measurement_a.counters = {};
+			backend_counters->sample_begin (measurement_a.counters);
+		}
+		measurement_a.start = std::chrono::steady_clock::now ();
+	}
+}
+
+void vxldollar::store_instrumentation::end (measurement & measurement_a)
+{
+	auto const elapsed (std::chrono::steady_clock::now () - measurement_a.start);
+	measurement_a.latency->add (std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ());
+	if (backend_counters != nullptr)
+	{
+		counter_values counters{};
+		backend_counters->sample_end (counters);
+		for (std::size_t i (0); i < counter_count; ++i)
+		{
+			totals[i].fetch_add (counters[i] - measurement_a.counters[i], std::memory_order_relaxed);
+		}
+	}
+}
+
+vxldollar::store_instrumentation::entry & vxldollar::store_instrumentation::get (vxldollar::tables table_a, operation operation_a)
+{
+	return entries[static_cast<std::size_t> (table_a)][static_cast<std::size_t> (operation_a)];
+}
+
+vxldollar::store_instrumentation::entry const & vxldollar::store_instrumentation::get (vxldollar::tables table_a, operation operation_a) const
+{
+	return entries[static_cast<std::size_t> (table_a)][static_cast<std::size_t> (operation_a)];
+}
+
+uint64_t vxldollar::store_instrumentation::count (vxldollar::tables table_a, operation operation_a) const
+{
+	return get (table_a, operation_a).count;
+}
+
+vxldollar::stat_log_histogram const & vxldollar::store_instrumentation::latency (vxldollar::tables table_a, operation operation_a) const
+{
+	return get (table_a, operation_a).latency;
+}
+
+uint64_t vxldollar::store_instrumentation::total (counter counter_a) const
+{
+	return totals[static_cast<std::size_t> (counter_a)];
+}
+
+void vxldollar::store_instrumentation::serialize (boost::property_tree::ptree & tree_a) const
+{
+	tree_a.put ("enabled", is_enabled ());
+	tree_a.put ("sample_interval", sample_interval ());
+	boost::property_tree::ptree tables_l;
+	for (std::size_t table (0); table < table_count; ++table)
+	{
+		boost::property_tree::ptree table_l;
+		for (std::size_t operation_l (0); operation_l < operation_count; ++operation_l)
+		{
+			auto const & entry (entries[table][operation_l]);
+			auto count_l (entry.count.load ());
+			if (count_l > 0)
+			{
+				boost::property_tree::ptree operation_tree;
+				operation_tree.put ("count", count_l);
+				auto const timed (entry.latency.count ());
+				operation_tree.put ("timed", timed);
+				if (timed > 0)
+				{
+					operation_tree.put ("average_ns", entry.latency.total () / timed);
+					boost::property_tree::ptree bins_l;
+					for (auto const & bin : entry.latency.get_bins ())
+					{
+						if (bin.value > 0)
+						{
+							boost::property_tree::ptree bin_l;
+							bin_l.put ("start_ns", bin.start_inclusive);
+							bin_l.put ("end_ns", bin.end_exclusive);
+							bin_l.put ("count", bin.value);
+							bins_l.push_back (std::make_pair ("", bin_l));
+						}
+					}
+					operation_tree.add_child ("bins", bins_l);
+				}
+				table_l.add_child (operation_name (static_cast<operation> (operation_l)), operation_tree);
+			}
+		}
+		if (!table_l.empty ())
+		{
+			tables_l.add_child (table_name (static_cast<vxldollar::tables> (table)), table_l);
+		}
+	}
+	tree_a.add_child ("tables", tables_l);
+	boost::property_tree::ptree counters_l;
+	for (std::size_t counter_l (0); counter_l < counter_count; ++counter_l)
+	{
+		counters_l.put (counter_name (static_cast<counter> (counter_l)), totals[counter_l].load ());
+	}
+	tree_a.add_child ("backend", counters_l);
+}
+
+std::string vxldollar::store_instrumentation::table_name (vxldollar::tables table_a)
+{
+	std::string result;
+	switch (table_a)
+	{
+		case vxldollar::tables::account_heights:
+			result = "account_heights";
+			break;
+		case vxldollar::tables::accounts:
+			result = "accounts";
+			break;
+		case vxldollar::tables::blocks:
+			result = "blocks";
+			break;
+		case vxldollar::tables::confirmation_height:
+			result = "confirmation_height";
+			break;
+		case vxldollar::tables::default_unused:
+			result = "default_unused";
+			break;
+		case vxldollar::tables::final_votes:
+			result = "final_votes";
+			break;
+		case vxldollar::tables::frontiers:
+			result = "frontiers";
+			break;
+		case vxldollar::tables::meta:
+			result = "meta";
+			break;
+		case vxldollar::tables::online_weight:
+			result = "online_weight";
+			break;
+		case vxldollar::tables::peers:
+			result = "peers";
+			break;
+		case vxldollar::tables::pending:
+			result = "pending";
+			break;
+		case vxldollar::tables::pruned:
+			result = "pruned";
+			break;
+		case vxldollar::tables::unchecked:
+			result = "unchecked";
+			break;
+		case vxldollar::tables::vote:
+			result = "vote";
+			break;
+	}
+	return result;
+}
+
+std::string vxldollar::store_instrumentation::operation_name (operation operation_a)
+{
+	std::string result;
+	switch (operation_a)
+	{
+		case operation::get:
+			result = "get";
+			break;
+		case operation::put:
+			result = "put";
+			break;
+		case operation::del:
+			result = "del";
+			break;
+		case operation::exists:
+			result = "exists";
+			break;
+		case operation::iterate:
+			result = "iterate";
+			break;
+	}
+	return result;
+}
+
+std::string vxldollar::store_instrumentation::counter_name (counter counter_a)
+{
+	std::string result;
+	switch (counter_a)
+	{
+		case counter::minor_page_faults:
+			result = "minor_page_faults";
+			break;
+		case counter::major_page_faults:
+			result = "major_page_faults";
+			break;
+		case counter::block_reads:
+			result = "block_reads";
+			break;
+		case counter::block_read_bytes:
+			result = "block_read_bytes";
+			break;
+		case counter::block_cache_hits:
+			result = "block_cache_hits";
+			break;
+		case counter::memtable_lookups:
+			result = "memtable_lookups";
+			break;
+		case counter::bloom_filter_useful:
+			result = "bloom_filter_useful";
+			break;
+	}
+	return result;
+}
+
+std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_container_info (store_instrumentation & instrumentation, std::string const & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	for (std::size_t table (0); table < store_instrumentation::table_count; ++table)
+	{
+		for (std::size_t operation (0); operation < store_instrumentation::operation_count; ++operation)
+		{
+			auto const table_l (static_cast<vxldollar::tables> (table));
+			auto const operation_l (static_cast<store_instrumentation::operation> (operation));
+			// Only the memory of the latency histograms is reported, operation counts are exported by the store stats
+			if (instrumentation.count (table_l, operation_l) > 0)
+			{
+				auto const name_l (store_instrumentation::table_name (table_l) + "_" + store_instrumentation::operation_name (operation_l));
+				composite->add_component (std::make_unique<container_info_leaf> (container_info{ name_l, 1, sizeof (vxldollar::stat_log_histogram) }));
+			}
+		}
+	}
+	return composite;
+}
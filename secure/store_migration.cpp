@@ -0,0 +1,264 @@
+#include <vxldollar/crypto/blake2/blake2.h>
+#include <vxldollar/lib/threading.hpp>
+#include <vxldollar/lib/timer.hpp>
+#include <vxldollar/secure/store_migration.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+std::string const vxldollar::store_migration::checkpoint_name = "checkpoint";
+
+vxldollar::store_migration::store_migration (vxldollar::store & source_a, vxldollar::store & target_a, boost::filesystem::path const & working_path_a, std::function<void (std::string const &)> progress_a) :
+	source (source_a),
+	target (target_a),
+	working_path (working_path_a),
+	progress_observer (std::move (progress_a))
+{
+}
+
+bool vxldollar::store_migration::resumable (boost::filesystem::path const & working_path_a)
+{
+	return boost::filesystem::exists (working_path_a / checkpoint_name);
+}
+
+bool vxldollar::store_migration::run ()
+{
+	boost::system::error_code ec;
+	boost::filesystem::create_directories (working_path, ec);
+	load_checkpoint ();
+	checkpoint_file.open ((working_path / checkpoint_name).string (), std::ios::app);
+	auto error (!checkpoint_file.is_open ());
+	// Keys of the large tables start with a hash or an account, so their first bytes are uniformly distributed
+	std::vector<std::tuple<vxldollar::tables, std::string, unsigned>> const tables_l{
+		{ vxldollar::tables::blocks, "blocks", range_count },
+		{ vxldollar::tables::accounts, "accounts", range_count },
+		{ vxldollar::tables::account_heights, "account_heights", range_count },
+		{ vxldollar::tables::confirmation_height, "confirmation_height", range_count },
+		{ vxldollar::tables::final_votes, "final_votes", range_count },
+		{ vxldollar::tables::frontiers, "frontiers", range_count },
+		{ vxldollar::tables::pending, "pending", range_count },
+		{ vxldollar::tables::pruned, "pruned", range_count },
+		{ vxldollar::tables::online_weight, "online_weight", 1 },
+		{ vxldollar::tables::peers, "peers", 1 }
+	};
+	for (auto i (tables_l.begin ()), n (tables_l.end ()); i != n && !error; ++i)
+	{
+		auto const & [table, name, ranges] = *i;
+		if (finished_tables.count (name) == 0)
+		{
+			error = migrate (table, name, ranges);
+		}
+		else
+		{
+			progress (name + ": migrated by an earlier run");
+		}
+	}
+	return error;
+}
+
+bool vxldollar::store_migration::migrate (vxldollar::tables table_a, std::string const & name_a, unsigned ranges_a)
+{
+	vxldollar::timer<std::chrono::milliseconds> timer (vxldollar::timer_state::started);
+	std::vector<table_range> ranges (ranges_a);
+	auto const width (256 / ranges_a);
+	for (unsigned i (0); i < ranges_a; ++i)
+	{
+		auto & range (ranges[i]);
+		range.first = static_cast<uint8_t> (i * width);
+		range.last = static_cast<uint8_t> ((i + 1) * width - 1);
+		range.path = working_path / boost::str (boost::format ("%1%.%2%") % name_a % i);
+	}
+	auto error (parallel (ranges.size (), [this, table_a, &name_a, &ranges] (std::size_t index_a) {
+		auto & range (ranges[index_a]);
+		auto const record (boost::str (boost::format ("%1% %2%") % name_a % index_a));
+		auto existing (finished_ranges.find (record));
+		// Files of an earlier run are gone once ingested, the range is then written again
+		if (existing != finished_ranges.end () && (existing->second == 0 || boost::filesystem::exists (range.path)))
+		{
+			range.entries = existing->second;
+			return false;
+		}
+		auto error (write (table_a, range));
+		if (!error)
+		{
+			checkpoint (boost::str (boost::format ("%1% %2%") % record % range.entries));
+		}
+		return error;
+	}));
+	if (!error)
+	{
+		uint64_t entries (0);
+		std::vector<boost::filesystem::path> paths;
+		for (auto const & range : ranges)
+		{
+			entries += range.entries;
+			if (range.entries > 0)
+			{
+				paths.push_back (range.path);
+			}
+		}
+		progress (boost::str (boost::format ("%1%: %2% entries written, ingesting") % name_a % entries));
+		error = target.ingest (table_a, paths);
+		if (!error)
+		{
+			uint64_t expected (0);
+			{
+				auto transaction (source.tx_begin_read ());
+				expected = source.count (transaction, table_a);
+			}
+			error = entries != expected || verify (table_a, ranges, expected);
+			if (!error)
+			{
+				checkpoint (name_a + " done");
+				for (auto const & path : paths)
+				{
+					boost::system::error_code ec;
+					boost::filesystem::remove (path, ec);
+				}
+				progress (boost::str (boost::format ("%1%: %2% entries migrated in %3% ms") % name_a % entries % timer.stop ().count ()));
+			}
+			else
+			{
+				progress (boost::str (boost::format ("%1%: verification failed, %2% entries expected") % name_a % expected));
+			}
+		}
+		else
+		{
+			progress (name_a + ": ingesting failed");
+		}
+	}
+	else
+	{
+		progress (name_a + ": writing table files failed");
+	}
+	return error;
+}
+
+bool vxldollar::store_migration::write (vxldollar::tables table_a, table_range & range_a)
+{
+	auto writer (target.make_table_file_writer (table_a, range_a.path));
+	auto error (writer == nullptr);
+	if (!error)
+	{
+		auto transaction (source.tx_begin_read ());
+		source.for_each_raw (transaction, table_a, range_a.first, range_a.last, [&error, &writer, &range_a] (uint8_t const * key_a, std::size_t key_size_a, uint8_t const * value_a, std::size_t value_size_a) {
+			if (!error)
+			{
+				if (range_a.entries % sample_interval == 0)
+				{
+					range_a.samples.push_back ({ std::vector<uint8_t> (key_a, key_a + key_size_a), digest (value_a, value_size_a) });
+				}
+				error = writer->put (key_a, key_size_a, value_a, value_size_a);
+				++range_a.entries;
+			}
+		});
+		error = error || writer->finish ();
+	}
+	return error;
+}
+
+bool vxldollar::store_migration::verify (vxldollar::tables table_a, std::vector<table_range> const & ranges_a, uint64_t expected_a)
+{
+	std::atomic<uint64_t> found{ 0 };
+	auto error (parallel (ranges_a.size (), [this, table_a, &ranges_a, &found] (std::size_t index_a) {
+		auto const & range (ranges_a[index_a]);
+		auto transaction (target.tx_begin_read ());
+		uint64_t entries (0);
+		auto mismatch (false);
+		auto sample (range.samples.begin ());
+		// Samples are in key order, so they are met one after another while iterating
+		target.for_each_raw (transaction, table_a, range.first, range.last, [&entries, &mismatch, &sample, &range] (uint8_t const * key_a, std::size_t key_size_a, uint8_t const * value_a, std::size_t value_size_a) {
+			++entries;
+			if (sample != range.samples.end () && sample->key.size () == key_size_a && std::equal (key_a, key_a + key_size_a, sample->key.begin ()))
+			{
+				mismatch = mismatch || sample->digest != digest (value_a, value_size_a);
+				++sample;
+			}
+		});
+		found += entries;
+		return mismatch || sample != range.samples.end ();
+	}));
+	return error || found != expected_a;
+}
+
+bool vxldollar::store_migration::parallel (std::size_t count_a, std::function<bool (std::size_t)> const & action_a)
+{
+	std::atomic<std::size_t> next{ 0 };
+	std::atomic<bool> error{ false };
+	auto const thread_count (std::min<std::size_t> (count_a, std::max (1u, std::thread::hardware_concurrency ())));
+	std::vector<std::thread> threads;
+	threads.reserve (thread_count);
+	for (std::size_t i (0); i < thread_count; ++i)
+	{
+		threads.emplace_back ([count_a, &action_a, &next, &error] () {
+			vxldollar::thread_role::set (vxldollar::thread_role::name::db_parallel_traversal);
+			for (auto index (next++); index < count_a && !error; index = next++)
+			{
+				if (action_a (index))
+				{
+					error = true;
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	return error;
+}
+
+void vxldollar::store_migration::load_checkpoint ()
+{
+	std::ifstream file ((working_path / checkpoint_name).string ());
+	std::string line;
+	while (std::getline (file, line))
+	{
+		// Records are "<table> <range> <entries>" for a written range and "<table> done" for an ingested table
+		std::istringstream record (line);
+		std::string name;
+		std::string range;
+		uint64_t entries (0);
+		if (record >> name >> range)
+		{
+			if (range == "done")
+			{
+				finished_tables.insert (name);
+			}
+			else if (record >> entries)
+			{
+				finished_ranges[name + " " + range] = entries;
+			}
+		}
+	}
+}
+
+void vxldollar::store_migration::checkpoint (std::string const & record_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+	checkpoint_file << record_a << std::endl;
+}
+
+void vxldollar::store_migration::progress (std::string const & message_a)
+{
+	if (progress_observer)
+	{
+		progress_observer (message_a);
+	}
+}
+
+uint64_t vxldollar::store_migration::digest (uint8_t const * value_a, std::size_t size_a)
+{
+	uint64_t result;
+	blake2b_state state;
+	blake2b_init (&state, sizeof (result));
+	blake2b_update (&state, value_a, size_a);
+	blake2b_final (&state, &result, sizeof (result));
+	return result;
+}
@@ -1,14 +1,20 @@
 #include <vxldollar/crypto_lib/random_pool.hpp>
 #include <vxldollar/lib/threading.hpp>
 #include <vxldollar/node/election.hpp>
+#include <vxldollar/node/lmdb/lmdb.hpp>
+#include <vxldollar/node/rocksdb/rocksdb.hpp>
 #include <vxldollar/node/transport/udp.hpp>
 #include <vxldollar/node/unchecked_map.hpp>
+#include <vxldollar/secure/network_filter.hpp>
 #include <vxldollar/test_common/network.hpp>
 #include <vxldollar/test_common/system.hpp>
 #include <vxldollar/test_common/testutil.hpp>
 
 #include <gtest/gtest.h>
 
+#include <crypto/cryptopp/seckey.h>
+#include <crypto/cryptopp/siphash.h>
+
 #include <boost/format.hpp>
 #include <boost/unordered_set.hpp>
 
@@ -1933,3 +1939,471 @@ TEST (node, wallet_create_block_confirm_conflicts)
 		t.join ();
 	}
 }
+
+namespace
+{
+/** Direct-mapped, mutex protected SipHash-2-4 filter, as network_filter was before becoming set-associative. Used as a benchmark baseline. */
+class siphash_filter final
+{
+public:
+	explicit siphash_filter (size_t size_a) :
+		items (size_a, vxldollar::uint128_t{ 0 })
+	{
+		vxldollar::random_pool::generate_block (key, key.size ());
+	}
+	bool apply (uint8_t const * bytes_a, size_t count_a)
+	{
+		vxldollar::uint128_union digest{ 0 };
+		CryptoPP::SipHash<2, 4, true> siphash (key, static_cast<unsigned int> (key.size ()));
+		siphash.CalculateDigest (digest.bytes.data (), bytes_a, count_a);
+		vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+		auto & element (items[static_cast<size_t> (digest.number () % items.size ())]);
+		bool existed (element == digest.number ());
+		element = digest.number ();
+		return existed;
+	}
+
+private:
+	std::vector<vxldollar::uint128_t> items;
+	CryptoPP::SecByteBlock key{ CryptoPP::SipHash<2, 4, true>::KEYLENGTH };
+	vxldollar::mutex mutex;
+};
+}
+
+/*
+ * Compares the duplicate filter against the previous SipHash filter with the same number of digests:
+ * - Throughput with 1 and 4 threads applying publish-sized payloads
+ * - How many recently seen duplicates are still recognized once the filter is filled (false positives, i.e. duplicates passed as unique)
+ */
+TEST (network_filter, benchmark)
+{
+	auto const capacity = 256 * 1024;
+	auto const message_count = 1024 * 1024;
+	std::vector<std::array<uint8_t, vxldollar::state_block::size>> messages (message_count);
+	for (auto & message : messages)
+	{
+		vxldollar::random_pool::generate_block (message.data (), message.size ());
+	}
+	auto run = [&messages] (auto & filter, size_t thread_count) {
+		std::atomic<size_t> unique{ 0 };
+		vxldollar::timer<std::chrono::milliseconds> timer;
+		timer.start ();
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < thread_count; ++i)
+		{
+			threads.emplace_back ([&filter, &messages, &unique, i, thread_count] () {
+				size_t unique_l{ 0 };
+				for (auto j = i; j < messages.size (); j += thread_count)
+				{
+					unique_l += !filter.apply (messages[j].data (), messages[j].size ());
+				}
+				unique += unique_l;
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		auto elapsed (timer.stop ().count ());
+		// Replay the most recent quarter of the filter capacity, all of them should be duplicates
+		size_t missed{ 0 };
+		auto const recent = capacity / 4;
+		for (auto j = messages.size () - recent; j < messages.size (); ++j)
+		{
+			missed += !filter.apply (messages[j].data (), messages[j].size ());
+		}
+		std::cout << boost::str (boost::format ("%1% thread(s): %2% ms, %3% unique of %4%, %5% of %6% recent duplicates passed as unique\n") % thread_count % elapsed % unique % messages.size () % missed % recent);
+	};
+	for (size_t thread_count : { 1, 4 })
+	{
+		{
+			siphash_filter filter (capacity);
+			std::cout << "siphash_filter, ";
+			run (filter, thread_count);
+		}
+		{
+			vxldollar::network_filter filter (capacity);
+			std::cout << "network_filter, ";
+			run (filter, thread_count);
+		}
+	}
+}
+
+/*
+ * Measures peer selection and flooding with 1024 peers, while another thread keeps connecting and disconnecting peers.
+ * Readers work on the published channel snapshot, so their latency should not depend on the membership churn.
+ */
+TEST (network, flood_peer_selection_benchmark)
+{
+	vxldollar::system system;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_udp = false;
+	node_flags.disable_initial_telemetry_requests = true;
+	node_flags.disable_ongoing_telemetry_requests = true;
+	auto & node (*system.add_node (node_flags));
+	auto const peer_count = 1024;
+	for (auto i = 0; i < peer_count; ++i)
+	{
+		ASSERT_NE (nullptr, node.network.udp_channels.insert (vxldollar::endpoint (boost::asio::ip::address_v6::loopback (), 10000 + i), node.network_params.network.protocol_version));
+	}
+	ASSERT_EQ (peer_count, node.network.size ());
+	auto run = [&node] (size_t thread_count, bool churn, int iterations, auto && action) {
+		std::atomic<bool> done{ false };
+		std::thread churn_thread;
+		if (churn)
+		{
+			churn_thread = std::thread ([&node, &done] () {
+				for (uint16_t port = 0; !done; port = (port + 1) % 256)
+				{
+					vxldollar::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 20000 + port);
+					node.network.udp_channels.insert (endpoint, node.network_params.network.protocol_version);
+					node.network.udp_channels.erase (endpoint);
+				}
+			});
+		}
+		vxldollar::timer<std::chrono::microseconds> timer;
+		timer.start ();
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < thread_count; ++i)
+		{
+			threads.emplace_back ([&action, iterations] () {
+				for (auto j = 0; j < iterations; ++j)
+				{
+					action ();
+				}
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		auto elapsed (timer.stop ().count ());
+		done = true;
+		if (churn_thread.joinable ())
+		{
+			churn_thread.join ();
+		}
+		return static_cast<double> (elapsed) / iterations;
+	};
+	auto random_set = [&node] () {
+		auto peers (node.network.random_set (node.network.fanout ()));
+		ASSERT_FALSE (peers.empty ());
+	};
+	auto list = [&node] () {
+		auto peers (node.network.list (node.network.fanout ()));
+		ASSERT_FALSE (peers.empty ());
+	};
+	for (auto churn : { false, true })
+	{
+		for (size_t thread_count : { 1, 4 })
+		{
+			std::cout << boost::str (boost::format ("%1% thread(s)%2%: random_set %3% us, list %4% us per call\n") % thread_count % (churn ? " with churn" : "") % run (thread_count, churn, 20000, random_set) % run (thread_count, churn, 20000, list));
+		}
+	}
+	// Flooding a small message also includes queueing it on every selected channel
+	vxldollar::keepalive keepalive{ node.network_params.network };
+	auto flood = [&node, &keepalive] () {
+		node.network.flood_message (keepalive, vxldollar::buffer_drop_policy::no_limiter_drop);
+	};
+	std::cout << boost::str (boost::format ("flood_message with churn: %1% us per flood to %2% peers\n") % run (1, true, 1000, flood) % node.network.fanout ());
+}
+
+/*
+ * Measures legacy bootstrap of many small accounts from a local peer over a single connection, with one pull at a time
+ * and with pipelined pulls. Every pull costs at least a round trip without pipelining, so the gap grows with peer latency.
+ */
+TEST (bootstrap, pull_pipelining_benchmark)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	config.bootstrap_connections = 1;
+	config.bootstrap_connections_max = 1;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.disable_lazy_bootstrap = true;
+	node_flags.disable_ongoing_bootstrap = true;
+	auto & node0 (*system.add_node (config, node_flags));
+	auto const account_count = 1000;
+	vxldollar::state_block_builder builder;
+	auto latest (vxldollar::dev::genesis->hash ());
+	auto balance (vxldollar::dev::constants.genesis_amount);
+	for (auto i = 0; i < account_count; ++i)
+	{
+		vxldollar::keypair key;
+		balance -= vxldollar::Gxrb_ratio;
+		auto send = builder
+					.make_block ()
+					.account (vxldollar::dev::genesis_key.pub)
+					.previous (latest)
+					.representative (vxldollar::dev::genesis_key.pub)
+					.balance (balance)
+					.link (key.pub)
+					.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					.work (*system.work.generate (latest))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0.process (*send).code);
+		latest = send->hash ();
+		auto open = builder
+					.make_block ()
+					.account (key.pub)
+					.previous (0)
+					.representative (key.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send->hash ())
+					.sign (key.prv, key.pub)
+					.work (*system.work.generate (key.pub))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0.process (*open).code);
+	}
+	for (auto pipelining : { false, true })
+	{
+		auto flags (node_flags);
+		flags.disable_bootstrap_pipelining = !pipelining;
+		config.peering_port = vxldollar::get_available_port ();
+		auto & node1 (*system.add_node (config, flags));
+		vxldollar::timer<std::chrono::milliseconds> timer;
+		timer.start ();
+		node1.bootstrap_initiator.bootstrap (node0.network.endpoint (), false);
+		ASSERT_TIMELY (120s, node1.ledger.cache.block_count == node0.ledger.cache.block_count);
+		auto elapsed (timer.stop ().count ());
+		std::cout << boost::str (boost::format ("%1%: %2% accounts in %3% ms, %4% pipelined pulls\n") % (pipelining ? "pipelined" : "sequential") % account_count % elapsed % node1.stats.count (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_pipelined, vxldollar::stat::dir::out));
+	}
+}
+
+/*
+ * Measures legacy bootstrap of a long account chain with unchecked blocks written to the unchecked table and kept in memory.
+ * A bulk pull arrives newest block first, so every block but the first processed one waits in unchecked for its previous block.
+ */
+TEST (bootstrap, unchecked_memory_benchmark)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.disable_lazy_bootstrap = true;
+	node_flags.disable_ongoing_bootstrap = true;
+	auto & node0 (*system.add_node (config, node_flags));
+	auto const block_count = 10000;
+	vxldollar::state_block_builder builder;
+	auto latest (vxldollar::dev::genesis->hash ());
+	auto balance (vxldollar::dev::constants.genesis_amount);
+	for (auto i = 0; i < block_count; ++i)
+	{
+		balance -= 1;
+		auto send = builder
+					.make_block ()
+					.account (vxldollar::dev::genesis_key.pub)
+					.previous (latest)
+					.representative (vxldollar::dev::genesis_key.pub)
+					.balance (balance)
+					.link (vxldollar::dev::genesis_key.pub)
+					.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					.work (*system.work.generate (latest))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0.process (*send).code);
+		latest = send->hash ();
+	}
+	for (std::size_t memory_limit : { std::size_t{ 0 }, std::size_t{ 256 * 1024 * 1024 } })
+	{
+		auto config1 (config);
+		config1.peering_port = vxldollar::get_available_port ();
+		config1.unchecked_memory_limit = memory_limit;
+		auto & node1 (*system.add_node (config1, node_flags));
+		vxldollar::timer<std::chrono::milliseconds> timer;
+		timer.start ();
+		node1.bootstrap_initiator.bootstrap (node0.network.endpoint (), false);
+		ASSERT_TIMELY (300s, node1.ledger.cache.block_count == node0.ledger.cache.block_count);
+		auto elapsed (std::max<uint64_t> (1, timer.stop ().count ()));
+		std::cout << boost::str (boost::format ("%1%: %2% blocks in %3% ms, %4% blocks/s\n") % (memory_limit != 0 ? "memory" : "table") % block_count % elapsed % (block_count * 1000 / elapsed));
+	}
+}
+
+/*
+ * Compares reading blocks one hash at a time with block_store::get_many, for random hashes in a store of 100k blocks.
+ * Uses RocksDB when TEST_USE_ROCKSDB is set.
+ */
+TEST (store, get_many_benchmark)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store->init_error ());
+	auto const block_count = 100000;
+	std::vector<vxldollar::block_hash> stored;
+	{
+		auto transaction (store->tx_begin_write ());
+		for (auto i = 0; i < block_count; ++i)
+		{
+			vxldollar::block_hash previous;
+			vxldollar::random_pool::generate_block (previous.bytes.data (), previous.bytes.size ());
+			vxldollar::send_block block (previous, 1, 2, vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub, 0);
+			block.sideband_set ({});
+			store->block.put (transaction, block.hash (), block);
+			stored.push_back (block.hash ());
+		}
+	}
+	std::shuffle (stored.begin (), stored.end (), std::mt19937 (42));
+	for (std::size_t count : { 1000, 10000 })
+	{
+		std::vector<vxldollar::block_hash> hashes (stored.begin (), stored.begin () + count);
+		auto transaction (store->tx_begin_read ());
+		vxldollar::timer<std::chrono::microseconds> timer;
+		timer.start ();
+		std::size_t found (0);
+		for (auto const & hash : hashes)
+		{
+			found += store->block.get (transaction, hash) != nullptr;
+		}
+		auto single (timer.stop ().count ());
+		timer.restart ();
+		for (auto const & block : store->block.get_many (transaction, hashes))
+		{
+			found += block != nullptr;
+		}
+		auto batched (timer.stop ().count ());
+		ASSERT_EQ (2 * count, found);
+		std::cout << boost::str (boost::format ("%1% hashes: %2% us with get, %3% us with get_many\n") % count % single % batched);
+	}
+}
+
+// Compares on-disk size of the blocks table, ledger processing throughput and read latency for each RocksDB compression setting
+TEST (store, rocksdb_compression_benchmark)
+{
+	auto const block_count = 20000;
+	vxldollar::work_pool pool{ vxldollar::dev::network_params.network, std::numeric_limits<unsigned>::max () };
+	std::vector<std::shared_ptr<vxldollar::state_block>> blocks;
+	auto previous (vxldollar::dev::genesis->hash ());
+	auto balance (vxldollar::dev::constants.genesis_amount);
+	for (auto i = 0; i < block_count; ++i)
+	{
+		vxldollar::keypair destination;
+		balance -= 1;
+		vxldollar::state_block_builder builder;
+		auto block = builder
+					 .account (vxldollar::dev::genesis_key.pub)
+					 .previous (previous)
+					 .representative (vxldollar::dev::genesis_key.pub)
+					 .balance (balance)
+					 .link (destination.pub)
+					 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					 .work (*pool.generate (previous))
+					 .build_shared ();
+		previous = block->hash ();
+		blocks.push_back (block);
+	}
+	std::vector<vxldollar::block_hash> hashes;
+	std::transform (blocks.begin (), blocks.end (), std::back_inserter (hashes), [] (auto const & block) { return block->hash (); });
+	std::shuffle (hashes.begin (), hashes.end (), std::mt19937 (42));
+
+	std::vector<std::tuple<std::string, std::string, uint32_t>> settings{ { "none", "none", 0 }, { "lz4", "lz4", 0 }, { "lz4", "zstd", 0 }, { "lz4", "zstd", 16 * 1024 } };
+	for (auto const & [compression, bottommost_compression, dictionary_bytes] : settings)
+	{
+		vxldollar::rocksdb_config config;
+		config.enable = true;
+		config.compression = compression;
+		config.bottommost_compression = bottommost_compression;
+		config.dictionary_bytes = dictionary_bytes;
+		vxldollar::logger_mt logger;
+		vxldollar::rocksdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants, config);
+		ASSERT_FALSE (store.init_error ());
+		vxldollar::stat stats;
+		vxldollar::ledger ledger (store, stats, vxldollar::dev::constants);
+		vxldollar::timer<std::chrono::milliseconds> timer;
+		{
+			auto transaction (store.tx_begin_write ());
+			store.initialize (transaction, ledger.cache);
+			timer.start ();
+			for (auto const & block : blocks)
+			{
+				ASSERT_EQ (vxldollar::process_result::progress, ledger.process (transaction, *block).code);
+			}
+		}
+		auto process_ms (timer.stop ().count ());
+		ASSERT_FALSE (store.compact (vxldollar::tables::blocks));
+		auto size (store.table_file_size (vxldollar::tables::blocks));
+		vxldollar::timer<std::chrono::microseconds> read_timer;
+		read_timer.start ();
+		{
+			auto transaction (store.tx_begin_read ());
+			for (auto const & hash : hashes)
+			{
+				ASSERT_NE (nullptr, store.block.get (transaction, hash));
+			}
+		}
+		auto read_us (read_timer.stop ().count ());
+		std::cout << boost::str (boost::format ("compression %1%, bottommost %2%, dictionary %3% bytes: %4% bytes on disk, %5% blocks/s processed, %6% us per read\n") % compression % bottommost_compression % dictionary_bytes % size % (block_count * 1000 / std::max<uint64_t> (process_ms, 1)) % (static_cast<double> (read_us) / block_count));
+	}
+}
+
+// Cost of beginning and ending a read transaction, with a new LMDB transaction each time and with pooled ones
+TEST (store, read_transaction_benchmark)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// Read transactions are only pooled with LMDB
+		return;
+	}
+	vxldollar::logger_mt logger;
+	vxldollar::mdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	auto const count = 1000000;
+	vxldollar::timer<std::chrono::microseconds> timer;
+	timer.start ();
+	for (auto i = 0; i < count; ++i)
+	{
+		auto transaction (store.env.tx_begin_read ());
+	}
+	auto unpooled (timer.stop ().count ());
+	timer.restart ();
+	for (auto i = 0; i < count; ++i)
+	{
+		auto transaction (store.tx_begin_read ());
+	}
+	auto pooled (timer.stop ().count ());
+	std::cout << boost::str (boost::format ("%1% read transactions: %2% ns each when begun, %3% ns each when pooled\n") % count % (unpooled * 1000.0 / count) % (pooled * 1000.0 / count));
+}
+
+// Compares ledger write throughput through the write database queue, flushing on every commit and with group commit
+TEST (store, group_commit_benchmark)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// The write database queue is not used with RocksDB
+		return;
+	}
+	auto const count = 500;
+	std::vector<vxldollar::writer> writers{ vxldollar::writer::confirmation_height, vxldollar::writer::process_batch, vxldollar::writer::pruning };
+	auto run = [&writers, count] (bool group_commit_a) {
+		vxldollar::logger_mt logger;
+		vxldollar::mdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+		release_assert (!store.init_error ());
+		vxldollar::stat stats;
+		vxldollar::write_database_queue queue (false, group_commit_a ? std::function<void ()> ([&store] () { store.sync (); }) : nullptr, stats);
+		vxldollar::timer<std::chrono::microseconds> timer;
+		timer.start ();
+		std::vector<std::thread> threads;
+		for (auto i (0); i < writers.size (); ++i)
+		{
+			threads.emplace_back ([&store, &queue, writer = writers[i], i, count] () {
+				for (auto j (0); j < count; ++j)
+				{
+					auto guard (queue.wait (writer));
+					auto transaction (store.tx_begin_write ());
+					store.online_weight.put (transaction, i * count + j, vxldollar::amount (j));
+					transaction.commit ();
+				}
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		auto elapsed (timer.stop ().count ());
+		auto commits (writers.size () * count);
+		auto syncs (group_commit_a ? stats.count (vxldollar::stat::type::write_queue, vxldollar::stat::detail::group_sync) : commits);
+		std::cout << boost::str (boost::format ("%1%: %2% commits/s, %3% flushes, %4% commits per flush\n") % (group_commit_a ? "group commit" : "flush per commit") % (commits * 1000000.0 / elapsed) % syncs % (static_cast<double> (commits) / syncs));
+	};
+	run (false);
+	run (true);
+}
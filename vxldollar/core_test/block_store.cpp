@@ -5,6 +5,7 @@
 #include <vxldollar/lib/utility.hpp>
 #include <vxldollar/lib/work.hpp>
 #include <vxldollar/node/common.hpp>
+#include <vxldollar/node/ledger_backup.hpp>
 #include <vxldollar/node/lmdb/lmdb.hpp>
 #include <vxldollar/node/rocksdb/rocksdb.hpp>
 #include <vxldollar/secure/ledger.hpp>
@@ -17,6 +18,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <rocksdb/utilities/backupable_db.h>
+
 #include <fstream>
 #include <unordered_set>
 
@@ -131,6 +134,138 @@ TEST (block_store, add_item)
 	ASSERT_EQ (nullptr, latest3);
 }
 
+// Operations are counted per table once enabled, one in every sample interval of them is timed
+TEST (block_store, instrumentation)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	vxldollar::open_block block (0, 1, 0, vxldollar::keypair ().prv, 0, 0);
+	block.sideband_set ({});
+	auto hash1 (block.hash ());
+	auto transaction (store->tx_begin_write ());
+	store->block.put (transaction, hash1, block);
+	auto & instrumentation (store->instrumentation);
+	ASSERT_EQ (0, instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::put));
+	instrumentation.enable (true, 2);
+	store->block.put (transaction, hash1, block);
+	ASSERT_LE (1, instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::put));
+	auto const gets (instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get));
+	auto const timed (instrumentation.latency (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get).count ());
+	for (auto i (0); i < 4; ++i)
+	{
+		ASSERT_NE (nullptr, store->block.get (transaction, hash1));
+	}
+	ASSERT_EQ (gets + 4, instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get));
+	ASSERT_EQ (timed + 2, instrumentation.latency (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get).count ());
+	ASSERT_EQ (0, instrumentation.count (vxldollar::tables::accounts, vxldollar::store_instrumentation::operation::get));
+	{
+		// Container info reports the memory of each used histogram, not the number of operations
+		auto info (vxldollar::collect_container_info (instrumentation, "instrumentation"));
+		auto & composite (static_cast<vxldollar::container_info_composite &> (*info));
+		ASSERT_FALSE (composite.get_children ().empty ());
+		for (auto const & child : composite.get_children ())
+		{
+			auto const & leaf (static_cast<vxldollar::container_info_leaf &> (*child).get_info ());
+			ASSERT_EQ (1, leaf.count);
+			ASSERT_EQ (sizeof (vxldollar::stat_log_histogram), leaf.sizeof_element);
+		}
+	}
+	instrumentation.enable (false, 2);
+	ASSERT_NE (nullptr, store->block.get (transaction, hash1));
+	ASSERT_EQ (gets + 4, instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get));
+	instrumentation.clear ();
+	ASSERT_EQ (0, instrumentation.count (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get));
+}
+
+TEST (block_store, get_many)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	std::vector<vxldollar::open_block> blocks;
+	for (auto i (0); i < 3; ++i)
+	{
+		blocks.emplace_back (0, i + 1, i + 1, vxldollar::keypair ().prv, 0, 0);
+		blocks.back ().sideband_set ({});
+	}
+	vxldollar::account_info info (blocks[0].hash (), 2, blocks[0].hash (), 100, 0, 1, vxldollar::epoch::epoch_0);
+	vxldollar::pending_key pending_key (1, blocks[0].hash ());
+	vxldollar::pending_info pending_info (2, 3, vxldollar::epoch::epoch_0);
+	vxldollar::block_hash missing (blocks[0].hash ().number () + 1);
+	std::vector<vxldollar::block_hash> hashes{ blocks[2].hash (), missing, blocks[0].hash (), blocks[1].hash (), blocks[0].hash () };
+	auto check = [&] (vxldollar::transaction const & transaction_a) {
+		auto result (store->block.get_many (transaction_a, hashes));
+		ASSERT_EQ (hashes.size (), result.size ());
+		ASSERT_NE (nullptr, result[0]);
+		ASSERT_EQ (blocks[2], *result[0]);
+		ASSERT_EQ (nullptr, result[1]);
+		ASSERT_EQ (blocks[0], *result[2]);
+		ASSERT_EQ (blocks[1], *result[3]);
+		ASSERT_EQ (blocks[0], *result[4]);
+		ASSERT_TRUE (store->block.get_many (transaction_a, {}).empty ());
+		auto accounts (store->account.get_many (transaction_a, { 2, 1 }));
+		ASSERT_EQ (2, accounts.size ());
+		ASSERT_FALSE (accounts[0]);
+		ASSERT_TRUE (accounts[1]);
+		ASSERT_EQ (info, *accounts[1]);
+		auto pending (store->pending.get_many (transaction_a, { pending_key, vxldollar::pending_key (1, missing) }));
+		ASSERT_EQ (2, pending.size ());
+		ASSERT_TRUE (pending[0]);
+		ASSERT_EQ (pending_info, *pending[0]);
+		ASSERT_FALSE (pending[1]);
+		auto heights (store->confirmation_height.get_many (transaction_a, { 1, 2 }));
+		ASSERT_EQ (2, heights.size ());
+		ASSERT_EQ (5, heights[0].height);
+		ASSERT_EQ (blocks[0].hash (), heights[0].frontier);
+		ASSERT_EQ (0, heights[1].height);
+		ASSERT_TRUE (heights[1].frontier.is_zero ());
+	};
+	{
+		auto transaction (store->tx_begin_write ());
+		for (auto const & block : blocks)
+		{
+			store->block.put (transaction, block.hash (), block);
+		}
+		store->account.put (transaction, 1, info);
+		store->pending.put (transaction, pending_key, pending_info);
+		store->confirmation_height.put (transaction, 1, { 5, blocks[0].hash () });
+		check (transaction);
+	}
+	check (store->tx_begin_read ());
+}
+
+TEST (block_store, account_height)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	auto transaction (store->tx_begin_write ());
+	// Heights are ordered numerically within an account, not by their in-memory byte order
+	store->account_height.put (transaction, 2, 256, 3);
+	store->account_height.put (transaction, 2, 1, 4);
+	store->account_height.put (transaction, 1, 7, 5);
+	ASSERT_EQ (3, store->account_height.count (transaction));
+	ASSERT_EQ (vxldollar::block_hash (3), store->account_height.get (transaction, 2, 256));
+	ASSERT_EQ (vxldollar::block_hash (4), store->account_height.get (transaction, 2, 1));
+	ASSERT_TRUE (store->account_height.get (transaction, 2, 2).is_zero ());
+	ASSERT_TRUE (store->account_height.get (transaction, 1, 256).is_zero ());
+	auto i (store->account_height.begin (transaction, vxldollar::account_height_key (2, 0)));
+	ASSERT_NE (store->account_height.end (), i);
+	ASSERT_EQ (vxldollar::account (2), i->first.key ());
+	ASSERT_EQ (1, i->first.height ());
+	++i;
+	ASSERT_NE (store->account_height.end (), i);
+	ASSERT_EQ (256, i->first.height ());
+	ASSERT_EQ (vxldollar::block_hash (3), i->second);
+	++i;
+	ASSERT_EQ (store->account_height.end (), i);
+	store->account_height.del (transaction, 2, 256);
+	ASSERT_TRUE (store->account_height.get (transaction, 2, 256).is_zero ());
+	store->account_height.clear (transaction);
+	ASSERT_EQ (store->account_height.end (), store->account_height.begin (transaction));
+}
+
 TEST (block_store, clear_successor)
 {
 	vxldollar::logger_mt logger;
@@ -750,6 +885,144 @@ TEST (mdb_block_store, bad_path)
 	ASSERT_TRUE (store.init_error ());
 }
 
+TEST (mdb_block_store, read_txn_pool)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// Don't test this in rocksdb mode
+		return;
+	}
+	vxldollar::logger_mt logger;
+	vxldollar::mdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	vxldollar::read_mdb_txn_pool pool (store.env);
+	MDB_txn * handle;
+	{
+		vxldollar::read_transaction transaction{ std::make_unique<vxldollar::read_mdb_txn> (pool, vxldollar::mdb_txn_callbacks{}) };
+		handle = static_cast<MDB_txn *> (transaction.get_handle ());
+		ASSERT_EQ (0, pool.size ());
+	}
+	ASSERT_EQ (1, pool.size ());
+	// A renewed transaction sees writes committed while it was pooled
+	{
+		auto transaction (store.tx_begin_write ());
+		store.account.put (transaction, vxldollar::dev::genesis_key.pub, vxldollar::account_info{});
+	}
+	{
+		vxldollar::read_transaction transaction{ std::make_unique<vxldollar::read_mdb_txn> (pool, vxldollar::mdb_txn_callbacks{}) };
+		ASSERT_EQ (handle, transaction.get_handle ());
+		ASSERT_EQ (0, pool.size ());
+		ASSERT_TRUE (store.account.exists (transaction, vxldollar::dev::genesis_key.pub));
+	}
+	// Idle handles are kept up to the capacity of a shard
+	{
+		std::vector<vxldollar::read_transaction> transactions;
+		for (std::size_t i (0); i < vxldollar::read_mdb_txn_pool::shard_capacity + 1; ++i)
+		{
+			transactions.emplace_back (std::make_unique<vxldollar::read_mdb_txn> (pool, vxldollar::mdb_txn_callbacks{}));
+		}
+	}
+	ASSERT_EQ (vxldollar::read_mdb_txn_pool::shard_capacity, pool.size ());
+	pool.clear ();
+	ASSERT_EQ (0, pool.size ());
+}
+
+TEST (mdb_block_store, read_txn_pool_max_age)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// Don't test this in rocksdb mode
+		return;
+	}
+	vxldollar::logger_mt logger;
+	vxldollar::mdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	vxldollar::read_mdb_txn_pool pool (store.env, std::chrono::milliseconds (0));
+	{
+		vxldollar::read_transaction transaction{ std::make_unique<vxldollar::read_mdb_txn> (pool, vxldollar::mdb_txn_callbacks{}) };
+	}
+	ASSERT_EQ (1, pool.size ());
+	// The expired handle is aborted rather than renewed
+	vxldollar::read_transaction transaction{ std::make_unique<vxldollar::read_mdb_txn> (pool, vxldollar::mdb_txn_callbacks{}) };
+	ASSERT_EQ (0, pool.size ());
+	ASSERT_EQ (store.account.end (), store.account.begin (transaction));
+}
+
+TEST (mdb_block_store, backup)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// Don't test this in rocksdb mode
+		return;
+	}
+	vxldollar::logger_mt logger;
+	vxldollar::mdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	{
+		auto transaction (store.tx_begin_write ());
+		for (auto i (0); i < 100; ++i)
+		{
+			store.online_weight.put (transaction, i, vxldollar::amount (i));
+		}
+	}
+	auto destination (vxldollar::unique_path ());
+	vxldollar::ledger_backup backup (store, logger);
+	ASSERT_FALSE (backup.start (destination));
+	backup.wait ();
+	auto status (backup.get_status ());
+	ASSERT_FALSE (status.running);
+	ASSERT_TRUE (status.success.value_or (false));
+	ASSERT_GT (status.bytes_copied, 0);
+	ASSERT_LE (status.bytes_copied, status.bytes_total);
+	{
+		vxldollar::mdb_store copy (logger, destination / "data.ldb", vxldollar::dev::constants);
+		ASSERT_FALSE (copy.init_error ());
+		ASSERT_EQ (100, copy.online_weight.count (copy.tx_begin_read ()));
+	}
+	// A cancelled backup leaves the previous one in place
+	vxldollar::backup_progress progress;
+	progress.cancelled = true;
+	ASSERT_FALSE (store.backup (destination, progress, 0));
+	ASSERT_TRUE (boost::filesystem::exists (destination / "data.ldb"));
+	ASSERT_FALSE (boost::filesystem::exists (destination / "data.ldb.partial"));
+}
+
+// Cancelling a throttled backup aborts the copy rather than reading the rest of the ledger
+TEST (mdb_block_store, backup_cancel)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// Don't test this in rocksdb mode
+		return;
+	}
+	vxldollar::system system;
+	vxldollar::logger_mt logger;
+	vxldollar::mdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	{
+		// Several backup chunks
+		auto transaction (store.tx_begin_write ());
+		for (auto i (0); i < 100000; ++i)
+		{
+			store.online_weight.put (transaction, i, vxldollar::amount (i));
+		}
+	}
+	auto destination (vxldollar::unique_path ());
+	vxldollar::ledger_backup backup (store, logger);
+	// Only the first chunk passes the rate limit
+	ASSERT_FALSE (backup.start (destination, 1));
+	ASSERT_TIMELY (5s, backup.get_status ().bytes_copied > 0);
+	backup.stop ();
+	auto status (backup.get_status ());
+	ASSERT_FALSE (status.running);
+	ASSERT_FALSE (status.success.value_or (true));
+	ASSERT_LT (status.bytes_copied, status.bytes_total);
+	ASSERT_FALSE (boost::filesystem::exists (destination / "data.ldb"));
+	ASSERT_FALSE (boost::filesystem::exists (destination / "data.ldb.partial"));
+	// The store is still usable
+	ASSERT_EQ (100000, store.online_weight.count (store.tx_begin_read ()));
+}
+
 TEST (block_store, DISABLED_already_open) // File can be shared
 {
 	auto path (vxldollar::unique_path ());
@@ -791,6 +1064,69 @@ TEST (block_store, pending_exists)
 	ASSERT_FALSE (store->pending.exists (transaction, one));
 }
 
+// Lookups by account prefix, answered from filters for most accounts without pending entries
+TEST (block_store, pending_any)
+{
+	vxldollar::logger_mt logger;
+	auto path (vxldollar::unique_path ());
+	vxldollar::keypair key1;
+	vxldollar::keypair key2;
+	{
+		auto store = vxldollar::make_store (logger, path, vxldollar::dev::constants);
+		ASSERT_TRUE (!store->init_error ());
+		auto transaction (store->tx_begin_write ());
+		ASSERT_FALSE (store->pending.any (transaction, key1.pub));
+		store->pending.put (transaction, vxldollar::pending_key (key1.pub, 1), { 2, 3, vxldollar::epoch::epoch_0 });
+		store->pending.put (transaction, vxldollar::pending_key (key1.pub, 2), { 2, 3, vxldollar::epoch::epoch_0 });
+		ASSERT_TRUE (store->pending.any (transaction, key1.pub));
+		ASSERT_FALSE (store->pending.any (transaction, key2.pub));
+		ASSERT_TRUE (store->pending.exists (transaction, vxldollar::pending_key (key1.pub, 1)));
+		ASSERT_FALSE (store->pending.exists (transaction, vxldollar::pending_key (key2.pub, 1)));
+		store->pending.del (transaction, vxldollar::pending_key (key1.pub, 1));
+		ASSERT_TRUE (store->pending.any (transaction, key1.pub));
+		ASSERT_FALSE (store->pending.exists (transaction, vxldollar::pending_key (key1.pub, 1)));
+	}
+	// Filters are rebuilt from the stored entries when opening again
+	auto store = vxldollar::make_store (logger, path, vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	{
+		auto transaction (store->tx_begin_read ());
+		ASSERT_TRUE (store->pending.any (transaction, key1.pub));
+		ASSERT_FALSE (store->pending.any (transaction, key2.pub));
+		vxldollar::pending_info info;
+		ASSERT_FALSE (store->pending.get (transaction, vxldollar::pending_key (key1.pub, 2), info));
+		ASSERT_EQ (vxldollar::amount (3), info.amount);
+	}
+	{
+		auto transaction (store->tx_begin_write ());
+		store->pending.del (transaction, vxldollar::pending_key (key1.pub, 2));
+		ASSERT_FALSE (store->pending.any (transaction, key1.pub));
+	}
+}
+
+// Deletions reach the filters once committed, transactions reading the previous state still find the entries until then
+TEST (block_store, pending_del_uncommitted)
+{
+	vxldollar::logger_mt logger;
+	auto store = vxldollar::make_store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_TRUE (!store->init_error ());
+	vxldollar::keypair key1;
+	vxldollar::pending_key pending_key (key1.pub, 1);
+	store->pending.put (store->tx_begin_write (), pending_key, { 2, 3, vxldollar::epoch::epoch_0 });
+	auto write_transaction (store->tx_begin_write ());
+	store->pending.del (write_transaction, pending_key);
+	ASSERT_FALSE (store->pending.any (write_transaction, key1.pub));
+	{
+		auto read_transaction (store->tx_begin_read ());
+		ASSERT_TRUE (store->pending.exists (read_transaction, pending_key));
+		ASSERT_TRUE (store->pending.any (read_transaction, key1.pub));
+	}
+	write_transaction.commit ();
+	auto read_transaction (store->tx_begin_read ());
+	ASSERT_FALSE (store->pending.exists (read_transaction, pending_key));
+	ASSERT_FALSE (store->pending.any (read_transaction, key1.pub));
+}
+
 TEST (block_store, latest_exists)
 {
 	vxldollar::logger_mt logger;
@@ -1844,6 +2180,35 @@ TEST (mdb_block_store, upgrade_v20_v21)
 	ASSERT_LT (19, store.version.get (transaction));
 }
 
+TEST (mdb_block_store, upgrade_v21_v22)
+{
+	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		// Don't test this in rocksdb mode
+		return;
+	}
+	auto path (vxldollar::unique_path ());
+	vxldollar::logger_mt logger;
+	vxldollar::stat stats;
+	{
+		vxldollar::mdb_store store (logger, path, vxldollar::dev::constants);
+		vxldollar::ledger ledger (store, stats, vxldollar::dev::constants);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, ledger.cache);
+		// Delete account heights table
+		ASSERT_FALSE (mdb_drop (store.env.tx (transaction), store.account_heights_handle, 1));
+		store.version.put (transaction, 21);
+	}
+	// Upgrading should create the table
+	vxldollar::mdb_store store (logger, path, vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	ASSERT_NE (store.account_heights_handle, 0);
+
+	// Version should be correct
+	auto transaction (store.tx_begin_read ());
+	ASSERT_LT (21, store.version.get (transaction));
+}
+
 TEST (mdb_block_store, upgrade_backup)
 {
 	if (vxldollar::rocksdb_config::using_rocksdb_in_tests ())
@@ -2067,6 +2432,63 @@ TEST (rocksdb_block_store, tombstone_count)
 }
 }
 
+TEST (rocksdb_block_store, backup)
+{
+	vxldollar::logger_mt logger;
+	auto path (vxldollar::unique_path ());
+	auto destination (vxldollar::unique_path ());
+	{
+		vxldollar::rocksdb_store store (logger, path, vxldollar::dev::constants);
+		ASSERT_FALSE (store.init_error ());
+		{
+			auto transaction (store.tx_begin_write ());
+			for (auto i (0); i < 100; ++i)
+			{
+				store.online_weight.put (transaction, i, vxldollar::amount (i));
+			}
+		}
+		vxldollar::backup_progress progress;
+		ASSERT_TRUE (store.backup (destination, progress, 0));
+		// Table files of the first backup are shared with the second one
+		ASSERT_TRUE (store.backup (destination, progress, 0));
+	}
+	{
+		// File deletions cannot be paused on a read-only database
+		vxldollar::rocksdb_store store (logger, path, vxldollar::dev::constants, vxldollar::rocksdb_config{}, true);
+		ASSERT_FALSE (store.init_error ());
+		vxldollar::backup_progress progress;
+		ASSERT_FALSE (store.backup (vxldollar::unique_path (), progress, 0));
+	}
+	rocksdb::BackupEngineReadOnly * backup_engine_raw;
+	ASSERT_TRUE (rocksdb::BackupEngineReadOnly::Open (rocksdb::Env::Default (), rocksdb::BackupableDBOptions (destination.string ()), &backup_engine_raw).ok ());
+	std::unique_ptr<rocksdb::BackupEngineReadOnly> backup_engine (backup_engine_raw);
+	std::vector<rocksdb::BackupInfo> backups;
+	backup_engine->GetBackupInfo (&backups);
+	ASSERT_EQ (2, backups.size ());
+	auto restored (vxldollar::unique_path ());
+	ASSERT_TRUE (backup_engine->RestoreDBFromLatestBackup (restored.string (), restored.string ()).ok ());
+	vxldollar::rocksdb_store copy (logger, restored, vxldollar::dev::constants);
+	ASSERT_FALSE (copy.init_error ());
+	ASSERT_EQ (100, copy.online_weight.count (copy.tx_begin_read ()));
+}
+
+// Reads count block cache activity without leaving perf counting enabled on the calling thread
+TEST (rocksdb_block_store, perf_level_restored)
+{
+	vxldollar::logger_mt logger;
+	vxldollar::rocksdb_store store (logger, vxldollar::unique_path (), vxldollar::dev::constants);
+	ASSERT_FALSE (store.init_error ());
+	rocksdb::SetPerfLevel (rocksdb::PerfLevel::kDisable);
+	auto transaction (store.tx_begin_read ());
+	ASSERT_FALSE (store.block.exists (transaction, vxldollar::block_hash (1)));
+	ASSERT_EQ (rocksdb::PerfLevel::kDisable, rocksdb::GetPerfLevel ());
+	// Timed operations of the store instrumentation sample the perf context as well
+	store.instrumentation.enable (true, 1);
+	ASSERT_FALSE (store.block.exists (transaction, vxldollar::block_hash (1)));
+	ASSERT_LE (1, store.instrumentation.latency (vxldollar::tables::blocks, vxldollar::store_instrumentation::operation::get).count ());
+	ASSERT_EQ (rocksdb::PerfLevel::kDisable, rocksdb::GetPerfLevel ());
+}
+
 namespace
 {
 void write_sideband_v14 (vxldollar::mdb_store & store_a, vxldollar::transaction & transaction_a, vxldollar::block const & block_a, MDB_dbi db_a)
@@ -1,5 +1,7 @@
 #include <vxldollar/node/bootstrap/bootstrap_frontier.hpp>
 #include <vxldollar/node/bootstrap/bootstrap_lazy.hpp>
+#include <vxldollar/node/bootstrap/bootstrap_legacy.hpp>
+#include <vxldollar/node/bootstrap/bootstrap_priority.hpp>
 #include <vxldollar/test_common/system.hpp>
 #include <vxldollar/test_common/testutil.hpp>
 
@@ -167,6 +169,125 @@ TEST (bulk_pull, count_limit)
 	ASSERT_EQ (nullptr, block);
 }
 
+TEST (bulk_pull, read_ahead)
+{
+	vxldollar::system system (1);
+	auto node0 (system.nodes[0]);
+	vxldollar::block_builder builder;
+	std::vector<vxldollar::block_hash> chain{ vxldollar::dev::genesis->hash () };
+	auto const blocks_count (vxldollar::bulk_pull_server::read_ahead_max + 2);
+	for (std::size_t i (0); i < blocks_count; ++i)
+	{
+		auto send = builder
+					.state ()
+					.account (vxldollar::dev::genesis_key.pub)
+					.previous (chain.back ())
+					.representative (vxldollar::dev::genesis_key.pub)
+					.balance (vxldollar::dev::constants.genesis_amount - i - 1)
+					.link (vxldollar::dev::genesis_key.pub)
+					.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					.work (*system.work.generate (chain.back ()))
+					.build ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0->process (*send).code);
+		chain.push_back (send->hash ());
+	}
+
+	auto connection (std::make_shared<vxldollar::bootstrap_server> (std::make_shared<vxldollar::socket> (*node0, vxldollar::socket::endpoint_type_t::server), node0));
+	auto req = std::make_unique<vxldollar::bulk_pull> (vxldollar::dev::network_params.network);
+	req->start = vxldollar::dev::genesis_key.pub;
+	req->end.clear ();
+	connection->requests.push (std::unique_ptr<vxldollar::message>{});
+	auto request (std::make_shared<vxldollar::bulk_pull_server> (connection, std::move (req)));
+
+	// The first window is read in one go
+	auto block (request->get_next ());
+	ASSERT_NE (nullptr, block);
+	ASSERT_EQ (chain.back (), block->hash ());
+	ASSERT_EQ (vxldollar::bulk_pull_server::read_ahead_max - 1, request->read_ahead.size ());
+
+	// Blocks are returned in chain order across windows
+	for (auto i (chain.rbegin () + 1), n (chain.rend ()); i != n; ++i)
+	{
+		block = request->get_next ();
+		ASSERT_NE (nullptr, block);
+		ASSERT_EQ (*i, block->hash ());
+	}
+	ASSERT_EQ (nullptr, request->get_next ());
+}
+
+TEST (bulk_pull, compact_records)
+{
+	vxldollar::keypair key1;
+	vxldollar::keypair key2;
+	vxldollar::block_builder builder;
+	std::vector<std::shared_ptr<vxldollar::block>> blocks;
+	auto state = [&builder] (vxldollar::keypair const & key_a, vxldollar::account const & representative_a) {
+		return builder
+		.state ()
+		.account (key_a.pub)
+		.previous (1)
+		.representative (representative_a)
+		.balance (2)
+		.link (3)
+		.sign (key_a.prv, key_a.pub)
+		.work (4)
+		.build_shared ();
+	};
+	blocks.push_back (state (key1, key1.pub));
+	blocks.push_back (state (key1, key1.pub));
+	blocks.push_back (state (key1, key2.pub));
+	blocks.push_back (builder.send ().previous (1).destination (2).balance (3).sign (key1.prv, key1.pub).work (4).build_shared ());
+	blocks.push_back (state (key2, key2.pub));
+	blocks.push_back (state (key1, key1.pub));
+	std::vector<uint8_t> bytes;
+	std::size_t plain_size (0);
+	std::size_t written (0);
+	{
+		vxldollar::bulk_pull_compact writer;
+		vxldollar::vectorstream stream (bytes);
+		for (auto const & block : blocks)
+		{
+			written += writer.serialize (stream, *block);
+			plain_size += sizeof (vxldollar::block_type) + vxldollar::block::size (block->type ());
+		}
+	}
+	ASSERT_EQ (written, bytes.size ());
+	// Both fields of the second block, the account of the third and the representative of the fifth
+	ASSERT_EQ (plain_size - 4 * sizeof (vxldollar::account), bytes.size ());
+	vxldollar::bulk_pull_compact reader;
+	vxldollar::bufferstream stream (bytes.data (), bytes.size ());
+	for (auto const & expected : blocks)
+	{
+		uint8_t type;
+		ASSERT_FALSE (vxldollar::try_read (stream, type));
+		std::shared_ptr<vxldollar::block> block;
+		if (vxldollar::bulk_pull_compact::is_elided (type))
+		{
+			std::vector<uint8_t> buffer;
+			vxldollar::read (stream, buffer, vxldollar::bulk_pull_compact::size (type));
+			ASSERT_FALSE (reader.expand (type, buffer, buffer.size ()));
+			vxldollar::bufferstream block_stream (buffer.data (), buffer.size ());
+			block = vxldollar::deserialize_block (block_stream, vxldollar::block_type::state);
+		}
+		else
+		{
+			block = vxldollar::deserialize_block (stream, static_cast<vxldollar::block_type> (type));
+		}
+		ASSERT_NE (nullptr, block);
+		reader.update (*block);
+		ASSERT_EQ (*expected, *block);
+	}
+	uint8_t end;
+	ASSERT_TRUE (vxldollar::try_read (stream, end));
+	// Elided fields refer to a state block received before
+	uint8_t const type (vxldollar::bulk_pull_compact::state_elided | vxldollar::bulk_pull_compact::account_elided);
+	std::vector<uint8_t> record (vxldollar::bulk_pull_compact::size (type));
+	ASSERT_TRUE (vxldollar::bulk_pull_compact{}.expand (type, record, record.size ()));
+	ASSERT_FALSE (vxldollar::bulk_pull_compact::is_elided (static_cast<uint8_t> (vxldollar::block_type::state)));
+	ASSERT_FALSE (vxldollar::bulk_pull_compact::is_elided (vxldollar::bulk_pull_compact::state_elided));
+	ASSERT_FALSE (vxldollar::bulk_pull_compact::is_elided (vxldollar::bulk_pull_compact::state_elided | 0x04));
+}
+
 TEST (bootstrap_processor, DISABLED_process_none)
 {
 	vxldollar::system system (1);
@@ -336,6 +457,158 @@ TEST (bootstrap_processor, pull_diamond)
 	node1->stop ();
 }
 
+// Pulls for different accounts are in flight together on a single bootstrap connection
+TEST (bootstrap_processor, pull_pipelined)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	config.bootstrap_connections = 1;
+	config.bootstrap_connections_max = 1;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.disable_lazy_bootstrap = true;
+	node_flags.disable_ongoing_bootstrap = true;
+	auto node0 (system.add_node (config, node_flags));
+	vxldollar::state_block_builder builder;
+	auto latest (vxldollar::dev::genesis->hash ());
+	auto balance (vxldollar::dev::constants.genesis_amount);
+	for (auto i (0); i < 16; ++i)
+	{
+		vxldollar::keypair key;
+		balance -= vxldollar::Gxrb_ratio;
+		auto send = builder
+					.make_block ()
+					.account (vxldollar::dev::genesis_key.pub)
+					.previous (latest)
+					.representative (vxldollar::dev::genesis_key.pub)
+					.balance (balance)
+					.link (key.pub)
+					.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					.work (*system.work.generate (latest))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0->process (*send).code);
+		latest = send->hash ();
+		auto open = builder
+					.make_block ()
+					.account (key.pub)
+					.previous (0)
+					.representative (key.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send->hash ())
+					.sign (key.prv, key.pub)
+					.work (*system.work.generate (key.pub))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0->process (*open).code);
+	}
+	config.peering_port = vxldollar::get_available_port ();
+	auto node1 (system.add_node (config, node_flags));
+	ASSERT_NE (nullptr, node1->network.find_channel (node0->network.endpoint ()));
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint (), false);
+	ASSERT_TIMELY (10s, node1->ledger.cache.block_count == node0->ledger.cache.block_count);
+	ASSERT_LT (0, node1->stats.count (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_pipelined, vxldollar::stat::dir::out));
+}
+
+// Peers at bootstrap_compact_version_min leave out the account and representative repeated within a chain
+TEST (bootstrap_processor, pull_compact)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.disable_lazy_bootstrap = true;
+	node_flags.disable_ongoing_bootstrap = true;
+	auto node0 (system.add_node (config, node_flags));
+	vxldollar::state_block_builder builder;
+	auto latest (vxldollar::dev::genesis->hash ());
+	auto balance (vxldollar::dev::constants.genesis_amount);
+	auto const count (8);
+	for (auto i (0); i < count; ++i)
+	{
+		balance -= vxldollar::Gxrb_ratio;
+		auto send = builder
+					.make_block ()
+					.account (vxldollar::dev::genesis_key.pub)
+					.previous (latest)
+					.representative (vxldollar::dev::genesis_key.pub)
+					.balance (balance)
+					.link (vxldollar::keypair ().pub)
+					.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					.work (*system.work.generate (latest))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0->process (*send).code);
+		latest = send->hash ();
+	}
+	config.peering_port = vxldollar::get_available_port ();
+	auto node1 (system.add_node (config, node_flags));
+	ASSERT_NE (nullptr, node1->network.find_channel (node0->network.endpoint ()));
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint (), false);
+	ASSERT_TIMELY (10s, node1->latest (vxldollar::dev::genesis_key.pub) == latest);
+	// Every block after the head of the response is sent without both fields
+	ASSERT_LE ((count - 1) * 2 * sizeof (vxldollar::account), node0->stats.count (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_elided_bytes, vxldollar::stat::dir::out));
+}
+
+// Frontiers of the account space are requested in several ranges, every account is pulled exactly once
+TEST (bootstrap_processor, frontier_ranges)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.disable_lazy_bootstrap = true;
+	node_flags.disable_ongoing_bootstrap = true;
+	auto node0 (system.add_node (config, node_flags));
+	vxldollar::state_block_builder builder;
+	auto latest (vxldollar::dev::genesis->hash ());
+	auto balance (vxldollar::dev::constants.genesis_amount);
+	auto const account_count (32);
+	for (auto i (0); i < account_count; ++i)
+	{
+		vxldollar::keypair key;
+		balance -= vxldollar::Gxrb_ratio;
+		auto send = builder
+					.make_block ()
+					.account (vxldollar::dev::genesis_key.pub)
+					.previous (latest)
+					.representative (vxldollar::dev::genesis_key.pub)
+					.balance (balance)
+					.link (key.pub)
+					.sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+					.work (*system.work.generate (latest))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0->process (*send).code);
+		latest = send->hash ();
+		auto open = builder
+					.make_block ()
+					.account (key.pub)
+					.previous (0)
+					.representative (key.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send->hash ())
+					.sign (key.prv, key.pub)
+					.work (*system.work.generate (key.pub))
+					.build_shared ();
+		ASSERT_EQ (vxldollar::process_result::progress, node0->process (*open).code);
+	}
+	config.peering_port = vxldollar::get_available_port ();
+	config.bootstrap_frontier_ranges = 4;
+	auto node1 (system.add_node (config, node_flags));
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint (), false);
+	auto attempt (node1->bootstrap_initiator.current_attempt ());
+	ASSERT_NE (nullptr, attempt);
+	auto legacy (std::dynamic_pointer_cast<vxldollar::bootstrap_attempt_legacy> (attempt));
+	ASSERT_NE (nullptr, legacy);
+	ASSERT_EQ (4, legacy->frontier_ranges.size ());
+	ASSERT_EQ (legacy->frontier_ranges.front ().begin, vxldollar::account (0));
+	ASSERT_EQ (legacy->frontier_ranges.back ().end, vxldollar::account (std::numeric_limits<vxldollar::uint256_t>::max ()));
+	ASSERT_TIMELY (10s, node1->ledger.cache.block_count == node0->ledger.cache.block_count);
+	// The genesis chain and every opened account are pulled once
+	ASSERT_TIMELY (10s, legacy->frontiers_received);
+	ASSERT_EQ (account_count + 1, legacy->account_count);
+}
+
 TEST (bootstrap_processor, DISABLED_pull_requeue_network_error)
 {
 	// Bootstrap attempt stopped before requeue & then cannot be found in attempts list
@@ -553,6 +826,118 @@ TEST (bootstrap_processor, lazy_hash)
 	node1->stop ();
 }
 
+// Lazy bootstrap state is moved to disk when it exceeds bootstrap_lazy_memory_limit, the attempt still completes
+TEST (bootstrap_processor, lazy_hash_spilled)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	auto node0 (system.add_node (config, node_flags));
+	vxldollar::keypair key1;
+	vxldollar::keypair key2;
+	vxldollar::state_block_builder builder;
+	auto send1 = builder
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (vxldollar::dev::genesis->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio)
+				 .link (key1.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*node0->work_generate_blocking (vxldollar::dev::genesis->hash ()))
+				 .build_shared ();
+	auto receive1 = builder
+					.make_block ()
+					.account (key1.pub)
+					.previous (0)
+					.representative (key1.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send1->hash ())
+					.sign (key1.prv, key1.pub)
+					.work (*node0->work_generate_blocking (key1.pub))
+					.build_shared ();
+	auto send2 = builder
+				 .make_block ()
+				 .account (key1.pub)
+				 .previous (receive1->hash ())
+				 .representative (key1.pub)
+				 .balance (0)
+				 .link (key2.pub)
+				 .sign (key1.prv, key1.pub)
+				 .work (*node0->work_generate_blocking (receive1->hash ()))
+				 .build_shared ();
+	auto receive2 = builder
+					.make_block ()
+					.account (key2.pub)
+					.previous (0)
+					.representative (key2.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send2->hash ())
+					.sign (key2.prv, key2.pub)
+					.work (*node0->work_generate_blocking (key2.pub))
+					.build_shared ();
+	node0->block_processor.add (send1);
+	node0->block_processor.add (receive1);
+	node0->block_processor.add (send2);
+	node0->block_processor.add (receive2);
+	node0->block_processor.flush ();
+	// Any lazy state exceeds the limit
+	config.peering_port = vxldollar::get_available_port ();
+	config.bootstrap_lazy_memory_limit = 1;
+	auto node1 (std::make_shared<vxldollar::node> (system.io_ctx, vxldollar::unique_path (), config, system.work, node_flags, 1));
+	node1->network.udp_channels.insert (node0->network.endpoint (), node1->network_params.network.protocol_version);
+	node1->bootstrap_initiator.bootstrap_lazy (receive2->hash (), true);
+	auto lazy_attempt (std::dynamic_pointer_cast<vxldollar::bootstrap_attempt_lazy> (node1->bootstrap_initiator.current_lazy_attempt ()));
+	ASSERT_NE (nullptr, lazy_attempt);
+	ASSERT_TIMELY (10s, node1->balance (key2.pub) != 0);
+	auto path (node1->application_path / ("lazy_bootstrap_" + std::to_string (lazy_attempt->incremental_id) + ".ldb"));
+	{
+		vxldollar::lock_guard<vxldollar::mutex> lock (lazy_attempt->mutex);
+		ASSERT_NE (nullptr, lazy_attempt->lazy_spilled);
+		ASSERT_TRUE (lazy_attempt->lazy_blocks.empty ());
+		ASSERT_TRUE (boost::filesystem::exists (path));
+	}
+	ASSERT_TIMELY (10s, lazy_attempt->stopped);
+	lazy_attempt.reset ();
+	// Removed with the attempt
+	ASSERT_TIMELY (10s, !boost::filesystem::exists (path));
+	node1->stop ();
+}
+
+TEST (bootstrap_processor, lazy_spill_store_batch)
+{
+	auto path (vxldollar::unique_path ());
+	vxldollar::lazy_spill_store store (path);
+	ASSERT_FALSE (store.error);
+	vxldollar::block_hash hash1 (1);
+	vxldollar::block_hash hash2 (2);
+	vxldollar::lazy_state_backlog_item item;
+	item.balance = 10;
+	store.backlog_insert (hash1, item);
+	ASSERT_EQ (1, store.backlog_size ());
+	// Reads in a batch see its uncommitted writes
+	store.batch_begin ();
+	ASSERT_TRUE (store.batch_active ());
+	store.backlog_insert (hash2, item);
+	ASSERT_TRUE (store.fingerprint_insert (store.blocks, 42));
+	ASSERT_TRUE (store.fingerprint_exists (store.blocks, 42));
+	ASSERT_EQ (2, store.backlog_size ());
+	ASSERT_EQ (2, store.size (store.backlog));
+	auto taken (store.backlog_take (hash1));
+	ASSERT_TRUE (taken.is_initialized ());
+	ASSERT_EQ (10, taken->balance);
+	ASSERT_FALSE (store.backlog_take (hash1).is_initialized ());
+	store.batch_commit ();
+	ASSERT_FALSE (store.batch_active ());
+	ASSERT_EQ (1, store.backlog_size ());
+	ASSERT_EQ (1, store.size (store.backlog));
+	ASSERT_TRUE (store.fingerprint_exists (store.blocks, 42));
+	store.backlog_erase (hash2);
+	ASSERT_EQ (0, store.backlog_size ());
+	ASSERT_EQ (0, store.size (store.backlog));
+}
+
 TEST (bootstrap_processor, lazy_hash_bootstrap_id)
 {
 	vxldollar::system system;
@@ -1173,6 +1558,219 @@ TEST (bootstrap_processor, lazy_cancel)
 	node1->stop ();
 }
 
+// A block with a missing source raises the priority of the source, which is pulled together with its own dependencies
+TEST (bootstrap_processor, priority_gap)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	auto node0 (system.add_node (config, node_flags));
+	vxldollar::keypair key1;
+	vxldollar::keypair key2;
+	vxldollar::state_block_builder builder;
+	auto send1 = builder
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (vxldollar::dev::genesis->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio)
+				 .link (key1.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*node0->work_generate_blocking (vxldollar::dev::genesis->hash ()))
+				 .build_shared ();
+	auto receive1 = builder
+					.make_block ()
+					.account (key1.pub)
+					.previous (0)
+					.representative (key1.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send1->hash ())
+					.sign (key1.prv, key1.pub)
+					.work (*node0->work_generate_blocking (key1.pub))
+					.build_shared ();
+	auto send2 = builder
+				 .make_block ()
+				 .account (key1.pub)
+				 .previous (receive1->hash ())
+				 .representative (key1.pub)
+				 .balance (0)
+				 .link (key2.pub)
+				 .sign (key1.prv, key1.pub)
+				 .work (*node0->work_generate_blocking (receive1->hash ()))
+				 .build_shared ();
+	auto receive2 = builder
+					.make_block ()
+					.account (key2.pub)
+					.previous (0)
+					.representative (key2.pub)
+					.balance (vxldollar::Gxrb_ratio)
+					.link (send2->hash ())
+					.sign (key2.prv, key2.pub)
+					.work (*node0->work_generate_blocking (key2.pub))
+					.build_shared ();
+	node0->block_processor.add (send1);
+	node0->block_processor.add (receive1);
+	node0->block_processor.add (send2);
+	node0->block_processor.add (receive2);
+	node0->block_processor.flush ();
+	config.peering_port = vxldollar::get_available_port ();
+	node_flags.enable_priority_bootstrap = true;
+	auto node1 (std::make_shared<vxldollar::node> (system.io_ctx, vxldollar::unique_path (), config, system.work, node_flags, 1));
+	node1->network.udp_channels.insert (node0->network.endpoint (), node1->network_params.network.protocol_version);
+	// Only the last block arrives, as if from the live network
+	node1->block_processor.add (receive2);
+	ASSERT_TIMELY (10s, node1->balance (key2.pub) != 0);
+	ASSERT_TRUE (node1->ledger.block_or_pruned_exists (send1->hash ()));
+	auto priority_attempt (std::dynamic_pointer_cast<vxldollar::bootstrap_attempt_priority> (node1->bootstrap_initiator.current_priority_attempt ()));
+	ASSERT_NE (nullptr, priority_attempt);
+	ASSERT_LE (1, priority_attempt->requests);
+	ASSERT_EQ (1, node1->stats.count (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::initiate_priority, vxldollar::stat::dir::out));
+	node1->stop ();
+}
+
+// An account already in the ledger is pulled from the remote head down to the local head
+TEST (bootstrap_processor, priority_known_account)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.frontiers_confirmation = vxldollar::frontiers_confirmation_mode::disabled;
+	vxldollar::node_flags node_flags;
+	node_flags.disable_bootstrap_bulk_push_client = true;
+	node_flags.disable_legacy_bootstrap = true;
+	auto node0 (system.add_node (config, node_flags));
+	vxldollar::keypair key1;
+	vxldollar::state_block_builder builder;
+	auto send1 = builder
+				 .account (vxldollar::dev::genesis_key.pub)
+				 .previous (vxldollar::dev::genesis->hash ())
+				 .representative (vxldollar::dev::genesis_key.pub)
+				 .balance (vxldollar::dev::constants.genesis_amount - vxldollar::Gxrb_ratio)
+				 .link (key1.pub)
+				 .sign (vxldollar::dev::genesis_key.prv, vxldollar::dev::genesis_key.pub)
+				 .work (*node0->work_generate_blocking (vxldollar::dev::genesis->hash ()))
+				 .build_shared ();
+	node0->block_processor.add (send1);
+	node0->block_processor.flush ();
+	ASSERT_TRUE (node0->ledger.block_or_pruned_exists (send1->hash ()));
+	config.peering_port = vxldollar::get_available_port ();
+	node_flags.enable_priority_bootstrap = true;
+	auto node1 (std::make_shared<vxldollar::node> (system.io_ctx, vxldollar::unique_path (), config, system.work, node_flags, 1));
+	node1->network.udp_channels.insert (node0->network.endpoint (), node1->network_params.network.protocol_version);
+	node1->bootstrap_initiator.bootstrap_priority (vxldollar::dev::genesis_key.pub);
+	ASSERT_TIMELY (10s, node1->ledger.block_or_pruned_exists (send1->hash ()));
+	auto priority_attempt (std::dynamic_pointer_cast<vxldollar::bootstrap_attempt_priority> (node1->bootstrap_initiator.current_priority_attempt ()));
+	ASSERT_NE (nullptr, priority_attempt);
+	ASSERT_EQ (0, priority_attempt->satisfied);
+	node1->stop ();
+}
+
+// Priority bootstrap is opt-in, gaps are not scored otherwise
+TEST (bootstrap_processor, priority_disabled)
+{
+	vxldollar::system system;
+	auto node (system.add_node ());
+	vxldollar::keypair key1;
+	vxldollar::state_block_builder builder;
+	auto open = builder
+				.account (key1.pub)
+				.previous (0)
+				.representative (key1.pub)
+				.balance (vxldollar::Gxrb_ratio)
+				.link (vxldollar::block_hash (1))
+				.sign (key1.prv, key1.pub)
+				.work (*system.work.generate (key1.pub))
+				.build_shared ();
+	node->process_active (open);
+	ASSERT_TIMELY (5s, node->stats.count (vxldollar::stat::type::ledger, vxldollar::stat::detail::gap_source) > 0);
+	ASSERT_EQ (0, node->bootstrap_initiator.priorities.size ());
+	ASSERT_EQ (nullptr, node->bootstrap_initiator.current_priority_attempt ());
+}
+
+TEST (bootstrap_priorities, next)
+{
+	vxldollar::bootstrap_priorities priorities (std::chrono::milliseconds (1000));
+	vxldollar::block_hash hash1 (1);
+	vxldollar::block_hash hash2 (2);
+	ASSERT_TRUE (priorities.next ().is_zero ());
+	ASSERT_FALSE (priorities.raise (0));
+	ASSERT_TRUE (priorities.raise (hash1));
+	ASSERT_TRUE (priorities.raise (hash2));
+	ASSERT_FALSE (priorities.raise (hash2));
+	ASSERT_EQ (2, priorities.size ());
+	ASSERT_EQ (2 * vxldollar::bootstrap_priorities::priority_increase, priorities.priority (hash2));
+	auto now (std::chrono::steady_clock::now ());
+	// Highest score first, picking keeps the score
+	ASSERT_EQ (hash2, priorities.next (now).as_block_hash ());
+	ASSERT_EQ (2 * vxldollar::bootstrap_priorities::priority_increase, priorities.priority (hash2));
+	// hash2 waits for the request interval
+	ASSERT_EQ (hash1, priorities.next (now).as_block_hash ());
+	ASSERT_TRUE (priorities.next (now).is_zero ());
+	now += priorities.request_interval;
+	ASSERT_EQ (hash2, priorities.next (now).as_block_hash ());
+	ASSERT_EQ (hash1, priorities.next (now).as_block_hash ());
+	ASSERT_EQ (2, priorities.size ());
+	priorities.erase (hash1);
+	priorities.raise (hash2);
+	priorities.erase (hash2);
+	ASSERT_EQ (0, priorities.size ());
+	for (auto i (0); i < 100; ++i)
+	{
+		priorities.raise (hash1);
+	}
+	ASSERT_EQ (vxldollar::bootstrap_priorities::priority_max, priorities.priority (hash1));
+}
+
+TEST (bootstrap_priorities, pull_results)
+{
+	vxldollar::bootstrap_priorities priorities (std::chrono::milliseconds (1000));
+	vxldollar::block_hash hash1 (1);
+	vxldollar::block_hash hash2 (2);
+	priorities.raise (hash1, 4 * vxldollar::bootstrap_priorities::priority_increase);
+	// Pulls which received blocks halve the score until it drops below the cutoff
+	priorities.pull_succeeded (hash1);
+	ASSERT_EQ (2 * vxldollar::bootstrap_priorities::priority_increase, priorities.priority (hash1));
+	priorities.pull_succeeded (hash1);
+	priorities.pull_succeeded (hash1);
+	ASSERT_EQ (1, priorities.size ());
+	priorities.pull_succeeded (hash1);
+	ASSERT_EQ (0, priorities.size ());
+	// Failed or empty pulls recover the score, the entry is dropped once too many failed in a row
+	priorities.raise (hash2);
+	priorities.pull_failed (hash2);
+	ASSERT_EQ (2 * vxldollar::bootstrap_priorities::priority_increase, priorities.priority (hash2));
+	priorities.pull_succeeded (hash2);
+	for (auto i (1u); i < vxldollar::bootstrap_priorities::failures_max; ++i)
+	{
+		priorities.pull_failed (hash2);
+	}
+	ASSERT_EQ (1, priorities.size ());
+	priorities.pull_failed (hash2);
+	ASSERT_EQ (0, priorities.size ());
+	// Results of keys which are no longer scored are ignored
+	priorities.pull_failed (hash1);
+	priorities.pull_succeeded (hash1);
+	ASSERT_EQ (0, priorities.size ());
+}
+
+// The priority attempt runs on its own thread, it neither delays other attempts nor counts as a bootstrap in progress
+TEST (bootstrap_processor, priority_background)
+{
+	vxldollar::system system;
+	vxldollar::node_config config (vxldollar::get_available_port (), system.logging);
+	config.bootstrap_initiator_threads = 1;
+	vxldollar::node_flags node_flags;
+	node_flags.enable_priority_bootstrap = true;
+	auto node (system.add_node (config, node_flags));
+	node->bootstrap_initiator.bootstrap_priority (vxldollar::block_hash (1));
+	ASSERT_TIMELY (5s, node->bootstrap_initiator.current_priority_attempt () != nullptr && node->bootstrap_initiator.current_priority_attempt ()->started);
+	ASSERT_FALSE (node->bootstrap_initiator.in_progress ());
+	node->bootstrap_initiator.bootstrap_lazy (vxldollar::block_hash (2));
+	ASSERT_TRUE (node->bootstrap_initiator.in_progress ());
+	ASSERT_TIMELY (5s, node->bootstrap_initiator.current_lazy_attempt () == nullptr || node->bootstrap_initiator.current_lazy_attempt ()->started);
+	ASSERT_NE (nullptr, node->bootstrap_initiator.current_priority_attempt ());
+}
+
 TEST (bootstrap_processor, wallet_lazy_frontier)
 {
 	vxldollar::system system;
@@ -6,6 +6,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <thread>
+
 TEST (network_filter, unit)
 {
 	vxldollar::network_filter filter (1);
@@ -126,3 +129,94 @@ TEST (network_filter, optional_digest)
 	filter.clear (digest);
 	ASSERT_FALSE (filter.apply (bytes1.data (), bytes1.size ()));
 }
+
+TEST (network_filter, associative)
+{
+	vxldollar::network_filter filter (vxldollar::network_filter::bucket_ways);
+	ASSERT_EQ (vxldollar::network_filter::bucket_ways, filter.capacity ());
+	std::vector<std::vector<uint8_t>> messages;
+	for (uint8_t i = 0; i < vxldollar::network_filter::bucket_ways; ++i)
+	{
+		messages.push_back ({ i, 1, 2, 3 });
+	}
+	// A single bucket holds every message without evicting the previous ones
+	for (auto const & message : messages)
+	{
+		ASSERT_FALSE (filter.apply (message.data (), message.size ()));
+	}
+	for (auto const & message : messages)
+	{
+		ASSERT_TRUE (filter.apply (message.data (), message.size ()));
+	}
+	filter.clear ();
+	for (auto const & message : messages)
+	{
+		ASSERT_FALSE (filter.apply (message.data (), message.size ()));
+	}
+}
+
+TEST (network_filter, salt)
+{
+	vxldollar::network_filter filter (vxldollar::network_filter::bucket_ways);
+	std::vector<uint8_t> bytes{ 1, 2, 3 };
+	vxldollar::uint128_t digest1{ 0 };
+	vxldollar::uint128_t digest2{ 0 };
+	ASSERT_FALSE (filter.apply (bytes.data (), bytes.size (), &digest1, 1));
+	ASSERT_FALSE (filter.apply (bytes.data (), bytes.size (), &digest2, 2));
+	ASSERT_NE (digest1, digest2);
+	ASSERT_TRUE (filter.apply (bytes.data (), bytes.size (), nullptr, 1));
+	filter.clear (digest1);
+	ASSERT_FALSE (filter.apply (bytes.data (), bytes.size (), nullptr, 1));
+	ASSERT_TRUE (filter.apply (bytes.data (), bytes.size (), nullptr, 2));
+}
+
+// Messages ending in words which cancel fixed hash constants must not collide independently of the key
+TEST (network_filter, keyed_collisions)
+{
+	auto message = [] (uint64_t first_a) {
+		std::array<uint64_t, 4> words{ first_a, 0, 0x8ebc6af09c88c6e3ull, 0xe7037ed1a0b428dbull };
+		std::vector<uint8_t> result (sizeof (words));
+		std::memcpy (result.data (), words.data (), result.size ());
+		return result;
+	};
+	auto message1 (message (1));
+	auto message2 (message (2));
+	vxldollar::network_filter filter1 (vxldollar::network_filter::bucket_ways);
+	vxldollar::network_filter filter2 (vxldollar::network_filter::bucket_ways);
+	vxldollar::uint128_t digest1{ 0 };
+	vxldollar::uint128_t digest2{ 0 };
+	ASSERT_FALSE (filter1.apply (message1.data (), message1.size (), &digest1));
+	ASSERT_FALSE (filter1.apply (message2.data (), message2.size (), &digest2));
+	ASSERT_NE (digest1, digest2);
+	// Digests, and so the pairs of messages which collide, depend on the key of each filter
+	vxldollar::uint128_t other1{ 0 };
+	ASSERT_FALSE (filter2.apply (message1.data (), message1.size (), &other1));
+	ASSERT_NE (digest1, other1);
+}
+
+TEST (network_filter, concurrent)
+{
+	vxldollar::network_filter filter (64 * 1024);
+	std::atomic<size_t> unique{ 0 };
+	std::vector<std::thread> threads;
+	for (auto i = 0; i < 4; ++i)
+	{
+		threads.emplace_back ([&filter, &unique] () {
+			for (uint32_t j = 0; j < 1000; ++j)
+			{
+				std::vector<uint8_t> bytes (sizeof (j));
+				std::memcpy (bytes.data (), &j, sizeof (j));
+				if (!filter.apply (bytes.data (), bytes.size ()))
+				{
+					++unique;
+				}
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	// Every message is seen as unique by exactly one thread
+	ASSERT_EQ (1000, unique);
+}
@@ -38,6 +38,39 @@ TEST (peer_container, no_self_incoming)
 	ASSERT_TRUE (system.nodes[0]->network.empty ());
 }
 
+// Lookups and random selection read a snapshot of the channels, which must follow every membership and node ID change
+TEST (peer_container, snapshot_membership)
+{
+	vxldollar::system system (1);
+	auto & node1 (*system.nodes[0]);
+	auto & channels (node1.network.udp_channels);
+	vxldollar::endpoint endpoint1 (boost::asio::ip::address_v6::loopback (), 10000);
+	vxldollar::endpoint endpoint2 (boost::asio::ip::address_v6::loopback (), 10001);
+	vxldollar::keypair key1;
+	auto channel1 (channels.insert (endpoint1, node1.network_params.network.protocol_version));
+	auto channel2 (channels.insert (endpoint2, node1.network_params.network.protocol_version));
+	ASSERT_NE (nullptr, channel1);
+	ASSERT_NE (nullptr, channel2);
+	ASSERT_EQ (2, channels.size ());
+	ASSERT_EQ (channel1, channels.channel (endpoint1));
+	ASSERT_EQ (2, channels.random_set (10).size ());
+	ASSERT_EQ (nullptr, channels.find_node_id (key1.pub));
+	channels.modify (channel1, [&key1] (auto channel) {
+		channel->set_node_id (key1.pub);
+	});
+	ASSERT_EQ (channel1, channels.find_node_id (key1.pub));
+	channels.clean_node_id (key1.pub);
+	ASSERT_EQ (nullptr, channels.find_node_id (key1.pub));
+	ASSERT_EQ (nullptr, channels.channel (endpoint1));
+	ASSERT_EQ (1, channels.size ());
+	channels.erase (endpoint2);
+	ASSERT_EQ (nullptr, channels.channel (endpoint2));
+	ASSERT_TRUE (channels.random_set (10).empty ());
+	std::deque<std::shared_ptr<vxldollar::transport::channel>> list;
+	channels.list (list);
+	ASSERT_TRUE (list.empty ());
+}
+
 TEST (peer_container, reserved_peers_no_contact)
 {
 	vxldollar::system system (1);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vxldollar
+{
+/**
+ * Counting bloom filter over 64-bit keys, answering "definitely absent" for most keys which were never inserted.
+ * Keys can be erased as many times as they were inserted. A counter which saturated is never decremented again,
+ * so erasing only ever leaves false positives behind, never false negatives.
+ * @note This class is thread-safe and lock-free. Counters are updated with relaxed atomics, as no other data depends on them.
+ */
+class counting_filter final
+{
+public:
+	/** Creates a filter of at least \p counters_a one byte counters, rounded up to a power of two */
+	explicit counting_filter (std::size_t counters_a);
+	void insert (uint64_t key_a);
+	/** @warning \p key_a must have been inserted, erasing other keys can cause false negatives */
+	void erase (uint64_t key_a);
+	/** @return false if \p key_a is not in the filter, true if it may be */
+	bool may_contain (uint64_t key_a) const;
+	void clear ();
+	std::size_t memory_size () const;
+
+	static std::size_t constexpr hash_count = 3;
+
+private:
+	std::size_t index (uint64_t key_a, std::size_t i) const;
+	std::vector<std::atomic<uint8_t>> counters;
+};
+}
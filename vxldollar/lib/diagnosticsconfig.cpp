@@ -9,6 +9,11 @@ vxldollar::error vxldollar::diagnostics_config::serialize_toml (vxldollar::tomlc
 	txn_tracking_l.put ("min_write_txn_time", txn_tracking.min_write_txn_time.count (), "Log stacktrace when write transactions are held longer than this duration.\ntype:milliseconds");
 	txn_tracking_l.put ("ignore_writes_below_block_processor_max_time", txn_tracking.ignore_writes_below_block_processor_max_time, "Ignore any block processor writes less than block_processor_batch_max_time.\ntype:bool");
 	toml.put_child ("txn_tracking", txn_tracking_l);
+
+	vxldollar::tomlconfig store_instrumentation_l;
+	store_instrumentation_l.put ("enable", store_instrumentation.enable, "Enable or disable counting database operations per table and timing a sample of them.\ntype:bool");
+	store_instrumentation_l.put ("sample_interval", store_instrumentation.sample_interval, "Time one in this many operations on each table.\ntype:uint32,[1..]");
+	toml.put_child ("store_instrumentation", store_instrumentation_l);
 	return toml.get_error ();
 }
 
@@ -28,5 +33,16 @@ vxldollar::error vxldollar::diagnostics_config::deserialize_toml (vxldollar::tom
 
 		txn_tracking_l->get_optional<bool> ("ignore_writes_below_block_processor_max_time", txn_tracking.ignore_writes_below_block_processor_max_time);
 	}
+
+	auto store_instrumentation_l (toml.get_optional_child ("store_instrumentation"));
+	if (store_instrumentation_l)
+	{
+		store_instrumentation_l->get_optional<bool> ("enable", store_instrumentation.enable);
+		store_instrumentation_l->get_optional<unsigned> ("sample_interval", store_instrumentation.sample_interval);
+		if (store_instrumentation.sample_interval == 0)
+		{
+			toml.get_error ().set ("store_instrumentation.sample_interval must be greater than 0");
+		}
+	}
 	return toml.get_error ();
 }
@@ -24,6 +24,7 @@ vxldollar::error vxldollar::lmdb_config::serialize_toml (vxldollar::tomlconfig &
 	}
 
 	toml.put ("sync", sync_string, "Sync strategy for flushing commits to the ledger database. This does not affect the wallet database.\ntype:string,{always, nosync_safe, nosync_unsafe, nosync_unsafe_large_memory}");
+	toml.put ("group_commit", group_commit, "Share one flush to disk between ledger writers committing in the same window, instead of flushing on every commit. Writers still wait for their commit to be flushed. Only applies to the always and nosync_safe sync strategies.\nOn filesystems without write ordering a system crash during a shared flush may corrupt the database.\ntype:bool");
 	toml.put ("max_databases", max_databases, "Maximum open lmdb databases. Increase default if more than 100 wallets is required.\nNote: external management is recommended when a large amounts of wallets are required (see https://docs.vxldollar.org/integration-guides/key-management/).\ntype:uin32");
 	toml.put ("map_size", map_size, "Maximum ledger database map size in bytes.\ntype:uint64");
 	return toml.get_error ();
@@ -32,6 +33,7 @@ vxldollar::error vxldollar::lmdb_config::serialize_toml (vxldollar::tomlconfig &
 vxldollar::error vxldollar::lmdb_config::deserialize_toml (vxldollar::tomlconfig & toml)
 {
 	auto default_max_databases = max_databases;
+	toml.get_optional<bool> ("group_commit", group_commit);
 	toml.get_optional<uint32_t> ("max_databases", max_databases);
 	toml.get_optional<size_t> ("map_size", map_size);
 
@@ -5,12 +5,16 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <initializer_list>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace vxldollar
 {
@@ -112,6 +116,72 @@ private:
 	std::vector<bin> bins;
 };
 
+/**
+ * Lock-free histogram with power of two bins, for durations recorded on hot paths
+ * Bin 0 counts zero values and bin i counts values in [2^(i-1), 2^i). Values beyond the last bin are clamped into it.
+ */
+class stat_log_histogram final
+{
+public:
+	static size_t constexpr bin_count = 32;
+
+	void add (uint64_t value_a)
+	{
+		size_t index (0);
+		for (auto value (value_a); value != 0 && index < bin_count - 1; value >>= 1)
+		{
+			++index;
+		}
+		bins[index].fetch_add (1, std::memory_order_relaxed);
+		sum.fetch_add (value_a, std::memory_order_relaxed);
+	}
+
+	/** Number of values added */
+	uint64_t count () const
+	{
+		uint64_t result (0);
+		for (auto const & bin : bins)
+		{
+			result += bin.load (std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	/** Sum of all values added */
+	uint64_t total () const
+	{
+		return sum.load (std::memory_order_relaxed);
+	}
+
+	/** Bins in the same form as stat_histogram. Concurrent updates may or may not be included. */
+	std::vector<stat_histogram::bin> get_bins () const
+	{
+		std::vector<stat_histogram::bin> result;
+		result.reserve (bin_count);
+		for (size_t i (0); i < bin_count; ++i)
+		{
+			auto const start (i == 0 ? 0 : uint64_t{ 1 } << (i - 1));
+			auto const end (i == bin_count - 1 ? std::numeric_limits<uint64_t>::max () : uint64_t{ 1 } << i);
+			result.emplace_back (start, end);
+			result.back ().value = bins[i].load (std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	void clear ()
+	{
+		for (auto & bin : bins)
+		{
+			bin.store (0, std::memory_order_relaxed);
+		}
+		sum.store (0, std::memory_order_relaxed);
+	}
+
+private:
+	std::array<std::atomic<uint64_t>, bin_count> bins{};
+	std::atomic<uint64_t> sum{ 0 };
+};
+
 /**
  * Bookkeeping of statistics for a specific type/detail/direction combination
  */
@@ -241,7 +311,10 @@ public:
 		requests,
 		filter,
 		telemetry,
-		vote_generator
+		vote_generator,
+		write_queue,
+		block_filter,
+		pruning
 	};
 
 	/** Optional detail type */
@@ -289,6 +362,7 @@ public:
 		initiate_legacy_age,
 		initiate_lazy,
 		initiate_wallet_lazy,
+		initiate_priority,
 
 		// bootstrap specific
 		bulk_pull,
@@ -298,6 +372,10 @@ public:
 		bulk_pull_failed_account,
 		bulk_pull_receive_block_failure,
 		bulk_pull_request_failure,
+		bulk_pull_blocks_served,
+		bulk_pull_serve_time_us,
+		bulk_pull_pipelined,
+		bulk_pull_elided_bytes,
 		bulk_push,
 		frontier_req,
 		frontier_confirmation_failed,
@@ -384,6 +462,12 @@ public:
 
 		// duplicate
 		duplicate_publish,
+		duplicate_confirm_req,
+		duplicate_confirm_ack,
+
+		// peering
+		rtt_sample,
+		selected_degraded,
 
 		// telemetry
 		invalid_signature,
@@ -398,7 +482,22 @@ public:
 		generator_broadcasts,
 		generator_replies,
 		generator_replies_discarded,
-		generator_spacing
+		generator_spacing,
+
+		// write queue
+		group_sync,
+		writer_confirmation_height,
+		writer_process_batch,
+		writer_pruning,
+		writer_testing,
+
+		// block filter
+		filtered,
+		negative_cached,
+		false_positive,
+
+		// pruning
+		pruned
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -495,6 +594,54 @@ public:
 	/** Returns a non-owning histogram pointer, or nullptr if a histogram is not defined */
 	vxldollar::stat_histogram * get_histogram (stat::type type, stat::detail detail, stat::dir dir);
 
+	/** Stages of inbound realtime message handling with latency histograms */
+	enum class latency_stage : uint8_t
+	{
+		/** From receipt on the socket until a packet processing thread takes the message from its queue */
+		queue,
+		/** Time spent handling the message in network::process_message */
+		handle,
+		/** From hand-off until the block or vote is taken up by the block processor or vote processor */
+		processor
+	};
+	static size_t constexpr latency_stage_count = 3;
+
+	/**
+	 * Records a duration in microseconds for a message type, given by its detail (keepalive to telemetry_ack).
+	 * This does not lock and does not create stat entries, so it is cheap enough for every message.
+	 */
+	void update_latency (stat::detail detail, latency_stage stage, std::chrono::steady_clock::duration duration)
+	{
+		auto histogram (get_latency (detail, stage));
+		if (histogram != nullptr)
+		{
+			histogram->add (std::chrono::duration_cast<std::chrono::microseconds> (duration).count ());
+		}
+	}
+
+	/** Returns a non-owning latency histogram pointer, or nullptr if \p detail is not a message type */
+	vxldollar::stat_log_histogram * get_latency (stat::detail detail, latency_stage stage)
+	{
+		vxldollar::stat_log_histogram * result (nullptr);
+		if (detail >= stat::detail::keepalive && detail <= stat::detail::telemetry_ack)
+		{
+			result = &latencies[static_cast<size_t> (detail) - static_cast<size_t> (stat::detail::keepalive)][static_cast<size_t> (stage)];
+		}
+		return result;
+	}
+
+	/** Resets all latency histograms */
+	void clear_latencies ()
+	{
+		for (auto & stages : latencies)
+		{
+			for (auto & histogram : stages)
+			{
+				histogram.clear ();
+			}
+		}
+	}
+
 	/**
 	 * Add \p value to stat. If sampling is configured, this will update the current sample and
 	 * call any sample observers if the interval is over.
@@ -636,6 +783,9 @@ private:
 	/** Whether stats should be output */
 	bool stopped{ false };
 
+	/** Latency histograms indexed by message detail, starting at detail::keepalive, and stage */
+	std::array<std::array<vxldollar::stat_log_histogram, latency_stage_count>, static_cast<size_t> (stat::detail::telemetry_ack) - static_cast<size_t> (stat::detail::keepalive) + 1> latencies;
+
 	/** All access to stat is thread safe, including calls from observers on the same thread */
 	vxldollar::mutex stat_mutex;
 };
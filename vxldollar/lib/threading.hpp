@@ -30,6 +30,7 @@ namespace thread_role
 		wallet_actions,
 		bootstrap_initiator,
 		bootstrap_connections,
+		bootstrap_priority,
 		voting,
 		signature_checking,
 		rpc_request_processor,
@@ -42,6 +43,8 @@ namespace thread_role
 		db_parallel_traversal,
 		election_scheduler,
 		unchecked,
+		traffic_recorder,
+		ledger_backup,
 	};
 
 	/*
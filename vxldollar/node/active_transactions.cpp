@@ -1286,9 +1286,14 @@ vxldollar::inactive_cache_status vxldollar::active_transactions::inactive_votes_
 			lock_a.lock ();
 			insert_impl (lock_a, block);
 		}
-		else if (!block && status.bootstrap_started && !previously_a.bootstrap_started && (!node.ledger.pruning || !node.store.pruned.exists (transaction, hash_a)))
+		else if (!block && (!node.ledger.pruning || !node.store.pruned.exists (transaction, hash_a)))
 		{
-			node.gap_cache.bootstrap_start (hash_a);
+			// Enough vote weight for a block missing from the ledger
+			node.bootstrap_initiator.bootstrap_priority (hash_a);
+			if (status.bootstrap_started && !previously_a.bootstrap_started)
+			{
+				node.gap_cache.bootstrap_start (hash_a);
+			}
 		}
 	}
 
@@ -27,7 +27,8 @@ enum class bootstrap_mode
 {
 	legacy,
 	lazy,
-	wallet_lazy
+	wallet_lazy,
+	priority
 };
 enum class sync_result
 {
@@ -64,6 +65,68 @@ public:
 	constexpr static std::size_t cache_size_max = 10000;
 };
 
+class bootstrap_priority_entry final
+{
+public:
+	vxldollar::hash_or_account key;
+	double priority;
+	std::chrono::steady_clock::time_point next_request;
+	/** Failed or empty pulls since the last successful one */
+	unsigned failures{ 0 };
+};
+
+/**
+ * Accounts and block hashes with unconfirmed activity that is missing from the ledger, scored by how often they were seen.
+ * Scores are raised by gaps in the block processor and by votes for unknown blocks, halved by each pull which received blocks and recovered by failed or empty pulls.
+ * Used by bootstrap_attempt_priority, owned by bootstrap_initiator.
+ */
+class bootstrap_priorities final
+{
+public:
+	explicit bootstrap_priorities (std::chrono::milliseconds const & request_interval_a);
+	/** Adds \p priority_a to the score of \p key_a, inserting it if needed. The lowest scored entry is dropped when full.
+	 * @return true if \p key_a was inserted */
+	bool raise (vxldollar::hash_or_account const & key_a, double priority_a = priority_increase);
+	void erase (vxldollar::hash_or_account const & key_a);
+	/** Picks the highest scored entry which was not requested during the last request_interval
+	 * @return zero if no entry is ready */
+	vxldollar::hash_or_account next (std::chrono::steady_clock::time_point const & now_a = std::chrono::steady_clock::now ());
+	/** Halves the score of \p key_a after a pull which received blocks, removing it below priority_cutoff */
+	void pull_succeeded (vxldollar::hash_or_account const & key_a);
+	/** Adds priority_increase back to the score of \p key_a after a failed or empty pull, removing it after failures_max of them in a row */
+	void pull_failed (vxldollar::hash_or_account const & key_a);
+	/** @return zero if \p key_a has no entry */
+	double priority (vxldollar::hash_or_account const & key_a) const;
+	std::size_t size () const;
+	void clear ();
+	std::chrono::milliseconds const request_interval;
+	static double constexpr priority_increase = 2.0;
+	static double constexpr priority_max = 64.0;
+	static double constexpr priority_cutoff = 1.0;
+	static std::size_t constexpr priorities_max = 256 * 1024;
+	static unsigned constexpr failures_max = 8;
+	/** Entries examined by next () before giving up, entries waiting for request_interval are skipped */
+	static std::size_t constexpr next_scan_max = 64;
+
+private:
+	class tag_key
+	{
+	};
+	class tag_priority
+	{
+	};
+	// clang-format off
+	boost::multi_index_container<vxldollar::bootstrap_priority_entry,
+	mi::indexed_by<
+		mi::hashed_unique<mi::tag<tag_key>,
+			mi::member<vxldollar::bootstrap_priority_entry, vxldollar::hash_or_account, &vxldollar::bootstrap_priority_entry::key>, std::hash<vxldollar::uint256_union>>,
+		mi::ordered_non_unique<mi::tag<tag_priority>,
+			mi::member<vxldollar::bootstrap_priority_entry, double, &vxldollar::bootstrap_priority_entry::priority>, std::greater<double>>>>
+	entries;
+	// clang-format on
+	mutable vxldollar::mutex mutex;
+};
+
 /**
  * Container for bootstrap sessions that are active. Owned by bootstrap_initiator.
  */
@@ -82,7 +145,7 @@ public:
 
 /**
  * Client side portion to initiate bootstrap sessions. Prevents multiple legacy-type bootstrap sessions from being started at the same time. Does permit
- * lazy/wallet bootstrap sessions to overlap with legacy sessions.
+ * lazy/wallet bootstrap sessions to overlap with legacy sessions. The priority session runs on its own thread so that it never holds up the others.
  */
 class bootstrap_initiator final
 {
@@ -93,10 +156,14 @@ public:
 	void bootstrap (bool force = false, std::string id_a = "", uint32_t const frontiers_age_a = std::numeric_limits<uint32_t>::max (), vxldollar::account const & start_account_a = vxldollar::account{});
 	bool bootstrap_lazy (vxldollar::hash_or_account const &, bool force = false, bool confirmed = true, std::string id_a = "");
 	void bootstrap_wallet (std::deque<vxldollar::account> &);
+	/** Raises the priority of \p key_a and starts a priority bootstrap attempt if none is running. Does nothing unless node_flags::enable_priority_bootstrap is set. */
+	void bootstrap_priority (vxldollar::hash_or_account const & key_a, double priority_a = vxldollar::bootstrap_priorities::priority_increase);
 	void run_bootstrap ();
+	void run_priority_bootstrap ();
 	void lazy_requeue (vxldollar::block_hash const &, vxldollar::block_hash const &);
 	void notify_listeners (bool);
 	void add_observer (std::function<void (bool)> const &);
+	/** @return true while a legacy, lazy or wallet attempt is running. The priority attempt runs in the background and is not counted. */
 	bool in_progress ();
 	std::shared_ptr<vxldollar::bootstrap_connections> connections;
 	std::shared_ptr<vxldollar::bootstrap_attempt> new_attempt ();
@@ -105,7 +172,9 @@ public:
 	std::shared_ptr<vxldollar::bootstrap_attempt> current_attempt ();
 	std::shared_ptr<vxldollar::bootstrap_attempt> current_lazy_attempt ();
 	std::shared_ptr<vxldollar::bootstrap_attempt> current_wallet_attempt ();
+	std::shared_ptr<vxldollar::bootstrap_attempt> current_priority_attempt ();
 	vxldollar::pulls_cache cache;
+	vxldollar::bootstrap_priorities priorities;
 	vxldollar::bootstrap_attempts attempts;
 	void stop ();
 
@@ -144,9 +213,12 @@ public:
 	static constexpr unsigned requeued_pulls_processed_blocks_factor = 4096;
 	static constexpr uint64_t pull_count_per_check = 8 * 1024;
 	static constexpr unsigned bulk_push_cost_limit = 200;
+	static constexpr std::size_t bulk_pull_pipeline_depth = 4;
 	static constexpr std::chrono::seconds lazy_flush_delay_sec = std::chrono::seconds (5);
 	static constexpr uint64_t lazy_batch_pull_count_resize_blocks_limit = 4 * 1024 * 1024;
 	static constexpr double lazy_batch_pull_count_resize_ratio = 2.0;
 	static constexpr std::size_t lazy_blocks_restart_limit = 1024 * 1024;
+	static constexpr unsigned priority_pulls_max = 64;
+	static constexpr std::chrono::seconds priority_idle_timeout = std::chrono::seconds (60);
 };
 }
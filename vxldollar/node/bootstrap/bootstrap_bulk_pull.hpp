@@ -3,6 +3,7 @@
 #include <vxldollar/node/common.hpp>
 #include <vxldollar/node/socket.hpp>
 
+#include <deque>
 #include <unordered_set>
 
 namespace vxldollar
@@ -26,6 +27,36 @@ public:
 };
 class bootstrap_client;
 
+/**
+ * Record format of compact bulk_pull responses, requested with bulk_pull::compact_flag from peers at or above network_constants::bootstrap_compact_version_min.
+ * Blocks of a chain mostly repeat the same account and representative. A state block sharing any of them with the previous state block of the same response
+ * is sent as record type state_elided with the elided field bits set, followed by the block without those fields. Every other block is sent as in a plain response.
+ */
+class bulk_pull_compact final
+{
+public:
+	/** Writes \p block_a to \p stream_a, eliding fields equal to those of the last state block written. @return the number of bytes written */
+	std::size_t serialize (vxldollar::stream & stream_a, vxldollar::block const & block_a);
+	/**
+	 * Replaces a record of type \p type_a and \p size_a bytes at the start of \p buffer_a with the plain serialization of the state block
+	 * @return true if the record is malformed or elides fields while no state block was received
+	 */
+	bool expand (uint8_t type_a, std::vector<uint8_t> & buffer_a, std::size_t size_a) const;
+	/** Remembers the fields of a state block, they may be elided from the next records */
+	void update (vxldollar::block const & block_a);
+	static bool is_elided (uint8_t type_a);
+	/** Size of a record of type \p type_a without the type byte */
+	static std::size_t size (uint8_t type_a);
+	static uint8_t constexpr state_elided = 0x80;
+	static uint8_t constexpr account_elided = 0x01;
+	static uint8_t constexpr representative_elided = 0x02;
+
+private:
+	vxldollar::account last_account{ 0 };
+	vxldollar::account last_representative{ 0 };
+	bool last_valid{ false };
+};
+
 /**
  * Client side of a bulk_pull request. Created when the bootstrap_attempt wants to make a bulk_pull request to the remote side.
  */
@@ -39,6 +70,10 @@ public:
 	void throttled_receive_block ();
 	void received_type ();
 	void received_block (boost::system::error_code const &, std::size_t, vxldollar::block_type);
+	/** Receives a state block with elided fields, see bulk_pull_compact */
+	void received_elided (boost::system::error_code const &, std::size_t, uint8_t);
+	/** Hands the connection over to the next pull in flight, see bootstrap_client::pipeline_pop */
+	void finish (bool reuse_a);
 	vxldollar::block_hash first ();
 	std::shared_ptr<vxldollar::bootstrap_client> connection;
 	std::shared_ptr<vxldollar::bootstrap_attempt> attempt;
@@ -48,6 +83,13 @@ public:
 	uint64_t pull_blocks;
 	uint64_t unexpected_count;
 	bool network_error{ false };
+	/** Set when the pull was stopped early on a pipelined connection, the rest of the response is read and discarded */
+	bool draining{ false };
+	/** Fields elided from a compact response */
+	vxldollar::bulk_pull_compact compact;
+
+private:
+	bool finished{ false };
 };
 class bulk_pull_account_client final : public std::enable_shared_from_this<vxldollar::bulk_pull_account_client>
 {
@@ -85,6 +127,22 @@ public:
 	bool include_start;
 	vxldollar::bulk_pull::count_t max_count;
 	vxldollar::bulk_pull::count_t sent_count;
+	/** Blocks read from the store but not yet sent, in sending order */
+	std::deque<std::shared_ptr<vxldollar::block>> read_ahead;
+	/** Set if the request asked for a compact response */
+	bool compact{ false };
+	vxldollar::bulk_pull_compact compact_state;
+	/** Blocks sent and time spent reading and serializing them, reported when the request finishes */
+	uint64_t served_count{ 0 };
+	std::chrono::steady_clock::duration serve_time{ 0 };
+	/** Maximum number of blocks read from the store in a single read transaction */
+	static std::size_t constexpr read_ahead_max = 128;
+	/** Blocks are serialized into one buffer up to this size, so a single socket write carries many blocks */
+	static std::size_t constexpr send_buffer_max = 64 * 1024;
+
+private:
+	void fill_read_ahead ();
+	std::shared_ptr<vxldollar::block> read_next (vxldollar::transaction const &);
 };
 class bulk_pull_account;
 class bulk_pull_account_server final : public std::enable_shared_from_this<vxldollar::bulk_pull_account_server>
@@ -24,6 +24,14 @@ vxldollar::bootstrap_client::bootstrap_client (std::shared_ptr<vxldollar::node>
 	++connections.connections_count;
 	receive_buffer->resize (256);
 	channel->set_endpoint ();
+	// The bootstrap connection carries no version, use the one of the realtime channel to the same peer
+	if (!node->flags.disable_bootstrap_pipelining || !node->flags.disable_bootstrap_compact)
+	{
+		auto realtime (node->network.find_channel (vxldollar::transport::map_tcp_to_endpoint (channel->get_tcp_endpoint ())));
+		auto const version (realtime != nullptr ? realtime->get_network_version () : 0);
+		pipelining = !node->flags.disable_bootstrap_pipelining && version >= node->network_params.network.bootstrap_pipelining_version_min;
+		compact = !node->flags.disable_bootstrap_compact && version >= node->network_params.network.bootstrap_compact_version_min;
+	}
 }
 
 vxldollar::bootstrap_client::~bootstrap_client ()
@@ -50,6 +58,94 @@ double vxldollar::bootstrap_client::elapsed_seconds () const
 	return std::chrono::duration_cast<std::chrono::duration<double>> (std::chrono::steady_clock::now () - start_time_m).count ();
 }
 
+bool vxldollar::bootstrap_client::pipeline_push (std::shared_ptr<vxldollar::bulk_pull_client> const & client_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> lock (pipeline_mutex);
+	pooled = false;
+	auto const front (pipeline.empty ());
+	pipeline.emplace_back (client_a.get (), front ? nullptr : client_a);
+	if (!front)
+	{
+		node->stats.inc (vxldollar::stat::type::bootstrap, vxldollar::stat::detail::bulk_pull_pipelined, vxldollar::stat::dir::out);
+	}
+	return front;
+}
+
+void vxldollar::bootstrap_client::pipeline_sent ()
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (pipeline_mutex);
+	auto const pool_l (pipelining && !pooled && !pipeline.empty () && pipeline.size () < vxldollar::bootstrap_limits::bulk_pull_pipeline_depth);
+	if (pool_l)
+	{
+		pooled = true;
+		lock.unlock ();
+		connections.pool_pipelined (shared_from_this ());
+	}
+}
+
+void vxldollar::bootstrap_client::pipeline_pop (vxldollar::bulk_pull_client const * client_a, bool reuse_a)
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (pipeline_mutex);
+	if (!pipeline.empty () && pipeline.front ().first == client_a)
+	{
+		pipeline.pop_front ();
+		if (reuse_a)
+		{
+			std::shared_ptr<vxldollar::bulk_pull_client> next;
+			if (!pipeline.empty ())
+			{
+				next = std::move (pipeline.front ().second);
+			}
+			auto const pool_l (!pooled && pipeline.size () < (pipelining ? vxldollar::bootstrap_limits::bulk_pull_pipeline_depth : 1));
+			auto const empty (pipeline.empty ());
+			pooled = pooled || pool_l;
+			lock.unlock ();
+			if (next != nullptr)
+			{
+				next->throttled_receive_block ();
+			}
+			if (pool_l && empty)
+			{
+				connections.pool_connection (shared_from_this ());
+			}
+			else if (pool_l)
+			{
+				connections.pool_pipelined (shared_from_this ());
+			}
+		}
+		else
+		{
+			decltype (pipeline) dropped;
+			dropped.swap (pipeline);
+			lock.unlock ();
+			socket->close ();
+			for (auto & i : dropped)
+			{
+				// Not the fault of the dropped pulls, requeue them without counting an attempt
+				if (i.second != nullptr)
+				{
+					i.second->network_error = true;
+				}
+			}
+		}
+	}
+}
+
+void vxldollar::bootstrap_client::pool ()
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (pipeline_mutex);
+	auto const empty (pipeline.empty ());
+	lock.unlock ();
+	if (empty)
+	{
+		connections.pool_connection (shared_from_this ());
+	}
+	else
+	{
+		connections.pool_pipelined (shared_from_this ());
+	}
+}
+
 void vxldollar::bootstrap_client::stop (bool force)
 {
 	pending_stop = true;
@@ -120,6 +216,19 @@ void vxldollar::bootstrap_connections::pool_connection (std::shared_ptr<vxldolla
 	condition.notify_all ();
 }
 
+void vxldollar::bootstrap_connections::pool_pipelined (std::shared_ptr<vxldollar::bootstrap_client> const & client_a)
+{
+	{
+		vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+		// Connections with pulls in flight are not closed here, the pulls finish first
+		if (!stopped && !client_a->pending_stop)
+		{
+			pipelined.push_back (client_a);
+		}
+	}
+	condition.notify_all ();
+}
+
 void vxldollar::bootstrap_connections::add_connection (vxldollar::endpoint const & endpoint_a)
 {
 	connect_client (vxldollar::tcp_endpoint (endpoint_a.address (), endpoint_a.port ()), true);
@@ -334,9 +443,20 @@ void vxldollar::bootstrap_connections::add_pull (vxldollar::pull_info const & pu
 
 void vxldollar::bootstrap_connections::request_pull (vxldollar::unique_lock<vxldollar::mutex> & lock_a)
 {
-	lock_a.unlock ();
-	auto connection_l (connection ());
-	lock_a.lock ();
+	condition.wait (lock_a, [this] () { return stopped || !idle.empty () || !pipelined.empty () || new_connections_empty; });
+	std::shared_ptr<vxldollar::bootstrap_client> connection_l;
+	// Prefer connections which already have pulls in flight, so that the idle ones stay available for other requests
+	if (!stopped && !pipelined.empty ())
+	{
+		connection_l = pipelined.front ();
+		pipelined.pop_front ();
+	}
+	else
+	{
+		lock_a.unlock ();
+		connection_l = connection ();
+		lock_a.lock ();
+	}
 	if (connection_l != nullptr && !pulls.empty ())
 	{
 		std::shared_ptr<vxldollar::bootstrap_attempt> attempt_l;
@@ -368,7 +488,7 @@ void vxldollar::bootstrap_connections::request_pull (vxldollar::unique_lock<vxld
 	{
 		// Reuse connection if pulls deque become empty
 		lock_a.unlock ();
-		pool_connection (connection_l);
+		connection_l->pool ();
 		lock_a.lock ();
 	}
 }
@@ -486,4 +606,5 @@ void vxldollar::bootstrap_connections::stop ()
 	}
 	clients.clear ();
 	idle.clear ();
+	pipelined.clear ();
 }
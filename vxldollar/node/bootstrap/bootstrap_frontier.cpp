@@ -12,13 +12,14 @@ constexpr unsigned vxldollar::bootstrap_limits::bulk_push_cost_limit;
 
 constexpr std::size_t vxldollar::frontier_req_client::size_frontier;
 
-void vxldollar::frontier_req_client::run (vxldollar::account const & start_account_a, uint32_t const frontiers_age_a, uint32_t const count_a)
+void vxldollar::frontier_req_client::run (vxldollar::account const & start_account_a, vxldollar::account const & end_account_a, uint32_t const frontiers_age_a, uint32_t const count_a)
 {
 	vxldollar::frontier_req request{ connection->node->network_params.network };
 	request.start = (start_account_a.is_zero () || start_account_a.number () == std::numeric_limits<vxldollar::uint256_t>::max ()) ? start_account_a : start_account_a.number () + 1;
 	request.age = frontiers_age_a;
 	request.count = count_a;
 	current = start_account_a;
+	end_account = end_account_a;
 	frontiers_age = frontiers_age_a;
 	count_limit = count_a;
 	next (); // Load accounts from disk
@@ -43,7 +44,6 @@ void vxldollar::frontier_req_client::run (vxldollar::account const & start_accou
 vxldollar::frontier_req_client::frontier_req_client (std::shared_ptr<vxldollar::bootstrap_client> const & connection_a, std::shared_ptr<vxldollar::bootstrap_attempt> const & attempt_a) :
 	connection (connection_a),
 	attempt (attempt_a),
-	count (0),
 	bulk_push_cost (0)
 {
 }
@@ -124,7 +124,7 @@ void vxldollar::frontier_req_client::received_frontier (boost::system::error_cod
 		{
 			connection->node->logger.always_log (boost::str (boost::format ("Received %1% frontiers from %2%") % std::to_string (count) % connection->channel->to_string ()));
 		}
-		if (!account.is_zero () && count <= count_limit)
+		if (!account.is_zero () && count <= count_limit && !(end_account < account))
 		{
 			last_account = account;
 			while (!current.is_zero () && current < account)
@@ -180,8 +180,8 @@ void vxldollar::frontier_req_client::received_frontier (boost::system::error_cod
 					unsynced (frontier, 0);
 					next ();
 				}
-				// Prevent new frontier_req requests
-				attempt->set_start_account (std::numeric_limits<vxldollar::uint256_t>::max ());
+				// Prevent new frontier_req requests for this range
+				attempt->set_start_account (end_account);
 				if (connection->node->config.logging.bulk_pull_logging ())
 				{
 					connection->node->logger.try_log ("Bulk push cost: ", bulk_push_cost);
@@ -192,7 +192,15 @@ void vxldollar::frontier_req_client::received_frontier (boost::system::error_cod
 				// Set last processed account as new start target
 				attempt->set_start_account (last_account);
 			}
-			connection->connections.pool_connection (connection);
+			if (account.is_zero ())
+			{
+				connection->connections.pool_connection (connection);
+			}
+			else
+			{
+				// The peer keeps sending frontiers after the end of the range, the connection cannot be reused
+				connection->socket->close ();
+			}
 			try
 			{
 				promise.set_value (false);
@@ -218,7 +226,7 @@ void vxldollar::frontier_req_client::next ()
 	{
 		std::size_t max_size (128);
 		auto transaction (connection->node->store.tx_begin_read ());
-		for (auto i (connection->node->store.account.begin (transaction, current.number () + 1)), n (connection->node->store.account.end ()); i != n && accounts.size () != max_size; ++i)
+		for (auto i (connection->node->store.account.begin (transaction, current.number () + 1)), n (connection->node->store.account.end ()); i != n && accounts.size () != max_size && !(end_account < i->first); ++i)
 		{
 			vxldollar::account_info const & info (i->second);
 			vxldollar::account const & account (i->first);
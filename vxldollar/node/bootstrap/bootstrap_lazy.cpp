@@ -1,9 +1,12 @@
+#include <vxldollar/lib/stream.hpp>
 #include <vxldollar/node/bootstrap/bootstrap.hpp>
 #include <vxldollar/node/bootstrap/bootstrap_lazy.hpp>
 #include <vxldollar/node/common.hpp>
 #include <vxldollar/node/node.hpp>
+#include <vxldollar/node/lmdb/lmdb.hpp>
 #include <vxldollar/node/transport/tcp.hpp>
 
+#include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 
 #include <algorithm>
@@ -13,6 +16,317 @@ constexpr uint64_t vxldollar::bootstrap_limits::lazy_batch_pull_count_resize_blo
 constexpr double vxldollar::bootstrap_limits::lazy_batch_pull_count_resize_ratio;
 constexpr std::size_t vxldollar::bootstrap_limits::lazy_blocks_restart_limit;
 
+namespace
+{
+std::vector<uint8_t> serialize_backlog_item (vxldollar::lazy_state_backlog_item const & item_a)
+{
+	std::vector<uint8_t> result;
+	{
+		vxldollar::vectorstream stream (result);
+		vxldollar::write (stream, item_a.link);
+		vxldollar::write (stream, vxldollar::amount (item_a.balance));
+		vxldollar::write (stream, static_cast<uint32_t> (item_a.retry_limit));
+	}
+	return result;
+}
+
+vxldollar::lazy_state_backlog_item deserialize_backlog_item (vxldollar::mdb_val const & value_a)
+{
+	vxldollar::lazy_state_backlog_item result;
+	vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (value_a.data ()), value_a.size ());
+	vxldollar::amount balance;
+	uint32_t retry_limit (0);
+	vxldollar::read (stream, result.link);
+	vxldollar::read (stream, balance);
+	vxldollar::read (stream, retry_limit);
+	result.balance = balance.number ();
+	result.retry_limit = retry_limit;
+	return result;
+}
+}
+
+vxldollar::lazy_spill_store::lazy_spill_store (boost::filesystem::path const & path_a) :
+	path (path_a)
+{
+	// Leftover from an attempt which did not shut down cleanly
+	boost::system::error_code ec;
+	boost::filesystem::remove (path, ec);
+	boost::filesystem::remove (path.string () + "-lock", ec);
+	// Contents are discarded on exit, so there is no need to sync to disk
+	env = std::make_unique<vxldollar::mdb_env> (error, path, vxldollar::mdb_env::options::make ().override_config_sync (vxldollar::lmdb_config::sync_strategy::nosync_unsafe));
+	if (!error)
+	{
+		auto transaction (env->tx_begin_write ());
+		error |= mdb_dbi_open (tx (transaction), "blocks", MDB_CREATE, &blocks) != 0;
+		error |= mdb_dbi_open (tx (transaction), "undefined_links", MDB_CREATE, &undefined_links) != 0;
+		error |= mdb_dbi_open (tx (transaction), "backlog", MDB_CREATE, &backlog) != 0;
+		error |= mdb_dbi_open (tx (transaction), "balances", MDB_CREATE, &balances) != 0;
+		error |= mdb_dbi_open (tx (transaction), "pulls", MDB_CREATE, &pulls) != 0;
+	}
+}
+
+vxldollar::lazy_spill_store::~lazy_spill_store ()
+{
+	batch.reset ();
+	env.reset ();
+	boost::system::error_code ec;
+	boost::filesystem::remove (path, ec);
+	boost::filesystem::remove (path.string () + "-lock", ec);
+}
+
+MDB_txn * vxldollar::lazy_spill_store::tx (vxldollar::transaction const & transaction_a) const
+{
+	return env->tx (transaction_a);
+}
+
+template <typename Action>
+auto vxldollar::lazy_spill_store::write (Action const & action_a) -> decltype (action_a (std::declval<MDB_txn *> ()))
+{
+	if (batch != nullptr)
+	{
+		return action_a (tx (*batch));
+	}
+	vxldollar::write_transaction transaction (std::make_unique<vxldollar::write_mdb_txn> (*env, vxldollar::mdb_txn_callbacks{}));
+	return action_a (tx (transaction));
+}
+
+template <typename Action>
+auto vxldollar::lazy_spill_store::read (Action const & action_a) const -> decltype (action_a (std::declval<MDB_txn *> ()))
+{
+	// Reads within a batch see its uncommitted writes
+	if (batch != nullptr)
+	{
+		return action_a (tx (*batch));
+	}
+	auto transaction (env->tx_begin_read ());
+	return action_a (tx (transaction));
+}
+
+void vxldollar::lazy_spill_store::batch_begin ()
+{
+	debug_assert (batch == nullptr);
+	batch = std::make_unique<vxldollar::write_transaction> (std::make_unique<vxldollar::write_mdb_txn> (*env, vxldollar::mdb_txn_callbacks{}));
+}
+
+void vxldollar::lazy_spill_store::batch_commit ()
+{
+	debug_assert (batch != nullptr);
+	batch.reset ();
+}
+
+bool vxldollar::lazy_spill_store::batch_active () const
+{
+	return batch != nullptr;
+}
+
+void vxldollar::lazy_spill_store::load (vxldollar::fingerprint_set const & blocks_a, vxldollar::fingerprint_set const & undefined_links_a, std::unordered_map<vxldollar::block_hash, vxldollar::lazy_state_backlog_item> const & backlog_a, std::unordered_map<vxldollar::block_hash, vxldollar::uint128_t> const & balances_a, std::deque<std::pair<vxldollar::hash_or_account, unsigned>> const & pulls_a)
+{
+	write ([&] (MDB_txn * transaction_a) {
+		auto put_fingerprint = [transaction_a] (MDB_dbi table_a) {
+			return [transaction_a, table_a] (uint64_t fingerprint_a) {
+				auto status (mdb_put (transaction_a, table_a, vxldollar::mdb_val (fingerprint_a), vxldollar::mdb_val (nullptr), 0));
+				release_assert (status == MDB_SUCCESS);
+			};
+		};
+		blocks_a.for_each (put_fingerprint (blocks));
+		undefined_links_a.for_each (put_fingerprint (undefined_links));
+		for (auto const & [hash, item] : backlog_a)
+		{
+			auto bytes (serialize_backlog_item (item));
+			auto status (mdb_put (transaction_a, backlog, vxldollar::mdb_val (hash), vxldollar::mdb_val (bytes.size (), bytes.data ()), 0));
+			release_assert (status == MDB_SUCCESS);
+		}
+		backlog_count = backlog_a.size ();
+		for (auto const & [hash, balance] : balances_a)
+		{
+			auto status (mdb_put (transaction_a, balances, vxldollar::mdb_val (hash), vxldollar::mdb_val (vxldollar::uint128_union (balance)), 0));
+			release_assert (status == MDB_SUCCESS);
+		}
+		for (auto const & [pull, retry_limit] : pulls_a)
+		{
+			std::vector<uint8_t> bytes;
+			{
+				vxldollar::vectorstream stream (bytes);
+				vxldollar::write (stream, pull.as_block_hash ());
+				vxldollar::write (stream, static_cast<uint32_t> (retry_limit));
+			}
+			auto status (mdb_put (transaction_a, pulls, vxldollar::mdb_val (pulls_tail++), vxldollar::mdb_val (bytes.size (), bytes.data ()), 0));
+			release_assert (status == MDB_SUCCESS);
+		}
+	});
+}
+
+bool vxldollar::lazy_spill_store::fingerprint_insert (MDB_dbi table_a, uint64_t fingerprint_a)
+{
+	return write ([table_a, fingerprint_a] (MDB_txn * transaction_a) {
+		auto status (mdb_put (transaction_a, table_a, vxldollar::mdb_val (fingerprint_a), vxldollar::mdb_val (nullptr), MDB_NOOVERWRITE));
+		release_assert (status == MDB_SUCCESS || status == MDB_KEYEXIST);
+		return status == MDB_SUCCESS;
+	});
+}
+
+bool vxldollar::lazy_spill_store::fingerprint_erase (MDB_dbi table_a, uint64_t fingerprint_a)
+{
+	return write ([table_a, fingerprint_a] (MDB_txn * transaction_a) {
+		auto status (mdb_del (transaction_a, table_a, vxldollar::mdb_val (fingerprint_a), nullptr));
+		release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+		return status == MDB_SUCCESS;
+	});
+}
+
+bool vxldollar::lazy_spill_store::fingerprint_exists (MDB_dbi table_a, uint64_t fingerprint_a) const
+{
+	return read ([table_a, fingerprint_a] (MDB_txn * transaction_a) {
+		vxldollar::mdb_val junk;
+		auto status (mdb_get (transaction_a, table_a, vxldollar::mdb_val (fingerprint_a), junk));
+		release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+		return status == MDB_SUCCESS;
+	});
+}
+
+void vxldollar::lazy_spill_store::backlog_insert (vxldollar::block_hash const & hash_a, vxldollar::lazy_state_backlog_item const & item_a)
+{
+	auto bytes (serialize_backlog_item (item_a));
+	write ([this, &hash_a, &bytes] (MDB_txn * transaction_a) {
+		auto status (mdb_put (transaction_a, backlog, vxldollar::mdb_val (hash_a), vxldollar::mdb_val (bytes.size (), bytes.data ()), MDB_NOOVERWRITE));
+		release_assert (status == MDB_SUCCESS || status == MDB_KEYEXIST);
+		if (status == MDB_SUCCESS)
+		{
+			++backlog_count;
+		}
+	});
+}
+
+boost::optional<vxldollar::lazy_state_backlog_item> vxldollar::lazy_spill_store::backlog_take (vxldollar::block_hash const & hash_a)
+{
+	return write ([this, &hash_a] (MDB_txn * transaction_a) {
+		boost::optional<vxldollar::lazy_state_backlog_item> result;
+		vxldollar::mdb_val value;
+		auto status (mdb_get (transaction_a, backlog, vxldollar::mdb_val (hash_a), value));
+		release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+		if (status == MDB_SUCCESS)
+		{
+			result = deserialize_backlog_item (value);
+			status = mdb_del (transaction_a, backlog, vxldollar::mdb_val (hash_a), nullptr);
+			release_assert (status == MDB_SUCCESS);
+			--backlog_count;
+		}
+		return result;
+	});
+}
+
+std::vector<std::pair<vxldollar::block_hash, vxldollar::lazy_state_backlog_item>> vxldollar::lazy_spill_store::backlog_read (vxldollar::block_hash const & start_a, std::size_t count_a) const
+{
+	return read ([this, &start_a, count_a] (MDB_txn * transaction_a) {
+		std::vector<std::pair<vxldollar::block_hash, vxldollar::lazy_state_backlog_item>> result;
+		MDB_cursor * cursor (nullptr);
+		auto status (mdb_cursor_open (transaction_a, backlog, &cursor));
+		release_assert (status == MDB_SUCCESS);
+		vxldollar::mdb_val key (start_a);
+		vxldollar::mdb_val value;
+		for (status = mdb_cursor_get (cursor, key, value, MDB_SET_RANGE); status == MDB_SUCCESS && result.size () < count_a; status = mdb_cursor_get (cursor, key, value, MDB_NEXT))
+		{
+			result.emplace_back (static_cast<vxldollar::block_hash> (key), deserialize_backlog_item (value));
+		}
+		release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+		mdb_cursor_close (cursor);
+		return result;
+	});
+}
+
+void vxldollar::lazy_spill_store::backlog_erase (vxldollar::block_hash const & hash_a)
+{
+	write ([this, &hash_a] (MDB_txn * transaction_a) {
+		auto status (mdb_del (transaction_a, backlog, vxldollar::mdb_val (hash_a), nullptr));
+		release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+		if (status == MDB_SUCCESS)
+		{
+			--backlog_count;
+		}
+	});
+}
+
+std::size_t vxldollar::lazy_spill_store::backlog_size () const
+{
+	return backlog_count;
+}
+
+void vxldollar::lazy_spill_store::balance_insert (vxldollar::block_hash const & hash_a, vxldollar::uint128_t const & balance_a)
+{
+	write ([this, &hash_a, &balance_a] (MDB_txn * transaction_a) {
+		auto status (mdb_put (transaction_a, balances, vxldollar::mdb_val (hash_a), vxldollar::mdb_val (vxldollar::uint128_union (balance_a)), MDB_NOOVERWRITE));
+		release_assert (status == MDB_SUCCESS || status == MDB_KEYEXIST);
+	});
+}
+
+boost::optional<vxldollar::uint128_t> vxldollar::lazy_spill_store::balance_take (vxldollar::block_hash const & hash_a)
+{
+	return write ([this, &hash_a] (MDB_txn * transaction_a) {
+		boost::optional<vxldollar::uint128_t> result;
+		vxldollar::mdb_val value;
+		auto status (mdb_get (transaction_a, balances, vxldollar::mdb_val (hash_a), value));
+		release_assert (status == MDB_SUCCESS || status == MDB_NOTFOUND);
+		if (status == MDB_SUCCESS)
+		{
+			result = static_cast<vxldollar::uint128_union> (value).number ();
+			status = mdb_del (transaction_a, balances, vxldollar::mdb_val (hash_a), nullptr);
+			release_assert (status == MDB_SUCCESS);
+		}
+		return result;
+	});
+}
+
+void vxldollar::lazy_spill_store::pulls_push (vxldollar::hash_or_account const & hash_or_account_a, unsigned retry_limit_a)
+{
+	std::vector<uint8_t> bytes;
+	{
+		vxldollar::vectorstream stream (bytes);
+		vxldollar::write (stream, hash_or_account_a.as_block_hash ());
+		vxldollar::write (stream, static_cast<uint32_t> (retry_limit_a));
+	}
+	write ([this, &bytes] (MDB_txn * transaction_a) {
+		auto status (mdb_put (transaction_a, pulls, vxldollar::mdb_val (pulls_tail), vxldollar::mdb_val (bytes.size (), bytes.data ()), 0));
+		release_assert (status == MDB_SUCCESS);
+	});
+	++pulls_tail;
+}
+
+std::pair<vxldollar::hash_or_account, unsigned> vxldollar::lazy_spill_store::pulls_pop ()
+{
+	debug_assert (pulls_head < pulls_tail);
+	vxldollar::block_hash hash;
+	uint32_t retry_limit (0);
+	write ([this, &hash, &retry_limit] (MDB_txn * transaction_a) {
+		vxldollar::mdb_val value;
+		auto status (mdb_get (transaction_a, pulls, vxldollar::mdb_val (pulls_head), value));
+		release_assert (status == MDB_SUCCESS);
+		{
+			vxldollar::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			vxldollar::read (stream, hash);
+			vxldollar::read (stream, retry_limit);
+		}
+		status = mdb_del (transaction_a, pulls, vxldollar::mdb_val (pulls_head), nullptr);
+		release_assert (status == MDB_SUCCESS);
+	});
+	++pulls_head;
+	return { static_cast<vxldollar::hash_or_account const &> (hash), retry_limit };
+}
+
+std::size_t vxldollar::lazy_spill_store::pulls_size () const
+{
+	return static_cast<std::size_t> (pulls_tail - pulls_head);
+}
+
+std::size_t vxldollar::lazy_spill_store::size (MDB_dbi table_a) const
+{
+	return read ([table_a] (MDB_txn * transaction_a) {
+		MDB_stat stats;
+		auto status (mdb_stat (transaction_a, table_a, &stats));
+		release_assert (status == MDB_SUCCESS);
+		return static_cast<std::size_t> (stats.ms_entries);
+	});
+}
+
 vxldollar::bootstrap_attempt_lazy::bootstrap_attempt_lazy (std::shared_ptr<vxldollar::node> const & node_a, uint64_t incremental_id_a, std::string const & id_a) :
 	vxldollar::bootstrap_attempt (node_a, vxldollar::bootstrap_mode::lazy, incremental_id_a, id_a)
 {
@@ -21,7 +335,7 @@ vxldollar::bootstrap_attempt_lazy::bootstrap_attempt_lazy (std::shared_ptr<vxldo
 
 vxldollar::bootstrap_attempt_lazy::~bootstrap_attempt_lazy ()
 {
-	debug_assert (lazy_blocks.size () == lazy_blocks_count);
+	debug_assert ((lazy_spilled != nullptr ? lazy_spilled->size (lazy_spilled->blocks) : lazy_blocks.size ()) == lazy_blocks_count);
 	node->bootstrap_initiator.notify_listeners (false);
 }
 
@@ -34,7 +348,7 @@ bool vxldollar::bootstrap_attempt_lazy::lazy_start (vxldollar::hash_or_account c
 	if (lazy_keys.size () < max_keys && lazy_keys.find (hash_or_account_a.as_block_hash ()) == lazy_keys.end () && !lazy_blocks_processed (hash_or_account_a.as_block_hash ()))
 	{
 		lazy_keys.insert (hash_or_account_a.as_block_hash ());
-		lazy_pulls.emplace_back (hash_or_account_a, confirmed ? lazy_retry_limit_confirmed () : node->network_params.bootstrap.lazy_retry_limit);
+		lazy_pulls_push (hash_or_account_a, confirmed ? lazy_retry_limit_confirmed () : node->network_params.bootstrap.lazy_retry_limit);
 		lock.unlock ();
 		condition.notify_all ();
 		inserted = true;
@@ -48,7 +362,7 @@ void vxldollar::bootstrap_attempt_lazy::lazy_add (vxldollar::hash_or_account con
 	debug_assert (!mutex.try_lock ());
 	if (!lazy_blocks_processed (hash_or_account_a.as_block_hash ()))
 	{
-		lazy_pulls.emplace_back (hash_or_account_a, retry_limit);
+		lazy_pulls_push (hash_or_account_a, retry_limit);
 	}
 }
 
@@ -100,10 +414,9 @@ void vxldollar::bootstrap_attempt_lazy::lazy_pull_flush (vxldollar::unique_lock<
 		uint64_t read_count (0);
 		std::size_t count (0);
 		auto transaction (node->store.tx_begin_read ());
-		while (!lazy_pulls.empty () && count < max_pulls)
+		while (!lazy_pulls_empty () && count < max_pulls)
 		{
-			auto pull_start (lazy_pulls.front ());
-			lazy_pulls.pop_front ();
+			auto pull_start (lazy_pulls_pop ());
 			// Recheck if block was already processed
 			if (!lazy_blocks_processed (pull_start.first.as_block_hash ()) && !node->ledger.block_or_pruned_exists (transaction, pull_start.first.as_block_hash ()))
 			{
@@ -155,7 +468,7 @@ bool vxldollar::bootstrap_attempt_lazy::lazy_finished ()
 		}
 	}
 	// Finish lazy bootstrap without lazy pulls (in combination with still_pulling ())
-	if (!result && lazy_pulls.empty () && lazy_state_backlog.empty ())
+	if (!result && lazy_pulls_empty () && lazy_state_backlog_empty ())
 	{
 		result = true;
 	}
@@ -171,7 +484,8 @@ bool vxldollar::bootstrap_attempt_lazy::lazy_has_expired () const
 	{
 		result = true;
 	}
-	else if (!node->flags.disable_legacy_bootstrap && lazy_blocks_count > vxldollar::bootstrap_limits::lazy_blocks_restart_limit)
+	// Without spilling to disk the attempt restarts before lazy state grows too large
+	else if (!node->flags.disable_legacy_bootstrap && lazy_blocks_count > vxldollar::bootstrap_limits::lazy_blocks_restart_limit && (node->config.bootstrap_lazy_memory_limit == 0 || lazy_spill_failed))
 	{
 		result = true;
 	}
@@ -188,10 +502,9 @@ void vxldollar::bootstrap_attempt_lazy::run ()
 	while ((still_pulling () || !lazy_finished ()) && !lazy_has_expired ())
 	{
 		unsigned iterations (0);
-		auto this_l (shared_from_this ());
 		while (still_pulling () && !lazy_has_expired ())
 		{
-			condition.wait (lock, [&stopped = stopped, &pulling = pulling, &lazy_pulls = lazy_pulls, this_l] { return stopped || pulling == 0 || (pulling < vxldollar::bootstrap_limits::bootstrap_connection_scale_target_blocks && !lazy_pulls.empty ()) || this_l->lazy_has_expired (); });
+			condition.wait (lock, [this] { return stopped || pulling == 0 || (pulling < vxldollar::bootstrap_limits::bootstrap_connection_scale_target_blocks && !lazy_pulls_empty ()) || lazy_has_expired (); });
 			++iterations;
 			// Flushing lazy pulls
 			lazy_pull_flush (lock);
@@ -243,6 +556,11 @@ bool vxldollar::bootstrap_attempt_lazy::process_block_lazy (std::shared_ptr<vxld
 	bool stop_pull (false);
 	auto hash (block_a->hash ());
 	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	if (lazy_spilled != nullptr)
+	{
+		// The lookups and updates for a block share a single spill transaction
+		lazy_spilled->batch_begin ();
+	}
 	// Processing new blocks
 	if (!lazy_blocks_processed (hash))
 	{
@@ -259,18 +577,24 @@ bool vxldollar::bootstrap_attempt_lazy::process_block_lazy (std::shared_ptr<vxld
 		// Adding lazy balances for first processed block in pull
 		if (pull_blocks_processed == 1 && (block_a->type () == vxldollar::block_type::state || block_a->type () == vxldollar::block_type::send))
 		{
-			lazy_balances.emplace (hash, block_a->balance ().number ());
+			lazy_balances_insert (hash, block_a->balance ().number ());
 		}
 		// Clearing lazy balances for previous block
-		if (!block_a->previous ().is_zero () && lazy_balances.find (block_a->previous ()) != lazy_balances.end ())
+		if (!block_a->previous ().is_zero ())
 		{
-			lazy_balances.erase (block_a->previous ());
+			lazy_balances_take (block_a->previous ());
 		}
 		lazy_block_state_backlog_check (block_a, hash);
+		lazy_spill_batch_commit ();
+		lazy_spill_check ();
 		lock.unlock ();
 		vxldollar::unchecked_info info (block_a, known_account_a, vxldollar::signature_verification::unknown);
 		node->block_processor.add (info);
 	}
+	else
+	{
+		lazy_spill_batch_commit ();
+	}
 	// Force drop lazy bootstrap connection for long bulk_pull
 	if (pull_blocks_processed > max_blocks)
 	{
@@ -313,20 +637,19 @@ void vxldollar::bootstrap_attempt_lazy::lazy_block_state (std::shared_ptr<vxldol
 			// Search balance of already processed previous blocks
 			else if (lazy_blocks_processed (previous))
 			{
-				auto previous_balance (lazy_balances.find (previous));
-				if (previous_balance != lazy_balances.end ())
+				auto previous_balance (lazy_balances_take (previous));
+				if (previous_balance)
 				{
-					if (previous_balance->second <= balance)
+					if (*previous_balance <= balance)
 					{
 						lazy_add (link, retry_limit);
 					}
-					lazy_balances.erase (previous_balance);
 				}
 			}
 			// Insert in backlog state blocks if previous wasn't already processed
 			else
 			{
-				lazy_state_backlog.emplace (previous, vxldollar::lazy_state_backlog_item{ link, balance, retry_limit });
+				lazy_state_backlog_insert (previous, vxldollar::lazy_state_backlog_item{ link, balance, retry_limit });
 			}
 		}
 	}
@@ -335,25 +658,22 @@ void vxldollar::bootstrap_attempt_lazy::lazy_block_state (std::shared_ptr<vxldol
 void vxldollar::bootstrap_attempt_lazy::lazy_block_state_backlog_check (std::shared_ptr<vxldollar::block> const & block_a, vxldollar::block_hash const & hash_a)
 {
 	// Search unknown state blocks balances
-	auto find_state (lazy_state_backlog.find (hash_a));
-	if (find_state != lazy_state_backlog.end ())
+	auto next_block (lazy_state_backlog_take (hash_a));
+	if (next_block)
 	{
-		auto next_block (find_state->second);
 		// Retrieve balance for previous state & send blocks
 		if (block_a->type () == vxldollar::block_type::state || block_a->type () == vxldollar::block_type::send)
 		{
-			if (block_a->balance ().number () <= next_block.balance) // balance
+			if (block_a->balance ().number () <= next_block->balance) // balance
 			{
-				lazy_add (next_block.link, next_block.retry_limit); // link
+				lazy_add (next_block->link, next_block->retry_limit); // link
 			}
 		}
 		// Assumption for other legacy block types
-		else if (lazy_undefined_links.find (next_block.link.as_block_hash ()) == lazy_undefined_links.end ())
+		else if (lazy_undefined_links_insert (next_block->link.as_block_hash ()))
 		{
-			lazy_add (next_block.link, node->network_params.bootstrap.lazy_retry_limit); // Head is not confirmed. It can be account or hash or non-existing
-			lazy_undefined_links.insert (next_block.link.as_block_hash ());
+			lazy_add (next_block->link, node->network_params.bootstrap.lazy_retry_limit); // Head is not confirmed. It can be account or hash or non-existing
 		}
-		lazy_state_backlog.erase (find_state);
 	}
 }
 
@@ -361,45 +681,87 @@ void vxldollar::bootstrap_attempt_lazy::lazy_backlog_cleanup ()
 {
 	uint64_t read_count (0);
 	auto transaction (node->store.tx_begin_read ());
-	for (auto it (lazy_state_backlog.begin ()), end (lazy_state_backlog.end ()); it != end && !stopped;)
+	if (lazy_spilled != nullptr)
 	{
-		if (node->ledger.block_or_pruned_exists (transaction, it->first))
+		vxldollar::block_hash start (0);
+		for (auto more (true); more && !stopped;)
 		{
-			auto next_block (it->second);
-			bool error_or_pruned (false);
-			auto balance (node->ledger.balance_safe (transaction, it->first, error_or_pruned));
-			if (!error_or_pruned)
+			// Each batch of entries is read and resolved in a single spill transaction
+			lazy_spilled->batch_begin ();
+			auto entries (lazy_spilled->backlog_read (start, batch_read_size));
+			for (auto const & [hash, item] : entries)
 			{
-				if (balance <= next_block.balance) // balance
+				if (lazy_backlog_resolve (transaction, hash, item))
 				{
-					lazy_add (next_block.link, next_block.retry_limit); // link
+					lazy_spilled->backlog_erase (hash);
 				}
 			}
+			lazy_spilled->batch_commit ();
+			more = entries.size () == batch_read_size && entries.back ().first.number () != std::numeric_limits<vxldollar::uint256_t>::max ();
+			if (more)
+			{
+				start = entries.back ().first.number () + 1;
+			}
+			// We don't want to open read transactions for too long
+			transaction.refresh ();
+		}
+	}
+	else
+	{
+		for (auto it (lazy_state_backlog.begin ()), end (lazy_state_backlog.end ()); it != end && !stopped;)
+		{
+			if (lazy_backlog_resolve (transaction, it->first, it->second))
+			{
+				it = lazy_state_backlog.erase (it);
+			}
 			else
 			{
-				lazy_add (next_block.link, node->network_params.bootstrap.lazy_retry_limit); // Not confirmed
+				++it;
+			}
+			// We don't want to open read transactions for too long
+			++read_count;
+			if (read_count % batch_read_size == 0)
+			{
+				transaction.refresh ();
 			}
-			it = lazy_state_backlog.erase (it);
 		}
-		else
+	}
+	lazy_spill_check ();
+}
+
+bool vxldollar::bootstrap_attempt_lazy::lazy_backlog_resolve (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a, vxldollar::lazy_state_backlog_item const & next_block_a)
+{
+	bool result (false);
+	if (node->ledger.block_or_pruned_exists (transaction_a, hash_a))
+	{
+		bool error_or_pruned (false);
+		auto balance (node->ledger.balance_safe (transaction_a, hash_a, error_or_pruned));
+		if (!error_or_pruned)
 		{
-			lazy_add (it->first, it->second.retry_limit);
-			++it;
+			if (balance <= next_block_a.balance) // balance
+			{
+				lazy_add (next_block_a.link, next_block_a.retry_limit); // link
+			}
 		}
-		// We don't want to open read transactions for too long
-		++read_count;
-		if (read_count % batch_read_size == 0)
+		else
 		{
-			transaction.refresh ();
+			lazy_add (next_block_a.link, node->network_params.bootstrap.lazy_retry_limit); // Not confirmed
 		}
+		result = true;
+	}
+	else
+	{
+		lazy_add (hash_a, next_block_a.retry_limit);
 	}
+	return result;
 }
 
 void vxldollar::bootstrap_attempt_lazy::lazy_blocks_insert (vxldollar::block_hash const & hash_a)
 {
 	debug_assert (!mutex.try_lock ());
-	auto inserted (lazy_blocks.insert (std::hash<::vxldollar::block_hash> () (hash_a)));
-	if (inserted.second)
+	auto fingerprint (std::hash<::vxldollar::block_hash> () (hash_a));
+	auto inserted (lazy_spilled != nullptr ? lazy_spilled->fingerprint_insert (lazy_spilled->blocks, fingerprint) : lazy_blocks.insert (fingerprint));
+	if (inserted)
 	{
 		++lazy_blocks_count;
 		debug_assert (lazy_blocks_count > 0);
@@ -409,7 +771,8 @@ void vxldollar::bootstrap_attempt_lazy::lazy_blocks_insert (vxldollar::block_has
 void vxldollar::bootstrap_attempt_lazy::lazy_blocks_erase (vxldollar::block_hash const & hash_a)
 {
 	debug_assert (!mutex.try_lock ());
-	auto erased (lazy_blocks.erase (std::hash<::vxldollar::block_hash> () (hash_a)));
+	auto fingerprint (std::hash<::vxldollar::block_hash> () (hash_a));
+	auto erased (lazy_spilled != nullptr ? lazy_spilled->fingerprint_erase (lazy_spilled->blocks, fingerprint) : lazy_blocks.erase (fingerprint));
 	if (erased)
 	{
 		--lazy_blocks_count;
@@ -419,7 +782,174 @@ void vxldollar::bootstrap_attempt_lazy::lazy_blocks_erase (vxldollar::block_hash
 
 bool vxldollar::bootstrap_attempt_lazy::lazy_blocks_processed (vxldollar::block_hash const & hash_a)
 {
-	return lazy_blocks.find (std::hash<::vxldollar::block_hash> () (hash_a)) != lazy_blocks.end ();
+	auto fingerprint (std::hash<::vxldollar::block_hash> () (hash_a));
+	return lazy_spilled != nullptr ? lazy_spilled->fingerprint_exists (lazy_spilled->blocks, fingerprint) : lazy_blocks.contains (fingerprint);
+}
+
+void vxldollar::bootstrap_attempt_lazy::lazy_state_backlog_insert (vxldollar::block_hash const & hash_a, vxldollar::lazy_state_backlog_item const & item_a)
+{
+	debug_assert (!mutex.try_lock ());
+	if (lazy_spilled != nullptr)
+	{
+		lazy_spilled->backlog_insert (hash_a, item_a);
+	}
+	else
+	{
+		lazy_state_backlog.emplace (hash_a, item_a);
+	}
+}
+
+boost::optional<vxldollar::lazy_state_backlog_item> vxldollar::bootstrap_attempt_lazy::lazy_state_backlog_take (vxldollar::block_hash const & hash_a)
+{
+	debug_assert (!mutex.try_lock ());
+	boost::optional<vxldollar::lazy_state_backlog_item> result;
+	if (lazy_spilled != nullptr)
+	{
+		result = lazy_spilled->backlog_take (hash_a);
+	}
+	else
+	{
+		auto existing (lazy_state_backlog.find (hash_a));
+		if (existing != lazy_state_backlog.end ())
+		{
+			result = existing->second;
+			lazy_state_backlog.erase (existing);
+		}
+	}
+	return result;
+}
+
+bool vxldollar::bootstrap_attempt_lazy::lazy_state_backlog_empty () const
+{
+	return lazy_spilled != nullptr ? lazy_spilled->backlog_size () == 0 : lazy_state_backlog.empty ();
+}
+
+void vxldollar::bootstrap_attempt_lazy::lazy_balances_insert (vxldollar::block_hash const & hash_a, vxldollar::uint128_t const & balance_a)
+{
+	debug_assert (!mutex.try_lock ());
+	if (lazy_spilled != nullptr)
+	{
+		lazy_spilled->balance_insert (hash_a, balance_a);
+	}
+	else
+	{
+		lazy_balances.emplace (hash_a, balance_a);
+	}
+}
+
+boost::optional<vxldollar::uint128_t> vxldollar::bootstrap_attempt_lazy::lazy_balances_take (vxldollar::block_hash const & hash_a)
+{
+	debug_assert (!mutex.try_lock ());
+	boost::optional<vxldollar::uint128_t> result;
+	if (lazy_spilled != nullptr)
+	{
+		result = lazy_spilled->balance_take (hash_a);
+	}
+	else
+	{
+		auto existing (lazy_balances.find (hash_a));
+		if (existing != lazy_balances.end ())
+		{
+			result = existing->second;
+			lazy_balances.erase (existing);
+		}
+	}
+	return result;
+}
+
+bool vxldollar::bootstrap_attempt_lazy::lazy_undefined_links_insert (vxldollar::block_hash const & hash_a)
+{
+	debug_assert (!mutex.try_lock ());
+	auto fingerprint (std::hash<::vxldollar::block_hash> () (hash_a));
+	return lazy_spilled != nullptr ? lazy_spilled->fingerprint_insert (lazy_spilled->undefined_links, fingerprint) : lazy_undefined_links.insert (fingerprint);
+}
+
+void vxldollar::bootstrap_attempt_lazy::lazy_pulls_push (vxldollar::hash_or_account const & hash_or_account_a, unsigned retry_limit_a)
+{
+	debug_assert (!mutex.try_lock ());
+	if (lazy_spilled != nullptr)
+	{
+		lazy_spilled->pulls_push (hash_or_account_a, retry_limit_a);
+	}
+	else
+	{
+		lazy_pulls.emplace_back (hash_or_account_a, retry_limit_a);
+	}
+}
+
+std::pair<vxldollar::hash_or_account, unsigned> vxldollar::bootstrap_attempt_lazy::lazy_pulls_pop ()
+{
+	debug_assert (!mutex.try_lock ());
+	debug_assert (!lazy_pulls_empty ());
+	if (lazy_spilled != nullptr)
+	{
+		return lazy_spilled->pulls_pop ();
+	}
+	auto result (lazy_pulls.front ());
+	lazy_pulls.pop_front ();
+	return result;
+}
+
+bool vxldollar::bootstrap_attempt_lazy::lazy_pulls_empty () const
+{
+	return lazy_spilled != nullptr ? lazy_spilled->pulls_size () == 0 : lazy_pulls.empty ();
+}
+
+std::size_t vxldollar::bootstrap_attempt_lazy::lazy_memory_size () const
+{
+	// Node based containers hold the element and about two pointers per entry
+	auto constexpr node_overhead (2 * sizeof (void *));
+	std::size_t result (lazy_blocks.memory_size () + lazy_undefined_links.memory_size ());
+	result += lazy_state_backlog.size () * (sizeof (decltype (lazy_state_backlog)::value_type) + node_overhead);
+	result += lazy_balances.size () * (sizeof (decltype (lazy_balances)::value_type) + node_overhead);
+	result += lazy_pulls.size () * sizeof (decltype (lazy_pulls)::value_type);
+	result += lazy_keys.size () * (sizeof (decltype (lazy_keys)::value_type) + node_overhead);
+	return result;
+}
+
+void vxldollar::bootstrap_attempt_lazy::lazy_spill_batch_commit ()
+{
+	if (lazy_spilled != nullptr && lazy_spilled->batch_active ())
+	{
+		lazy_spilled->batch_commit ();
+	}
+}
+
+void vxldollar::bootstrap_attempt_lazy::lazy_spill_check ()
+{
+	debug_assert (!mutex.try_lock ());
+	auto limit (node->config.bootstrap_lazy_memory_limit);
+	if (limit != 0 && lazy_spilled == nullptr && !lazy_spill_failed && lazy_memory_size () > limit)
+	{
+		lazy_spill ();
+	}
+}
+
+void vxldollar::bootstrap_attempt_lazy::lazy_spill ()
+{
+	debug_assert (!mutex.try_lock ());
+	if (lazy_spilled == nullptr && !lazy_spill_failed)
+	{
+		auto path (node->application_path / boost::str (boost::format ("lazy_bootstrap_%1%.ldb") % incremental_id));
+		auto store (std::make_unique<vxldollar::lazy_spill_store> (path));
+		if (!store->error)
+		{
+			node->logger.try_log (boost::str (boost::format ("Lazy bootstrap attempt ID %1% uses %2% bytes of memory, moving its state to %3%") % id % lazy_memory_size () % path.string ()));
+			store->load (lazy_blocks, lazy_undefined_links, lazy_state_backlog, lazy_balances, lazy_pulls);
+			lazy_spilled = std::move (store);
+			// Release memory, clear () keeps hash table buckets
+			lazy_blocks.clear ();
+			lazy_undefined_links.clear ();
+			decltype (lazy_state_backlog) {}.swap (lazy_state_backlog);
+			decltype (lazy_balances) {}.swap (lazy_balances);
+			decltype (lazy_pulls) {}.swap (lazy_pulls);
+		}
+		else
+		{
+			node->logger.always_log (boost::str (boost::format ("Lazy bootstrap attempt ID %1% could not open %2%, keeping its state in memory") % id % path.string ()));
+			lazy_spill_failed = true;
+		}
+	}
 }
 
 bool vxldollar::bootstrap_attempt_lazy::lazy_processed_or_exists (vxldollar::block_hash const & hash_a)
@@ -456,12 +986,25 @@ unsigned vxldollar::bootstrap_attempt_lazy::lazy_retry_limit_confirmed ()
 void vxldollar::bootstrap_attempt_lazy::get_information (boost::property_tree::ptree & tree_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	tree_a.put ("lazy_blocks", std::to_string (lazy_blocks.size ()));
-	tree_a.put ("lazy_state_backlog", std::to_string (lazy_state_backlog.size ()));
-	tree_a.put ("lazy_balances", std::to_string (lazy_balances.size ()));
-	tree_a.put ("lazy_undefined_links", std::to_string (lazy_undefined_links.size ()));
-	tree_a.put ("lazy_pulls", std::to_string (lazy_pulls.size ()));
+	if (lazy_spilled != nullptr)
+	{
+		tree_a.put ("lazy_blocks", std::to_string (lazy_spilled->size (lazy_spilled->blocks)));
+		tree_a.put ("lazy_state_backlog", std::to_string (lazy_spilled->backlog_size ()));
+		tree_a.put ("lazy_balances", std::to_string (lazy_spilled->size (lazy_spilled->balances)));
+		tree_a.put ("lazy_undefined_links", std::to_string (lazy_spilled->size (lazy_spilled->undefined_links)));
+		tree_a.put ("lazy_pulls", std::to_string (lazy_spilled->pulls_size ()));
+	}
+	else
+	{
+		tree_a.put ("lazy_blocks", std::to_string (lazy_blocks.size ()));
+		tree_a.put ("lazy_state_backlog", std::to_string (lazy_state_backlog.size ()));
+		tree_a.put ("lazy_balances", std::to_string (lazy_balances.size ()));
+		tree_a.put ("lazy_undefined_links", std::to_string (lazy_undefined_links.size ()));
+		tree_a.put ("lazy_pulls", std::to_string (lazy_pulls.size ()));
+	}
 	tree_a.put ("lazy_keys", std::to_string (lazy_keys.size ()));
+	tree_a.put ("lazy_memory", std::to_string (lazy_memory_size ()));
+	tree_a.put ("lazy_spilled", lazy_spilled != nullptr);
 	if (!lazy_keys.empty ())
 	{
 		tree_a.put ("lazy_key_1", (*(lazy_keys.begin ())).to_string ());
@@ -1,15 +1,19 @@
 #pragma once
 
+#include <vxldollar/lib/fingerprint_set.hpp>
 #include <vxldollar/node/bootstrap/bootstrap_attempt.hpp>
+#include <vxldollar/node/lmdb/lmdb_env.hpp>
 
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index_container.hpp>
+#include <boost/optional.hpp>
 
 #include <atomic>
 #include <queue>
 #include <unordered_set>
+#include <utility>
 
 namespace mi = boost::multi_index;
 
@@ -24,6 +28,65 @@ public:
 	unsigned retry_limit{ 0 };
 };
 
+/**
+ * Temporary LMDB environment holding the state of a lazy bootstrap attempt which exceeded node_config::bootstrap_lazy_memory_limit
+ * Operations between batch_begin () and batch_commit () share one write transaction, others run in their own. Callers serialize access
+ * with the attempt mutex and keep it held for the whole batch, as LMDB write transactions cannot change threads. The file is removed on destruction.
+ */
+class lazy_spill_store final
+{
+public:
+	explicit lazy_spill_store (boost::filesystem::path const &);
+	~lazy_spill_store ();
+	/** Moves in-memory state to the store in a single transaction */
+	void load (vxldollar::fingerprint_set const &, vxldollar::fingerprint_set const &, std::unordered_map<vxldollar::block_hash, vxldollar::lazy_state_backlog_item> const &, std::unordered_map<vxldollar::block_hash, vxldollar::uint128_t> const &, std::deque<std::pair<vxldollar::hash_or_account, unsigned>> const &);
+	/** @return true if \p fingerprint_a was not in table \p table_a */
+	bool fingerprint_insert (MDB_dbi table_a, uint64_t fingerprint_a);
+	/** @return true if \p fingerprint_a was in table \p table_a */
+	bool fingerprint_erase (MDB_dbi table_a, uint64_t fingerprint_a);
+	bool fingerprint_exists (MDB_dbi table_a, uint64_t fingerprint_a) const;
+	/** Inserts the entry unless \p hash_a already has one */
+	void backlog_insert (vxldollar::block_hash const & hash_a, vxldollar::lazy_state_backlog_item const &);
+	boost::optional<vxldollar::lazy_state_backlog_item> backlog_take (vxldollar::block_hash const & hash_a);
+	/** Reads up to \p count_a backlog entries, starting from \p start_a */
+	std::vector<std::pair<vxldollar::block_hash, vxldollar::lazy_state_backlog_item>> backlog_read (vxldollar::block_hash const & start_a, std::size_t count_a) const;
+	void backlog_erase (vxldollar::block_hash const & hash_a);
+	/** Counted in memory, so that checking for an empty backlog does not read the store */
+	std::size_t backlog_size () const;
+	/** Inserts the balance unless \p hash_a already has one */
+	void balance_insert (vxldollar::block_hash const & hash_a, vxldollar::uint128_t const & balance_a);
+	boost::optional<vxldollar::uint128_t> balance_take (vxldollar::block_hash const & hash_a);
+	void pulls_push (vxldollar::hash_or_account const &, unsigned);
+	std::pair<vxldollar::hash_or_account, unsigned> pulls_pop ();
+	std::size_t pulls_size () const;
+	std::size_t size (MDB_dbi table_a) const;
+	void batch_begin ();
+	void batch_commit ();
+	bool batch_active () const;
+	bool error{ false };
+	MDB_dbi blocks{ 0 };
+	MDB_dbi undefined_links{ 0 };
+	MDB_dbi backlog{ 0 };
+	MDB_dbi balances{ 0 };
+	/** FIFO of lazy pulls, keyed by a sequence number from pulls_head to pulls_tail */
+	MDB_dbi pulls{ 0 };
+
+private:
+	MDB_txn * tx (vxldollar::transaction const &) const;
+	/** Runs \p action_a in the open batch, otherwise in a write transaction of its own */
+	template <typename Action>
+	auto write (Action const & action_a) -> decltype (action_a (std::declval<MDB_txn *> ()));
+	/** Runs \p action_a in the open batch, otherwise in a read transaction */
+	template <typename Action>
+	auto read (Action const & action_a) const -> decltype (action_a (std::declval<MDB_txn *> ()));
+	boost::filesystem::path const path;
+	std::unique_ptr<vxldollar::mdb_env> env;
+	std::unique_ptr<vxldollar::write_transaction> batch;
+	uint64_t pulls_head{ 0 };
+	uint64_t pulls_tail{ 0 };
+	std::size_t backlog_count{ 0 };
+};
+
 /**
  * Lazy bootstrap session. Started with a block hash, this will "trace down" the blocks obtained to find a connection to the ledger.
  * This attempts to quickly bootstrap a section of the ledger given a hash that's known to be confirmed.
@@ -47,18 +110,41 @@ public:
 	void lazy_block_state (std::shared_ptr<vxldollar::block> const &, unsigned);
 	void lazy_block_state_backlog_check (std::shared_ptr<vxldollar::block> const &, vxldollar::block_hash const &);
 	void lazy_backlog_cleanup ();
+	/** @return true if the dependency of backlog entry \p hash_a was resolved, so that the entry can be removed */
+	bool lazy_backlog_resolve (vxldollar::transaction const &, vxldollar::block_hash const & hash_a, vxldollar::lazy_state_backlog_item const &);
 	void lazy_blocks_insert (vxldollar::block_hash const &);
 	void lazy_blocks_erase (vxldollar::block_hash const &);
 	bool lazy_blocks_processed (vxldollar::block_hash const &);
+	void lazy_state_backlog_insert (vxldollar::block_hash const &, vxldollar::lazy_state_backlog_item const &);
+	boost::optional<vxldollar::lazy_state_backlog_item> lazy_state_backlog_take (vxldollar::block_hash const &);
+	bool lazy_state_backlog_empty () const;
+	void lazy_balances_insert (vxldollar::block_hash const &, vxldollar::uint128_t const &);
+	boost::optional<vxldollar::uint128_t> lazy_balances_take (vxldollar::block_hash const &);
+	/** @return true if the link was not seen before */
+	bool lazy_undefined_links_insert (vxldollar::block_hash const &);
+	void lazy_pulls_push (vxldollar::hash_or_account const &, unsigned);
+	std::pair<vxldollar::hash_or_account, unsigned> lazy_pulls_pop ();
+	bool lazy_pulls_empty () const;
+	/** Estimated memory used by lazy state */
+	std::size_t lazy_memory_size () const;
+	/** Moves lazy state to a lazy_spill_store once lazy_memory_size () exceeds node_config::bootstrap_lazy_memory_limit */
+	void lazy_spill_check ();
+	/** Commits the spill batch of the current block, if any */
+	void lazy_spill_batch_commit ();
+	void lazy_spill ();
 	bool lazy_processed_or_exists (vxldollar::block_hash const &) override;
 	unsigned lazy_retry_limit_confirmed ();
 	void get_information (boost::property_tree::ptree &) override;
-	std::unordered_set<std::size_t> lazy_blocks;
+	/** Fingerprints of processed blocks, std::hash<vxldollar::block_hash> */
+	vxldollar::fingerprint_set lazy_blocks;
 	std::unordered_map<vxldollar::block_hash, vxldollar::lazy_state_backlog_item> lazy_state_backlog;
-	std::unordered_set<vxldollar::block_hash> lazy_undefined_links;
+	vxldollar::fingerprint_set lazy_undefined_links;
 	std::unordered_map<vxldollar::block_hash, vxldollar::uint128_t> lazy_balances;
 	std::unordered_set<vxldollar::block_hash> lazy_keys;
 	std::deque<std::pair<vxldollar::hash_or_account, unsigned>> lazy_pulls;
+	/** Replaces lazy_blocks, lazy_state_backlog, lazy_undefined_links, lazy_balances and lazy_pulls once set */
+	std::unique_ptr<vxldollar::lazy_spill_store> lazy_spilled;
+	bool lazy_spill_failed{ false };
 	std::chrono::steady_clock::time_point lazy_start_time;
 	std::atomic<std::size_t> lazy_blocks_count{ 0 };
 	std::size_t peer_count{ 0 };
@@ -4,12 +4,46 @@
 #include <vxldollar/node/node.hpp>
 
 #include <boost/format.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+
+vxldollar::frontier_range::frontier_range (vxldollar::account const & start_a, vxldollar::account const & end_a) :
+	begin (start_a),
+	start (start_a),
+	end (end_a)
+{
+}
+
+bool vxldollar::frontier_range::complete () const
+{
+	return start == end;
+}
+
+double vxldollar::frontier_range::progress () const
+{
+	auto result (100.0);
+	if (end != begin)
+	{
+		result = static_cast<double> (start.number () - begin.number ()) * 100.0 / static_cast<double> (end.number () - begin.number ());
+	}
+	return result;
+}
 
 vxldollar::bootstrap_attempt_legacy::bootstrap_attempt_legacy (std::shared_ptr<vxldollar::node> const & node_a, uint64_t const incremental_id_a, std::string const & id_a, uint32_t const frontiers_age_a, vxldollar::account const & start_account_a) :
 	vxldollar::bootstrap_attempt (node_a, vxldollar::bootstrap_mode::legacy, incremental_id_a, id_a),
-	frontiers_age (frontiers_age_a),
-	start_account (start_account_a)
+	start_account (start_account_a),
+	frontiers_age (frontiers_age_a)
 {
+	// Account numbers are uniformly distributed, equal ranges hold about the same number of accounts
+	vxldollar::uint256_t const max (std::numeric_limits<vxldollar::uint256_t>::max ());
+	auto const ranges ((max - start_account.number ()) > node->config.bootstrap_frontier_ranges ? std::max (1u, node->config.bootstrap_frontier_ranges) : 1u);
+	vxldollar::uint256_t const width ((max - start_account.number ()) / ranges);
+	for (auto i (0u); i < ranges; ++i)
+	{
+		vxldollar::uint256_t const begin (start_account.number () + width * i);
+		frontier_ranges.emplace_back (begin, i + 1 < ranges ? begin + width : max);
+	}
 	node->bootstrap_initiator.notify_listeners (true);
 }
 
@@ -34,14 +68,17 @@ void vxldollar::bootstrap_attempt_legacy::stop ()
 	lock.unlock ();
 	condition.notify_all ();
 	lock.lock ();
-	if (auto i = frontiers.lock ())
+	for (auto & range : frontier_ranges)
 	{
-		try
-		{
-			i->promise.set_value (true);
-		}
-		catch (std::future_error &)
+		if (auto i = range.client.lock ())
 		{
+			try
+			{
+				i->promise.set_value (true);
+			}
+			catch (std::future_error &)
+			{
+			}
 		}
 	}
 	if (auto i = push.lock ())
@@ -95,6 +132,13 @@ void vxldollar::bootstrap_attempt_legacy::add_frontier (vxldollar::pull_info con
 	{
 		vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
 		frontier_pulls.push_back (pull_a);
+		// Frontiers arrive in account order, a failed request for this range resumes after the last pull
+		auto account (pull_a.account_or_head.as_account ());
+		auto range (std::find_if (frontier_ranges.begin (), frontier_ranges.end (), [&account] (vxldollar::frontier_range const & range_a) { return !(range_a.end < account); }));
+		if (range != frontier_ranges.end () && range->start < account)
+		{
+			range->start = account;
+		}
 	}
 }
 
@@ -118,84 +162,123 @@ bool vxldollar::bootstrap_attempt_legacy::request_bulk_push_target (std::pair<vx
 
 void vxldollar::bootstrap_attempt_legacy::set_start_account (vxldollar::account const & start_account_a)
 {
-	// Add last account fron frontier request
+	// Add last account from frontier request, in the range it belongs to
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	start_account = start_account_a;
+	auto range (std::find_if (frontier_ranges.begin (), frontier_ranges.end (), [&start_account_a] (vxldollar::frontier_range const & range_a) { return !(range_a.end < start_account_a); }));
+	if (range != frontier_ranges.end () && range->start < start_account_a)
+	{
+		range->start = start_account_a;
+	}
 }
 
-bool vxldollar::bootstrap_attempt_legacy::request_frontier (vxldollar::unique_lock<vxldollar::mutex> & lock_a, bool first_attempt)
+void vxldollar::bootstrap_attempt_legacy::request_frontier (vxldollar::unique_lock<vxldollar::mutex> & lock_a, vxldollar::frontier_range & range_a, bool first_attempt)
 {
-	auto result (true);
 	lock_a.unlock ();
 	auto connection_l (node->bootstrap_initiator.connections->connection (shared_from_this (), first_attempt));
 	lock_a.lock ();
 	if (connection_l && !stopped)
 	{
 		endpoint_frontier_request = connection_l->channel->get_tcp_endpoint ();
-		std::future<bool> future;
-		{
-			auto this_l (shared_from_this ());
-			auto client (std::make_shared<vxldollar::frontier_req_client> (connection_l, this_l));
-			client->run (start_account, frontiers_age, node->config.bootstrap_frontier_request_count);
-			frontiers = client;
-			future = client->promise.get_future ();
-		}
+		range_a.endpoint = endpoint_frontier_request;
+		++range_a.requests;
+		auto this_l (shared_from_this ());
+		auto client (std::make_shared<vxldollar::frontier_req_client> (connection_l, this_l));
+		range_a.client = client;
+		range_a.future = client->promise.get_future ();
+		auto const start (range_a.start);
+		auto const end (range_a.end);
 		lock_a.unlock ();
-		result = consume_future (future); // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
+		// When the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception
+		client->run (start, end, frontiers_age, node->config.bootstrap_frontier_request_count);
 		lock_a.lock ();
-		if (result)
+	}
+}
+
+bool vxldollar::bootstrap_attempt_legacy::frontier_finished (vxldollar::unique_lock<vxldollar::mutex> & lock_a, vxldollar::frontier_range & range_a)
+{
+	debug_assert (range_a.future.valid ());
+	range_a.client.reset ();
+	auto future (std::move (range_a.future));
+	lock_a.unlock ();
+	auto result (consume_future (future));
+	lock_a.lock ();
+	if (node->config.logging.network_logging ())
+	{
+		if (!result)
 		{
-			frontier_pulls.clear ();
+			node->logger.try_log (boost::str (boost::format ("Completed frontier request up to %1%, %2% out of sync accounts so far according to %3%") % range_a.start.to_account () % (account_count + frontier_pulls.size ()) % range_a.endpoint));
 		}
 		else
 		{
-			account_count = vxldollar::narrow_cast<unsigned int> (frontier_pulls.size ());
-			// Shuffle pulls
-			release_assert (std::numeric_limits<CryptoPP::word32>::max () > frontier_pulls.size ());
-			if (!frontier_pulls.empty ())
-			{
-				for (auto i = static_cast<CryptoPP::word32> (frontier_pulls.size () - 1); i > 0; --i)
-				{
-					auto k = vxldollar::random_pool::generate_word32 (0, i);
-					std::swap (frontier_pulls[i], frontier_pulls[k]);
-				}
-			}
-			// Add to regular pulls
-			while (!frontier_pulls.empty ())
-			{
-				auto pull (frontier_pulls.front ());
-				lock_a.unlock ();
-				node->bootstrap_initiator.connections->add_pull (pull);
-				lock_a.lock ();
-				++pulling;
-				frontier_pulls.pop_front ();
-			}
+			node->stats.inc (vxldollar::stat::type::error, vxldollar::stat::detail::frontier_req, vxldollar::stat::dir::out);
 		}
-		if (node->config.logging.network_logging ())
+	}
+	return result;
+}
+
+void vxldollar::bootstrap_attempt_legacy::flush_frontier_pulls (vxldollar::unique_lock<vxldollar::mutex> & lock_a)
+{
+	account_count += vxldollar::narrow_cast<unsigned int> (frontier_pulls.size ());
+	// Shuffle pulls
+	release_assert (std::numeric_limits<CryptoPP::word32>::max () > frontier_pulls.size ());
+	if (!frontier_pulls.empty ())
+	{
+		for (auto i = static_cast<CryptoPP::word32> (frontier_pulls.size () - 1); i > 0; --i)
 		{
-			if (!result)
-			{
-				node->logger.try_log (boost::str (boost::format ("Completed frontier request, %1% out of sync accounts according to %2%") % account_count % connection_l->channel->to_string ()));
-			}
-			else
-			{
-				node->stats.inc (vxldollar::stat::type::error, vxldollar::stat::detail::frontier_req, vxldollar::stat::dir::out);
-			}
+			auto k = vxldollar::random_pool::generate_word32 (0, i);
+			std::swap (frontier_pulls[i], frontier_pulls[k]);
 		}
 	}
-	return result;
+	// Add to regular pulls
+	while (!frontier_pulls.empty ())
+	{
+		auto pull (frontier_pulls.front ());
+		frontier_pulls.pop_front ();
+		lock_a.unlock ();
+		node->bootstrap_initiator.connections->add_pull (pull);
+		lock_a.lock ();
+		++pulling;
+	}
 }
 
 void vxldollar::bootstrap_attempt_legacy::run_start (vxldollar::unique_lock<vxldollar::mutex> & lock_a)
 {
 	frontiers_received = false;
-	auto frontier_failure (true);
 	uint64_t frontier_attempts (0);
-	while (!stopped && frontier_failure)
+	// Ranges stopped by bootstrap_frontier_request_count continue in the next round, once their pulls are done
+	std::vector<bool> finished (frontier_ranges.size (), false);
+	auto pending ([&ranges = frontier_ranges, &finished] () {
+		auto result (false);
+		for (std::size_t i (0); i < ranges.size () && !result; ++i)
+		{
+			result = ranges[i].future.valid () || (!ranges[i].complete () && !finished[i]);
+		}
+		return result;
+	});
+	while (!stopped && pending ())
 	{
-		++frontier_attempts;
-		frontier_failure = request_frontier (lock_a, frontier_attempts == 1);
+		for (std::size_t i (0); i < frontier_ranges.size () && !stopped; ++i)
+		{
+			auto & range (frontier_ranges[i]);
+			if (!range.complete () && !finished[i] && !range.future.valid ())
+			{
+				++frontier_attempts;
+				request_frontier (lock_a, range, frontier_attempts == 1);
+			}
+		}
+		condition.wait_for (lock_a, std::chrono::milliseconds (100));
+		for (std::size_t i (0); i < frontier_ranges.size (); ++i)
+		{
+			auto & range (frontier_ranges[i]);
+			if (range.future.valid () && range.future.wait_for (std::chrono::seconds (0)) == std::future_status::ready)
+			{
+				finished[i] = !frontier_finished (lock_a, range);
+			}
+		}
+		// Pulls start while frontiers of other ranges are still streaming in
+		flush_frontier_pulls (lock_a);
 	}
+	flush_frontier_pulls (lock_a);
 	frontiers_received = true;
 }
 
@@ -218,9 +301,10 @@ void vxldollar::bootstrap_attempt_legacy::run ()
 		lock.unlock ();
 		node->block_processor.flush ();
 		lock.lock ();
-		if (start_account.number () != std::numeric_limits<vxldollar::uint256_t>::max ())
+		auto incomplete (std::find_if (frontier_ranges.begin (), frontier_ranges.end (), [] (vxldollar::frontier_range const & range_a) { return !range_a.complete (); }));
+		if (incomplete != frontier_ranges.end ())
 		{
-			node->logger.try_log (boost::str (boost::format ("Finished flushing unchecked blocks, requesting new frontiers after %1%") % start_account.to_account ()));
+			node->logger.try_log (boost::str (boost::format ("Finished flushing unchecked blocks, requesting new frontiers after %1%") % incomplete->start.to_account ()));
 			// Requesting new frontiers
 			run_start (lock);
 		}
@@ -252,5 +336,24 @@ void vxldollar::bootstrap_attempt_legacy::get_information (boost::property_tree:
 	tree_a.put ("frontier_pulls", std::to_string (frontier_pulls.size ()));
 	tree_a.put ("frontiers_received", static_cast<bool> (frontiers_received));
 	tree_a.put ("frontiers_age", std::to_string (frontiers_age));
-	tree_a.put ("last_account", start_account.to_account ());
+	auto incomplete (std::find_if (frontier_ranges.begin (), frontier_ranges.end (), [] (vxldollar::frontier_range const & range_a) { return !range_a.complete (); }));
+	tree_a.put ("last_account", incomplete != frontier_ranges.end () ? incomplete->start.to_account () : vxldollar::account (std::numeric_limits<vxldollar::uint256_t>::max ()).to_account ());
+	boost::property_tree::ptree ranges;
+	for (auto const & range : frontier_ranges)
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("start", range.begin.to_account ());
+		entry.put ("end", range.end.to_account ());
+		entry.put ("last_account", range.start.to_account ());
+		entry.put ("progress", boost::str (boost::format ("%.2f") % range.progress ()));
+		entry.put ("requests", std::to_string (range.requests));
+		entry.put ("in_progress", range.future.valid ());
+		if (auto client = range.client.lock ())
+		{
+			entry.put ("frontiers_received", std::to_string (client->count));
+			entry.put ("peer", boost::str (boost::format ("%1%") % range.endpoint));
+		}
+		ranges.push_back (std::make_pair ("", entry));
+	}
+	tree_a.add_child ("frontier_ranges", ranges);
 }
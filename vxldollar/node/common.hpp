@@ -6,6 +6,7 @@
 #include <vxldollar/lib/asio.hpp>
 #include <vxldollar/lib/jsonconfig.hpp>
 #include <vxldollar/lib/memory.hpp>
+#include <vxldollar/lib/stats.hpp>
 #include <vxldollar/secure/common.hpp>
 #include <vxldollar/secure/network_filter.hpp>
 
@@ -190,6 +191,8 @@ enum class message_type : uint8_t
 };
 
 std::string message_type_to_string (message_type);
+/** Returns the stat detail counting \p message_type, or stat::detail::all for bootstrap and invalid types */
+vxldollar::stat::detail message_type_to_stat_detail (message_type);
 
 enum class bulk_pull_account_flags : uint8_t
 {
@@ -223,6 +226,7 @@ public:
 
 	void flag_set (uint8_t);
 	static uint8_t constexpr bulk_pull_count_present_flag = 0;
+	static uint8_t constexpr bulk_pull_compact_flag = 1;
 	bool bulk_pull_is_count_present () const;
 	static uint8_t constexpr frontier_req_only_confirmed = 1;
 	bool frontier_req_is_only_confirmed_present () const;
@@ -272,19 +276,28 @@ public:
 		invalid_telemetry_req_message,
 		invalid_telemetry_ack_message,
 		outdated_version,
-		duplicate_publish_message
+		duplicate_publish_message,
+		duplicate_confirm_req_message,
+		duplicate_confirm_ack_message
 	};
-	message_parser (vxldollar::network_filter &, vxldollar::block_uniquer &, vxldollar::vote_uniquer &, vxldollar::message_visitor &, vxldollar::work_pool &, vxldollar::network_constants const & protocol);
+	/**
+	 * Optional \p vote_filter and \p confirm_req_filter drop duplicate confirm_ack and confirm_req payloads before deserialization.
+	 * Confirm_req digests are salted with \p salt , which should identify the sender, as identical requests from different peers all need a reply.
+	 */
+	message_parser (vxldollar::network_filter &, vxldollar::block_uniquer &, vxldollar::vote_uniquer &, vxldollar::message_visitor &, vxldollar::work_pool &, vxldollar::network_constants const & protocol, vxldollar::network_filter * vote_filter = nullptr, vxldollar::network_filter * confirm_req_filter = nullptr, uint64_t salt = 0);
 	void deserialize_buffer (uint8_t const *, std::size_t);
 	void deserialize_keepalive (vxldollar::stream &, vxldollar::message_header const &);
 	void deserialize_publish (vxldollar::stream &, vxldollar::message_header const &, vxldollar::uint128_t const & = 0);
-	void deserialize_confirm_req (vxldollar::stream &, vxldollar::message_header const &);
-	void deserialize_confirm_ack (vxldollar::stream &, vxldollar::message_header const &);
+	void deserialize_confirm_req (vxldollar::stream &, vxldollar::message_header const &, vxldollar::uint128_t const & = 0);
+	void deserialize_confirm_ack (vxldollar::stream &, vxldollar::message_header const &, vxldollar::uint128_t const & = 0);
 	void deserialize_node_id_handshake (vxldollar::stream &, vxldollar::message_header const &);
 	void deserialize_telemetry_req (vxldollar::stream &, vxldollar::message_header const &);
 	void deserialize_telemetry_ack (vxldollar::stream &, vxldollar::message_header const &);
 	bool at_end (vxldollar::stream &);
 	vxldollar::network_filter & publish_filter;
+	vxldollar::network_filter * vote_filter;
+	vxldollar::network_filter * confirm_req_filter;
+	uint64_t salt;
 	vxldollar::block_uniquer & block_uniquer;
 	vxldollar::vote_uniquer & vote_uniquer;
 	vxldollar::message_visitor & visitor;
@@ -324,7 +337,7 @@ public:
 class confirm_req final : public message
 {
 public:
-	confirm_req (bool &, vxldollar::stream &, vxldollar::message_header const &, vxldollar::block_uniquer * = nullptr);
+	confirm_req (bool &, vxldollar::stream &, vxldollar::message_header const &, vxldollar::block_uniquer * = nullptr, vxldollar::uint128_t const & = 0);
 	confirm_req (vxldollar::network_constants const & constants, std::shared_ptr<vxldollar::block> const &);
 	confirm_req (vxldollar::network_constants const & constants, std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> const &);
 	confirm_req (vxldollar::network_constants const & constants, vxldollar::block_hash const &, vxldollar::root const &);
@@ -334,6 +347,8 @@ public:
 	bool operator== (vxldollar::confirm_req const &) const;
 	std::shared_ptr<vxldollar::block> block;
 	std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> roots_hashes;
+	/** Salted duplicate filter digest, zero if the request was not filtered */
+	vxldollar::uint128_t digest{ 0 };
 	std::string roots_string () const;
 	static std::size_t size (vxldollar::block_type, std::size_t = 0);
 };
@@ -341,12 +356,14 @@ public:
 class confirm_ack final : public message
 {
 public:
-	confirm_ack (bool &, vxldollar::stream &, vxldollar::message_header const &, vxldollar::vote_uniquer * = nullptr);
+	confirm_ack (bool &, vxldollar::stream &, vxldollar::message_header const &, vxldollar::vote_uniquer * = nullptr, vxldollar::uint128_t const & = 0);
 	confirm_ack (vxldollar::network_constants const & constants, std::shared_ptr<vxldollar::vote> const &);
 	void serialize (vxldollar::stream &) const override;
 	void visit (vxldollar::message_visitor &) const override;
 	bool operator== (vxldollar::confirm_ack const &) const;
 	std::shared_ptr<vxldollar::vote> vote;
+	/** Duplicate filter digest, zero if the vote was not filtered */
+	vxldollar::uint128_t digest{ 0 };
 	static std::size_t size (vxldollar::block_type, std::size_t = 0);
 };
 
@@ -450,7 +467,11 @@ public:
 	count_t count{ 0 };
 	bool is_count_present () const;
 	void set_count_present (bool);
+	/** Requests a compact response, see bulk_pull_compact */
+	bool is_compact () const;
+	void set_compact (bool);
 	static std::size_t constexpr count_present_flag = vxldollar::message_header::bulk_pull_count_present_flag;
+	static std::size_t constexpr compact_flag = vxldollar::message_header::bulk_pull_compact_flag;
 	static std::size_t constexpr extended_parameters_size = 8;
 	static std::size_t constexpr size = sizeof (start) + sizeof (end);
 };
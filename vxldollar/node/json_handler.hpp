@@ -65,6 +65,7 @@ public:
 	void confirmation_info ();
 	void confirmation_quorum ();
 	void confirmation_height_currently_processing ();
+	void database_instrumentation ();
 	void database_txn_tracker ();
 	void delegators ();
 	void delegators_count ();
@@ -75,6 +76,8 @@ public:
 	void key_create ();
 	void key_expand ();
 	void ledger ();
+	void ledger_backup ();
+	void ledger_backup_status ();
 	void mvxldollar_to_raw (vxldollar::uint128_t = vxldollar::Mxrb_ratio);
 	void mvxldollar_from_raw (vxldollar::uint128_t = vxldollar::Mxrb_ratio);
 	void vxldollar_to_raw ();
@@ -160,6 +163,7 @@ public:
 	vxldollar::amount amount_impl ();
 	std::shared_ptr<vxldollar::block> block_impl (bool = true);
 	vxldollar::block_hash hash_impl (std::string = "hash");
+	bool hashes_impl (std::vector<std::string> &, std::vector<vxldollar::block_hash> &);
 	vxldollar::amount threshold_optional_impl ();
 	uint64_t work_optional_impl ();
 	uint64_t count_impl ();
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vxldollar/lib/locks.hpp>
+#include <vxldollar/secure/store.hpp>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <thread>
+
+namespace vxldollar
+{
+class logger_mt;
+
+/**
+ * Runs store::backup in a background thread, the ledger keeps being read and written while it is copied.
+ * One backup runs at a time. With LMDB the destination directory receives a compacted data.ldb, with RocksDB it is a backup engine
+ * directory where table files from earlier backups are reused.
+ */
+class ledger_backup final
+{
+public:
+	class status final
+	{
+	public:
+		bool running{ false };
+		/** Whether the last backup completed, unset until one has finished */
+		boost::optional<bool> success;
+		boost::filesystem::path destination;
+		uint64_t bytes_copied{ 0 };
+		/** Upper bound of the bytes to copy, 0 until known */
+		uint64_t bytes_total{ 0 };
+		std::chrono::seconds duration{ 0 };
+	};
+
+	ledger_backup (vxldollar::store &, vxldollar::logger_mt &);
+	~ledger_backup ();
+	/**
+	 * Starts a backup into the \p destination_a directory, copying at most \p max_bytes_per_second_a unless 0
+	 * @return true if a backup is already running
+	 */
+	bool start (boost::filesystem::path const & destination_a, uint64_t max_bytes_per_second_a = 0);
+	/** Cancels the running backup, the partial copy is discarded */
+	void cancel ();
+	/** Waits for the running backup to finish */
+	void wait ();
+	/** Cancels the running backup and waits for it */
+	void stop ();
+	status get_status ();
+
+private:
+	void run (boost::filesystem::path const & destination_a, uint64_t max_bytes_per_second_a);
+	vxldollar::store & store;
+	vxldollar::logger_mt & logger;
+	vxldollar::backup_progress progress;
+	boost::filesystem::path destination;
+	bool running{ false };
+	boost::optional<bool> success;
+	std::chrono::steady_clock::time_point started;
+	std::chrono::steady_clock::time_point finished;
+	vxldollar::mutex mutex;
+	vxldollar::condition_variable condition;
+	std::thread thread;
+};
+}
@@ -0,0 +1,541 @@
+#include <vxldollar/lib/locks.hpp>
+#include <vxldollar/node/ledger_snapshot.hpp>
+#include <vxldollar/secure/buffer.hpp>
+#include <vxldollar/secure/common.hpp>
+#include <vxldollar/secure/store.hpp>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+constexpr std::array<char, 4> vxldollar::ledger_snapshot::magic;
+constexpr std::size_t vxldollar::ledger_snapshot::chunk_size;
+constexpr std::size_t vxldollar::ledger_snapshot::chunk_size_max;
+
+namespace
+{
+template <typename T>
+void write_big_endian (vxldollar::stream & stream_a, T value_a)
+{
+	vxldollar::write (stream_a, boost::endian::native_to_big (value_a));
+}
+
+template <typename T>
+T read_big_endian (uint8_t const * bytes_a)
+{
+	T result;
+	std::memcpy (&result, bytes_a, sizeof (result));
+	return boost::endian::big_to_native (result);
+}
+
+template <typename T>
+void read_big_endian (vxldollar::stream & stream_a, T & value_a)
+{
+	vxldollar::read (stream_a, value_a);
+	boost::endian::big_to_native_inplace (value_a);
+}
+
+vxldollar::uint128_union checksum (std::vector<uint8_t> const & payload_a)
+{
+	vxldollar::uint128_union result;
+	blake2b_state hash;
+	blake2b_init (&hash, sizeof (result.bytes));
+	blake2b_update (&hash, payload_a.data (), payload_a.size ());
+	blake2b_final (&hash, result.bytes.data (), sizeof (result.bytes));
+	return result;
+}
+
+std::vector<vxldollar::tables> const import_tables{ vxldollar::tables::accounts, vxldollar::tables::blocks, vxldollar::tables::confirmation_height, vxldollar::tables::frontiers, vxldollar::tables::pending };
+
+/** Deletes every entry of \p table_a, keeping each write transaction to \p batch_size_a entries */
+template <typename Table>
+void discard_table (vxldollar::store & store_a, Table & table_a, std::size_t batch_size_a)
+{
+	for (auto more (true); more;)
+	{
+		auto transaction (store_a.tx_begin_write (import_tables));
+		std::vector<std::decay_t<decltype (table_a.begin (transaction)->first)>> keys;
+		for (auto i (table_a.begin (transaction)), n (table_a.end ()); i != n && keys.size () < batch_size_a; ++i)
+		{
+			keys.push_back (i->first);
+		}
+		for (auto const & key : keys)
+		{
+			table_a.del (transaction, key);
+		}
+		more = keys.size () == batch_size_a;
+	}
+}
+}
+
+vxldollar::ledger_export::ledger_export (vxldollar::store & store_a, vxldollar::network_params const & network_params_a, std::size_t chunk_size_a) :
+	store (store_a),
+	network_params (network_params_a),
+	chunk_size (chunk_size_a)
+{
+	debug_assert (chunk_size <= ledger_snapshot::chunk_size_max);
+}
+
+vxldollar::error vxldollar::ledger_export::run (boost::filesystem::path const & path_a)
+{
+	vxldollar::error result;
+	accounts = blocks = pending = frontiers = 0;
+	payload.clear ();
+	records = 0;
+	// A single read transaction, so that the snapshot is consistent
+	auto transaction (store.tx_begin_read ());
+	if (store.pruned.count (transaction) != 0)
+	{
+		result = "Exporting pruned ledgers is not supported";
+		return result;
+	}
+	file.open (path_a.string (), std::ios::binary | std::ios::trunc);
+	if (!file.is_open ())
+	{
+		result = boost::str (boost::format ("Could not open %1%") % path_a.string ());
+		return result;
+	}
+	{
+		std::vector<uint8_t> header;
+		{
+			vxldollar::vectorstream stream (header);
+			vxldollar::write (stream, ledger_snapshot::magic);
+			vxldollar::write (stream, ledger_snapshot::version);
+			write_big_endian (stream, static_cast<uint16_t> (network_params.network.current_network));
+		}
+		file.write (reinterpret_cast<char const *> (header.data ()), header.size ());
+	}
+	for (auto i (store.account.begin (transaction)), n (store.account.end ()); i != n && !result; ++i)
+	{
+		auto const & account (i->first);
+		auto const & info (i->second);
+		// Chain from the open block, so that an importer sees blocks in ledger order
+		auto hash (info.open_block);
+		while (!hash.is_zero ())
+		{
+			auto block (store.block.get (transaction, hash));
+			if (block == nullptr)
+			{
+				result = boost::str (boost::format ("Missing block %1% in the chain of account %2%") % hash.to_string () % account.to_account ());
+				break;
+			}
+			std::vector<uint8_t> bytes;
+			{
+				vxldollar::vectorstream stream (bytes);
+				vxldollar::serialize_block (stream, *block);
+				block->sideband ().serialize (stream, block->type ());
+			}
+			{
+				vxldollar::vectorstream stream (payload);
+				vxldollar::write (stream, ledger_snapshot::record_type::block);
+				write_big_endian (stream, static_cast<uint16_t> (bytes.size ()));
+				vxldollar::write (stream, bytes);
+			}
+			++blocks;
+			record_end ();
+			hash = block->sideband ().successor;
+		}
+		vxldollar::confirmation_height_info confirmation_height;
+		store.confirmation_height.get (transaction, account, confirmation_height);
+		{
+			vxldollar::vectorstream stream (payload);
+			vxldollar::write (stream, ledger_snapshot::record_type::account);
+			vxldollar::write (stream, account);
+			info.serialize (stream);
+			confirmation_height.serialize (stream);
+		}
+		++accounts;
+		record_end ();
+	}
+	for (auto i (store.pending.begin (transaction)), n (store.pending.end ()); i != n && !result; ++i)
+	{
+		{
+			vxldollar::vectorstream stream (payload);
+			vxldollar::write (stream, ledger_snapshot::record_type::pending);
+			i->first.serialize (stream);
+			i->second.serialize (stream);
+		}
+		++pending;
+		record_end ();
+	}
+	for (auto i (store.frontier.begin (transaction)), n (store.frontier.end ()); i != n && !result; ++i)
+	{
+		{
+			vxldollar::vectorstream stream (payload);
+			vxldollar::write (stream, ledger_snapshot::record_type::frontier);
+			vxldollar::write (stream, i->first);
+			vxldollar::write (stream, i->second);
+		}
+		++frontiers;
+		record_end ();
+	}
+	if (!result)
+	{
+		// The last record may have filled a chunk, an empty one would be read as the totals
+		if (records > 0)
+		{
+			flush ();
+		}
+		// Totals in a chunk without records mark the end of the snapshot
+		{
+			vxldollar::vectorstream stream (payload);
+			write_big_endian (stream, accounts);
+			write_big_endian (stream, blocks);
+			write_big_endian (stream, pending);
+			write_big_endian (stream, frontiers);
+		}
+		flush ();
+		file.close ();
+		if (file.fail ())
+		{
+			result = boost::str (boost::format ("Could not write %1%") % path_a.string ());
+		}
+	}
+	return result;
+}
+
+void vxldollar::ledger_export::record_end ()
+{
+	++records;
+	if (payload.size () >= chunk_size)
+	{
+		flush ();
+	}
+}
+
+void vxldollar::ledger_export::flush ()
+{
+	std::vector<uint8_t> header;
+	{
+		vxldollar::vectorstream stream (header);
+		write_big_endian (stream, records);
+		write_big_endian (stream, static_cast<uint32_t> (payload.size ()));
+		vxldollar::write (stream, ledger_snapshot::compression::none);
+		vxldollar::write (stream, checksum (payload));
+	}
+	debug_assert (header.size () == ledger_snapshot::chunk_header_size);
+	file.write (reinterpret_cast<char const *> (header.data ()), header.size ());
+	file.write (reinterpret_cast<char const *> (payload.data ()), payload.size ());
+	payload.clear ();
+	records = 0;
+}
+
+vxldollar::ledger_import::ledger_import (vxldollar::store & store_a, vxldollar::network_params & network_params_a, unsigned threads_a) :
+	store (store_a),
+	network_params (network_params_a),
+	threads (std::max (1u, threads_a))
+{
+}
+
+vxldollar::error vxldollar::ledger_import::run (boost::filesystem::path const & path_a)
+{
+	vxldollar::error result;
+	std::ifstream file (path_a.string (), std::ios::binary);
+	if (!file.is_open ())
+	{
+		result = boost::str (boost::format ("Could not open %1%") % path_a.string ());
+		return result;
+	}
+	{
+		std::array<uint8_t, ledger_snapshot::header_size> header;
+		file.read (reinterpret_cast<char *> (header.data ()), header.size ());
+		if (!file || !std::equal (ledger_snapshot::magic.begin (), ledger_snapshot::magic.end (), header.begin ()) || header[4] != ledger_snapshot::version)
+		{
+			result = "Not a ledger snapshot, or written by an unsupported version";
+			return result;
+		}
+		if (read_big_endian<uint16_t> (header.data () + 5) != static_cast<uint16_t> (network_params.network.current_network))
+		{
+			result = "Ledger snapshot is for a different network";
+			return result;
+		}
+	}
+	auto genesis_l (false);
+	{
+		auto transaction (store.tx_begin_write (import_tables));
+		auto const & genesis (*network_params.ledger.genesis);
+		auto count (store.block.count (transaction));
+		if (count > 1 || (count == 1 && !store.block.exists (transaction, genesis.hash ())))
+		{
+			result = "The ledger must be empty or only hold the genesis block";
+			return result;
+		}
+		genesis_l = count == 1;
+		// Genesis records are replaced by the snapshot, which holds its own frontiers
+		store.frontier.del (transaction, genesis.hash ());
+	}
+
+	vxldollar::mutex mutex;
+	vxldollar::condition_variable condition;
+	std::deque<chunk> chunks;
+	auto done (false);
+	auto queue_max (2 * threads);
+	std::vector<std::thread> workers;
+	for (auto i (0u); i < threads; ++i)
+	{
+		workers.emplace_back ([this, &mutex, &condition, &chunks, &done, &result] () {
+			vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+			while ((!chunks.empty () || !done) && !result)
+			{
+				if (!chunks.empty ())
+				{
+					auto chunk_l (std::move (chunks.front ()));
+					chunks.pop_front ();
+					lock.unlock ();
+					condition.notify_all ();
+					auto error (load (chunk_l));
+					lock.lock ();
+					if (error && !result)
+					{
+						result = error;
+						done = true;
+					}
+				}
+				else
+				{
+					condition.wait (lock);
+				}
+			}
+			condition.notify_all ();
+		});
+	}
+
+	std::array<uint64_t, 4> totals{};
+	auto complete (false);
+	auto read_error (false);
+	while (!complete && !read_error)
+	{
+		std::array<uint8_t, ledger_snapshot::chunk_header_size> header;
+		file.read (reinterpret_cast<char *> (header.data ()), header.size ());
+		chunk chunk_l;
+		chunk_l.records = read_big_endian<uint32_t> (header.data ());
+		auto size (read_big_endian<uint32_t> (header.data () + 4));
+		auto compression (static_cast<ledger_snapshot::compression> (header[8]));
+		if (!file || size > ledger_snapshot::chunk_size_max || compression != ledger_snapshot::compression::none)
+		{
+			read_error = true;
+			break;
+		}
+		chunk_l.payload.resize (size);
+		file.read (reinterpret_cast<char *> (chunk_l.payload.data ()), size);
+		vxldollar::uint128_union expected;
+		std::copy (header.begin () + 9, header.end (), expected.bytes.begin ());
+		if (!file)
+		{
+			read_error = true;
+		}
+		else if (chunk_l.records == 0)
+		{
+			read_error = size != totals.size () * sizeof (uint64_t) || checksum (chunk_l.payload) != expected;
+			for (auto i (0u); !read_error && i < totals.size (); ++i)
+			{
+				totals[i] = read_big_endian<uint64_t> (chunk_l.payload.data () + i * sizeof (uint64_t));
+			}
+			complete = true;
+		}
+		// Checksums are verified by the workers along with the records
+		else
+		{
+			vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+			condition.wait (lock, [&] () { return chunks.size () < queue_max || done; });
+			if (done)
+			{
+				break;
+			}
+			std::copy (expected.bytes.begin (), expected.bytes.end (), std::back_inserter (chunk_l.payload));
+			chunks.push_back (std::move (chunk_l));
+			lock.unlock ();
+			condition.notify_all ();
+		}
+	}
+	{
+		vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+		done = true;
+	}
+	condition.notify_all ();
+	for (auto & worker : workers)
+	{
+		worker.join ();
+	}
+	if (!result)
+	{
+		if (read_error || !complete)
+		{
+			result = "Ledger snapshot is truncated or corrupt";
+		}
+		else if (totals != std::array<uint64_t, 4>{ accounts, blocks, pending, frontiers })
+		{
+			result = "Ledger snapshot totals do not match its records";
+		}
+	}
+	if (result)
+	{
+		// Verified chunks are committed as they are loaded, so a failed import is removed to allow another attempt
+		discard (genesis_l);
+	}
+	return result;
+}
+
+void vxldollar::ledger_import::discard (bool genesis_a)
+{
+	auto const batch_size (64 * 1024);
+	discard_table (store, store.block, batch_size);
+	discard_table (store, store.account, batch_size);
+	discard_table (store, store.pending, batch_size);
+	discard_table (store, store.frontier, batch_size);
+	auto transaction (store.tx_begin_write (import_tables));
+	store.confirmation_height.clear (transaction);
+	if (genesis_a)
+	{
+		vxldollar::ledger_cache ledger_cache;
+		store.initialize (transaction, ledger_cache);
+	}
+	accounts = 0;
+	blocks = 0;
+	pending = 0;
+	frontiers = 0;
+}
+
+vxldollar::error vxldollar::ledger_import::load (vxldollar::ledger_import::chunk const & chunk_a)
+{
+	vxldollar::error result;
+	debug_assert (chunk_a.payload.size () >= sizeof (vxldollar::uint128_union));
+	// The checksum is appended to the payload by the reader
+	auto const payload_size (chunk_a.payload.size () - sizeof (vxldollar::uint128_union));
+	vxldollar::uint128_union expected;
+	std::copy (chunk_a.payload.begin () + payload_size, chunk_a.payload.end (), expected.bytes.begin ());
+	vxldollar::uint128_union actual;
+	{
+		blake2b_state hash;
+		blake2b_init (&hash, sizeof (actual.bytes));
+		blake2b_update (&hash, chunk_a.payload.data (), payload_size);
+		blake2b_final (&hash, actual.bytes.data (), sizeof (actual.bytes));
+	}
+	if (actual != expected)
+	{
+		result = "Ledger snapshot chunk checksum mismatch";
+		return result;
+	}
+
+	std::vector<std::pair<vxldollar::block_hash, std::vector<uint8_t>>> blocks_l;
+	std::vector<std::tuple<vxldollar::account, vxldollar::account_info, vxldollar::confirmation_height_info>> accounts_l;
+	std::vector<std::pair<vxldollar::pending_key, vxldollar::pending_info>> pending_l;
+	std::vector<std::pair<vxldollar::block_hash, vxldollar::account>> frontiers_l;
+	vxldollar::bufferstream stream (chunk_a.payload.data (), payload_size);
+	try
+	{
+		for (auto i (0u); i < chunk_a.records && !result; ++i)
+		{
+			ledger_snapshot::record_type type;
+			vxldollar::read (stream, type);
+			switch (type)
+			{
+				case ledger_snapshot::record_type::block:
+				{
+					uint16_t size;
+					read_big_endian (stream, size);
+					std::vector<uint8_t> bytes;
+					vxldollar::read (stream, bytes, size);
+					vxldollar::bufferstream block_stream (bytes.data (), bytes.size ());
+					auto block (vxldollar::deserialize_block (block_stream));
+					vxldollar::block_sideband sideband;
+					if (block == nullptr || sideband.deserialize (block_stream, block->type ()))
+					{
+						result = "Malformed block in ledger snapshot";
+						break;
+					}
+					block->sideband_set (sideband);
+					auto const & hash (block->hash ());
+					// Epoch blocks are signed by the epoch signer, legacy blocks other than open only have their account in the sideband
+					auto const & signer (sideband.details.is_epoch ? network_params.ledger.epochs.signer (network_params.ledger.epochs.epoch (block->link ())) : (block->type () == vxldollar::block_type::state || block->type () == vxldollar::block_type::open) ? block->account () : sideband.account);
+					if (vxldollar::validate_message (signer, hash, block->block_signature ()))
+					{
+						result = boost::str (boost::format ("Invalid signature on block %1%") % hash.to_string ());
+					}
+					else if (network_params.work.difficulty (*block) < network_params.work.threshold (block->work_version (), sideband.details))
+					{
+						result = boost::str (boost::format ("Insufficient work on block %1%") % hash.to_string ());
+					}
+					blocks_l.emplace_back (hash, std::move (bytes));
+					break;
+				}
+				case ledger_snapshot::record_type::account:
+				{
+					vxldollar::account account;
+					vxldollar::account_info info;
+					vxldollar::confirmation_height_info confirmation_height;
+					vxldollar::read (stream, account);
+					if (info.deserialize (stream) || confirmation_height.deserialize (stream))
+					{
+						result = "Malformed account in ledger snapshot";
+						break;
+					}
+					accounts_l.emplace_back (account, info, confirmation_height);
+					break;
+				}
+				case ledger_snapshot::record_type::pending:
+				{
+					vxldollar::pending_key key;
+					vxldollar::pending_info info;
+					if (key.deserialize (stream) || info.deserialize (stream))
+					{
+						result = "Malformed pending entry in ledger snapshot";
+						break;
+					}
+					pending_l.emplace_back (key, info);
+					break;
+				}
+				case ledger_snapshot::record_type::frontier:
+				{
+					vxldollar::block_hash hash;
+					vxldollar::account account;
+					vxldollar::read (stream, hash);
+					vxldollar::read (stream, account);
+					frontiers_l.emplace_back (hash, account);
+					break;
+				}
+				default:
+					result = "Unknown record in ledger snapshot";
+					break;
+			}
+		}
+	}
+	catch (std::runtime_error const &)
+	{
+		result = "Malformed record in ledger snapshot";
+	}
+	if (!result)
+	{
+		// Ordered keys keep B-tree inserts on neighbouring pages
+		std::sort (blocks_l.begin (), blocks_l.end (), [] (auto const & lhs, auto const & rhs) { return lhs.first < rhs.first; });
+		std::sort (accounts_l.begin (), accounts_l.end (), [] (auto const & lhs, auto const & rhs) { return std::get<0> (lhs) < std::get<0> (rhs); });
+		std::sort (pending_l.begin (), pending_l.end (), [] (auto const & lhs, auto const & rhs) { return lhs.first.account < rhs.first.account || (lhs.first.account == rhs.first.account && lhs.first.hash < rhs.first.hash); });
+		std::sort (frontiers_l.begin (), frontiers_l.end (), [] (auto const & lhs, auto const & rhs) { return lhs.first < rhs.first; });
+		auto transaction (store.tx_begin_write (import_tables));
+		for (auto const & [hash, bytes] : blocks_l)
+		{
+			store.block.raw_put (transaction, bytes, hash);
+		}
+		for (auto const & [account, info, confirmation_height] : accounts_l)
+		{
+			store.account.put (transaction, account, info);
+			store.confirmation_height.put (transaction, account, confirmation_height);
+		}
+		for (auto const & [key, info] : pending_l)
+		{
+			store.pending.put (transaction, key, info);
+		}
+		for (auto const & [hash, account] : frontiers_l)
+		{
+			store.frontier.put (transaction, hash, account);
+		}
+		blocks += blocks_l.size ();
+		accounts += accounts_l.size ();
+		pending += pending_l.size ();
+		frontiers += frontiers_l.size ();
+	}
+	return result;
+}
@@ -43,6 +43,9 @@ public:
 	// TODO TSB: make this 65536
 	static constexpr std::size_t in_memory_block_count = 0;
 
+	/** How many blocks 'walk' reads from the store in one batch */
+	static constexpr std::size_t walk_batch_size = 1024;
+
 private:
 	vxldollar::ledger const & ledger;
 	bool use_in_memory_walked_blocks;
@@ -51,6 +51,7 @@ void vxldollar::mdb_env::init (bool & error_a, boost::filesystem::path const & p
 			{
 				environment_flags |= MDB_NOMEMINIT;
 			}
+			sync_deferrable = (environment_flags & MDB_NOSYNC) == 0;
 			auto status4 (mdb_env_open (environment, path_a.string ().c_str (), environment_flags, 00600));
 			if (status4 != 0)
 			{
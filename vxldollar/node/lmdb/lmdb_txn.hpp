@@ -7,6 +7,8 @@
 #include <boost/property_tree/ptree_fwd.hpp>
 #include <boost/stacktrace/stacktrace_fwd.hpp>
 
+#include <array>
+#include <chrono>
 #include <mutex>
 
 #include <lmdb/libraries/liblmdb/lmdb.h>
@@ -24,16 +26,65 @@ public:
 	std::function<void (vxldollar::transaction_impl const *)> txn_end{ [] (vxldollar::transaction_impl const *) {} };
 };
 
+class read_mdb_txn_pool;
+
 class read_mdb_txn final : public read_transaction_impl
 {
 public:
 	read_mdb_txn (vxldollar::mdb_env const &, mdb_txn_callbacks mdb_txn_callbacks);
+	/** Takes a handle from \p pool_a and gives it back when destroyed */
+	read_mdb_txn (vxldollar::read_mdb_txn_pool & pool_a, mdb_txn_callbacks mdb_txn_callbacks);
 	~read_mdb_txn ();
 	void reset () override;
 	void renew () override;
 	void * get_handle () const override;
 	MDB_txn * handle;
 	mdb_txn_callbacks txn_callbacks;
+	vxldollar::read_mdb_txn_pool * pool{ nullptr };
+};
+
+/**
+ * Keeps read transactions which were reset, so that beginning a read transaction renews one instead of allocating a new
+ * MDB_txn and acquiring a reader slot. With MDB_NOTLS a reset transaction keeps its reader slot, but not its snapshot.
+ * Handles are kept in shards picked by the calling thread, so threads mostly take back their own handles without contention.
+ * Handles idle for longer than max_age are aborted, giving their reader slot back to the environment.
+ * @warning Database handles opened with a pooled transaction are discarded when it is reset, open them with a regular one
+ */
+class read_mdb_txn_pool final
+{
+public:
+	explicit read_mdb_txn_pool (vxldollar::mdb_env const &, std::chrono::milliseconds max_age_a = std::chrono::milliseconds (5000));
+	~read_mdb_txn_pool ();
+	/** Renews a pooled handle of the calling thread's shard, or begins a new one */
+	MDB_txn * take ();
+	/** Resets \p handle_a and keeps it for reuse, unless the shard is full */
+	void give_back (MDB_txn * handle_a);
+	/** Aborts all pooled handles */
+	void clear ();
+	/** Number of pooled handles */
+	std::size_t size () const;
+
+	static std::size_t constexpr shard_count = 16;
+	/** Bounds the reader slots held by idle handles to shard_count * shard_capacity */
+	static std::size_t constexpr shard_capacity = 2;
+
+private:
+	class entry final
+	{
+	public:
+		MDB_txn * handle;
+		std::chrono::steady_clock::time_point reset_at;
+	};
+	class shard final
+	{
+	public:
+		mutable vxldollar::mutex mutex;
+		std::vector<entry> entries;
+	};
+	shard & current_shard ();
+	vxldollar::mdb_env const & env;
+	std::chrono::milliseconds const max_age;
+	std::array<shard, shard_count> shards;
 };
 
 class write_mdb_txn final : public write_transaction_impl
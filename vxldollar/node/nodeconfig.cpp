@@ -96,12 +96,18 @@ vxldollar::error vxldollar::node_config::serialize_toml (vxldollar::tomlconfig &
 	toml.put ("bootstrap_connections_max", bootstrap_connections_max, "Maximum number of inbound bootstrap connections. Defaults to 64.\nWarning: a larger amount of connections may use additional system memory.\ntype:uint64");
 	toml.put ("bootstrap_initiator_threads", bootstrap_initiator_threads, "Number of threads dedicated to concurrent bootstrap attempts. Defaults to 1.\nWarning: a larger amount of attempts may use additional system memory and disk IO.\ntype:uint64");
 	toml.put ("bootstrap_frontier_request_count", bootstrap_frontier_request_count, "Number frontiers per bootstrap frontier request. Defaults to 1048576.\ntype:uint32,[1024..4294967295]");
+	toml.put ("bootstrap_frontier_ranges", bootstrap_frontier_ranges, "Number of account ranges whose frontiers are requested in parallel during legacy bootstrap, each from its own connection. Defaults to 4.\ntype:uint32,[1..64]");
+	toml.put ("bootstrap_lazy_memory_limit", bootstrap_lazy_memory_limit, "Memory in bytes a lazy bootstrap attempt keeps its state in before moving it to a temporary database in the data directory. 0 keeps the state in memory and restarts lazy bootstrap after a fixed number of blocks. Defaults to 268435456 (256 MB).\ntype:uint64");
 	toml.put ("block_processor_batch_max_time", block_processor_batch_max_time.count (), "The maximum time the block processor can continuously process blocks for.\ntype:milliseconds");
 	toml.put ("allow_local_peers", allow_local_peers, "Enable or disable local host peering.\ntype:bool");
 	toml.put ("vote_minimum", vote_minimum.to_string_dec (), "Local representatives do not vote if the delegated weight is under this threshold. Saves on system resources.\ntype:string,amount,raw");
 	toml.put ("vote_generator_delay", vote_generator_delay.count (), "Delay before votes are sent to allow for efficient bundling of hashes in votes.\ntype:milliseconds");
 	toml.put ("vote_generator_threshold", vote_generator_threshold, "Number of bundled hashes required for an additional generator delay.\ntype:uint64,[1..11]");
 	toml.put ("unchecked_cutoff_time", unchecked_cutoff_time.count (), "Number of seconds before deleting an unchecked entry.\nWarning: lower values (e.g., 3600 seconds, or 1 hour) may result in unsuccessful bootstraps, especially a bootstrap from scratch.\ntype:seconds");
+	toml.put ("unchecked_memory_limit", unchecked_memory_limit, "Memory in bytes unchecked blocks are kept in instead of the unchecked table. The oldest blocks are dropped when the limit is reached, and unchecked blocks are lost on restart. 0 writes unchecked blocks to the unchecked table. Defaults to 0.\ntype:uint64");
+	toml.put ("account_height_index", account_height_index, "Maintain an index of the blocks in each account chain by height, so that RPC history with an offset jumps directly to a position instead of walking the chain. The index is built on start when enabled and dropped when disabled, and uses additional disk space.\ntype:bool");
+	toml.put ("block_filter_false_positive_rate", block_filter_false_positive_rate, "Target share of lookups of unknown blocks which are not answered from the in-memory block filter and read the database instead. Lower rates use more memory. 0 disables the filter.\ntype:double,[0..0.5]");
+	toml.put ("block_filter_memory_limit", block_filter_memory_limit, "Memory in bytes the block filter uses at most, the false positive rate is higher than configured when the limit is reached. Defaults to 268435456 (256 MB).\ntype:uint64");
 	toml.put ("tcp_io_timeout", tcp_io_timeout.count (), "Timeout for TCP connect-, read- and write operations.\nWarning: a low value (e.g., below 5 seconds) may result in TCP connections failing.\ntype:seconds");
 	toml.put ("pow_sleep_interval", pow_sleep_interval.count (), "Time to sleep between batch work generation attempts. Reduces max CPU usage at the expense of a longer generation time.\ntype:nanoseconds");
 	toml.put ("external_address", external_address, "The external address of this node (NAT). If not set, the node will request this information via UPnP.\ntype:string,ip");
@@ -147,6 +153,8 @@ vxldollar::error vxldollar::node_config::serialize_toml (vxldollar::tomlconfig &
 	}
 	experimental_l.put ("max_pruning_age", max_pruning_age.count (), "Time limit for blocks age after pruning.\ntype:seconds");
 	experimental_l.put ("max_pruning_depth", max_pruning_depth, "Limit for full blocks in chain after pruning.\ntype:uint64");
+	experimental_l.put ("pruning_threads", pruning_threads, "Number of threads collecting pruning targets in parallel, each from its own range of accounts.\ntype:uint64,[1..64]");
+	experimental_l.put ("pruning_write_share", pruning_write_share, "Share of time pruning may hold the database write lock. Pruning pauses between its write batches for the rest of the time, leaving the database to block processing.\ntype:double,(0..1]");
 	toml.put_child ("experimental", experimental_l);
 
 	vxldollar::tomlconfig callback_l;
@@ -311,6 +319,10 @@ vxldollar::error vxldollar::node_config::deserialize_toml (vxldollar::tomlconfig
 		auto unchecked_cutoff_time_l = static_cast<unsigned long> (unchecked_cutoff_time.count ());
 		toml.get ("unchecked_cutoff_time", unchecked_cutoff_time_l);
 		unchecked_cutoff_time = std::chrono::seconds (unchecked_cutoff_time_l);
+		toml.get<std::size_t> ("unchecked_memory_limit", unchecked_memory_limit);
+		toml.get<bool> ("account_height_index", account_height_index);
+		toml.get<double> ("block_filter_false_positive_rate", block_filter_false_positive_rate);
+		toml.get<std::size_t> ("block_filter_memory_limit", block_filter_memory_limit);
 
 		auto tcp_io_timeout_l = static_cast<unsigned long> (tcp_io_timeout.count ());
 		toml.get ("tcp_io_timeout", tcp_io_timeout_l);
@@ -333,6 +345,8 @@ vxldollar::error vxldollar::node_config::deserialize_toml (vxldollar::tomlconfig
 		toml.get<unsigned> ("bootstrap_connections_max", bootstrap_connections_max);
 		toml.get<unsigned> ("bootstrap_initiator_threads", bootstrap_initiator_threads);
 		toml.get<uint32_t> ("bootstrap_frontier_request_count", bootstrap_frontier_request_count);
+		toml.get<unsigned> ("bootstrap_frontier_ranges", bootstrap_frontier_ranges);
+		toml.get<std::size_t> ("bootstrap_lazy_memory_limit", bootstrap_lazy_memory_limit);
 		toml.get<bool> ("enable_voting", enable_voting);
 		toml.get<bool> ("allow_local_peers", allow_local_peers);
 		toml.get<unsigned> (signature_checker_threads_key, signature_checker_threads);
@@ -398,6 +412,8 @@ vxldollar::error vxldollar::node_config::deserialize_toml (vxldollar::tomlconfig
 			experimental_config_l.get ("max_pruning_age", max_pruning_age_l);
 			max_pruning_age = std::chrono::seconds (max_pruning_age_l);
 			experimental_config_l.get<uint64_t> ("max_pruning_depth", max_pruning_depth);
+			experimental_config_l.get<unsigned> ("pruning_threads", pruning_threads);
+			experimental_config_l.get<double> ("pruning_write_share", pruning_write_share);
 		}
 
 		// Validate ranges
@@ -405,6 +421,10 @@ vxldollar::error vxldollar::node_config::deserialize_toml (vxldollar::tomlconfig
 		{
 			toml.get_error ().set ("election_hint_weight_percent must be a number between 5 and 50");
 		}
+		if (block_filter_false_positive_rate < 0 || block_filter_false_positive_rate > 0.5)
+		{
+			toml.get_error ().set ("block_filter_false_positive_rate must be a number between 0 and 0.5");
+		}
 		if (password_fanout < 16 || password_fanout > 1024 * 1024)
 		{
 			toml.get_error ().set ("password_fanout must be a number between 16 and 1048576");
@@ -441,6 +461,14 @@ vxldollar::error vxldollar::node_config::deserialize_toml (vxldollar::tomlconfig
 		{
 			toml.get_error ().set ("max_pruning_age must be greater than or equal to 5 minutes");
 		}
+		if (pruning_threads < 1 || pruning_threads > 64)
+		{
+			toml.get_error ().set ("pruning_threads must be a number between 1 and 64");
+		}
+		if (pruning_write_share <= 0 || pruning_write_share > 1)
+		{
+			toml.get_error ().set ("pruning_write_share must be greater than 0 and less than or equal to 1");
+		}
 		if (confirm_req_batches_max < 1 || confirm_req_batches_max > 100)
 		{
 			toml.get_error ().set ("confirm_req_batches_max must be between 1 and 100");
@@ -449,6 +477,10 @@ vxldollar::error vxldollar::node_config::deserialize_toml (vxldollar::tomlconfig
 		{
 			toml.get_error ().set ("bootstrap_frontier_request_count must be greater than or equal to 1024");
 		}
+		if (bootstrap_frontier_ranges < 1 || bootstrap_frontier_ranges > 64)
+		{
+			toml.get_error ().set ("bootstrap_frontier_ranges must be between 1 and 64");
+		}
 	}
 	catch (std::runtime_error const & ex)
 	{
@@ -66,6 +66,9 @@ public:
 	unsigned bootstrap_connections_max{ 64 };
 	unsigned bootstrap_initiator_threads{ 1 };
 	uint32_t bootstrap_frontier_request_count{ 1024 * 1024 };
+	unsigned bootstrap_frontier_ranges{ network_params.network.is_dev_network () ? 1u : 4u };
+	/** Lazy bootstrap state above this size is moved to disk, 0 keeps it in memory */
+	std::size_t bootstrap_lazy_memory_limit{ 256 * 1024 * 1024 };
 	vxldollar::websocket::config websocket_config;
 	vxldollar::diagnostics_config diagnostics_config;
 	std::size_t confirmation_history_size{ 2048 };
@@ -79,6 +82,13 @@ public:
 	uint16_t external_port{ 0 };
 	std::chrono::milliseconds block_processor_batch_max_time{ network_params.network.is_dev_network () ? std::chrono::milliseconds (500) : std::chrono::milliseconds (5000) };
 	std::chrono::seconds unchecked_cutoff_time{ std::chrono::seconds (4 * 60 * 60) }; // 4 hours
+	/** Unchecked blocks are kept only in memory within this many bytes, 0 writes them to the unchecked table */
+	std::size_t unchecked_memory_limit{ 0 };
+	/** Maintain an index of each account chain by height, for direct access to deep history */
+	bool account_height_index{ false };
+	/** Share of lookups of unknown blocks which pass the in-memory block filter and read the database, 0 disables the filter */
+	double block_filter_false_positive_rate{ 0.01 };
+	std::size_t block_filter_memory_limit{ 256 * 1024 * 1024 };
 	/** Timeout for initiated async operations */
 	std::chrono::seconds tcp_io_timeout{ (network_params.network.is_dev_network () && !is_sanitizer_build) ? std::chrono::seconds (5) : std::chrono::seconds (15) };
 	std::chrono::nanoseconds pow_sleep_interval{ 0 };
@@ -101,6 +111,10 @@ public:
 	uint32_t confirm_req_batches_max{ network_params.network.is_dev_network () ? 1u : 2u };
 	std::chrono::seconds max_pruning_age{ !network_params.network.is_beta_network () ? std::chrono::seconds (24 * 60 * 60) : std::chrono::seconds (5 * 60) }; // 1 day; 5 minutes for beta network
 	uint64_t max_pruning_depth{ 0 };
+	/** Threads collecting pruning targets, each from its own range of accounts */
+	unsigned pruning_threads{ std::max<unsigned> (1, std::thread::hardware_concurrency () / 4) };
+	/** Share of its time pruning may hold the database write lock, it pauses between write batches for the rest */
+	double pruning_write_share{ 0.5 };
 	vxldollar::rocksdb_config rocksdb_config;
 	vxldollar::lmdb_config lmdb_config;
 	vxldollar::frontiers_confirmation_mode frontiers_confirmation{ vxldollar::frontiers_confirmation_mode::automatic };
@@ -115,10 +129,14 @@ class node_flags final
 public:
 	std::vector<std::string> config_overrides;
 	std::vector<std::string> rpc_config_overrides;
+	/** If set, inbound realtime messages are recorded to this file, see traffic_recorder */
+	std::string record_traffic_path;
 	bool disable_add_initial_peers{ false }; // For testing only
 	bool disable_backup{ false };
 	bool disable_lazy_bootstrap{ false };
 	bool disable_legacy_bootstrap{ false };
+	bool disable_bootstrap_pipelining{ false };
+	bool disable_bootstrap_compact{ false };
 	bool disable_wallet_bootstrap{ false };
 	bool disable_bootstrap_listener{ false };
 	bool disable_bootstrap_bulk_pull_server{ false };
@@ -141,6 +159,7 @@ public:
 	bool force_use_write_database_queue{ false }; // For testing only. RocksDB does not use the database queue, but some tests rely on it being used.
 	bool disable_search_pending{ false }; // For testing only
 	bool enable_pruning{ false };
+	bool enable_priority_bootstrap{ false };
 	bool fast_bootstrap{ false };
 	bool read_only{ false };
 	bool disable_connection_cleanup{ false };
@@ -18,6 +18,10 @@ void vxldollar::rep_crawler::remove (vxldollar::block_hash const & hash_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (active_mutex);
 	active.erase (hash_a);
+	for (auto i (queried.begin ()); i != queried.end ();)
+	{
+		i = i->second == hash_a ? queried.erase (i) : std::next (i);
+	}
 }
 
 void vxldollar::rep_crawler::start ()
@@ -169,6 +173,10 @@ void vxldollar::rep_crawler::query (std::vector<std::shared_ptr<vxldollar::trans
 			}
 		}
 		active.insert (hash_root.first);
+		for (auto const & channel : channels_a)
+		{
+			queried.emplace (channel->get_endpoint ().address (), hash_root.first);
+		}
 	}
 	if (!channels_a.empty ())
 	{
@@ -245,6 +253,20 @@ bool vxldollar::rep_crawler::response (std::shared_ptr<vxldollar::transport::cha
 	return error;
 }
 
+bool vxldollar::rep_crawler::is_queried (boost::asio::ip::address const & address_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> lock (active_mutex);
+	return queried.count (address_a) != 0;
+}
+
+bool vxldollar::rep_crawler::is_pending (std::shared_ptr<vxldollar::vote> const & vote_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> lock (active_mutex);
+	return !active.empty () && std::any_of (vote_a->begin (), vote_a->end (), [this] (vxldollar::block_hash const & hash_a) {
+		return active.count (hash_a) != 0;
+	});
+}
+
 vxldollar::uint128_t vxldollar::rep_crawler::total_weight () const
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (probable_reps_mutex);
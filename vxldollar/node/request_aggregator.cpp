@@ -11,7 +11,7 @@
 #include <vxldollar/secure/ledger.hpp>
 #include <vxldollar/secure/store.hpp>
 
-vxldollar::request_aggregator::request_aggregator (vxldollar::node_config const & config_a, vxldollar::stat & stats_a, vxldollar::vote_generator & generator_a, vxldollar::vote_generator & final_generator_a, vxldollar::local_vote_history & history_a, vxldollar::ledger & ledger_a, vxldollar::wallets & wallets_a, vxldollar::active_transactions & active_a) :
+vxldollar::request_aggregator::request_aggregator (vxldollar::node_config const & config_a, vxldollar::stat & stats_a, vxldollar::vote_generator & generator_a, vxldollar::vote_generator & final_generator_a, vxldollar::local_vote_history & history_a, vxldollar::ledger & ledger_a, vxldollar::wallets & wallets_a, vxldollar::active_transactions & active_a, vxldollar::network_filter & confirm_req_filter_a) :
 	config{ config_a },
 	max_delay (config_a.network_params.network.is_dev_network () ? 50 : 300),
 	small_delay (config_a.network_params.network.is_dev_network () ? 10 : 50),
@@ -23,6 +23,7 @@ vxldollar::request_aggregator::request_aggregator (vxldollar::node_config const
 	active (active_a),
 	generator (generator_a),
 	final_generator (final_generator_a),
+	confirm_req_filter (confirm_req_filter_a),
 	thread ([this] () { run (); })
 {
 	generator.set_reply_action ([this] (std::shared_ptr<vxldollar::vote> const & vote_a, std::shared_ptr<vxldollar::transport::channel> const & channel_a) {
@@ -35,7 +36,7 @@ vxldollar::request_aggregator::request_aggregator (vxldollar::node_config const
 	condition.wait (lock, [&started = started] { return started; });
 }
 
-void vxldollar::request_aggregator::add (std::shared_ptr<vxldollar::transport::channel> const & channel_a, std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> const & hashes_roots_a)
+void vxldollar::request_aggregator::add (std::shared_ptr<vxldollar::transport::channel> const & channel_a, std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> const & hashes_roots_a, vxldollar::uint128_t const & digest_a)
 {
 	debug_assert (wallets.reps ().voting > 0);
 	bool error = true;
@@ -51,7 +52,7 @@ void vxldollar::request_aggregator::add (std::shared_ptr<vxldollar::transport::c
 		{
 			existing = requests_by_endpoint.emplace (channel_a).first;
 		}
-		requests_by_endpoint.modify (existing, [&hashes_roots_a, &channel_a, &error, this] (channel_pool & pool_a) {
+		requests_by_endpoint.modify (existing, [&hashes_roots_a, &channel_a, &digest_a, &error, this] (channel_pool & pool_a) {
 			// This extends the lifetime of the channel, which is acceptable up to max_delay
 			pool_a.channel = channel_a;
 			if (pool_a.hashes_roots.size () + hashes_roots_a.size () <= this->max_channel_requests)
@@ -60,6 +61,10 @@ void vxldollar::request_aggregator::add (std::shared_ptr<vxldollar::transport::c
 				auto new_deadline (std::min (pool_a.start + this->max_delay, std::chrono::steady_clock::now () + this->small_delay));
 				pool_a.deadline = new_deadline;
 				pool_a.hashes_roots.insert (pool_a.hashes_roots.begin (), hashes_roots_a.begin (), hashes_roots_a.end ());
+				if (digest_a != 0)
+				{
+					pool_a.digests.push_back (digest_a);
+				}
 			}
 		});
 		if (requests.size () == 1)
@@ -68,6 +73,10 @@ void vxldollar::request_aggregator::add (std::shared_ptr<vxldollar::transport::c
 			condition.notify_all ();
 		}
 	}
+	if (error && digest_a != 0)
+	{
+		confirm_req_filter.clear (digest_a);
+	}
 	stats.inc (vxldollar::stat::type::aggregator, !error ? vxldollar::stat::detail::aggregator_accepted : vxldollar::stat::detail::aggregator_dropped);
 }
 
@@ -90,12 +99,16 @@ void vxldollar::request_aggregator::run ()
 				// Store the channel and requests for processing after erasing this pool
 				decltype (front->channel) channel{};
 				decltype (front->hashes_roots) hashes_roots{};
-				requests_by_deadline.modify (front, [&channel, &hashes_roots] (channel_pool & pool) {
+				decltype (front->digests) digests{};
+				requests_by_deadline.modify (front, [&channel, &hashes_roots, &digests] (channel_pool & pool) {
 					channel.swap (pool.channel);
 					hashes_roots.swap (pool.hashes_roots);
+					digests.swap (pool.digests);
 				});
 				requests_by_deadline.erase (front);
 				lock.unlock ();
+				// Requests from this channel are served from here on, identical ones must be accepted again
+				confirm_req_filter.clear (digests);
 				erase_duplicates (hashes_roots);
 				auto const remaining = aggregate (hashes_roots, channel);
 				if (!remaining.first.empty ())
@@ -173,9 +186,10 @@ std::pair<std::vector<std::shared_ptr<vxldollar::block>>, std::vector<std::share
 	std::vector<std::shared_ptr<vxldollar::block>> to_generate;
 	std::vector<std::shared_ptr<vxldollar::block>> to_generate_final;
 	std::vector<std::shared_ptr<vxldollar::vote>> cached_votes;
+	// 1. Votes in cache
+	std::vector<std::pair<vxldollar::block_hash, vxldollar::root>> uncached;
 	for (auto const & [hash, root] : requests_a)
 	{
-		// 1. Votes in cache
 		auto find_votes (local_votes.votes (root, hash));
 		if (!find_votes.empty ())
 		{
@@ -184,109 +198,134 @@ std::pair<std::vector<std::shared_ptr<vxldollar::block>>, std::vector<std::share
 		}
 		else
 		{
-			bool generate_vote (true);
-			bool generate_final_vote (false);
-			std::shared_ptr<vxldollar::block> block;
+			uncached.emplace_back (hash, root);
+		}
+	}
+	// Blocks and confirmation heights for the remaining hashes are read in batches, the ledger is the most common source
+	std::vector<vxldollar::block_hash> hashes;
+	hashes.reserve (uncached.size ());
+	std::transform (uncached.begin (), uncached.end (), std::back_inserter (hashes), [] (auto const & request) { return request.first; });
+	auto ledger_blocks (ledger.store.block.get_many (transaction, hashes));
+	std::vector<vxldollar::account> accounts;
+	for (auto const & block : ledger_blocks)
+	{
+		if (block != nullptr)
+		{
+			accounts.push_back (block->account ().is_zero () ? block->sideband ().account : block->account ());
+		}
+	}
+	auto confirmation_heights (ledger.store.confirmation_height.get_many (transaction, accounts));
+	auto confirmation_height_i (confirmation_heights.begin ());
+	for (std::size_t i (0), n (uncached.size ()); i < n; ++i)
+	{
+		auto const & [hash, root] = uncached[i];
+		auto const & ledger_block (ledger_blocks[i]);
+		std::uint64_t ledger_block_confirmed_height (0);
+		if (ledger_block != nullptr)
+		{
+			ledger_block_confirmed_height = confirmation_height_i->height;
+			++confirmation_height_i;
+		}
+		bool generate_vote (true);
+		bool generate_final_vote (false);
+		std::shared_ptr<vxldollar::block> block;
 
-			//2. Final votes
-			auto final_vote_hashes (ledger.store.final_vote.get (transaction, root));
-			if (!final_vote_hashes.empty ())
+		//2. Final votes
+		auto final_vote_hashes (ledger.store.final_vote.get (transaction, root));
+		if (!final_vote_hashes.empty ())
+		{
+			generate_final_vote = true;
+			block = ledger.store.block.get (transaction, final_vote_hashes[0]);
+			// Allow same root vote
+			if (block != nullptr && final_vote_hashes.size () > 1)
 			{
-				generate_final_vote = true;
-				block = ledger.store.block.get (transaction, final_vote_hashes[0]);
-				// Allow same root vote
-				if (block != nullptr && final_vote_hashes.size () > 1)
-				{
-					to_generate_final.push_back (block);
-					block = ledger.store.block.get (transaction, final_vote_hashes[1]);
-					debug_assert (final_vote_hashes.size () == 2);
-				}
+				to_generate_final.push_back (block);
+				block = ledger.store.block.get (transaction, final_vote_hashes[1]);
+				debug_assert (final_vote_hashes.size () == 2);
 			}
+		}
+
+		// 3. Election winner by hash
+		if (block == nullptr)
+		{
+			block = active.winner (hash);
+		}
 
-			// 3. Election winner by hash
-			if (block == nullptr)
+		// 4. Ledger by hash
+		if (block == nullptr)
+		{
+			block = ledger_block;
+			// Confirmation status. Generate final votes for confirmed
+			if (block != nullptr)
 			{
-				block = active.winner (hash);
+				generate_final_vote = (ledger_block_confirmed_height >= block->sideband ().height);
 			}
+		}
+
+		// 5. Ledger by root
+		if (block == nullptr && !root.is_zero ())
+		{
+			// Search for block root
+			auto successor (ledger.store.block.successor (transaction, root.as_block_hash ()));
 
-			// 4. Ledger by hash
-			if (block == nullptr)
+			// Search for account root
+			if (successor.is_zero ())
 			{
-				block = ledger.store.block.get (transaction, hash);
-				// Confirmation status. Generate final votes for confirmed
-				if (block != nullptr)
+				vxldollar::account_info info;
+				auto error (ledger.store.account.get (transaction, root.as_account (), info));
+				if (!error)
 				{
-					vxldollar::confirmation_height_info confirmation_height_info;
-					ledger.store.confirmation_height.get (transaction, block->account ().is_zero () ? block->sideband ().account : block->account (), confirmation_height_info);
-					generate_final_vote = (confirmation_height_info.height >= block->sideband ().height);
+					successor = info.open_block;
 				}
 			}
-
-			// 5. Ledger by root
-			if (block == nullptr && !root.is_zero ())
+			if (!successor.is_zero ())
 			{
-				// Search for block root
-				auto successor (ledger.store.block.successor (transaction, root.as_block_hash ()));
-
-				// Search for account root
-				if (successor.is_zero ())
+				auto successor_block = ledger.store.block.get (transaction, successor);
+				debug_assert (successor_block != nullptr);
+				block = std::move (successor_block);
+				// 5. Votes in cache for successor
+				auto find_successor_votes (local_votes.votes (root, successor));
+				if (!find_successor_votes.empty ())
 				{
-					vxldollar::account_info info;
-					auto error (ledger.store.account.get (transaction, root.as_account (), info));
-					if (!error)
-					{
-						successor = info.open_block;
-					}
+					cached_votes.insert (cached_votes.end (), find_successor_votes.begin (), find_successor_votes.end ());
+					generate_vote = false;
 				}
-				if (!successor.is_zero ())
+				// Confirmation status. Generate final votes for confirmed successor
+				if (block != nullptr && generate_vote)
 				{
-					auto successor_block = ledger.store.block.get (transaction, successor);
-					debug_assert (successor_block != nullptr);
-					block = std::move (successor_block);
-					// 5. Votes in cache for successor
-					auto find_successor_votes (local_votes.votes (root, successor));
-					if (!find_successor_votes.empty ())
-					{
-						cached_votes.insert (cached_votes.end (), find_successor_votes.begin (), find_successor_votes.end ());
-						generate_vote = false;
-					}
-					// Confirmation status. Generate final votes for confirmed successor
-					if (block != nullptr && generate_vote)
-					{
-						vxldollar::confirmation_height_info confirmation_height_info;
-						ledger.store.confirmation_height.get (transaction, block->account ().is_zero () ? block->sideband ().account : block->account (), confirmation_height_info);
-						generate_final_vote = (confirmation_height_info.height >= block->sideband ().height);
-					}
+					vxldollar::confirmation_height_info confirmation_height_info;
+					ledger.store.confirmation_height.get (transaction, block->account ().is_zero () ? block->sideband ().account : block->account (), confirmation_height_info);
+					generate_final_vote = (confirmation_height_info.height >= block->sideband ().height);
 				}
 			}
+		}
 
-			if (block)
+		if (block)
+		{
+			// Generate new vote
+			if (generate_vote)
 			{
-				// Generate new vote
-				if (generate_vote)
+				if (generate_final_vote)
 				{
-					if (generate_final_vote)
-					{
-						to_generate_final.push_back (block);
-					}
-					else
-					{
-						to_generate.push_back (block);
-					}
+					to_generate_final.push_back (block);
 				}
-
-				// Let the node know about the alternative block
-				if (block->hash () != hash)
+				else
 				{
-					vxldollar::publish publish (config.network_params.network, block);
-					channel_a->send (publish);
+					to_generate.push_back (block);
 				}
 			}
-			else
+
+			// Let the node know about the alternative block
+			if (block->hash () != hash)
 			{
-				stats.inc (vxldollar::stat::type::requests, vxldollar::stat::detail::requests_unknown, stat::dir::in);
+				vxldollar::publish publish (config.network_params.network, block);
+				channel_a->send (publish);
 			}
 		}
+		else
+		{
+			stats.inc (vxldollar::stat::type::requests, vxldollar::stat::detail::requests_unknown, stat::dir::in);
+		}
 	}
 	// Unique votes
 	std::sort (cached_votes.begin (), cached_votes.end ());
@@ -5,6 +5,7 @@
 #include <vxldollar/lib/numbers.hpp>
 #include <vxldollar/node/rocksdb/rocksdb_iterator.hpp>
 #include <vxldollar/secure/common.hpp>
+#include <vxldollar/secure/store/account_height_store_partial.hpp>
 #include <vxldollar/secure/store/account_store_partial.hpp>
 #include <vxldollar/secure/store/confirmation_height_store_partial.hpp>
 #include <vxldollar/secure/store/final_vote_store_partial.hpp>
@@ -17,13 +18,16 @@
 #include <vxldollar/secure/store/version_store_partial.hpp>
 #include <vxldollar/secure/store_partial.hpp>
 
+#include <rocksdb/cache.h>
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/options.h>
+#include <rocksdb/perf_level.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/table.h>
 #include <rocksdb/utilities/optimistic_transaction_db.h>
 #include <rocksdb/utilities/transaction.h>
+#include <rocksdb/write_buffer_manager.h>
 
 namespace vxldollar
 {
@@ -66,6 +70,7 @@ private:
 	vxldollar::peer_store_partial<rocksdb::Slice, rocksdb_store> peer_store_partial;
 	vxldollar::confirmation_height_store_partial<rocksdb::Slice, rocksdb_store> confirmation_height_store_partial;
 	vxldollar::final_vote_store_partial<rocksdb::Slice, rocksdb_store> final_vote_store_partial;
+	vxldollar::account_height_store_partial<rocksdb::Slice, rocksdb_store> account_height_store_partial;
 	vxldollar::version_rocksdb_store version_rocksdb_store;
 
 public:
@@ -82,13 +87,28 @@ public:
 	uint64_t count (vxldollar::transaction const & transaction_a, tables table_a) const override;
 
 	bool exists (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & key_a) const;
+	bool exists_prefix (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & prefix_a) const;
 	int get (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & key_a, vxldollar::rocksdb_val & value_a) const;
+	std::vector<int> get_many (vxldollar::transaction const & transaction_a, tables table_a, std::vector<vxldollar::rocksdb_val> const & keys_a, std::vector<vxldollar::rocksdb_val> & values_a) const;
 	int put (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & key_a, vxldollar::rocksdb_val const & value_a);
 	int del (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::rocksdb_val const & key_a);
 
 	void serialize_memory_stats (boost::property_tree::ptree &) override;
 
 	bool copy_db (boost::filesystem::path const & destination) override;
+	/**
+	 * Adds a backup to the backup engine directory \p destination, only table files not already in it are copied.
+	 * The bytes copied are counted in steps of backup_progress_interval.
+	 */
+	bool backup (boost::filesystem::path const & destination, vxldollar::backup_progress & progress_a, uint64_t max_bytes_per_second_a) override;
+	/** Rewrites all files of \p table_a with the configured compression, training new dictionaries for the last level */
+	bool compact (vxldollar::tables table_a);
+	/** Size of the files holding \p table_a on disk */
+	uint64_t table_file_size (vxldollar::tables table_a) const;
+	void for_each_raw (vxldollar::transaction const & transaction_a, tables table_a, uint8_t first_a, uint8_t last_a, std::function<void (uint8_t const *, std::size_t, uint8_t const *, std::size_t)> const & action_a) const override;
+	/** The writer creates a sorted table file with the options of \p table_a */
+	std::unique_ptr<vxldollar::table_file_writer> make_table_file_writer (vxldollar::tables table_a, boost::filesystem::path const & path_a) override;
+	bool ingest (vxldollar::tables table_a, std::vector<boost::filesystem::path> const & paths_a) override;
 	void rebuild_db (vxldollar::write_transaction const & transaction_a) override;
 
 	unsigned max_block_write_batch_num () const override;
@@ -106,6 +126,7 @@ public:
 	}
 
 	bool init_error () const override;
+	void sync () override;
 
 	std::string error_string (int status) const override;
 
@@ -117,9 +138,15 @@ private:
 	rocksdb::OptimisticTransactionDB * optimistic_db = nullptr;
 	std::unique_ptr<rocksdb::DB> db;
 	std::vector<std::unique_ptr<rocksdb::ColumnFamilyHandle>> handles;
-	std::shared_ptr<rocksdb::TableFactory> small_table_factory;
 	std::unordered_map<vxldollar::tables, vxldollar::mutex> write_lock_mutexes;
 	vxldollar::rocksdb_config rocksdb_config;
+	/** Shared by all tables, memtables are charged against its capacity through write_buffer_manager */
+	std::shared_ptr<rocksdb::Cache> block_cache;
+	std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager;
+	std::shared_ptr<rocksdb::TableFactory> active_table_factory;
+	std::shared_ptr<rocksdb::TableFactory> small_table_factory;
+	rocksdb::CompressionType compression{ rocksdb::kNoCompression };
+	rocksdb::CompressionType bottommost_compression{ rocksdb::kNoCompression };
 	unsigned const max_block_write_batch_num_m;
 
 	class tombstone_info
@@ -131,6 +158,31 @@ private:
 	};
 
 	std::unordered_map<vxldollar::tables, tombstone_info> tombstone_map;
+
+	/** Block cache hits and misses of point reads on a table */
+	class cache_counters final
+	{
+	public:
+		std::atomic<uint64_t> hits{ 0 };
+		std::atomic<uint64_t> misses{ 0 };
+	};
+
+	/** Attributes block cache activity of reads on the calling thread to a table while in scope */
+	class cache_read_scope final
+	{
+	public:
+		explicit cache_read_scope (cache_counters &);
+		~cache_read_scope ();
+
+	private:
+		cache_counters & counters;
+		uint64_t hits;
+		uint64_t misses;
+		/** Perf level of the calling thread before the scope, restored on destruction */
+		rocksdb::PerfLevel previous_level;
+	};
+
+	mutable std::unordered_map<vxldollar::tables, cache_counters> cache_counters_map;
 	std::unordered_map<char const *, vxldollar::tables> cf_name_table_map;
 
 	rocksdb::Transaction * tx (vxldollar::transaction const & transaction_a) const;
@@ -151,9 +203,10 @@ private:
 	rocksdb::ColumnFamilyOptions get_common_cf_options (std::shared_ptr<rocksdb::TableFactory> const & table_factory_a, unsigned long long memtable_size_bytes_a) const;
 	rocksdb::ColumnFamilyOptions get_active_cf_options (std::shared_ptr<rocksdb::TableFactory> const & table_factory_a, unsigned long long memtable_size_bytes_a) const;
 	rocksdb::ColumnFamilyOptions get_small_cf_options (std::shared_ptr<rocksdb::TableFactory> const & table_factory_a) const;
-	rocksdb::BlockBasedTableOptions get_active_table_options (std::size_t lru_size) const;
+	rocksdb::BlockBasedTableOptions get_active_table_options () const;
 	rocksdb::BlockBasedTableOptions get_small_table_options () const;
 	rocksdb::ColumnFamilyOptions get_cf_options (std::string const & cf_name_a) const;
+	rocksdb::CompressionType supported_compression (std::string const & compression_a) const;
 
 	void on_flush (rocksdb::FlushJobInfo const &);
 	void flush_table (vxldollar::tables table_a);
@@ -166,7 +219,15 @@ private:
 	unsigned long long blocks_memtable_size_bytes () const;
 
 	constexpr static int base_memtable_size = 16;
-	constexpr static int base_block_cache_size = 8;
+	/** Share of the memory budget memtables can use before they are flushed */
+	constexpr static int write_buffer_budget_divisor = 4;
+	/** Share of the block cache reserved for index and filter blocks */
+	constexpr static double high_priority_pool_ratio = 0.2;
+	/** zstd recommends training a dictionary on about 100 times its size of samples */
+	constexpr static int dictionary_training_ratio = 100;
+	constexpr static uint64_t backup_progress_interval = 4 * 1024 * 1024;
+	/** Backups kept in a backup directory, older ones are purged once a new one completes */
+	constexpr static uint32_t backups_kept = 2;
 
 	friend class rocksdb_block_store_tombstone_count_Test;
 };
@@ -36,16 +36,19 @@ public:
 	rocksdb_iterator (rocksdb::DB * db, vxldollar::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb_val const * val_a, bool const direction_asc)
 	{
 		// Don't fill the block cache for any blocks read as a result of an iterator
+		// Iterators may cross prefixes of tables with a prefix extractor, so they need a total order seek which ignores prefix bloom filters
 		if (is_read (transaction_a))
 		{
 			auto read_options = snapshot_options (transaction_a);
 			read_options.fill_cache = false;
+			read_options.total_order_seek = true;
 			cursor.reset (db->NewIterator (read_options, handle_a));
 		}
 		else
 		{
 			rocksdb::ReadOptions ropts;
 			ropts.fill_cache = false;
+			ropts.total_order_seek = true;
 			cursor.reset (tx (transaction_a)->GetIterator (ropts, handle_a));
 		}
 
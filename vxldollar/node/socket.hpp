@@ -6,6 +6,7 @@
 
 #include <boost/optional.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
 #include <map>
@@ -81,6 +82,11 @@ public:
 	{
 		return queue_size >= queue_size_max * 2;
 	}
+	/** Fraction of the write queue in use, 1 when full () */
+	double queue_occupancy () const
+	{
+		return std::min (1.0, static_cast<double> (queue_size) / (queue_size_max * 2));
+	}
 	type_t type () const
 	{
 		return type_m;
@@ -44,10 +44,12 @@ void vxldollar::transport::channel_tcp::send_buffer (vxldollar::shared_const_buf
 {
 	if (auto socket_l = socket.lock ())
 	{
+		health->queue_sample (socket_l->queue_occupancy ());
 		if (!socket_l->max () || (policy_a == vxldollar::buffer_drop_policy::no_socket_drop && !socket_l->full ()))
 		{
 			socket_l->async_write (
-			buffer_a, [endpoint_a = socket_l->remote_endpoint (), node = std::weak_ptr<vxldollar::node> (node.shared ()), callback_a] (boost::system::error_code const & ec, std::size_t size_a) {
+			buffer_a, [endpoint_a = socket_l->remote_endpoint (), node = std::weak_ptr<vxldollar::node> (node.shared ()), health_l = health, callback_a] (boost::system::error_code const & ec, std::size_t size_a) {
+				health_l->send_sample (static_cast<bool> (ec));
 				if (auto node_l = node.lock ())
 				{
 					if (!ec)
@@ -67,6 +69,7 @@ void vxldollar::transport::channel_tcp::send_buffer (vxldollar::shared_const_buf
 		}
 		else
 		{
+			health->send_sample (true);
 			if (policy_a == vxldollar::buffer_drop_policy::no_socket_drop)
 			{
 				node.stats.inc (vxldollar::stat::type::tcp, vxldollar::stat::detail::tcp_write_no_socket_drop, vxldollar::stat::dir::out);
@@ -130,6 +133,7 @@ bool vxldollar::transport::tcp_channels::insert (std::shared_ptr<vxldollar::tran
 			}
 			channels.get<endpoint_tag> ().emplace (channel_a, socket_a, bootstrap_server_a);
 			attempts.get<endpoint_tag> ().erase (endpoint);
+			publish_snapshot ();
 			error = false;
 			lock.unlock ();
 			node.network.channel_observer (channel_a);
@@ -145,23 +149,25 @@ bool vxldollar::transport::tcp_channels::insert (std::shared_ptr<vxldollar::tran
 void vxldollar::transport::tcp_channels::erase (vxldollar::tcp_endpoint const & endpoint_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	channels.get<endpoint_tag> ().erase (endpoint_a);
+	if (channels.get<endpoint_tag> ().erase (endpoint_a) > 0)
+	{
+		publish_snapshot ();
+	}
 }
 
 std::size_t vxldollar::transport::tcp_channels::size () const
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	return channels.size ();
+	return load_snapshot ()->channels.size ();
 }
 
 std::shared_ptr<vxldollar::transport::channel_tcp> vxldollar::transport::tcp_channels::find_channel (vxldollar::tcp_endpoint const & endpoint_a) const
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
 	std::shared_ptr<vxldollar::transport::channel_tcp> result;
-	auto existing (channels.get<endpoint_tag> ().find (endpoint_a));
-	if (existing != channels.get<endpoint_tag> ().end ())
+	auto snapshot_l (load_snapshot ());
+	auto existing (snapshot_l->endpoints.find (endpoint_a));
+	if (existing != snapshot_l->endpoints.end ())
 	{
-		result = existing->channel;
+		result = existing->second;
 	}
 	return result;
 }
@@ -170,19 +176,20 @@ std::unordered_set<std::shared_ptr<vxldollar::transport::channel>> vxldollar::tr
 {
 	std::unordered_set<std::shared_ptr<vxldollar::transport::channel>> result;
 	result.reserve (count_a);
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+	auto snapshot_l (load_snapshot ());
+	auto const & channels_l (snapshot_l->channels);
 	// Stop trying to fill result with random samples after this many attempts
 	auto random_cutoff (count_a * 2);
-	auto peers_size (channels.size ());
+	auto peers_size (channels_l.size ());
 	// Usually count_a will be much smaller than peers.size()
 	// Otherwise make sure we have a cutoff on attempting to randomly fill
-	if (!channels.empty ())
+	if (!channels_l.empty ())
 	{
 		for (auto i (0); i < random_cutoff && result.size () < count_a; ++i)
 		{
 			auto index (vxldollar::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (peers_size - 1)));
 
-			auto channel = channels.get<random_access_tag> ()[index].channel;
+			auto const & channel (channels_l[index]);
 			if (channel->get_network_version () >= min_version && (include_temporary_channels_a || !channel->temporary))
 			{
 				result.insert (channel);
@@ -240,11 +247,11 @@ bool vxldollar::transport::tcp_channels::store_all (bool clear_peers)
 std::shared_ptr<vxldollar::transport::channel_tcp> vxldollar::transport::tcp_channels::find_node_id (vxldollar::account const & node_id_a)
 {
 	std::shared_ptr<vxldollar::transport::channel_tcp> result;
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	auto existing (channels.get<node_id_tag> ().find (node_id_a));
-	if (existing != channels.get<node_id_tag> ().end ())
+	auto snapshot_l (load_snapshot ());
+	auto existing (snapshot_l->node_ids.find (node_id_a));
+	if (existing != snapshot_l->node_ids.end ())
 	{
-		result = existing->channel;
+		result = existing->second;
 	}
 	return result;
 }
@@ -278,6 +285,7 @@ void vxldollar::transport::tcp_channels::process_messages ()
 		auto item (node.network.tcp_message_manager.get_message ());
 		if (item.message != nullptr)
 		{
+			node.stats.update_latency (vxldollar::message_type_to_stat_detail (item.message->header.type), vxldollar::stat::latency_stage::queue, std::chrono::steady_clock::now () - item.received);
 			process_message (*item.message, item.endpoint, item.node_id, item.socket);
 		}
 	}
@@ -326,12 +334,20 @@ void vxldollar::transport::tcp_channels::process_message (vxldollar::message con
 					node.stats.inc (vxldollar::stat::type::message, vxldollar::stat::detail::node_id_handshake, vxldollar::stat::dir::in);
 				}
 			}
+			else
+			{
+				node.network.clear_filters (message_a);
+			}
 		}
 		if (channel)
 		{
 			channel->set_last_packet_received (std::chrono::steady_clock::now ());
 		}
 	}
+	else
+	{
+		node.network.clear_filters (message_a);
+	}
 }
 
 void vxldollar::transport::tcp_channels::start ()
@@ -357,6 +373,7 @@ void vxldollar::transport::tcp_channels::stop ()
 		}
 	}
 	channels.clear ();
+	publish_snapshot ();
 }
 
 bool vxldollar::transport::tcp_channels::max_ip_connections (vxldollar::tcp_endpoint const & endpoint_a)
@@ -443,6 +460,7 @@ std::unique_ptr<vxldollar::container_info_component> vxldollar::transport::tcp_c
 void vxldollar::transport::tcp_channels::purge (std::chrono::steady_clock::time_point const & cutoff_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+	auto const channels_count (channels.size ());
 	auto disconnect_cutoff (channels.get<last_packet_sent_tag> ().lower_bound (cutoff_a));
 	channels.get<last_packet_sent_tag> ().erase (channels.get<last_packet_sent_tag> ().begin (), disconnect_cutoff);
 	// Remove keepalive attempt tracking for attempts older than cutoff
@@ -452,6 +470,10 @@ void vxldollar::transport::tcp_channels::purge (std::chrono::steady_clock::time_
 	// Check if any tcp channels belonging to old protocol versions which may still be alive due to async operations
 	auto lower_bound = channels.get<version_tag> ().lower_bound (node.network_params.network.protocol_version_min);
 	channels.get<version_tag> ().erase (channels.get<version_tag> ().begin (), lower_bound);
+	if (channels.size () != channels_count)
+	{
+		publish_snapshot ();
+	}
 }
 
 void vxldollar::transport::tcp_channels::ongoing_keepalive ()
@@ -499,11 +521,11 @@ void vxldollar::transport::tcp_channels::ongoing_keepalive ()
 
 void vxldollar::transport::tcp_channels::list (std::deque<std::shared_ptr<vxldollar::transport::channel>> & deque_a, uint8_t minimum_version_a, bool include_temporary_channels_a)
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+	auto snapshot_l (load_snapshot ());
 	// clang-format off
-	vxldollar::transform_if (channels.get<random_access_tag> ().begin (), channels.get<random_access_tag> ().end (), std::back_inserter (deque_a),
-		[include_temporary_channels_a, minimum_version_a](auto & channel_a) { return channel_a.channel->get_network_version () >= minimum_version_a && (include_temporary_channels_a || !channel_a.channel->temporary); },
-		[](auto const & channel) { return channel.channel; });
+	vxldollar::transform_if (snapshot_l->channels.begin (), snapshot_l->channels.end (), std::back_inserter (deque_a),
+		[include_temporary_channels_a, minimum_version_a](auto const & channel_a) { return channel_a->get_network_version () >= minimum_version_a && (include_temporary_channels_a || !channel_a->temporary); },
+		[](auto const & channel_a) { return channel_a; });
 	// clang-format on
 }
 
@@ -513,10 +535,41 @@ void vxldollar::transport::tcp_channels::modify (std::shared_ptr<vxldollar::tran
 	auto existing (channels.get<endpoint_tag> ().find (channel_a->get_tcp_endpoint ()));
 	if (existing != channels.get<endpoint_tag> ().end ())
 	{
+		auto node_id (existing->channel->get_node_id ());
 		channels.get<endpoint_tag> ().modify (existing, [modify_callback = std::move (modify_callback_a)] (channel_tcp_wrapper & wrapper_a) {
 			modify_callback (wrapper_a.channel);
 		});
+		// Only the node ID index of the snapshot can be affected by a modification
+		if (existing->channel->get_node_id () != node_id)
+		{
+			publish_snapshot ();
+		}
+	}
+}
+
+void vxldollar::transport::tcp_channels::publish_snapshot ()
+{
+	debug_assert (!mutex.try_lock ());
+	auto snapshot_l (std::make_shared<snapshot_t> ());
+	snapshot_l->channels.reserve (channels.size ());
+	snapshot_l->endpoints.reserve (channels.size ());
+	for (auto const & wrapper : channels.get<random_access_tag> ())
+	{
+		snapshot_l->channels.push_back (wrapper.channel);
+		snapshot_l->endpoints.emplace (wrapper.endpoint (), wrapper.channel);
+		// Prefer permanent channels when a node ID is shared with temporary ones
+		auto [existing, inserted] = snapshot_l->node_ids.emplace (wrapper.node_id (), wrapper.channel);
+		if (!inserted && existing->second->temporary && !wrapper.channel->temporary)
+		{
+			existing->second = wrapper.channel;
+		}
 	}
+	std::atomic_store (&snapshot, std::shared_ptr<snapshot_t const> (std::move (snapshot_l)));
+}
+
+std::shared_ptr<vxldollar::transport::tcp_channels::snapshot_t const> vxldollar::transport::tcp_channels::load_snapshot () const
+{
+	return std::atomic_load (&snapshot);
 }
 
 void vxldollar::transport::tcp_channels::update (vxldollar::tcp_endpoint const & endpoint_a)
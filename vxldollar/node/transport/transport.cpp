@@ -7,10 +7,20 @@
 #include <boost/asio/ip/address_v6.hpp>
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 namespace
 {
+/** Moves an exponentially weighted moving average towards \p sample_a */
+void update_average (std::atomic<double> & average_a, double sample_a, double weight_a)
+{
+	auto current (average_a.load (std::memory_order_relaxed));
+	while (!average_a.compare_exchange_weak (current, current + weight_a * (sample_a - current), std::memory_order_relaxed))
+	{
+	}
+}
+
 class callback_visitor : public vxldollar::message_visitor
 {
 public:
@@ -97,6 +107,54 @@ boost::asio::ip::address vxldollar::transport::ipv4_address_or_ipv6_subnet (boos
 	return address_a.to_v6 ().is_v4_mapped () ? address_a : boost::asio::ip::make_network_v6 (address_a.to_v6 (), ipv6_address_prefix_length).network ();
 }
 
+void vxldollar::transport::channel_health::rtt_sample (std::chrono::microseconds const & rtt_a)
+{
+	auto sample (static_cast<double> (std::max<std::chrono::microseconds::rep> (rtt_a.count (), 1)));
+	// The first sample replaces the unknown value, later ones are smoothed like TCP's SRTT
+	auto current (rtt_m.load (std::memory_order_relaxed));
+	if (current != 0.0 || !rtt_m.compare_exchange_strong (current, sample, std::memory_order_relaxed))
+	{
+		update_average (rtt_m, sample, 1.0 / 8);
+	}
+}
+
+void vxldollar::transport::channel_health::queue_sample (double occupancy_a)
+{
+	update_average (queue_occupancy_m, std::clamp (occupancy_a, 0.0, 1.0), 1.0 / 16);
+}
+
+void vxldollar::transport::channel_health::send_sample (bool dropped_a)
+{
+	update_average (drop_rate_m, dropped_a ? 1.0 : 0.0, 1.0 / 32);
+}
+
+std::chrono::microseconds vxldollar::transport::channel_health::rtt () const
+{
+	return std::chrono::microseconds (static_cast<std::chrono::microseconds::rep> (rtt_m.load (std::memory_order_relaxed)));
+}
+
+double vxldollar::transport::channel_health::queue_occupancy () const
+{
+	return queue_occupancy_m.load (std::memory_order_relaxed);
+}
+
+double vxldollar::transport::channel_health::drop_rate () const
+{
+	return drop_rate_m.load (std::memory_order_relaxed);
+}
+
+double vxldollar::transport::channel_health::score () const
+{
+	auto result ((1.0 - drop_rate ()) * (1.0 - queue_occupancy () / 2));
+	auto rtt_l (rtt_m.load (std::memory_order_relaxed));
+	if (rtt_l > 0.0)
+	{
+		double const reference (std::chrono::duration_cast<std::chrono::microseconds> (rtt_reference).count ());
+		result *= reference / (reference + rtt_l);
+	}
+	return std::max (result, min_score);
+}
+
 vxldollar::transport::channel::channel (vxldollar::node & node_a) :
 	node (node_a)
 {
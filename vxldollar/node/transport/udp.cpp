@@ -36,7 +36,8 @@ bool vxldollar::transport::channel_udp::operator== (vxldollar::transport::channe
 void vxldollar::transport::channel_udp::send_buffer (vxldollar::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, std::size_t)> const & callback_a, vxldollar::buffer_drop_policy drop_policy_a)
 {
 	set_last_packet_sent (std::chrono::steady_clock::now ());
-	channels.send (buffer_a, endpoint, [node = std::weak_ptr<vxldollar::node> (channels.node.shared ()), callback_a] (boost::system::error_code const & ec, std::size_t size_a) {
+	channels.send (buffer_a, endpoint, [node = std::weak_ptr<vxldollar::node> (channels.node.shared ()), health_l = health, callback_a] (boost::system::error_code const & ec, std::size_t size_a) {
+		health_l->send_sample (static_cast<bool> (ec));
 		if (auto node_l = node.lock ())
 		{
 			if (ec == boost::system::errc::host_unreachable)
@@ -113,6 +114,7 @@ std::shared_ptr<vxldollar::transport::channel_udp> vxldollar::transport::udp_cha
 			result = std::make_shared<vxldollar::transport::channel_udp> (*this, endpoint_a, network_version_a);
 			channels.get<endpoint_tag> ().insert (channel_udp_wrapper{ result });
 			attempts.get<endpoint_tag> ().erase (endpoint_a);
+			publish_snapshot ();
 			lock.unlock ();
 			node.network.channel_observer (result);
 		}
@@ -123,23 +125,25 @@ std::shared_ptr<vxldollar::transport::channel_udp> vxldollar::transport::udp_cha
 void vxldollar::transport::udp_channels::erase (vxldollar::endpoint const & endpoint_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	channels.get<endpoint_tag> ().erase (endpoint_a);
+	if (channels.get<endpoint_tag> ().erase (endpoint_a) > 0)
+	{
+		publish_snapshot ();
+	}
 }
 
 std::size_t vxldollar::transport::udp_channels::size () const
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	return channels.size ();
+	return load_snapshot ()->channels.size ();
 }
 
 std::shared_ptr<vxldollar::transport::channel_udp> vxldollar::transport::udp_channels::channel (vxldollar::endpoint const & endpoint_a) const
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
 	std::shared_ptr<vxldollar::transport::channel_udp> result;
-	auto existing (channels.get<endpoint_tag> ().find (endpoint_a));
-	if (existing != channels.get<endpoint_tag> ().end ())
+	auto snapshot_l (load_snapshot ());
+	auto existing (snapshot_l->endpoints.find (endpoint_a));
+	if (existing != snapshot_l->endpoints.end ())
 	{
-		result = existing->channel;
+		result = existing->second;
 	}
 	return result;
 }
@@ -148,18 +152,19 @@ std::unordered_set<std::shared_ptr<vxldollar::transport::channel>> vxldollar::tr
 {
 	std::unordered_set<std::shared_ptr<vxldollar::transport::channel>> result;
 	result.reserve (count_a);
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+	auto snapshot_l (load_snapshot ());
+	auto const & channels_l (snapshot_l->channels);
 	// Stop trying to fill result with random samples after this many attempts
 	auto random_cutoff (count_a * 2);
-	auto peers_size (channels.size ());
+	auto peers_size (channels_l.size ());
 	// Usually count_a will be much smaller than peers.size()
 	// Otherwise make sure we have a cutoff on attempting to randomly fill
-	if (!channels.empty ())
+	if (!channels_l.empty ())
 	{
 		for (auto i (0); i < random_cutoff && result.size () < count_a; ++i)
 		{
 			auto index (vxldollar::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (peers_size - 1)));
-			auto channel = channels.get<random_access_tag> ()[index].channel;
+			auto const & channel (channels_l[index]);
 			if (channel->get_network_version () >= min_version)
 			{
 				result.insert (channel);
@@ -218,11 +223,11 @@ bool vxldollar::transport::udp_channels::store_all (bool clear_peers)
 std::shared_ptr<vxldollar::transport::channel_udp> vxldollar::transport::udp_channels::find_node_id (vxldollar::account const & node_id_a)
 {
 	std::shared_ptr<vxldollar::transport::channel_udp> result;
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	auto existing (channels.get<node_id_tag> ().find (node_id_a));
-	if (existing != channels.get<node_id_tag> ().end ())
+	auto snapshot_l (load_snapshot ());
+	auto existing (snapshot_l->node_ids.find (node_id_a));
+	if (existing != snapshot_l->node_ids.end ())
 	{
-		result = existing->channel;
+		result = existing->second;
 	}
 	return result;
 }
@@ -230,7 +235,10 @@ std::shared_ptr<vxldollar::transport::channel_udp> vxldollar::transport::udp_cha
 void vxldollar::transport::udp_channels::clean_node_id (vxldollar::account const & node_id_a)
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	channels.get<node_id_tag> ().erase (node_id_a);
+	if (channels.get<node_id_tag> ().erase (node_id_a) > 0)
+	{
+		publish_snapshot ();
+	}
 }
 
 void vxldollar::transport::udp_channels::clean_node_id (vxldollar::endpoint const & endpoint_a, vxldollar::account const & node_id_a)
@@ -243,6 +251,7 @@ void vxldollar::transport::udp_channels::clean_node_id (vxldollar::endpoint cons
 		if (record.endpoint ().address () == endpoint_a.address () && record.endpoint ().port () != endpoint_a.port ())
 		{
 			channels.get<endpoint_tag> ().erase (record.endpoint ());
+			publish_snapshot ();
 			break;
 		}
 	}
@@ -288,6 +297,7 @@ void vxldollar::transport::udp_channels::receive ()
 			if (!error && !this->stopped)
 			{
 				data->size = size_a;
+				data->received = std::chrono::steady_clock::now ();
 				this->node.network.buffer_container.enqueue (data);
 				this->receive ();
 			}
@@ -516,6 +526,10 @@ public:
 			});
 			sink (message_a, find_channel);
 		}
+		else
+		{
+			node.network.clear_filters (message_a);
+		}
 	}
 	vxldollar::node & node;
 	vxldollar::endpoint endpoint;
@@ -540,17 +554,33 @@ void vxldollar::transport::udp_channels::receive_action (vxldollar::message_buff
 	}
 	if (allowed_sender)
 	{
+		auto const dequeued (std::chrono::steady_clock::now ());
 		udp_message_visitor visitor (node, data_a->endpoint, sink);
-		vxldollar::message_parser parser (node.network.publish_filter, node.block_uniquer, node.vote_uniquer, visitor, node.work, node.network_params.network);
+		// Votes of peers queried by the rep crawler are not filtered, a reply may repeat a vote received before the query
+		auto vote_filter (node.rep_crawler.is_queried (data_a->endpoint.address ()) ? nullptr : &node.network.vote_filter);
+		vxldollar::message_parser parser (node.network.publish_filter, node.block_uniquer, node.vote_uniquer, visitor, node.work, node.network_params.network, vote_filter, &node.network.confirm_req_filter, std::hash<vxldollar::endpoint> () (data_a->endpoint));
 		parser.deserialize_buffer (data_a->buffer, data_a->size);
 		if (parser.status == vxldollar::message_parser::parse_status::success)
 		{
 			node.stats.add (vxldollar::stat::type::traffic_udp, vxldollar::stat::dir::in, data_a->size);
+			vxldollar::bufferstream header_stream (data_a->buffer, data_a->size);
+			auto error (false);
+			vxldollar::message_header header (error, header_stream);
+			debug_assert (!error);
+			node.stats.update_latency (vxldollar::message_type_to_stat_detail (header.type), vxldollar::stat::latency_stage::queue, dequeued - data_a->received);
 		}
 		else if (parser.status == vxldollar::message_parser::parse_status::duplicate_publish_message)
 		{
 			node.stats.inc (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_publish);
 		}
+		else if (parser.status == vxldollar::message_parser::parse_status::duplicate_confirm_req_message)
+		{
+			node.stats.inc (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_confirm_req);
+		}
+		else if (parser.status == vxldollar::message_parser::parse_status::duplicate_confirm_ack_message)
+		{
+			node.stats.inc (vxldollar::stat::type::filter, vxldollar::stat::detail::duplicate_confirm_ack);
+		}
 		else
 		{
 			node.stats.inc (vxldollar::stat::type::error);
@@ -592,6 +622,8 @@ void vxldollar::transport::udp_channels::receive_action (vxldollar::message_buff
 					node.stats.inc (vxldollar::stat::type::udp, vxldollar::stat::detail::outdated_version);
 					break;
 				case vxldollar::message_parser::parse_status::duplicate_publish_message:
+				case vxldollar::message_parser::parse_status::duplicate_confirm_req_message:
+				case vxldollar::message_parser::parse_status::duplicate_confirm_ack_message:
 				case vxldollar::message_parser::parse_status::success:
 					/* Already checked, unreachable */
 					break;
@@ -702,7 +734,11 @@ void vxldollar::transport::udp_channels::purge (std::chrono::steady_clock::time_
 {
 	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
 	auto disconnect_cutoff (channels.get<last_packet_received_tag> ().lower_bound (cutoff_a));
-	channels.get<last_packet_received_tag> ().erase (channels.get<last_packet_received_tag> ().begin (), disconnect_cutoff);
+	if (disconnect_cutoff != channels.get<last_packet_received_tag> ().begin ())
+	{
+		channels.get<last_packet_received_tag> ().erase (channels.get<last_packet_received_tag> ().begin (), disconnect_cutoff);
+		publish_snapshot ();
+	}
 	// Remove keepalive attempt tracking for attempts older than cutoff
 	auto attempts_cutoff (attempts.get<last_attempt_tag> ().lower_bound (cutoff_a));
 	attempts.get<last_attempt_tag> ().erase (attempts.get<last_attempt_tag> ().begin (), attempts_cutoff);
@@ -735,11 +771,11 @@ void vxldollar::transport::udp_channels::ongoing_keepalive ()
 
 void vxldollar::transport::udp_channels::list (std::deque<std::shared_ptr<vxldollar::transport::channel>> & deque_a, uint8_t minimum_version_a)
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
+	auto snapshot_l (load_snapshot ());
 	// clang-format off
-	vxldollar::transform_if (channels.get<random_access_tag> ().begin (), channels.get<random_access_tag> ().end (), std::back_inserter (deque_a),
-		[minimum_version_a](auto & channel_a) { return channel_a.channel->get_network_version () >= minimum_version_a; },
-		[](auto const & channel) { return channel.channel; });
+	vxldollar::transform_if (snapshot_l->channels.begin (), snapshot_l->channels.end (), std::back_inserter (deque_a),
+		[minimum_version_a](auto const & channel_a) { return channel_a->get_network_version () >= minimum_version_a; },
+		[](auto const & channel_a) { return channel_a; });
 	// clang-format on
 }
 
@@ -749,8 +785,34 @@ void vxldollar::transport::udp_channels::modify (std::shared_ptr<vxldollar::tran
 	auto existing (channels.get<endpoint_tag> ().find (channel_a->endpoint));
 	if (existing != channels.get<endpoint_tag> ().end ())
 	{
+		auto node_id (existing->channel->get_node_id ());
 		channels.get<endpoint_tag> ().modify (existing, [modify_callback_a] (channel_udp_wrapper & wrapper_a) {
 			modify_callback_a (wrapper_a.channel);
 		});
+		// Most modifications only touch packet times, republish when the node ID index changes
+		if (existing->channel->get_node_id () != node_id)
+		{
+			publish_snapshot ();
+		}
+	}
+}
+
+void vxldollar::transport::udp_channels::publish_snapshot ()
+{
+	debug_assert (!mutex.try_lock ());
+	auto snapshot_l (std::make_shared<snapshot_t> ());
+	snapshot_l->channels.reserve (channels.size ());
+	snapshot_l->endpoints.reserve (channels.size ());
+	for (auto const & wrapper : channels.get<random_access_tag> ())
+	{
+		snapshot_l->channels.push_back (wrapper.channel);
+		snapshot_l->endpoints.emplace (wrapper.endpoint (), wrapper.channel);
+		snapshot_l->node_ids.emplace (wrapper.node_id (), wrapper.channel);
 	}
+	std::atomic_store (&snapshot, std::shared_ptr<snapshot_t const> (std::move (snapshot_l)));
+}
+
+std::shared_ptr<vxldollar::transport::udp_channels::snapshot_t const> vxldollar::transport::udp_channels::load_snapshot () const
+{
+	return std::atomic_load (&snapshot);
 }
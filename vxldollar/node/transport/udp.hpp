@@ -217,6 +217,11 @@ namespace transport
 				mi::member<endpoint_attempt, std::chrono::steady_clock::time_point, &endpoint_attempt::last_attempt>>>>
 		attempts;
 		// clang-format on
+		using snapshot_t = vxldollar::transport::channel_snapshot<vxldollar::transport::channel_udp, vxldollar::endpoint>;
+		/** Rebuilds and publishes the snapshot of \p channels, must be called with \p mutex held */
+		void publish_snapshot ();
+		std::shared_ptr<snapshot_t const> load_snapshot () const;
+		std::shared_ptr<snapshot_t const> snapshot{ std::make_shared<snapshot_t> () };
 		boost::asio::strand<boost::asio::io_context::executor_type> strand;
 		std::unique_ptr<boost::asio::ip::udp::socket> socket;
 		vxldollar::endpoint local_endpoint;
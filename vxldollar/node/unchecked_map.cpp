@@ -1,12 +1,67 @@
 #include <vxldollar/lib/locks.hpp>
 #include <vxldollar/lib/threading.hpp>
 #include <vxldollar/lib/timer.hpp>
+#include <vxldollar/lib/utility.hpp>
 #include <vxldollar/node/unchecked_map.hpp>
 #include <vxldollar/secure/store.hpp>
 
 #include <boost/range/join.hpp>
+#include <boost/variant/get.hpp>
 
-vxldollar::unchecked_map::unchecked_map (vxldollar::store & store, bool const & disable_delete) :
+/** Iterates a snapshot of the entries kept in memory, so callers can use the store iterator interface without holding the map lock */
+class vxldollar::unchecked_map::memory_iterator final : public vxldollar::store_iterator_impl<vxldollar::unchecked_key, vxldollar::unchecked_info>
+{
+public:
+	using values_t = std::vector<std::pair<vxldollar::unchecked_key, vxldollar::unchecked_info>>;
+	explicit memory_iterator (std::shared_ptr<values_t const> values_a) :
+		values{ std::move (values_a) }
+	{
+	}
+	vxldollar::store_iterator_impl<vxldollar::unchecked_key, vxldollar::unchecked_info> & operator++ () override
+	{
+		if (!is_end_sentinal ())
+		{
+			++index;
+		}
+		return *this;
+	}
+	vxldollar::store_iterator_impl<vxldollar::unchecked_key, vxldollar::unchecked_info> & operator-- () override
+	{
+		if (index > 0)
+		{
+			--index;
+		}
+		return *this;
+	}
+	bool operator== (vxldollar::store_iterator_impl<vxldollar::unchecked_key, vxldollar::unchecked_info> const & other_a) const override
+	{
+		auto other_l (dynamic_cast<memory_iterator const *> (&other_a));
+		return other_l != nullptr && ((is_end_sentinal () && other_l->is_end_sentinal ()) || (values == other_l->values && index == other_l->index));
+	}
+	bool is_end_sentinal () const override
+	{
+		return index >= values->size ();
+	}
+	void fill (std::pair<vxldollar::unchecked_key, vxldollar::unchecked_info> & value_a) const override
+	{
+		if (!is_end_sentinal ())
+		{
+			value_a = (*values)[index];
+		}
+		else
+		{
+			value_a = {};
+		}
+	}
+
+private:
+	std::shared_ptr<values_t const> values;
+	std::size_t index{ 0 };
+};
+
+vxldollar::unchecked_map::unchecked_map (vxldollar::store & store, bool const & disable_delete, std::size_t memory_limit) :
+	memory{ memory_limit != 0 },
+	memory_limit{ memory_limit },
 	store{ store },
 	disable_delete{ disable_delete },
 	thread{ [this] () { run (); } }
@@ -21,6 +76,11 @@ vxldollar::unchecked_map::~unchecked_map ()
 
 void vxldollar::unchecked_map::put (vxldollar::hash_or_account const & dependency, vxldollar::unchecked_info const & info)
 {
+	if (memory)
+	{
+		memory_put (dependency, info);
+		return;
+	}
 	vxldollar::unique_lock<vxldollar::mutex> lock{ mutex };
 	buffer.push_back (std::make_pair (dependency, info));
 	lock.unlock ();
@@ -29,39 +89,111 @@ void vxldollar::unchecked_map::put (vxldollar::hash_or_account const & dependenc
 
 auto vxldollar::unchecked_map::equal_range (vxldollar::transaction const & transaction, vxldollar::block_hash const & dependency) -> std::pair<iterator, iterator>
 {
+	if (memory)
+	{
+		auto values (std::make_shared<memory_iterator::values_t> ());
+		{
+			vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+			auto [i, n] = entries.get<tag_dependency> ().equal_range (dependency);
+			for (; i != n; ++i)
+			{
+				values->emplace_back (i->key, i->info);
+			}
+		}
+		return std::make_pair (iterator{ std::make_unique<memory_iterator> (std::move (values)) }, iterator{ nullptr });
+	}
 	return store.unchecked.equal_range (transaction, dependency);
 }
 
 auto vxldollar::unchecked_map::full_range (vxldollar::transaction const & transaction) -> std::pair<iterator, iterator>
 {
+	if (memory)
+	{
+		auto values (std::make_shared<memory_iterator::values_t> ());
+		{
+			vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+			values->reserve (entries.size ());
+			for (auto const & entry : entries.get<tag_sequenced> ())
+			{
+				values->emplace_back (entry.key, entry.info);
+			}
+		}
+		return std::make_pair (iterator{ std::make_unique<memory_iterator> (std::move (values)) }, iterator{ nullptr });
+	}
 	return store.unchecked.full_range (transaction);
 }
 
 std::vector<vxldollar::unchecked_info> vxldollar::unchecked_map::get (vxldollar::transaction const & transaction, vxldollar::block_hash const & hash)
 {
+	if (memory)
+	{
+		std::vector<vxldollar::unchecked_info> result;
+		vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+		auto [i, n] = entries.get<tag_dependency> ().equal_range (hash);
+		for (; i != n; ++i)
+		{
+			result.push_back (i->info);
+		}
+		return result;
+	}
 	return store.unchecked.get (transaction, hash);
 }
 
 bool vxldollar::unchecked_map::exists (vxldollar::transaction const & transaction, vxldollar::unchecked_key const & key) const
 {
+	if (memory)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+		return entries.get<tag_id> ().count (vxldollar::uint512_union (key.previous, key.hash)) > 0;
+	}
 	return store.unchecked.exists (transaction, key);
 }
 
 void vxldollar::unchecked_map::del (vxldollar::write_transaction const & transaction, vxldollar::unchecked_key const & key)
 {
+	if (memory)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+		auto & by_id (entries.get<tag_id> ());
+		auto existing (by_id.find (vxldollar::uint512_union (key.previous, key.hash)));
+		if (existing != by_id.end ())
+		{
+			entries_size -= existing->size;
+			by_id.erase (existing);
+		}
+		return;
+	}
 	store.unchecked.del (transaction, key);
 }
 
 void vxldollar::unchecked_map::clear (vxldollar::write_transaction const & transaction)
 {
+	if (memory)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+		entries.clear ();
+		entries_size = 0;
+		return;
+	}
 	store.unchecked.clear (transaction);
 }
 
 size_t vxldollar::unchecked_map::count (vxldollar::transaction const & transaction) const
 {
+	if (memory)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+		return entries.size ();
+	}
 	return store.unchecked.count (transaction);
 }
 
+std::size_t vxldollar::unchecked_map::memory_size () const
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+	return entries_size;
+}
+
 void vxldollar::unchecked_map::stop ()
 {
 	vxldollar::unique_lock<vxldollar::mutex> lock{ mutex };
@@ -120,8 +252,72 @@ void vxldollar::unchecked_map::item_visitor::operator() (query const & item)
 	}
 }
 
+void vxldollar::unchecked_map::memory_put (vxldollar::hash_or_account const & dependency, vxldollar::unchecked_info const & info)
+{
+	entry entry_l{ vxldollar::unchecked_key{ dependency, info.block->hash () }, vxldollar::unchecked_info{ info.block, info.account, info.verified }, entry_size (info) };
+	vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+	auto & by_id (entries.get<tag_id> ());
+	auto existing (by_id.find (entry_l.id ()));
+	if (existing != by_id.end ())
+	{
+		entries_size -= existing->size;
+		by_id.erase (existing);
+	}
+	entries_size += entry_l.size;
+	entries.get<tag_sequenced> ().push_back (std::move (entry_l));
+	// Evict oldest entries first, they are the least likely to still be satisfied
+	auto & sequenced (entries.get<tag_sequenced> ());
+	while (entries_size > memory_limit && sequenced.size () > 1)
+	{
+		entries_size -= sequenced.front ().size;
+		sequenced.pop_front ();
+		++evicted;
+	}
+}
+
+void vxldollar::unchecked_map::memory_trigger (vxldollar::hash_or_account const & dependency)
+{
+	std::vector<vxldollar::unchecked_info> satisfied_l;
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ entries_mutex };
+		auto & by_dependency (entries.get<tag_dependency> ());
+		auto [i, n] = by_dependency.equal_range (dependency.hash);
+		for (auto j (i); j != n; ++j)
+		{
+			satisfied_l.push_back (j->info);
+		}
+		if (!disable_delete)
+		{
+			for (auto j (i); j != n; ++j)
+			{
+				entries_size -= j->size;
+			}
+			by_dependency.erase (i, n);
+		}
+	}
+	for (auto const & info : satisfied_l)
+	{
+		satisfied (info);
+	}
+}
+
+std::size_t vxldollar::unchecked_map::entry_size (vxldollar::unchecked_info const & info)
+{
+	// Entry, the block object with its shared_ptr control block and one node in each of the three indices
+	return sizeof (entry) + vxldollar::block::size (info.block->type ()) + sizeof (vxldollar::block_sideband) + 2 * sizeof (void *) + 3 * 2 * sizeof (void *);
+}
+
 void vxldollar::unchecked_map::write_buffer (decltype (buffer) const & back_buffer)
 {
+	if (memory)
+	{
+		// Only queries are buffered when entries are kept in memory, satisfied callbacks are made from this thread as with the store
+		for (auto const & item : back_buffer)
+		{
+			memory_trigger (boost::get<query> (item));
+		}
+		return;
+	}
 	auto transaction = store.tx_begin_write ();
 	item_visitor visitor{ *this, transaction };
 	for (auto const & item : back_buffer)
@@ -155,3 +351,21 @@ void vxldollar::unchecked_map::run ()
 		}
 	}
 }
+
+std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_container_info (unchecked_map & unchecked, std::string const & name)
+{
+	std::size_t buffer_count;
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ unchecked.mutex };
+		buffer_count = unchecked.buffer.size ();
+	}
+	std::size_t entries_count;
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard{ unchecked.entries_mutex };
+		entries_count = unchecked.entries.size ();
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "buffer", buffer_count, sizeof (decltype (unchecked.buffer)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "entries", entries_count, sizeof (decltype (unchecked.entries)::value_type) }));
+	return composite;
+}
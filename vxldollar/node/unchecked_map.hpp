@@ -4,24 +4,37 @@
 #include <vxldollar/lib/numbers.hpp>
 #include <vxldollar/secure/store.hpp>
 
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
 #include <atomic>
 #include <thread>
 #include <unordered_map>
 
+namespace mi = boost::multi_index;
+
 namespace vxldollar
 {
+class container_info_component;
 class store;
 class transaction;
 class unchecked_info;
 class unchecked_key;
 class write_transaction;
+/**
+ * Blocks waiting for a dependency, keyed by the dependency and the block hash
+ * By default entries are written to the unchecked table by a background thread. With a non-zero \p memory_limit entries are only kept in memory,
+ * indexed by dependency, and the oldest entries are evicted once their estimated size exceeds the limit. Transactions passed to a memory backed map are unused.
+ */
 class unchecked_map
 {
 public:
 	using iterator = vxldollar::unchecked_store::iterator;
 
 public:
-	unchecked_map (vxldollar::store & store, bool const & do_delete);
+	unchecked_map (vxldollar::store & store, bool const & do_delete, std::size_t memory_limit = 0);
 	~unchecked_map ();
 	void put (vxldollar::hash_or_account const & dependency, vxldollar::unchecked_info const & info);
 	std::pair<iterator, iterator> equal_range (vxldollar::transaction const & transaction, vxldollar::block_hash const & dependency);
@@ -33,6 +46,12 @@ public:
 	size_t count (vxldollar::transaction const & transaction) const;
 	void stop ();
 	void flush ();
+	/** Estimated size in bytes of the entries kept in memory */
+	std::size_t memory_size () const;
+	bool const memory;
+	std::size_t const memory_limit;
+	/** Number of entries dropped to stay within memory_limit */
+	std::atomic<uint64_t> evicted{ 0 };
 
 public: // Trigger requested dependencies
 	void trigger (vxldollar::hash_or_account const & dependency);
@@ -50,6 +69,43 @@ private:
 		unchecked_map & unchecked;
 		vxldollar::write_transaction const & transaction;
 	};
+	class entry final
+	{
+	public:
+		vxldollar::unchecked_key key;
+		vxldollar::unchecked_info info;
+		std::size_t size;
+		vxldollar::block_hash dependency () const
+		{
+			return key.previous;
+		}
+		vxldollar::uint512_union id () const
+		{
+			return vxldollar::uint512_union (key.previous, key.hash);
+		}
+	};
+	class tag_sequenced
+	{
+	};
+	class tag_id
+	{
+	};
+	class tag_dependency
+	{
+	};
+	// clang-format off
+	using ordered_entries = boost::multi_index_container<entry,
+	mi::indexed_by<
+		mi::sequenced<mi::tag<tag_sequenced>>,
+		mi::hashed_unique<mi::tag<tag_id>,
+			mi::const_mem_fun<entry, vxldollar::uint512_union, &entry::id>>,
+		mi::hashed_non_unique<mi::tag<tag_dependency>,
+			mi::const_mem_fun<entry, vxldollar::block_hash, &entry::dependency>>>>;
+	// clang-format on
+	class memory_iterator;
+	void memory_put (vxldollar::hash_or_account const & dependency, vxldollar::unchecked_info const & info);
+	void memory_trigger (vxldollar::hash_or_account const & dependency);
+	static std::size_t entry_size (vxldollar::unchecked_info const & info);
 	void run ();
 	vxldollar::store & store;
 	bool const & disable_delete;
@@ -59,7 +115,14 @@ private:
 	bool stopped{ false };
 	vxldollar::condition_variable condition;
 	vxldollar::mutex mutex;
+	ordered_entries entries;
+	std::size_t entries_size{ 0 };
+	mutable vxldollar::mutex entries_mutex;
 	std::thread thread;
 	void write_buffer (decltype (buffer) const & back_buffer);
+
+	friend std::unique_ptr<container_info_component> collect_container_info (unchecked_map &, std::string const &);
 };
+
+std::unique_ptr<container_info_component> collect_container_info (unchecked_map & unchecked, std::string const & name);
 }
@@ -1,6 +1,7 @@
 #include <vxldollar/lib/config.hpp>
 #include <vxldollar/lib/utility.hpp>
 #include <vxldollar/node/write_database_queue.hpp>
+#include <vxldollar/secure/store.hpp>
 
 #include <algorithm>
 
@@ -65,6 +66,86 @@ vxldollar::write_database_queue::write_database_queue (bool use_noops_a) :
 {
 }
 
+vxldollar::write_database_queue::write_database_queue (bool use_noops_a, std::function<void ()> group_sync_a, vxldollar::stat & stats_a) :
+	write_database_queue (use_noops_a)
+{
+	if (!use_noops && group_sync_a)
+	{
+		group_sync = std::move (group_sync_a);
+		stats = &stats_a;
+		guard_finish_callback = [this] () { finish (); };
+	}
+}
+
+namespace
+{
+vxldollar::stat::detail to_stat_detail (vxldollar::writer writer_a)
+{
+	switch (writer_a)
+	{
+		case vxldollar::writer::confirmation_height:
+			return vxldollar::stat::detail::writer_confirmation_height;
+		case vxldollar::writer::process_batch:
+			return vxldollar::stat::detail::writer_process_batch;
+		case vxldollar::writer::pruning:
+			return vxldollar::stat::detail::writer_pruning;
+		case vxldollar::writer::testing:
+			return vxldollar::stat::detail::writer_testing;
+	}
+	debug_assert (false);
+	return vxldollar::stat::detail::all;
+}
+}
+
+vxldollar::write_guard vxldollar::write_database_queue::make_guard ()
+{
+	if (group_sync)
+	{
+		vxldollar::deferred_sync::set (true);
+	}
+	return write_guard (guard_finish_callback);
+}
+
+void vxldollar::write_database_queue::finish ()
+{
+	vxldollar::deferred_sync::set (false);
+	uint64_t ticket (0);
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (mutex);
+		stats->inc (vxldollar::stat::type::write_queue, to_stat_detail (queue.front ()));
+		queue.pop_front ();
+		// Writers commit before releasing the queue, so every ticket up to this one refers to a commit already made
+		ticket = ++written;
+	}
+	cv.notify_all ();
+	wait_group_sync (ticket);
+}
+
+void vxldollar::write_database_queue::wait_group_sync (uint64_t ticket_a)
+{
+	vxldollar::unique_lock<vxldollar::mutex> lock (mutex);
+	while (synced < ticket_a)
+	{
+		if (!syncing)
+		{
+			// Become the leader, flushing for everyone who released the queue so far
+			syncing = true;
+			auto const target (written);
+			lock.unlock ();
+			group_sync ();
+			stats->inc (vxldollar::stat::type::write_queue, vxldollar::stat::detail::group_sync);
+			lock.lock ();
+			synced = target;
+			syncing = false;
+			sync_condition.notify_all ();
+		}
+		else
+		{
+			sync_condition.wait (lock);
+		}
+	}
+}
+
 vxldollar::write_guard vxldollar::write_database_queue::wait (vxldollar::writer writer)
 {
 	if (use_noops)
@@ -85,7 +166,7 @@ vxldollar::write_guard vxldollar::write_database_queue::wait (vxldollar::writer
 		cv.wait (lk);
 	}
 
-	return write_guard (guard_finish_callback);
+	return make_guard ();
 }
 
 bool vxldollar::write_database_queue::contains (vxldollar::writer writer)
@@ -125,5 +206,5 @@ bool vxldollar::write_database_queue::process (vxldollar::writer writer)
 
 vxldollar::write_guard vxldollar::write_database_queue::pop ()
 {
-	return write_guard (guard_finish_callback);
+	return make_guard ();
 }
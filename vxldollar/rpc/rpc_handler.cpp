@@ -156,10 +156,12 @@ std::unordered_set<std::string> create_rpc_control_impls ()
 	set.emplace ("block_create");
 	set.emplace ("bootstrap_lazy");
 	set.emplace ("confirmation_height_currently_processing");
+	set.emplace ("database_instrumentation");
 	set.emplace ("database_txn_tracker");
 	set.emplace ("epoch_upgrade");
 	set.emplace ("keepalive");
 	set.emplace ("ledger");
+	set.emplace ("ledger_backup");
 	set.emplace ("node_id");
 	set.emplace ("password_change");
 	set.emplace ("receive");
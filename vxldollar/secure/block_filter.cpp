@@ -0,0 +1,108 @@
+#include <vxldollar/secure/block_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+vxldollar::block_filter::block_filter (uint64_t entries_a, double false_positive_rate_a, std::size_t max_memory_a) :
+	filter (counter_count (entries_a, false_positive_rate_a, max_memory_a)),
+	negative_cache (negative_cache_size),
+	insert_stamps (negative_cache_size)
+{
+}
+
+void vxldollar::block_filter::insert (vxldollar::block_hash const & hash_a)
+{
+	// Hashes are uniformly distributed, so any of their words serves as the filter key
+	filter.insert (hash_a.qwords[0]);
+	++entries;
+	// Incremented before negative_cache_used is read, so that a concurrent cache_absent either sees the new stamp or has its slot cleared below
+	insert_stamps[negative_cache_index (hash_a)].fetch_add (1);
+	// Populating the filter does not contend on the negative cache, which is empty until the first cache_absent
+	if (negative_cache_used)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (negative_cache_mutex);
+		auto & slot (negative_cache[negative_cache_index (hash_a)]);
+		if (slot == hash_a)
+		{
+			slot.clear ();
+		}
+	}
+}
+
+void vxldollar::block_filter::erase (vxldollar::block_hash const & hash_a)
+{
+	filter.erase (hash_a.qwords[0]);
+	--entries;
+}
+
+bool vxldollar::block_filter::may_contain (vxldollar::block_hash const & hash_a) const
+{
+	return filter.may_contain (hash_a.qwords[0]);
+}
+
+uint64_t vxldollar::block_filter::insert_stamp (vxldollar::block_hash const & hash_a) const
+{
+	return insert_stamps[negative_cache_index (hash_a)].load ();
+}
+
+void vxldollar::block_filter::cache_absent (vxldollar::block_hash const & hash_a, uint64_t insert_stamp_a)
+{
+	vxldollar::lock_guard<vxldollar::mutex> guard (negative_cache_mutex);
+	negative_cache_used = true;
+	auto const index (negative_cache_index (hash_a));
+	if (insert_stamps[index].load () == insert_stamp_a)
+	{
+		negative_cache[index] = hash_a;
+	}
+}
+
+bool vxldollar::block_filter::cached_absent (vxldollar::block_hash const & hash_a) const
+{
+	auto result (false);
+	if (negative_cache_used)
+	{
+		vxldollar::lock_guard<vxldollar::mutex> guard (negative_cache_mutex);
+		result = negative_cache[negative_cache_index (hash_a)] == hash_a;
+	}
+	return result;
+}
+
+double vxldollar::block_filter::false_positive_rate () const
+{
+	auto const hashes (static_cast<double> (vxldollar::counting_filter::hash_count));
+	auto const counters (static_cast<double> (filter.memory_size ()));
+	return std::pow (1.0 - std::exp (-hashes * static_cast<double> (entries.load ()) / counters), hashes);
+}
+
+std::size_t vxldollar::block_filter::memory_size () const
+{
+	return filter.memory_size () + negative_cache.size () * sizeof (decltype (negative_cache)::value_type) + insert_stamps.size () * sizeof (decltype (insert_stamps)::value_type);
+}
+
+uint64_t vxldollar::block_filter::size () const
+{
+	return entries;
+}
+
+double vxldollar::block_filter::counters_per_entry (double false_positive_rate_a)
+{
+	auto const hashes (static_cast<double> (vxldollar::counting_filter::hash_count));
+	return -hashes / std::log (1.0 - std::pow (false_positive_rate_a, 1.0 / hashes));
+}
+
+std::size_t vxldollar::block_filter::counter_count (uint64_t entries_a, double false_positive_rate_a, std::size_t max_memory_a)
+{
+	auto const wanted (static_cast<double> (std::max<uint64_t> (entries_a, 1)) * counters_per_entry (std::clamp (false_positive_rate_a, 1e-9, 0.5)));
+	// Counters are single bytes and their count a power of two, the smallest one reaching the wanted size is taken unless it exceeds the memory limit
+	std::size_t result (64);
+	while (result < wanted && result * 2 <= max_memory_a)
+	{
+		result *= 2;
+	}
+	return result;
+}
+
+std::size_t vxldollar::block_filter::negative_cache_index (vxldollar::block_hash const & hash_a) const
+{
+	return static_cast<std::size_t> (hash_a.qwords[1] % negative_cache.size ());
+}
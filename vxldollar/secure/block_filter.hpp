@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vxldollar/lib/counting_filter.hpp>
+#include <vxldollar/lib/locks.hpp>
+#include <vxldollar/lib/numbers.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace vxldollar
+{
+/**
+ * Answers most lookups of hashes which are neither blocks nor pruned blocks without reading the database
+ * The hashes in the blocks and pruned tables are held in a counting filter, which their stores update on every put and delete.
+ * Hashes which passed the filter but were not found are kept in a small negative cache until they are put.
+ * Misses are cached once their write transaction commits, each slot counts inserts so that a miss followed by a put in between is not cached.
+ */
+class block_filter final
+{
+public:
+	/** Sized for \p entries_a hashes at \p false_positive_rate_a, using at most \p max_memory_a bytes */
+	block_filter (uint64_t entries_a, double false_positive_rate_a, std::size_t max_memory_a);
+	void insert (vxldollar::block_hash const &);
+	/** @warning \p hash_a must have been inserted, erasing other hashes can cause false negatives */
+	void erase (vxldollar::block_hash const &);
+	/** @return false if \p hash_a is neither a block nor a pruned block, true if it may be */
+	bool may_contain (vxldollar::block_hash const &) const;
+	/** Read before a lookup of \p hash_a, changes whenever a hash sharing its negative cache slot is inserted */
+	uint64_t insert_stamp (vxldollar::block_hash const &) const;
+	/**
+	 * Remembers \p hash_a as neither a block nor a pruned block, unless a hash sharing its slot was inserted since \p insert_stamp_a was read.
+	 * @warning Only valid once the write transaction holding the blocks table in which the lookup ran has committed
+	 */
+	void cache_absent (vxldollar::block_hash const &, uint64_t insert_stamp_a);
+	bool cached_absent (vxldollar::block_hash const &) const;
+	/** Expected share of lookups of absent hashes which pass the filter, at the current number of hashes */
+	double false_positive_rate () const;
+	std::size_t memory_size () const;
+	uint64_t size () const;
+
+	static std::size_t constexpr negative_cache_size = 16 * 1024;
+
+private:
+	/** Counters per hash giving \p false_positive_rate_a with the hash functions of counting_filter */
+	static double counters_per_entry (double false_positive_rate_a);
+	static std::size_t counter_count (uint64_t entries_a, double false_positive_rate_a, std::size_t max_memory_a);
+	std::size_t negative_cache_index (vxldollar::block_hash const &) const;
+
+	vxldollar::counting_filter filter;
+	std::atomic<uint64_t> entries{ 0 };
+	/** Direct mapped, empty slots hold the zero hash which is never a block */
+	std::vector<vxldollar::block_hash> negative_cache;
+	std::vector<std::atomic<uint64_t>> insert_stamps;
+	std::atomic<bool> negative_cache_used{ false };
+	mutable vxldollar::mutex negative_cache_mutex;
+};
+}
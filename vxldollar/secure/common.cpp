@@ -201,6 +201,7 @@ vxldollar::bootstrap_constants::bootstrap_constants (vxldollar::network_constant
 	lazy_destinations_retry_limit = network_constants.is_dev_network () ? 1 : frontier_retry_limit / 4;
 	gap_cache_bootstrap_start_interval = network_constants.is_dev_network () ? std::chrono::milliseconds (5) : std::chrono::milliseconds (30 * 1000);
 	default_frontiers_age_seconds = network_constants.is_dev_network () ? 1 : 24 * 60 * 60; // 1 second for dev network, 24 hours for live/beta
+	priority_request_interval = network_constants.is_dev_network () ? std::chrono::milliseconds (50) : std::chrono::milliseconds (5 * 1000);
 }
 
 // Create a new random keypair
@@ -243,6 +244,17 @@ vxldollar::account_info::account_info (vxldollar::block_hash const & head_a, vxl
 {
 }
 
+void vxldollar::account_info::serialize (vxldollar::stream & stream_a) const
+{
+	vxldollar::write (stream_a, head.bytes);
+	vxldollar::write (stream_a, representative.bytes);
+	vxldollar::write (stream_a, open_block.bytes);
+	vxldollar::write (stream_a, balance.bytes);
+	vxldollar::write (stream_a, modified);
+	vxldollar::write (stream_a, block_count);
+	vxldollar::write (stream_a, epoch_m);
+}
+
 bool vxldollar::account_info::deserialize (vxldollar::stream & stream_a)
 {
 	auto error (false);
@@ -298,6 +310,13 @@ vxldollar::pending_info::pending_info (vxldollar::account const & source_a, vxld
 {
 }
 
+void vxldollar::pending_info::serialize (vxldollar::stream & stream_a) const
+{
+	vxldollar::write (stream_a, source.bytes);
+	vxldollar::write (stream_a, amount.bytes);
+	vxldollar::write (stream_a, epoch);
+}
+
 bool vxldollar::pending_info::deserialize (vxldollar::stream & stream_a)
 {
 	auto error (false);
@@ -331,6 +350,12 @@ vxldollar::pending_key::pending_key (vxldollar::account const & account_a, vxldo
 {
 }
 
+void vxldollar::pending_key::serialize (vxldollar::stream & stream_a) const
+{
+	vxldollar::write (stream_a, account.bytes);
+	vxldollar::write (stream_a, hash.bytes);
+}
+
 bool vxldollar::pending_key::deserialize (vxldollar::stream & stream_a)
 {
 	auto error (false);
@@ -419,6 +444,22 @@ uint16_t vxldollar::endpoint_key::port () const
 	return boost::endian::big_to_native (network_port);
 }
 
+vxldollar::account_height_key::account_height_key (vxldollar::account const & account_a, uint64_t height_a) :
+	account (account_a),
+	big_endian_height (boost::endian::native_to_big (height_a))
+{
+}
+
+vxldollar::account const & vxldollar::account_height_key::key () const
+{
+	return account;
+}
+
+uint64_t vxldollar::account_height_key::height () const
+{
+	return boost::endian::big_to_native (big_endian_height);
+}
+
 vxldollar::confirmation_height_info::confirmation_height_info (uint64_t confirmation_height_a, vxldollar::block_hash const & confirmed_frontier_a) :
 	height (confirmation_height_a),
 	frontier (confirmed_frontier_a)
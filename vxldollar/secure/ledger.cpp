@@ -1,10 +1,12 @@
 #include <vxldollar/lib/rep_weights.hpp>
 #include <vxldollar/lib/stats.hpp>
+#include <vxldollar/lib/threading.hpp>
 #include <vxldollar/lib/utility.hpp>
 #include <vxldollar/lib/work.hpp>
 #include <vxldollar/secure/common.hpp>
 #include <vxldollar/secure/ledger.hpp>
 #include <vxldollar/secure/store.hpp>
+#include <vxldollar/secure/store_migration.hpp>
 
 #include <crypto/cryptopp/words.h>
 
@@ -352,6 +354,10 @@ void ledger_processor::state_block_impl (vxldollar::state_block & block_a)
 						ledger.stats.inc (vxldollar::stat::type::ledger, vxldollar::stat::detail::state_block);
 						block_a.sideband_set (vxldollar::block_sideband (block_a.hashables.account /* unused */, 0, 0 /* unused */, info.block_count + 1, vxldollar::seconds_since_epoch (), block_details, source_epoch));
 						ledger.store.block.put (transaction, hash, block_a);
+						if (ledger.account_height_index)
+						{
+							ledger.store.account_height.put (transaction, block_a.hashables.account, block_a.sideband ().height, hash);
+						}
 
 						if (!info.head.is_zero ())
 						{
@@ -452,6 +458,10 @@ void ledger_processor::epoch_block_impl (vxldollar::state_block & block_a)
 								ledger.stats.inc (vxldollar::stat::type::ledger, vxldollar::stat::detail::epoch_block);
 								block_a.sideband_set (vxldollar::block_sideband (block_a.hashables.account /* unused */, 0, 0 /* unused */, info.block_count + 1, vxldollar::seconds_since_epoch (), block_details, vxldollar::epoch::epoch_0 /* unused */));
 								ledger.store.block.put (transaction, hash, block_a);
+								if (ledger.account_height_index)
+								{
+									ledger.store.account_height.put (transaction, block_a.hashables.account, block_a.sideband ().height, hash);
+								}
 								vxldollar::account_info new_info (hash, block_a.representative (), info.open_block.is_zero () ? hash : info.open_block, info.balance, vxldollar::seconds_since_epoch (), info.block_count + 1, epoch);
 								ledger.update_account (transaction, block_a.hashables.account, info, new_info);
 								if (!ledger.store.frontier.get (transaction, info.head).is_zero ())
@@ -505,6 +515,10 @@ void ledger_processor::change_block (vxldollar::change_block & block_a)
 							result.verified = vxldollar::signature_verification::valid;
 							block_a.sideband_set (vxldollar::block_sideband (account, 0, info.balance, info.block_count + 1, vxldollar::seconds_since_epoch (), block_details, vxldollar::epoch::epoch_0 /* unused */));
 							ledger.store.block.put (transaction, hash, block_a);
+							if (ledger.account_height_index)
+							{
+								ledger.store.account_height.put (transaction, account, block_a.sideband ().height, hash);
+							}
 							auto balance (ledger.balance (transaction, block_a.hashables.previous));
 							ledger.cache.rep_weights.representation_add_dual (block_a.representative (), balance, info.representative, 0 - balance);
 							vxldollar::account_info new_info (hash, block_a.representative (), info.open_block, info.balance, vxldollar::seconds_since_epoch (), info.block_count + 1, vxldollar::epoch::epoch_0);
@@ -564,6 +578,10 @@ void ledger_processor::send_block (vxldollar::send_block & block_a)
 								ledger.cache.rep_weights.representation_add (info.representative, 0 - amount);
 								block_a.sideband_set (vxldollar::block_sideband (account, 0, block_a.hashables.balance /* unused */, info.block_count + 1, vxldollar::seconds_since_epoch (), block_details, vxldollar::epoch::epoch_0 /* unused */));
 								ledger.store.block.put (transaction, hash, block_a);
+								if (ledger.account_height_index)
+								{
+									ledger.store.account_height.put (transaction, account, block_a.sideband ().height, hash);
+								}
 								vxldollar::account_info new_info (hash, info.representative, info.open_block, block_a.hashables.balance, vxldollar::seconds_since_epoch (), info.block_count + 1, vxldollar::epoch::epoch_0);
 								ledger.update_account (transaction, account, info, new_info);
 								ledger.store.pending.put (transaction, vxldollar::pending_key (block_a.hashables.destination, hash), { account, amount, vxldollar::epoch::epoch_0 });
@@ -639,6 +657,10 @@ void ledger_processor::receive_block (vxldollar::receive_block & block_a)
 											ledger.store.pending.del (transaction, key);
 											block_a.sideband_set (vxldollar::block_sideband (account, 0, new_balance, info.block_count + 1, vxldollar::seconds_since_epoch (), block_details, vxldollar::epoch::epoch_0 /* unused */));
 											ledger.store.block.put (transaction, hash, block_a);
+											if (ledger.account_height_index)
+											{
+												ledger.store.account_height.put (transaction, account, block_a.sideband ().height, hash);
+											}
 											vxldollar::account_info new_info (hash, info.representative, info.open_block, new_balance, vxldollar::seconds_since_epoch (), info.block_count + 1, vxldollar::epoch::epoch_0);
 											ledger.update_account (transaction, account, info, new_info);
 											ledger.cache.rep_weights.representation_add (info.representative, pending.amount.number ());
@@ -711,6 +733,10 @@ void ledger_processor::open_block (vxldollar::open_block & block_a)
 									ledger.store.pending.del (transaction, key);
 									block_a.sideband_set (vxldollar::block_sideband (block_a.hashables.account, 0, pending.amount, 1, vxldollar::seconds_since_epoch (), block_details, vxldollar::epoch::epoch_0 /* unused */));
 									ledger.store.block.put (transaction, hash, block_a);
+									if (ledger.account_height_index)
+									{
+										ledger.store.account_height.put (transaction, block_a.hashables.account, block_a.sideband ().height, hash);
+									}
 									vxldollar::account_info new_info (hash, block_a.representative (), hash, pending.amount.number (), vxldollar::seconds_since_epoch (), 1, vxldollar::epoch::epoch_0);
 									ledger.update_account (transaction, block_a.hashables.account, info, new_info);
 									ledger.cache.rep_weights.representation_add (block_a.representative (), pending.amount.number ());
@@ -894,11 +920,73 @@ bool vxldollar::ledger::block_or_pruned_exists (vxldollar::block_hash const & ha
 
 bool vxldollar::ledger::block_or_pruned_exists (vxldollar::transaction const & transaction_a, vxldollar::block_hash const & hash_a) const
 {
-	if (store.pruned.exists (transaction_a, hash_a))
+	auto const filter (store.block_filter ());
+	uint64_t insert_stamp (0);
+	if (filter != nullptr)
 	{
-		return true;
+		if (!filter->may_contain (hash_a))
+		{
+			stats.inc (vxldollar::stat::type::block_filter, vxldollar::stat::detail::filtered);
+			return false;
+		}
+		if (filter->cached_absent (hash_a))
+		{
+			stats.inc (vxldollar::stat::type::block_filter, vxldollar::stat::detail::negative_cached);
+			return false;
+		}
+		insert_stamp = filter->insert_stamp (hash_a);
+	}
+	auto result (store.pruned.exists (transaction_a, hash_a) || store.block.exists (transaction_a, hash_a));
+	if (!result && filter != nullptr)
+	{
+		stats.inc (vxldollar::stat::type::block_filter, vxldollar::stat::detail::false_positive);
+		// Readers of older snapshots may still find a block deleted by this transaction, so the miss is cached once it commits.
+		// A put of the hash in the meantime changes its insert stamp, which cancels the caching.
+		auto write_transaction (dynamic_cast<vxldollar::write_transaction const *> (&transaction_a));
+		if (write_transaction != nullptr && write_transaction->contains (vxldollar::tables::blocks))
+		{
+			write_transaction->on_commit ([filter, hash_a, insert_stamp] () {
+				filter->cache_absent (hash_a, insert_stamp);
+			});
+		}
 	}
-	return store.block.exists (transaction_a, hash_a);
+	return result;
+}
+
+void vxldollar::ledger::block_filter_enable (double false_positive_rate_a, std::size_t max_memory_a)
+{
+	uint64_t entries (0);
+	{
+		auto transaction (store.tx_begin_read ());
+		entries = store.block.count (transaction) + store.pruned.count (transaction);
+	}
+	// Room for the ledger to double before the false positive rate is exceeded
+	auto filter (std::make_unique<vxldollar::block_filter> (entries * 2, false_positive_rate_a, max_memory_a));
+	// Only keys are needed, ranges of their first byte are read in parallel without decoding blocks
+	unsigned const range_count (16);
+	std::vector<std::thread> threads;
+	threads.reserve (range_count);
+	for (unsigned range (0); range < range_count; ++range)
+	{
+		threads.emplace_back ([this, &filter, range] () {
+			vxldollar::thread_role::set (vxldollar::thread_role::name::db_parallel_traversal);
+			auto transaction (store.tx_begin_read ());
+			for (auto table : { vxldollar::tables::blocks, vxldollar::tables::pruned })
+			{
+				store.for_each_raw (transaction, table, static_cast<uint8_t> (range * 16), static_cast<uint8_t> (range * 16 + 15), [&filter] (uint8_t const * key_a, std::size_t key_size_a, uint8_t const *, std::size_t) {
+					vxldollar::block_hash hash;
+					debug_assert (key_size_a == sizeof (hash.bytes));
+					std::copy (key_a, key_a + sizeof (hash.bytes), hash.bytes.begin ());
+					filter->insert (hash);
+				});
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	store.block_filter_set (std::move (filter));
 }
 
 std::string vxldollar::ledger::block_text (char const * hash_a)
@@ -1057,6 +1145,10 @@ bool vxldollar::ledger::rollback (vxldollar::write_transaction const & transacti
 			if (!error)
 			{
 				--cache.block_count;
+				if (account_height_index)
+				{
+					store.account_height.del (transaction_a, account_l, account_info.block_count);
+				}
 			}
 		}
 		else
@@ -1397,11 +1489,9 @@ uint64_t vxldollar::ledger::pruning_action (vxldollar::write_transaction & trans
 		auto block (store.block.get (transaction_a, hash));
 		if (block != nullptr)
 		{
-			store.block.del (transaction_a, hash);
-			store.pruned.put (transaction_a, hash);
+			prune (transaction_a, { hash, store.block.account_calculated (*block), block->sideband ().height });
 			hash = block->previous ();
 			++pruned_count;
-			++cache.pruned_count;
 			if (pruned_count % batch_size_a == 0)
 			{
 				transaction_a.commit ();
@@ -1421,6 +1511,97 @@ uint64_t vxldollar::ledger::pruning_action (vxldollar::write_transaction & trans
 	return pruned_count;
 }
 
+void vxldollar::ledger::prune (vxldollar::write_transaction const & transaction_a, vxldollar::pruning_target const & target_a)
+{
+	if (account_height_index)
+	{
+		store.account_height.del (transaction_a, target_a.account, target_a.height);
+	}
+	store.block.del (transaction_a, target_a.hash);
+	store.pruned.put (transaction_a, target_a.hash);
+	++cache.pruned_count;
+}
+
+vxldollar::block_hash vxldollar::ledger::block_at_height (vxldollar::transaction const & transaction_a, vxldollar::account const & account_a, uint64_t height_a) const
+{
+	vxldollar::block_hash result{ 0 };
+	if (account_height_index)
+	{
+		result = store.account_height.get (transaction_a, account_a, height_a);
+	}
+	else
+	{
+		vxldollar::account_info info;
+		if (height_a > 0 && !store.account.get (transaction_a, account_a, info) && height_a <= info.block_count)
+		{
+			auto from_head (info.block_count - height_a < height_a - 1);
+			auto steps (from_head ? info.block_count - height_a : height_a - 1);
+			result = from_head ? info.head : info.open_block;
+			for (; steps > 0 && !result.is_zero (); --steps)
+			{
+				if (from_head)
+				{
+					auto block (store.block.get (transaction_a, result));
+					result = block != nullptr ? block->previous () : 0;
+				}
+				else
+				{
+					result = store.block.successor (transaction_a, result);
+				}
+			}
+		}
+	}
+	return result;
+}
+
+uint64_t vxldollar::ledger::account_height_index_build (vxldollar::write_transaction & transaction_a)
+{
+	auto constexpr accounts_per_commit = 1024;
+	uint64_t indexed (0);
+	vxldollar::account start{ 0 };
+	auto done (false);
+	while (!done)
+	{
+		auto i (store.account.begin (transaction_a, start));
+		auto n (store.account.end ());
+		for (auto accounts (0); i != n && accounts < accounts_per_commit; ++i, ++accounts)
+		{
+			// Walk down from the head until the first pruned block
+			auto const & account (i->first);
+			auto const & info (i->second);
+			auto lowest (info.block_count + 1);
+			auto hash (info.head);
+			auto block (store.block.get (transaction_a, hash));
+			while (block != nullptr)
+			{
+				lowest = block->sideband ().height;
+				store.account_height.put (transaction_a, account, lowest, hash);
+				++indexed;
+				hash = block->previous ();
+				block = !hash.is_zero () ? store.block.get (transaction_a, hash) : nullptr;
+			}
+			// Blocks still stored below a pruned gap, such as the genesis block, are reached from the open block through their successors
+			hash = info.open_block;
+			block = store.block.get (transaction_a, hash);
+			while (block != nullptr && block->sideband ().height < lowest)
+			{
+				store.account_height.put (transaction_a, account, block->sideband ().height, hash);
+				++indexed;
+				hash = block->sideband ().successor;
+				block = !hash.is_zero () ? store.block.get (transaction_a, hash) : nullptr;
+			}
+		}
+		done = i == n;
+		if (!done)
+		{
+			start = i->first;
+			transaction_a.commit ();
+			transaction_a.renew ();
+		}
+	}
+	return indexed;
+}
+
 std::multimap<uint64_t, vxldollar::uncemented_info, std::greater<>> vxldollar::ledger::unconfirmed_frontiers () const
 {
 	vxldollar::locked<std::multimap<uint64_t, vxldollar::uncemented_info, std::greater<>>> result;
@@ -1453,12 +1634,17 @@ std::multimap<uint64_t, vxldollar::uncemented_info, std::greater<>> vxldollar::l
 }
 
 // A precondition is that the store is an LMDB store
-bool vxldollar::ledger::migrate_lmdb_to_rocksdb (boost::filesystem::path const & data_path_a) const
+bool vxldollar::ledger::migrate_lmdb_to_rocksdb (boost::filesystem::path const & data_path_a, std::function<void (std::string const &)> const & progress_a) const
 {
 	boost::system::error_code error_chmod;
 	vxldollar::set_secure_perm_directory (data_path_a, error_chmod);
 	auto rockdb_data_path = data_path_a / "rocksdb";
-	boost::filesystem::remove_all (rockdb_data_path);
+	auto migration_path = data_path_a / "rocksdb_migration";
+	// An interrupted migration keeps the tables it already ingested
+	if (!vxldollar::store_migration::resumable (migration_path))
+	{
+		boost::filesystem::remove_all (rockdb_data_path);
+	}
 
 	vxldollar::logger_mt logger;
 	auto error (false);
@@ -1470,111 +1656,17 @@ bool vxldollar::ledger::migrate_lmdb_to_rocksdb (boost::filesystem::path const &
 
 	if (!rocksdb_store->init_error ())
 	{
-		store.block.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::blocks }));
-
-				std::vector<uint8_t> vector;
-				{
-					vxldollar::vectorstream stream (vector);
-					vxldollar::serialize_block (stream, *i->second.block);
-					i->second.sideband.serialize (stream, i->second.block->type ());
-				}
-				rocksdb_store->block.raw_put (rocksdb_transaction, vector, i->first);
-			}
-		});
-
-		store.pending.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::pending }));
-				rocksdb_store->pending.put (rocksdb_transaction, i->first, i->second);
-			}
-		});
-
-		store.confirmation_height.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::confirmation_height }));
-				rocksdb_store->confirmation_height.put (rocksdb_transaction, i->first, i->second);
-			}
-		});
-
-		store.account.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::accounts }));
-				rocksdb_store->account.put (rocksdb_transaction, i->first, i->second);
-			}
-		});
-
-		store.frontier.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::frontiers }));
-				rocksdb_store->frontier.put (rocksdb_transaction, i->first, i->second);
-			}
-		});
-
-		store.pruned.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::pruned }));
-				rocksdb_store->pruned.put (rocksdb_transaction, i->first);
-			}
-		});
-
-		store.final_vote.for_each_par (
-		[&rocksdb_store] (vxldollar::read_transaction const & /*unused*/, auto i, auto n) {
-			for (; i != n; ++i)
-			{
-				auto rocksdb_transaction (rocksdb_store->tx_begin_write ({}, { vxldollar::tables::final_votes }));
-				rocksdb_store->final_vote.put (rocksdb_transaction, i->first, i->second);
-			}
-		});
-
-		auto lmdb_transaction (store.tx_begin_read ());
-		auto version = store.version.get (lmdb_transaction);
-		auto rocksdb_transaction (rocksdb_store->tx_begin_write ());
-		rocksdb_store->version.put (rocksdb_transaction, version);
-
-		for (auto i (store.online_weight.begin (lmdb_transaction)), n (store.online_weight.end ()); i != n; ++i)
-		{
-			rocksdb_store->online_weight.put (rocksdb_transaction, i->first, i->second);
-		}
-
-		for (auto i (store.peer.begin (lmdb_transaction)), n (store.peer.end ()); i != n; ++i)
+		vxldollar::store_migration migration (store, *rocksdb_store, migration_path, progress_a);
+		error = migration.run ();
+		if (!error)
 		{
-			rocksdb_store->peer.put (rocksdb_transaction, i->first);
+			auto lmdb_transaction (store.tx_begin_read ());
+			auto rocksdb_transaction (rocksdb_store->tx_begin_write ());
+			rocksdb_store->version.put (rocksdb_transaction, store.version.get (lmdb_transaction));
 		}
-
-		// Compare counts
-		error |= store.peer.count (lmdb_transaction) != rocksdb_store->peer.count (rocksdb_transaction);
-		error |= store.pruned.count (lmdb_transaction) != rocksdb_store->pruned.count (rocksdb_transaction);
-		error |= store.final_vote.count (lmdb_transaction) != rocksdb_store->final_vote.count (rocksdb_transaction);
-		error |= store.online_weight.count (lmdb_transaction) != rocksdb_store->online_weight.count (rocksdb_transaction);
-		error |= store.version.get (lmdb_transaction) != rocksdb_store->version.get (rocksdb_transaction);
-
-		// For large tables a random key is used instead and makes sure it exists
-		auto random_block (store.block.random (lmdb_transaction));
-		error |= rocksdb_store->block.get (rocksdb_transaction, random_block->hash ()) == nullptr;
-
-		auto account = random_block->account ().is_zero () ? random_block->sideband ().account : random_block->account ();
-		vxldollar::account_info account_info;
-		error |= rocksdb_store->account.get (rocksdb_transaction, account, account_info);
-
-		// If confirmation height exists in the lmdb ledger for this account it should exist in the rocksdb ledger
-		vxldollar::confirmation_height_info confirmation_height_info{};
-		if (!store.confirmation_height.get (lmdb_transaction, account, confirmation_height_info))
+		if (!error)
 		{
-			error |= rocksdb_store->confirmation_height.get (rocksdb_transaction, account, confirmation_height_info);
+			boost::filesystem::remove_all (migration_path);
 		}
 	}
 	else
@@ -1596,5 +1688,9 @@ std::unique_ptr<vxldollar::container_info_component> vxldollar::collect_containe
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "bootstrap_weights", count, sizeof_element }));
 	composite->add_component (collect_container_info (ledger.cache.rep_weights, "rep_weights"));
+	if (auto const filter = ledger.store.block_filter (); filter != nullptr)
+	{
+		composite->add_component (std::make_unique<container_info_leaf> (container_info{ "block_filter", filter->size (), filter->memory_size () / std::max<uint64_t> (filter->size (), 1) }));
+	}
 	return composite;
 }
@@ -1,55 +1,122 @@
 #include <vxldollar/crypto_lib/random_pool.hpp>
-#include <vxldollar/lib/locks.hpp>
+#include <vxldollar/lib/utility.hpp>
 #include <vxldollar/secure/buffer.hpp>
 #include <vxldollar/secure/common.hpp>
 #include <vxldollar/secure/network_filter.hpp>
 
-vxldollar::network_filter::network_filter (size_t size_a) :
-	items (size_a, vxldollar::uint128_t{ 0 })
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace
 {
-	vxldollar::random_pool::generate_block (key, key.size ());
+/** 64x64 -> 128 bit multiplication, with both halves folded into the result */
+inline uint64_t mix (uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+	auto product (static_cast<unsigned __int128> (a) * b);
+	return static_cast<uint64_t> (product) ^ static_cast<uint64_t> (product >> 64);
+#elif defined(_MSC_VER)
+	uint64_t high;
+	auto low (_umul128 (a, b, &high));
+	return low ^ high;
+#else
+	// Portable 32-bit limb multiplication
+	uint64_t const a_lo (a & 0xffffffff), a_hi (a >> 32), b_lo (b & 0xffffffff), b_hi (b >> 32);
+	uint64_t const lo_lo (a_lo * b_lo), hi_lo (a_hi * b_lo), lo_hi (a_lo * b_hi), hi_hi (a_hi * b_hi);
+	uint64_t const cross ((lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi);
+	uint64_t const high (hi_hi + (hi_lo >> 32) + (cross >> 32));
+	uint64_t const low ((cross << 32) | (lo_lo & 0xffffffff));
+	return low ^ high;
+#endif
 }
 
-bool vxldollar::network_filter::apply (uint8_t const * bytes_a, size_t count_a, vxldollar::uint128_t * digest_a)
+inline uint64_t read_u64 (uint8_t const * bytes_a)
 {
-	// Get hash before locking
-	auto digest (hash (bytes_a, count_a));
+	uint64_t result;
+	std::memcpy (&result, bytes_a, sizeof (result));
+	return result;
+}
 
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	auto & element (get_element (digest));
-	bool existed (element == digest);
-	if (!existed)
-	{
-		// Replace likely old element with a new one
-		element = digest;
-	}
+/** Reads the 1 to 7 trailing bytes of a message into one word */
+inline uint64_t read_tail (uint8_t const * bytes_a, size_t count_a)
+{
+	uint64_t result (0);
+	std::memcpy (&result, bytes_a, count_a);
+	return result;
+}
+
+// Odd constants with good bit dispersion, as used by common multiply-mix hashes
+uint64_t constexpr prime0 = 0xa0761d6478bd642full;
+uint64_t constexpr prime1 = 0xe7037ed1a0b428dbull;
+uint64_t constexpr prime2 = 0x8ebc6af09c88c6e3ull;
+}
+
+vxldollar::network_filter::network_filter (size_t size_a) :
+	ways (std::max<size_t> (1, std::min (size_a, bucket_ways))),
+	buckets (std::max<size_t> (1, size_a / ways))
+{
+	clear ();
+	vxldollar::random_pool::generate_block (reinterpret_cast<uint8_t *> (key.data ()), key.size () * sizeof (uint64_t));
+}
+
+bool vxldollar::network_filter::apply (uint8_t const * bytes_a, size_t count_a, vxldollar::uint128_t * digest_a, uint64_t salt_a)
+{
+	auto digest (hash (bytes_a, count_a, salt_a));
 	if (digest_a)
 	{
 		*digest_a = digest;
 	}
-	return existed;
+	auto const fingerprint_l (fingerprint (digest));
+	auto & slots (get_bucket (digest).slots);
+	for (size_t i (0); i < ways; ++i)
+	{
+		if (slots[i].load (std::memory_order_relaxed) == fingerprint_l)
+		{
+			return true;
+		}
+	}
+	// Not found, take the first free slot. Another thread may be inserting the same digest concurrently.
+	for (size_t i (0); i < ways; ++i)
+	{
+		uint64_t expected (0);
+		if (slots[i].compare_exchange_strong (expected, fingerprint_l, std::memory_order_relaxed))
+		{
+			return false;
+		}
+		else if (expected == fingerprint_l)
+		{
+			return true;
+		}
+	}
+	// Bucket is full, replace a likely old element with a new one. Bits used for bucket selection are not reused here.
+	auto const victim ((fingerprint_l >> 32) % ways);
+	slots[victim].store (fingerprint_l, std::memory_order_relaxed);
+	return false;
 }
 
 void vxldollar::network_filter::clear (vxldollar::uint128_t const & digest_a)
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	auto & element (get_element (digest_a));
-	if (element == digest_a)
+	auto fingerprint_l (fingerprint (digest_a));
+	auto & slots (get_bucket (digest_a).slots);
+	for (size_t i (0); i < ways; ++i)
 	{
-		element = vxldollar::uint128_t{ 0 };
+		auto expected (fingerprint_l);
+		if (slots[i].compare_exchange_strong (expected, 0, std::memory_order_relaxed))
+		{
+			break;
+		}
 	}
 }
 
 void vxldollar::network_filter::clear (std::vector<vxldollar::uint128_t> const & digests_a)
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
 	for (auto const & digest : digests_a)
 	{
-		auto & element (get_element (digest));
-		if (element == digest)
-		{
-			element = vxldollar::uint128_t{ 0 };
-		}
+		clear (digest);
 	}
 }
 
@@ -66,8 +133,13 @@ void vxldollar::network_filter::clear (OBJECT const & object_a)
 
 void vxldollar::network_filter::clear ()
 {
-	vxldollar::lock_guard<vxldollar::mutex> lock (mutex);
-	items.assign (items.size (), vxldollar::uint128_t{ 0 });
+	for (auto & bucket_l : buckets)
+	{
+		for (auto & slot : bucket_l.slots)
+		{
+			slot.store (0, std::memory_order_relaxed);
+		}
+	}
 }
 
 template <typename OBJECT>
@@ -81,20 +153,56 @@ vxldollar::uint128_t vxldollar::network_filter::hash (OBJECT const & object_a) c
 	return hash (bytes.data (), bytes.size ());
 }
 
-vxldollar::uint128_t & vxldollar::network_filter::get_element (vxldollar::uint128_t const & hash_a)
+size_t vxldollar::network_filter::capacity () const
 {
-	debug_assert (!mutex.try_lock ());
-	debug_assert (items.size () > 0);
-	size_t index (hash_a % items.size ());
-	return items[index];
+	return buckets.size () * ways;
 }
 
-vxldollar::uint128_t vxldollar::network_filter::hash (uint8_t const * bytes_a, size_t count_a) const
+vxldollar::network_filter::bucket & vxldollar::network_filter::get_bucket (vxldollar::uint128_t const & hash_a)
 {
-	vxldollar::uint128_union digest{ 0 };
-	siphash_t siphash (key, static_cast<unsigned int> (key.size ()));
-	siphash.CalculateDigest (digest.bytes.data (), bytes_a, count_a);
-	return digest.number ();
+	debug_assert (buckets.size () > 0);
+	auto index (static_cast<uint64_t> (hash_a) % buckets.size ());
+	return buckets[index];
+}
+
+uint64_t vxldollar::network_filter::fingerprint (vxldollar::uint128_t const & hash_a)
+{
+	auto result (static_cast<uint64_t> (hash_a >> 64));
+	return result != 0 ? result : 1;
+}
+
+vxldollar::uint128_t vxldollar::network_filter::hash (uint8_t const * bytes_a, size_t count_a, uint64_t salt_a) const
+{
+	// Two lanes with independent keys, consuming 16 bytes per round. Both operands of every multiplication are keyed,
+	// otherwise a message word cancelling a known constant zeroes a lane, giving collisions which hold for any key.
+	uint64_t lane0 (key[0] ^ mix (count_a ^ prime0, salt_a ^ prime1));
+	uint64_t lane1 (key[1] ^ mix (count_a ^ prime2, salt_a ^ prime0));
+	auto remaining (count_a);
+	auto current (bytes_a);
+	for (; remaining >= 16; remaining -= 16, current += 16)
+	{
+		auto const word0 (read_u64 (current));
+		auto const word1 (read_u64 (current + 8));
+		lane0 = mix (word0 ^ key[2] ^ lane0, word1 ^ key[4]);
+		lane1 = mix (word1 ^ key[3] ^ lane1, word0 ^ key[5]);
+	}
+	uint64_t word0 (0);
+	uint64_t word1 (0);
+	if (remaining > 8)
+	{
+		word0 = read_u64 (current);
+		word1 = read_tail (current + 8, remaining - 8);
+	}
+	else if (remaining > 0)
+	{
+		word0 = read_tail (current, remaining);
+	}
+	lane0 = mix (word0 ^ key[2] ^ lane0, word1 ^ key[4]);
+	lane1 = mix (word1 ^ key[3] ^ lane1, word0 ^ key[5]);
+	// Finalize, making every output bit depend on both lanes
+	auto const low (mix (lane0 ^ key[0], lane1 ^ prime0));
+	auto const high (mix (lane1 ^ key[1], lane0 ^ prime1));
+	return (vxldollar::uint128_t{ high } << 64) | low;
 }
 
 // Explicitly instantiate
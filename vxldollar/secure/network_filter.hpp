@@ -1,33 +1,35 @@
-
 #pragma once
 
 #include <vxldollar/lib/numbers.hpp>
 
-#include <crypto/cryptopp/seckey.h>
-#include <crypto/cryptopp/siphash.h>
-
-#include <mutex>
+#include <array>
+#include <atomic>
+#include <vector>
 
 namespace vxldollar
 {
 /**
- * A probabilistic duplicate filter based on directed map caches, using SipHash 2/4/128
- * The probability of false negatives (unique packet marked as duplicate) is the probability of a 128-bit SipHash collision.
+ * A probabilistic duplicate filter based on set-associative caches, using a keyed 128-bit multiply-mix hash
+ * The filter is split into buckets of one cache line each, holding up to 8 fingerprints. A digest maps to exactly one bucket,
+ * so a lookup touches a single cache line. When a bucket is full, a victim slot is picked from the digest bits.
+ * The probability of false negatives (unique packet marked as duplicate) is the probability of a 64-bit fingerprint collision within a bucket.
  * The probability of false positives (duplicate packet marked as unique) shrinks with a larger filter.
- * @note This class is thread-safe.
+ * @note This class is thread-safe and lock-free. Slots are updated with relaxed atomics, as no other data depends on them.
  */
 class network_filter final
 {
 public:
 	network_filter () = delete;
+	/** Creates a filter holding up to \p size_a digests */
 	network_filter (size_t size_a);
 	/**
-	 * Reads \p count_a bytes starting from \p bytes_a and inserts the siphash digest in the filter.
-	 * @param \p digest_a if given, will be set to the resulting siphash digest
+	 * Reads \p count_a bytes starting from \p bytes_a and inserts the digest in the filter.
+	 * @param \p digest_a if given, will be set to the resulting digest
+	 * @param \p salt_a is mixed into the digest, so that the same bytes can be filtered separately per source (e.g. per endpoint)
 	 * @warning will read out of bounds if [ \p bytes_a, \p bytes_a + \p count_a ] is not a valid range
 	 * @return a boolean representing the previous existence of the hash in the filter.
 	 **/
-	bool apply (uint8_t const * bytes_a, size_t count_a, vxldollar::uint128_t * digest_a = nullptr);
+	bool apply (uint8_t const * bytes_a, size_t count_a, vxldollar::uint128_t * digest_a = nullptr, uint64_t salt_a = 0);
 
 	/**
 	 * Sets the corresponding element in the filter to zero, if it matches \p digest_a exactly.
@@ -47,7 +49,7 @@ public:
 	void clear (uint8_t const * bytes_a, size_t count_a);
 
 	/**
-	 * Serializes \p object_a and clears the resulting siphash digest from the filter.
+	 * Serializes \p object_a and clears the resulting digest from the filter.
 	 * @return a boolean representing the previous existence of the hash in the filter.
 	 **/
 	template <typename OBJECT>
@@ -57,29 +59,41 @@ public:
 	void clear ();
 
 	/**
-	 * Serializes \p object_a and returns the resulting siphash digest
+	 * Serializes \p object_a and returns the resulting digest
 	 */
 	template <typename OBJECT>
 	vxldollar::uint128_t hash (OBJECT const & object_a) const;
 
+	/** Number of digests the filter can hold */
+	size_t capacity () const;
+
+	static size_t constexpr bucket_ways = 8;
+
 private:
-	using siphash_t = CryptoPP::SipHash<2, 4, true>;
+	class alignas (64) bucket final
+	{
+	public:
+		std::array<std::atomic<uint64_t>, bucket_ways> slots;
+	};
+	static_assert (sizeof (bucket) == 64, "Filter bucket must fill exactly one cache line");
 
 	/**
-	 * Get element from digest.
-	 * @note must have a lock on mutex
-	 * @return a reference to the element with key \p hash_a
+	 * Get the bucket a digest maps into
+	 * @return a reference to the bucket for \p hash_a
 	 **/
-	vxldollar::uint128_t & get_element (vxldollar::uint128_t const & hash_a);
+	bucket & get_bucket (vxldollar::uint128_t const & hash_a);
+
+	/** The part of a digest stored in the filter. Zero is reserved for empty slots. */
+	static uint64_t fingerprint (vxldollar::uint128_t const & hash_a);
 
 	/**
 	 * Hashes \p count_a bytes starting from \p bytes_a .
-	 * @return the siphash digest of the contents in \p bytes_a .
+	 * @return the keyed digest of the contents in \p bytes_a .
 	 **/
-	vxldollar::uint128_t hash (uint8_t const * bytes_a, size_t count_a) const;
+	vxldollar::uint128_t hash (uint8_t const * bytes_a, size_t count_a, uint64_t salt_a = 0) const;
 
-	std::vector<vxldollar::uint128_t> items;
-	CryptoPP::SecByteBlock key{ siphash_t::KEYLENGTH };
-	vxldollar::mutex mutex{ mutex_identifier (mutexes::network_filter) };
+	size_t const ways;
+	std::vector<bucket> buckets;
+	std::array<uint64_t, 6> key;
 };
 }
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <vxldollar/lib/stats.hpp>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace vxldollar
+{
+class container_info_component;
+enum class tables;
+
+/**
+ * Counts the operations of the store per table and operation, and times one in every sample_interval of them
+ * Timed operations also read thread local counters of the database backend before and after, such as page faults
+ * for LMDB or block reads from the RocksDB perf context. Disabled by default, when an operation only costs a relaxed load.
+ */
+class store_instrumentation final
+{
+public:
+	enum class operation : uint8_t
+	{
+		get,
+		put,
+		del,
+		exists,
+		/** Creating an iterator, which seeks to its first entry */
+		iterate
+	};
+	static std::size_t constexpr operation_count = 5;
+	/** Entries of vxldollar::tables */
+	static std::size_t constexpr table_count = 14;
+
+	enum class counter : uint8_t
+	{
+		minor_page_faults,
+		major_page_faults,
+		block_reads,
+		block_read_bytes,
+		block_cache_hits,
+		memtable_lookups,
+		bloom_filter_useful
+	};
+	static std::size_t constexpr counter_count = 7;
+	using counter_values = std::array<uint64_t, counter_count>;
+
+	/** Reads the counters of a database backend, on the thread of a timed operation */
+	class backend
+	{
+	public:
+		virtual ~backend () = default;
+		virtual void sample_begin (counter_values &) = 0;
+		virtual void sample_end (counter_values &) = 0;
+	};
+
+	/** Counts an operation when constructed, and records its latency when destroyed if it is timed */
+	class measurement final
+	{
+	public:
+		measurement (store_instrumentation & instrumentation_a, vxldollar::tables table_a, operation operation_a)
+		{
+			if (instrumentation_a.enabled.load (std::memory_order_relaxed))
+			{
+				instrumentation_a.begin (*this, table_a, operation_a);
+			}
+		}
+		~measurement ()
+		{
+			if (instrumentation != nullptr)
+			{
+				instrumentation->end (*this);
+			}
+		}
+		measurement (measurement const &) = delete;
+		measurement & operator= (measurement const &) = delete;
+
+	private:
+		/** Null unless the operation is timed */
+		store_instrumentation * instrumentation{ nullptr };
+		vxldollar::stat_log_histogram * latency{ nullptr };
+		std::chrono::steady_clock::time_point start;
+		counter_values counters;
+
+		friend class vxldollar::store_instrumentation;
+	};
+
+	/** Starts or stops counting, timing one in \p sample_interval_a operations on each table */
+	void enable (bool enable_a, unsigned sample_interval_a);
+	bool is_enabled () const;
+	unsigned sample_interval () const;
+	void clear ();
+	void backend_set (std::unique_ptr<backend> backend_a);
+
+	uint64_t count (vxldollar::tables, operation) const;
+	/** Latencies of the timed operations in nanoseconds */
+	vxldollar::stat_log_histogram const & latency (vxldollar::tables, operation) const;
+	/** Sum of the changes of \p counter_a over the timed operations */
+	uint64_t total (counter counter_a) const;
+	void serialize (boost::property_tree::ptree &) const;
+
+	static std::string table_name (vxldollar::tables);
+	static std::string operation_name (operation);
+	static std::string counter_name (counter);
+
+private:
+	class entry final
+	{
+	public:
+		std::atomic<uint64_t> count{ 0 };
+		vxldollar::stat_log_histogram latency;
+	};
+
+	void begin (measurement &, vxldollar::tables, operation);
+	void end (measurement &);
+	entry & get (vxldollar::tables, operation);
+	entry const & get (vxldollar::tables, operation) const;
+
+	std::array<std::array<entry, operation_count>, table_count> entries;
+	std::array<std::atomic<uint64_t>, counter_count> totals{};
+	std::atomic<bool> enabled{ false };
+	std::atomic<unsigned> interval{ 64 };
+	std::unique_ptr<backend> backend_counters;
+};
+
+std::unique_ptr<container_info_component> collect_container_info (store_instrumentation & instrumentation, std::string const & name);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vxldollar/lib/locks.hpp>
+#include <vxldollar/secure/store.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vxldollar
+{
+/**
+ * Copies the ledger tables of a source store into a target store which ingests table files, e.g. from LMDB to RocksDB
+ * Large tables are split into ranges of the first key byte, which are read and written to table files in parallel.
+ * Finished ranges and tables are recorded in a checkpoint file in the working directory, so an interrupted migration
+ * resumes where it stopped. The source must not be modified in between.
+ * Each table is verified once ingested, by its entry count and by digests of a sample of its values.
+ */
+class store_migration final
+{
+public:
+	store_migration (vxldollar::store & source_a, vxldollar::store & target_a, boost::filesystem::path const & working_path_a, std::function<void (std::string const &)> progress_a = nullptr);
+	/** Migrates every table not finished by an earlier run. @return true on error */
+	bool run ();
+	/** Whether a migration in \p working_path_a was interrupted and can be resumed */
+	static bool resumable (boost::filesystem::path const & working_path_a);
+
+	/** Large tables are split into this many ranges */
+	static unsigned constexpr range_count = 16;
+	/** One in this many entries of a range is sampled for verification */
+	static uint64_t constexpr sample_interval = 1024;
+
+private:
+	class sample final
+	{
+	public:
+		std::vector<uint8_t> key;
+		uint64_t digest;
+	};
+
+	class table_range final
+	{
+	public:
+		uint8_t first;
+		uint8_t last;
+		boost::filesystem::path path;
+		uint64_t entries{ 0 };
+		/** Sampled entries in key order, empty if the range was written by an earlier run */
+		std::vector<sample> samples;
+	};
+
+	bool migrate (vxldollar::tables table_a, std::string const & name_a, unsigned ranges_a);
+	bool write (vxldollar::tables table_a, table_range & range_a);
+	bool verify (vxldollar::tables table_a, std::vector<table_range> const & ranges_a, uint64_t expected_a);
+	/** Runs \p action_a for each index below \p count_a on a set of threads. @return true if any action failed */
+	bool parallel (std::size_t count_a, std::function<bool (std::size_t)> const & action_a);
+	void load_checkpoint ();
+	void checkpoint (std::string const & record_a);
+	void progress (std::string const & message_a);
+	static uint64_t digest (uint8_t const * value_a, std::size_t size_a);
+
+	vxldollar::store & source;
+	vxldollar::store & target;
+	boost::filesystem::path const working_path;
+	std::function<void (std::string const &)> const progress_observer;
+	/** Entries of the ranges written by earlier runs, by "<table> <range>" */
+	std::unordered_map<std::string, uint64_t> finished_ranges;
+	std::unordered_set<std::string> finished_tables;
+	std::ofstream checkpoint_file;
+	vxldollar::mutex mutex;
+
+	static std::string const checkpoint_name;
+};
+}
@@ -6,6 +6,7 @@
 #include <vxldollar/lib/timer.hpp>
 #include <vxldollar/secure/buffer.hpp>
 #include <vxldollar/secure/store.hpp>
+#include <vxldollar/secure/store/account_height_store_partial.hpp>
 #include <vxldollar/secure/store/account_store_partial.hpp>
 #include <vxldollar/secure/store/block_store_partial.hpp>
 #include <vxldollar/secure/store/confirmation_height_store_partial.hpp>
@@ -43,6 +44,9 @@ void release_assert_success (store_partial<Val, Derived_Store> const & store, in
 	}
 }
 
+template <typename Val, typename Derived_Store>
+class account_height_store_partial;
+
 template <typename Val, typename Derived_Store>
 class account_store_partial;
 
@@ -68,6 +72,7 @@ class store_partial : public store
 	friend class vxldollar::confirmation_height_store_partial<Val, Derived_Store>;
 	friend class vxldollar::final_vote_store_partial<Val, Derived_Store>;
 	friend class vxldollar::version_store_partial<Val, Derived_Store>;
+	friend class vxldollar::account_height_store_partial<Val, Derived_Store>;
 
 public:
 	// clang-format off
@@ -83,7 +88,8 @@ public:
 		vxldollar::peer_store_partial<Val, Derived_Store> & peer_store_partial_a,
 		vxldollar::confirmation_height_store_partial<Val, Derived_Store> & confirmation_height_store_partial_a,
 		vxldollar::final_vote_store_partial<Val, Derived_Store> & final_vote_store_partial_a,
-		vxldollar::version_store_partial<Val, Derived_Store> & version_store_partial_a) :
+		vxldollar::version_store_partial<Val, Derived_Store> & version_store_partial_a,
+		vxldollar::account_height_store_partial<Val, Derived_Store> & account_height_store_partial_a) :
 		constants{ constants },
 		store{
 			block_store_partial_a,
@@ -96,7 +102,8 @@ public:
 			peer_store_partial_a,
 			confirmation_height_store_partial_a,
 			final_vote_store_partial_a,
-			version_store_partial_a
+			version_store_partial_a,
+			account_height_store_partial_a
 		}
 	{}
 	// clang-format on
@@ -128,24 +135,34 @@ public:
 
 	bool exists (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::db_val<Val> const & key_a) const
 	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::exists);
 		return static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a);
 	}
 
+	/** Whether any key in \p table_a starts with \p prefix_a. Backends answer most misses from a filter, without reading the table */
+	bool exists_prefix (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::db_val<Val> const & prefix_a) const
+	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::exists);
+		return static_cast<const Derived_Store &> (*this).exists_prefix (transaction_a, table_a, prefix_a);
+	}
+
 	int const minimum_version{ 14 };
 
 protected:
 	vxldollar::ledger_constants & constants;
-	int const version_number{ 21 };
+	int const version_number{ 22 };
 
 	template <typename Key, typename Value>
 	vxldollar::store_iterator<Key, Value> make_iterator (vxldollar::transaction const & transaction_a, tables table_a, bool const direction_asc = true) const
 	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::iterate);
 		return static_cast<Derived_Store const &> (*this).template make_iterator<Key, Value> (transaction_a, table_a, direction_asc);
 	}
 
 	template <typename Key, typename Value>
 	vxldollar::store_iterator<Key, Value> make_iterator (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::db_val<Val> const & key) const
 	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::iterate);
 		return static_cast<Derived_Store const &> (*this).template make_iterator<Key, Value> (transaction_a, table_a, key);
 	}
 
@@ -161,11 +178,20 @@ protected:
 
 	int get (vxldollar::transaction const & transaction_a, tables table_a, vxldollar::db_val<Val> const & key_a, vxldollar::db_val<Val> & value_a) const
 	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::get);
 		return static_cast<Derived_Store const &> (*this).get (transaction_a, table_a, key_a, value_a);
 	}
 
+	/** Batched get, \p values_a is resized to match \p keys_a. Returns the status of each lookup. Instrumentation counts a batch as a single get */
+	std::vector<int> get_many (vxldollar::transaction const & transaction_a, tables table_a, std::vector<vxldollar::db_val<Val>> const & keys_a, std::vector<vxldollar::db_val<Val>> & values_a) const
+	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::get);
+		return static_cast<Derived_Store const &> (*this).get_many (transaction_a, table_a, keys_a, values_a);
+	}
+
 	int put (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::db_val<Val> const & key_a, vxldollar::db_val<Val> const & value_a)
 	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::put);
 		return static_cast<Derived_Store &> (*this).put (transaction_a, table_a, key_a, value_a);
 	}
 
@@ -177,6 +203,7 @@ protected:
 
 	int del (vxldollar::write_transaction const & transaction_a, tables table_a, vxldollar::db_val<Val> const & key_a)
 	{
+		vxldollar::store_instrumentation::measurement measurement (this->instrumentation, table_a, vxldollar::store_instrumentation::operation::del);
 		return static_cast<Derived_Store &> (*this).del (transaction_a, table_a, key_a);
 	}
 
@@ -7,6 +7,7 @@
 #include <vxldollar/node/ipc/ipc_server.hpp>
 #include <vxldollar/node/json_handler.hpp>
 #include <vxldollar/node/node.hpp>
+#include <vxldollar/node/traffic_recorder.hpp>
 
 #include <boost/dll/runtime_symbol_info.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -97,6 +98,7 @@ int main (int argc, char * const * argv)
 		("debug_profile_votes", "Profile votes processing (only for vxldollar_dev_network)")
 		("debug_profile_frontiers_confirmation", "Profile frontiers confirmation speed (only for vxldollar_dev_network)")
 		("debug_random_feed", "Generates output to RNG test suites")
+		("debug_traffic_replay", "Replay a traffic log written with --record_traffic into a node with a fresh ledger. Requires --file, see also --speed")
 		("debug_rpc", "Read an RPC command from stdin and invoke it. Network operations will have no effect.")
 		("debug_peers", "Display peer IPv6:port connections")
 		("debug_cemented_block_count", "Displays the number of cemented (confirmed) blocks")
@@ -111,6 +113,7 @@ int main (int argc, char * const * argv)
 		("difficulty", boost::program_options::value<std::string> (), "Defines <difficulty> for OpenCL command, HEX")
 		("multiplier", boost::program_options::value<std::string> (), "Defines <multiplier> for work generation. Overrides <difficulty>")
 		("count", boost::program_options::value<std::string> (), "Defines <count> for various commands")
+		("speed", boost::program_options::value<std::string> (), "Defines <speed> multiplier for --debug_traffic_replay, 0 replays as fast as possible. Default 1")
 		("pow_sleep_interval", boost::program_options::value<std::string> (), "Defines the amount to sleep inbetween each pow calculation attempt")
 		("address_column", boost::program_options::value<std::string> (), "Defines which column the addresses are located, 0 indexed (check --debug_output_last_backtrace_dump output)")
 		("silent", "Silent command execution");
@@ -1121,6 +1124,45 @@ int main (int argc, char * const * argv)
 			node->stop ();
 			std::cerr << boost::str (boost::format ("%|1$ 12d| us \n%2% votes per second\n") % time % (max_votes * 1000000 / time));
 		}
+		else if (vm.count ("debug_traffic_replay"))
+		{
+			if (vm.count ("file") == 1)
+			{
+				double speed (1.0);
+				auto speed_it = vm.find ("speed");
+				if (speed_it != vm.end () && (!boost::conversion::try_lexical_convert (speed_it->second.as<std::string> (), speed) || speed < 0))
+				{
+					std::cerr << "Invalid speed\n";
+					result = -1;
+				}
+				if (!result)
+				{
+					vxldollar::node_flags node_flags;
+					vxldollar::update_flags (node_flags, vm);
+					// Never record the replay itself
+					node_flags.record_traffic_path.clear ();
+					vxldollar::node_wrapper node_wrapper (vxldollar::unique_path (), data_path, node_flags);
+					auto node = node_wrapper.node;
+					vxldollar::traffic_replay replay (*node, vm["file"].as<std::string> ());
+					auto begin (std::chrono::steady_clock::now ());
+					auto error (replay.run (speed));
+					node->block_processor.flush ();
+					auto time (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin).count ());
+					std::cout << boost::str (boost::format ("Replayed %1% messages in %2% ms, %3% dropped\nBlock count: %4%\n") % replay.messages % time % replay.dropped % node->ledger.cache.block_count);
+					if (error)
+					{
+						std::cerr << "Traffic log could not be opened or is malformed\n";
+						result = -1;
+					}
+					node->stop ();
+				}
+			}
+			else
+			{
+				std::cerr << "Replaying traffic requires one <file> option\n";
+				result = -1;
+			}
+		}
 		else if (vm.count ("debug_profile_frontiers_confirmation"))
 		{
 			vxldollar::block_builder builder;